@@ -924,6 +924,12 @@ namespace UserConfigParams
         PARAM_DEFAULT(IntUserConfigParam(5, "timer-sync-difference-tolerance",
         &m_network_group, "Max time difference tolerance (in ms) to "
         "synchronize timer with server."));
+    PARAM_PREFIX BoolUserConfigParam m_timer_sync_filter
+        PARAM_DEFAULT(BoolUserConfigParam(true, "timer-sync-filter",
+        &m_network_group, "Synchronize the timer with server using only the "
+        "samples with the lowest delay and an estimated clock drift, and "
+        "adjust it smoothly during the game. If false the average of 20 "
+        "samples is used once."));
     PARAM_PREFIX IntUserConfigParam m_default_ip_type
         PARAM_DEFAULT(IntUserConfigParam(0, "default-ip-type",
         &m_network_group, "Default IP type of this machine, "
@@ -1019,6 +1025,18 @@ namespace UserConfigParams
     // ---- Misc
     PARAM_PREFIX BoolUserConfigParam        m_cache_overworld
             PARAM_DEFAULT(  BoolUserConfigParam(true, "cache-overworld") );
+    PARAM_PREFIX BoolUserConfigParam        m_cache_graphs
+            PARAM_DEFAULT(  BoolUserConfigParam(true, "cache-graphs",
+            "Cache processed drive graph and arena path data on disk, "
+            "which speeds up loading of tracks and arenas.") );
+    PARAM_PREFIX IntUserConfigParam         m_arena_path_cache_max_mb
+            PARAM_DEFAULT(  IntUserConfigParam(64, "arena-path-cache-max-mb",
+            "Maximum size in MB of the on-disk shortest path cache of a "
+            "single arena.") );
+    PARAM_PREFIX IntUserConfigParam         m_ai_threads
+            PARAM_DEFAULT(  IntUserConfigParam(0, "ai-threads",
+            "Number of threads used to compute the AI in parallel, "
+            "0 or 1 to compute it only in the main thread.") );
 
     // TODO : is this used with new code? does it still work?
     PARAM_PREFIX BoolUserConfigParam        m_crashed
@@ -37,14 +37,23 @@
 Explosion::Explosion(const Vec3& coord, const char* explosion_sound, const char * particle_file)
                      : HitSFX(coord, explosion_sound)
 {
+    m_particle_file = particle_file;
+    m_emitter = NULL;
     // short emision time, explosion, not constant flame
-
     m_explosion_ticks = stk_config->time2Ticks(2.0f);
     m_remaining_ticks = stk_config->time2Ticks(0.1f);
     m_emission_frames = 0;
+    createEmitter(coord);
+}   // Explosion
 
+//-----------------------------------------------------------------------------
+/** Creates the particle emitter of the explosion (if particles are
+ *  enabled).
+ */
+void Explosion::createEmitter(const Vec3& coord)
+{
 #ifndef SERVER_ONLY
-    std::string filename = particle_file;
+    std::string filename = m_particle_file;
 
 #ifdef MOBILE_STK
     // Use a lower quality effect on mobile for better performance
@@ -58,7 +67,6 @@ Explosion::Explosion(const Vec3& coord, const char* explosion_sound, const char
 
     ParticleKindManager* pkm = ParticleKindManager::get();
     ParticleKind* particles = pkm->getParticles(filename);
-    m_emitter = NULL;
     
     if (UserConfigParams::m_particles_effects > 1)
     {
@@ -66,7 +74,7 @@ Explosion::Explosion(const Vec3& coord, const char* explosion_sound, const char
         m_emitter->getNode()->setPreGenerating(false);
     }
 #endif
-}   // Explosion
+}   // createEmitter
 
 //-----------------------------------------------------------------------------
 /** Destructor stops the explosion sfx from being played and frees its memory.
@@ -81,6 +89,23 @@ Explosion::~Explosion()
 #endif
 }   // ~Explosion
 
+//-----------------------------------------------------------------------------
+/** Restarts a finished explosion at a new position. The sfx is reused,
+ *  the particle emitter is created again since its particles can not be
+ *  restarted.
+ */
+void Explosion::reset(const Vec3& coord)
+{
+    HitSFX::reset(coord);
+    m_remaining_ticks = stk_config->time2Ticks(0.1f);
+    m_emission_frames = 0;
+#ifndef SERVER_ONLY
+    delete m_emitter;
+    m_emitter = NULL;
+#endif
+    createEmitter(coord);
+}   // reset
+
 //-----------------------------------------------------------------------------
 /** Updates the explosion, called one per time step.
  *  \param dt Time step size.
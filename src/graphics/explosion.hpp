@@ -45,11 +45,30 @@ private:
     ParticleEmitter* m_emitter;
     int              m_explosion_ticks;
 
+    /** Name of the particle file, used as pool key. */
+    std::string      m_particle_file;
+
+    void             createEmitter(const Vec3 &coord);
 
 public:
          Explosion(const Vec3& coord, const char* explosion_sound, const char * particle_file );
         ~Explosion();
     bool updateAndDelete(int ticks) OVERRIDE;
+    virtual void reset(const Vec3 &coord) OVERRIDE;
+    // ------------------------------------------------------------------------
+    virtual std::string getPoolKey() const OVERRIDE
+    {
+        return makePoolKey(HitSFX::getPoolKey().c_str(),
+                           m_particle_file.c_str());
+    }   // getPoolKey
+    // ------------------------------------------------------------------------
+    /** Returns the pool key of an explosion with the given sound and
+     *  particles. */
+    static std::string makePoolKey(const char *sound,
+                                   const char *particle_file)
+    {
+        return HitSFX::makePoolKey(sound) + "/" + particle_file;
+    }   // makePoolKey
     bool hasEnded () 
     {
         return  m_remaining_ticks <= -m_explosion_ticks; 
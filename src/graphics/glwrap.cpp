@@ -183,7 +183,8 @@ ScopedGPUTimer::ScopedGPUTimer(GPUTimer &t) : timer(t)
                 GL_DEBUG_SEVERITY_NOTIFICATION, -1, msg.c_str());
         }
     }
-    if (!UserConfigParams::m_profiler_enabled) return;
+    if (!UserConfigParams::m_profiler_enabled && !profiler.isTracing())
+        return;
     if (profiler.isFrozen()) return;
     if (!timer.canSubmitQuery) return;
 #ifdef GL_TIME_ELAPSED
@@ -207,7 +208,8 @@ ScopedGPUTimer::~ScopedGPUTimer()
                 GL_DEBUG_SEVERITY_NOTIFICATION, -1, msg.c_str());
         }
     }
-    if (!UserConfigParams::m_profiler_enabled) return;
+    if (!UserConfigParams::m_profiler_enabled && !profiler.isTracing())
+        return;
     if (profiler.isFrozen()) return;
     if (!timer.canSubmitQuery) return;
 #ifdef GL_TIME_ELAPSED
@@ -21,6 +21,8 @@
 
 #include "utils/no_copy.hpp"
 
+#include <string>
+
 class Vec3;
 
 /**
@@ -53,6 +55,15 @@ public:
     // ------------------------------------------------------------------------
     /** Returns if this effect affects a player kart. */
     bool getLocalPlayerKartHit() const { return m_local_player_kart_hit; }
+    // ------------------------------------------------------------------------
+    /** Returns a key so that finished effects with the same key can be
+     *  reused (see ProjectileManager), or an empty string if this effect
+     *  can not be reused. */
+    virtual std::string getPoolKey() const { return ""; }
+    // ------------------------------------------------------------------------
+    /** Restarts a finished effect at a new position. Only called for
+     *  effects with a non-empty pool key. */
+    virtual void reset(const Vec3 &coord) { m_local_player_kart_hit = false; }
 };   // HitEffect
 
 #endif
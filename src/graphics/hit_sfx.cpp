@@ -26,15 +26,28 @@
 HitSFX::HitSFX(const Vec3& coord, const char* explosion_sound)
              : HitEffect()
 {
+    m_sound = explosion_sound;
     m_sfx = SFXManager::get()->createSoundSource( explosion_sound );
+    play(coord);
+}   // HitSFX
 
+/** Plays the sfx at the given position. */
+void HitSFX::play(const Vec3 &coord)
+{
     // in multiplayer mode, sounds are NOT positional (because we have
     // multiple listeners) so the sounds of all AIs are constantly heard.
     // Therefore reduce volume of sounds.
     float vol = RaceManager::get()->getNumLocalPlayers() > 1 ? 0.5f : 1.0f;
     m_sfx->setVolume(vol);
     m_sfx->play(coord);
-}   // HitSFX
+}   // play
+
+/** Plays the (finished) sfx again at a new position. */
+void HitSFX::reset(const Vec3 &coord)
+{
+    HitEffect::reset(coord);
+    play(coord);
+}   // reset
 
 //-----------------------------------------------------------------------------
 /** Destructor stops the explosion sfx from being played and frees its memory.
@@ -22,6 +22,8 @@
 #include "graphics/hit_effect.hpp"
 #include "utils/cpp2011.hpp"
 
+#include <string>
+
 class SFXBase;
 
 /**
@@ -33,11 +35,28 @@ private:
     /** The sfx to play. */
     SFXBase*       m_sfx;
 
+    /** Name of the sfx, used as pool key. */
+    std::string    m_sound;
+
+    void           play(const Vec3 &coord);
+
 public:
          HitSFX(const Vec3& coord, const char* explosion_sound);
         ~HitSFX();
     virtual bool updateAndDelete(int ticks) OVERRIDE;
     virtual void setLocalPlayerKartHit() OVERRIDE;
+    virtual void reset(const Vec3 &coord) OVERRIDE;
+    // ------------------------------------------------------------------------
+    virtual std::string getPoolKey() const OVERRIDE
+    {
+        return makePoolKey(m_sound.c_str());
+    }   // getPoolKey
+    // ------------------------------------------------------------------------
+    /** Returns the pool key of a hit sfx with the given sound. */
+    static std::string makePoolKey(const char *sound)
+    {
+        return sound;
+    }   // makePoolKey
 
 };   // HitSFX
 
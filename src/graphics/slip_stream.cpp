@@ -39,6 +39,8 @@
 #include "utils/constants.hpp"
 #include "mini_glm.hpp"
 
+#include <algorithm>
+
 #include <IMeshCache.h>
 #include <ISceneManager.h>
 #include <SMeshBuffer.h>
@@ -918,15 +920,42 @@ void SlipStream::update(int ticks)
     bool is_inner_sstreaming = false;
     bool is_outer_sstreaming = false;
     m_target_kart            = NULL;
-    std::vector<float> target_value;
+    std::vector<float> target_value(num_karts, 0.0f);
 
     // Note that this loop can not be simply replaced with a shorter loop
     // using only the karts with a better position - since a kart might
-    // be a lap behind
-    for(unsigned int i=0; i<num_karts; i++)
+    // be a lap behind. But only karts close enough can pass the quick
+    // distance test below, so take the candidates from the proximity grid.
+    // The previous target must always be tested (since it is reset if it
+    // is not a target anymore), and in debug mode all karts are tested to
+    // set the debug colours.
+    std::vector<unsigned int> &candidates = m_candidate_karts;
+    if(UserConfigParams::m_slipstream_debug &&
+        m_kart->getController()->isLocalPlayerController())
+    {
+        candidates.clear();
+        for(unsigned int i=0; i<num_karts; i++)
+            candidates.push_back(i);
+    }
+    else
+    {
+        world->getKartProximity()->getKartsInRadius(m_kart->getXYZ(),
+            world->getKartProximity()->getMaxSlipstreamReach()
+            + 0.5f*m_kart->getKartLength(), &candidates);
+        if (m_previous_target_id >= 0 &&
+            !std::binary_search(candidates.begin(), candidates.end(),
+                                (unsigned int)m_previous_target_id))
+        {
+            candidates.insert(std::upper_bound(candidates.begin(),
+                                               candidates.end(),
+                                   (unsigned int)m_previous_target_id),
+                              (unsigned int)m_previous_target_id);
+        }
+    }
+
+    for(unsigned int i : candidates)
     {
         m_target_kart= world->getKart(i);
-        target_value.push_back(0);
 
         // Don't test for slipstream with itself, a kart that is being
         // rescued or exploding, a ghost kart or an eliminated kart
@@ -1022,7 +1051,9 @@ void SlipStream::update(int ticks)
             is_outer_sstreaming     = true;
             continue;
         }
-    }   // for i < num_karts
+    }   // for i in candidates
+    // Keep the target of testing all karts (used if there is no best target)
+    m_target_kart = num_karts > 0 ? world->getKart(num_karts-1) : NULL;
 
     int best_target=-1;
     float best_target_value=0.0f;
@@ -36,6 +36,7 @@ namespace SP
 #include "graphics/moving_texture.hpp"
 #include "utils/no_copy.hpp"
 #include <memory>
+#include <vector>
 
 class AbstractKart;
 class Quad;
@@ -94,6 +95,9 @@ private:
 
     int          m_current_target_id;
     int          m_previous_target_id;
+
+    /** The karts tested in update(), stored to avoid reallocations. */
+    std::vector<unsigned int> m_candidate_karts;
     int          m_speed_increase_ticks;
     int          m_speed_increase_duration;
 
@@ -266,6 +266,7 @@ FileManager::FileManager()
     checkAndCreateScreenshotDir();
     checkAndCreateReplayDir();
     checkAndCreateCachedTexturesDir();
+    checkAndCreateCachedGraphsDir();
     checkAndCreateGPDir();
 
     redirectOutput();
@@ -841,6 +842,15 @@ std::string FileManager::getCachedTexturesDir() const
     return m_cached_textures_dir;
 }   // getCachedTexturesDir
 
+//-----------------------------------------------------------------------------
+/** Returns the directory in which processed drive and arena graph data
+ *  is cached.
+ */
+std::string FileManager::getCachedGraphsDir() const
+{
+    return m_cached_graphs_dir;
+}   // getCachedGraphsDir
+
 //-----------------------------------------------------------------------------
 /** Returns the directory in which user-defined grand prix should be stored.
  */
@@ -1209,6 +1219,31 @@ void FileManager::checkAndCreateCachedTexturesDir()
 
 }   // checkAndCreateCachedTexturesDir
 
+// ----------------------------------------------------------------------------
+/** Creates the directory for the processed track graph data cache. This will
+ *  set m_cached_graphs_dir with the appropriate path.
+ */
+void FileManager::checkAndCreateCachedGraphsDir()
+{
+#if defined(WIN32) || defined(__HAIKU__)
+    m_cached_graphs_dir = m_user_config_dir + "cached-graphs/";
+#elif defined(__APPLE__)
+    m_cached_graphs_dir = getenv("HOME");
+    m_cached_graphs_dir += "/Library/Application Support/SuperTuxKart/CachedGraphs/";
+#else
+    m_cached_graphs_dir = checkAndCreateLinuxDir("XDG_CACHE_HOME", "supertuxkart", ".cache/", ".");
+    m_cached_graphs_dir += "cached-graphs/";
+#endif
+
+    if (!checkAndCreateDirectory(m_cached_graphs_dir))
+    {
+        Log::error("FileManager", "Can not create cached graphs directory '%s', "
+            "falling back to '.'.", m_cached_graphs_dir.c_str());
+        m_cached_graphs_dir = "./";
+    }
+
+}   // checkAndCreateCachedGraphsDir
+
 // ----------------------------------------------------------------------------
 /** Creates the directories for user-defined grand prix. This will set m_gp_dir
  *  with the appropriate path.
@@ -23,6 +23,7 @@
 #include "utils/string_utils.hpp"
 #include "utils/vec3.hpp"
 
+#include <functional>
 #include <stdexcept>
 
 XMLNode::XMLNode(io::IXMLReader *xml)
@@ -664,3 +665,25 @@ bool XMLNode::hasChildNamed(const char* name) const
     }
     return false;
 }
+
+// ----------------------------------------------------------------------------
+/** Returns a hash of the name, attributes and child nodes of this node, which
+ *  can be used to detect if a node changed, e.g. between two downloads.
+ */
+size_t XMLNode::getHash() const
+{
+    std::hash<std::string> hash_string;
+    size_t hash = hash_string(m_name);
+    auto combine = [&hash](size_t value)
+    {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    for (auto& attribute : m_attributes)
+    {
+        combine(hash_string(attribute.first));
+        combine(hash_string(StringUtils::wideToUtf8(attribute.second)));
+    }
+    for (unsigned int i = 0; i < m_nodes.size(); i++)
+        combine(m_nodes[i]->getHash());
+    return hash;
+}   // getHash
@@ -24,7 +24,7 @@
 #include "config/player_manager.hpp"
 #include "config/stk_config.hpp"
 #include "config/user_config.hpp"
-#include "graphics/explosion.hpp"
+#include "graphics/hit_effect.hpp"
 #include "graphics/irr_driver.hpp"
 #include <ge_render_info.hpp>
 #include "guiengine/engine.hpp"
@@ -308,8 +308,8 @@ void Attachment::hitBanana(ItemState *item_state)
         add_a_new_item = false;
         if (!GUIEngine::isNoGraphics() && !RewindManager::get()->isRewinding())
         {
-            HitEffect* he = new Explosion(m_kart->getXYZ(), "explosion",
-                "explosion_bomb.xml");
+            HitEffect* he = ProjectileManager::get()->newExplosion(
+                m_kart->getXYZ(), "explosion", "explosion_bomb.xml");
             // Rumble!
             Controller* controller = m_kart->getController();
             if (controller && controller->isLocalPlayerController())
@@ -525,8 +525,8 @@ void Attachment::update(int ticks)
         {
             if (!GUIEngine::isNoGraphics() && !RewindManager::get()->isRewinding())
             {
-                HitEffect* he = new Explosion(m_kart->getXYZ(), "explosion",
-                    "explosion_bomb.xml");
+                HitEffect* he = ProjectileManager::get()->newExplosion(
+                    m_kart->getXYZ(), "explosion", "explosion_bomb.xml");
                 // Rumble!
                 Controller* controller = m_kart->getController();
                 if (controller && controller->isLocalPlayerController())
@@ -20,9 +20,10 @@
 
 #include "audio/sfx_base.hpp"
 #include "audio/sfx_manager.hpp"
-#include "graphics/hit_sfx.hpp"
+#include "graphics/hit_effect.hpp"
 #include "graphics/material.hpp"
 #include "io/xml_node.hpp"
+#include "items/projectile_manager.hpp"
 #include "karts/abstract_kart.hpp"
 #include "modes/linear_world.hpp"
 
@@ -192,9 +193,9 @@ HitEffect* Bowling::getHitEffect() const
     if (m_deleted_once)
         return NULL;
     if(m_has_hit_kart)
-        return new HitSFX(getXYZ(), "strike");
+        return ProjectileManager::get()->newHitSFX(getXYZ(), "strike");
     else
-        return new HitSFX(getXYZ(), "crash");
+        return ProjectileManager::get()->newHitSFX(getXYZ(), "crash");
 }   // getHitEffect
 
 // ----------------------------------------------------------------------------
@@ -29,7 +29,7 @@
 #include "audio/sfx_base.hpp"
 #include "achievements/achievements_status.hpp"
 #include "config/player_manager.hpp"
-#include "graphics/explosion.hpp"
+#include "graphics/hit_effect.hpp"
 #include "graphics/irr_driver.hpp"
 #include "graphics/material.hpp"
 #include "graphics/mesh_tools.hpp"
@@ -633,7 +633,8 @@ HitEffect* Flyable::getHitEffect() const
     if (GUIEngine::isNoGraphics())
         return NULL;
     return m_deleted_once ? NULL :
-        new Explosion(getXYZ(), "explosion", "explosion_cake.xml");
+        ProjectileManager::get()->newExplosion(getXYZ(), "explosion",
+                                               "explosion_cake.xml");
 }   // getHitEffect
 
 // ----------------------------------------------------------------------------
@@ -683,7 +684,8 @@ BareNetworkString* Flyable::saveState(std::vector<std::string>* ru)
     else
     {
         CompressNetworkBody::compress(
-            m_body.get(), m_motion_state.get(), buffer);
+            m_body.get(), m_motion_state.get(), buffer,
+            !RewindManager::get()->isSavingPrediction());
     }
     return buffer;
 }   // saveState
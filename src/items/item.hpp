@@ -172,6 +172,13 @@ public:
         return false;
     }   // hitKart
 
+    // -----------------------------------------------------------------------
+    virtual float getMaxHitDistance() const
+    {
+        Log::fatal("ItemState", "getMaxHitDistance() called for ItemState.");
+        return 0;
+    }   // getMaxHitDistance
+
     // -----------------------------------------------------------------------
     virtual int getGraphNode() const 
     {
@@ -409,6 +416,14 @@ public:
         return lc.length2() < m_distance_2;
     }   // hitKart
     // ------------------------------------------------------------------------
+    /** Returns the largest distance between a kart and this item at which
+     *  hitKart() can return true. Since the vertical component is halved
+     *  there, this is twice the collection distance. */
+    virtual float getMaxHitDistance() const OVERRIDE
+    {
+        return 2.0f * sqrtf(m_distance_2);
+    }   // getMaxHitDistance
+    // ------------------------------------------------------------------------
     bool rotating() const               { return getType() != ITEM_BUBBLEGUM; }
 
 public:
@@ -41,6 +41,7 @@
 #include <IAnimatedMesh.h>
 
 #include <assert.h>
+#include <cmath>
 #include <stdexcept>
 #include <sstream>
 #include <string>
@@ -253,10 +254,11 @@ unsigned int ItemManager::insertItem(Item *item)
 
 //-----------------------------------------------------------------------------
 /** Insert into the appropriate quad list, if there is a quad list
- *  (i.e. race mode has a quad graph).
+ *  (i.e. race mode has a quad graph), and into the item hit grid.
  */
 void ItemManager::insertItemInQuad(Item *item)
 {
+    insertItemInGrid(item);
     if(m_items_in_quads)
     {
         int graph_node = item->getGraphNode();
@@ -270,6 +272,87 @@ void ItemManager::insertItemInQuad(Item *item)
     }   // if m_items_in_quads
 }   // insertItemInQuad
 
+//-----------------------------------------------------------------------------
+/** Size of a cell in the item hit grid. It is larger than twice the maximum
+ *  hit distance of an item, so each item is in at most 4 cells. */
+static const float ITEM_GRID_CELL_SIZE = 5.0f;
+
+/** Returns the index of the grid cell that contains the coordinate f. */
+static int getGridCoord(float f)
+{
+    return (int)floorf(f / ITEM_GRID_CELL_SIZE);
+}   // getGridCoord
+
+/** Returns the key in the item hit grid of the cell (x, z). */
+static uint64_t getGridKey(int x, int z)
+{
+    return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)z;
+}   // getGridKey
+
+//-----------------------------------------------------------------------------
+/** Adds the item to all cells of the item hit grid that overlap the area in
+ *  which the item can be hit by a kart.
+ *  \param item The item to add.
+ */
+void ItemManager::insertItemInGrid(ItemState *item)
+{
+    const Vec3 &xyz   = item->getXYZ();
+    const float reach = item->getMaxHitDistance();
+    const int min_x = getGridCoord(xyz.getX() - reach);
+    const int max_x = getGridCoord(xyz.getX() + reach);
+    const int min_z = getGridCoord(xyz.getZ() - reach);
+    const int max_z = getGridCoord(xyz.getZ() + reach);
+    for (int x = min_x; x <= max_x; x++)
+    {
+        for (int z = min_z; z <= max_z; z++)
+        {
+            // Keep the cell sorted by item id, so that items are tested in
+            // the same order as they are stored in m_all_items.
+            AllItemTypes &cell = m_item_grid[getGridKey(x, z)];
+            AllItemTypes::iterator it =
+                std::upper_bound(cell.begin(), cell.end(), item,
+                                 [](const ItemState *a, const ItemState *b)
+                                 {
+                                     return a->getItemId() < b->getItemId();
+                                 });
+            cell.insert(it, item);
+        }
+    }
+}   // insertItemInGrid
+
+//-----------------------------------------------------------------------------
+/** Removes the item from the item hit grid. The item must still be at the
+ *  position at which it was inserted.
+ *  \param item The item to remove.
+ */
+void ItemManager::deleteItemInGrid(ItemState *item)
+{
+    const Vec3 &xyz   = item->getXYZ();
+    const float reach = item->getMaxHitDistance();
+    const int min_x = getGridCoord(xyz.getX() - reach);
+    const int max_x = getGridCoord(xyz.getX() + reach);
+    const int min_z = getGridCoord(xyz.getZ() - reach);
+    const int max_z = getGridCoord(xyz.getZ() + reach);
+    for (int x = min_x; x <= max_x; x++)
+    {
+        for (int z = min_z; z <= max_z; z++)
+        {
+            auto cell = m_item_grid.find(getGridKey(x, z));
+            assert(cell != m_item_grid.end());
+            if (cell == m_item_grid.end())
+                continue;
+            AllItemTypes &items = cell->second;
+            AllItemTypes::iterator it = std::find(items.begin(), items.end(),
+                                                  item);
+            assert(it != items.end());
+            if (it != items.end())
+                items.erase(it);
+            if (items.empty())
+                m_item_grid.erase(cell);
+        }
+    }
+}   // deleteItemInGrid
+
 //-----------------------------------------------------------------------------
 /** Creates a new item at the location of the kart (e.g. kart drops a
  *  bubblegum).
@@ -388,43 +471,42 @@ void ItemManager::collectedItem(ItemState *item, AbstractKart *kart)
  */
 void  ItemManager::checkItemHit(AbstractKart* kart)
 {
-    // We could use m_items_in_quads to to check for item hits: take the quad
-    // of the graph node of the kart, and only check items in that quad. But
-    // then we also need to check for any adjacent quads (since an item just
-    // on the order of one quad might get hit from an adjacent quad). Then
-    // it is possible that a quad is that short that we need to test adjacent
-    // of adjacent quads. And check for items outside of the track.
-    // Since at this stace item detection is by far not a bottle neck,
-    // the original, simple and stable algorithm is left in place.
-
     /** Disable item collection detection for debug purposes. */
     if(m_disable_item_collection) return;
 
     // Spare tire karts don't collect items
     if ( dynamic_cast<SpareTireAI*>(kart->getController()) ) return;
 
-    for(AllItemTypes::iterator i =m_all_items.begin();
-                               i!=m_all_items.end();  i++)
+    // Only the items in the grid cell of the kart can be hit. Since the
+    // cell is sorted by item id, the items are collected in the same order
+    // as when testing all items, which keeps rewinds deterministic.
+    const Vec3 &xyz = kart->getXYZ();
+    auto cell = m_item_grid.find(getGridKey(getGridCoord(xyz.getX()),
+                                            getGridCoord(xyz.getZ())));
+    if (cell == m_item_grid.end()) return;
+
+    const AllItemTypes &items = cell->second;
+    for(unsigned int i = 0; i < items.size(); i++)
     {
+        ItemState *item = items[i];
         // Ignore items that have been collected or are not available atm
-        if ((!*i) || !(*i)->isAvailable() || (*i)->isUsedUp()) continue;
+        if (!item->isAvailable() || item->isUsedUp()) continue;
 
         // Shielded karts can simply drive over bubble gums without any effect
         if ( kart->isShielded() &&
-             ( (*i)->getType() == ItemState::ITEM_BUBBLEGUM      ||
-               (*i)->getType() == ItemState::ITEM_BUBBLEGUM_NOLOK  ) )
+             ( item->getType() == ItemState::ITEM_BUBBLEGUM      ||
+               item->getType() == ItemState::ITEM_BUBBLEGUM_NOLOK  ) )
         {
             continue;
         }
 
-
         // To allow inlining and avoid including kart.hpp in item.hpp,
         // we pass the kart and the position separately.
-        if((*i)->hitKart(kart->getXYZ(), kart))
+        if(item->hitKart(xyz, kart))
         {
-            collectedItem(*i, kart);
+            collectedItem(item, kart);
         }   // if hit
-    }   // for m_all_items
+    }   // for items
 }   // checkItemHit
 
 //-----------------------------------------------------------------------------
@@ -535,11 +617,12 @@ void ItemManager::deleteItem(ItemState *item)
 }   // delete item
 
 //-----------------------------------------------------------------------------
-/** Removes an items from the items-in-quad list only
+/** Removes an items from the items-in-quad list and the item hit grid only
  *  \param The item to delete.
  */
 void ItemManager::deleteItemInQuad(ItemState* item)
 {
+    deleteItemInGrid(item);
     if(m_items_in_quads)
     {
         int sector = item->getGraphNode();
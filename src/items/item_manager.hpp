@@ -35,6 +35,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class Kart;
@@ -113,6 +114,13 @@ private:
      *  field is undefined if no Graph exist, e.g. arena without navmesh. */
     std::vector< AllItemTypes > *m_items_in_quads;
 
+    /** A uniform grid on the XZ plane used to find the items a kart can
+     *  hit. Each item is stored in every cell that overlaps the area in
+     *  which it can be hit, so a kart only has to test the items in the cell
+     *  it is in. This works for arenas and for items not on a quad. The items
+     *  in a cell are sorted by item id. The key is created by getGridKey. */
+    std::unordered_map<uint64_t, AllItemTypes> m_item_grid;
+
     /** Stores all item models. */
     static std::vector<scene::IMesh *> m_item_mesh;
 
@@ -132,6 +140,8 @@ protected:
     void setSwitchItems(const std::vector<int> &switch_items);
     void insertItemInQuad(Item *item);
     void deleteItemInQuad(ItemState *item);
+    void insertItemInGrid(ItemState *item);
+    void deleteItemInGrid(ItemState *item);
 public:
              ItemManager();
     virtual ~ItemManager();
@@ -40,6 +40,7 @@ NetworkItemManager::NetworkItemManager()
                   : Rewinder({RN_ITEM_MANAGER}), ItemManager()
 {
     m_confirmed_switch_ticks = -1;
+    m_checkpoint_ticks = -1;
     m_last_confirmed_item_ticks.clear();
     initServer();
 }   // NetworkItemManager
@@ -203,7 +204,12 @@ void NetworkItemManager::setItemConfirmationTime(std::weak_ptr<STKPeer> peer,
     m_item_events.lock();
     auto p = m_item_events.getData().begin();
     while (p != m_item_events.getData().end() && p->getTicks() < min_time)
+    {
+        // Keep the events since the latest checkpoint for live join
+        if (m_checkpoint_ticks >= 0 && p->getTicks() >= m_checkpoint_ticks)
+            m_checkpoint_events.push_back(*p);
         p++;
+    }
     m_item_events.getData().erase(m_item_events.getData().begin(), p);
     m_item_events.unlock();
 
@@ -484,7 +490,15 @@ void NetworkItemManager::restoreState(BareNetworkString *buffer, int count)
         // ... will be copied from item state to item
         if (is && item)
         {
+            // The index can be used by a different item on the server
+            // (e.g. a bubble gum dropped elsewhere), so the item hit grid
+            // must be updated if the position changes.
+            const bool moved = item->getXYZ() != is->getXYZ();
+            if (moved)
+                deleteItemInGrid(item);
             *(ItemState*)item = *is;
+            if (moved)
+                insertItemInGrid(item);
         }
         else if (is && !item)
         {
@@ -562,3 +576,39 @@ void NetworkItemManager::restoreCompleteState(const BareNetworkString& buffer)
             m_confirmed_state.push_back(NULL);
     }
 }   // restoreCompleteState
+
+//-----------------------------------------------------------------------------
+/** Called on the server when a new checkpoint of the complete state is
+ *  available. From now on only events since this checkpoint are kept after
+ *  all clients have confirmed them.
+ *  \param ticks World ticks at which the checkpoint was saved.
+ */
+void NetworkItemManager::setCheckpointTicks(int ticks)
+{
+    m_item_events.lock();
+    m_checkpoint_ticks = ticks;
+    auto p = m_checkpoint_events.begin();
+    while (p != m_checkpoint_events.end() && p->getTicks() < ticks)
+        p++;
+    m_checkpoint_events.erase(m_checkpoint_events.begin(), p);
+    m_item_events.unlock();
+}   // setCheckpointTicks
+
+//-----------------------------------------------------------------------------
+/** Called on the server when a client live joins with the latest checkpoint
+ *  instead of the current complete state. The already confirmed events since
+ *  the checkpoint are put back in front of all events, so they are sent
+ *  again with the next states. The peer must have been added with
+ *  addLiveJoinPeer before, so they are kept till the new client confirms
+ *  them. The other clients ignore them as they are in their past.
+ */
+void NetworkItemManager::restoreCheckpointEvents()
+{
+    m_item_events.lock();
+    // The stored events were removed from the front, so they are all older
+    // than the remaining ones
+    m_item_events.getData().insert(m_item_events.getData().begin(),
+        m_checkpoint_events.begin(), m_checkpoint_events.end());
+    m_checkpoint_events.clear();
+    m_item_events.unlock();
+}   // restoreCheckpointEvents
@@ -65,6 +65,17 @@ private:
     /** List of all items events. */
     Synchronised< std::vector<ItemEventInfo> > m_item_events;
 
+    /** On the server the ticks of the latest checkpoint of the complete
+     *  state (see StateCheckpoint), or -1 if there is none. Protected by the
+     *  lock of m_item_events. */
+    int m_checkpoint_ticks;
+
+    /** Events since the latest checkpoint which were already confirmed by
+     *  all clients and removed from m_item_events. A client which starts
+     *  from the checkpoint needs them. Protected by the lock of
+     *  m_item_events. */
+    std::vector<ItemEventInfo> m_checkpoint_events;
+
     void forwardTime(int ticks);
 public:
 
@@ -111,6 +122,10 @@ public:
     // ------------------------------------------------------------------------
     void restoreCompleteState(const BareNetworkString& buffer);
     // ------------------------------------------------------------------------
+    void setCheckpointTicks(int ticks);
+    // ------------------------------------------------------------------------
+    void restoreCheckpointEvents();
+    // ------------------------------------------------------------------------
     void initServer();
 
 };   // NetworkItemManager
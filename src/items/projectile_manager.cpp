@@ -20,6 +20,7 @@
 
 #include "graphics/explosion.hpp"
 #include "graphics/hit_effect.hpp"
+#include "graphics/hit_sfx.hpp"
 #include "items/bowling.hpp"
 #include "items/cake.hpp"
 #include "items/plunger.hpp"
@@ -32,6 +33,7 @@
 #include "network/network_config.hpp"
 #include "network/network_string.hpp"
 #include "network/rewind_manager.hpp"
+#include "utils/memory_pool.hpp"
 #include "utils/stk_process.hpp"
 #include "utils/string_utils.hpp"
 
@@ -67,6 +69,14 @@ void ProjectileManager::clear()
     memset(g_projectile_manager, 0, sizeof(g_projectile_manager));
 }   // clear
 
+//---------------------------------------------------------------------------------------------
+ProjectileManager::ProjectileManager()
+{
+    m_change_count = 0;
+    for (unsigned int i = 0; i < PowerupManager::POWERUP_MAX; i++)
+        m_flyable_pools[i] = std::make_shared<MemoryPool>();
+}   // ProjectileManager
+
 //---------------------------------------------------------------------------------------------
 void ProjectileManager::loadData()
 {
@@ -84,6 +94,7 @@ void ProjectileManager::removeTextures()
 void ProjectileManager::cleanup()
 {
     m_active_projectiles.clear();
+    m_change_count++;
     for(HitEffects::iterator i  = m_active_hit_effects.begin();
         i != m_active_hit_effects.end(); ++i)
     {
@@ -91,6 +102,13 @@ void ProjectileManager::cleanup()
     }
 
     m_active_hit_effects.clear();
+
+    for (auto &pool : m_hit_effect_pool)
+    {
+        for (HitEffect *he : pool.second)
+            delete he;
+    }
+    m_hit_effect_pool.clear();
 }   // cleanup
 
 // -----------------------------------------------------------------------------
@@ -109,6 +127,7 @@ void ProjectileManager::updateGraphics(float dt)
 void ProjectileManager::update(int ticks)
 {
     updateServer(ticks);
+    m_change_count++;
 
     if (RewindManager::get()->isRewinding())
         return;
@@ -124,7 +143,7 @@ void ProjectileManager::update(int ticks)
         // Update this hit effect. If it can be removed, remove it.
         else if((*he)->updateAndDelete(ticks))
         {
-            delete *he;
+            recycleHitEffect(*he);
             HitEffects::iterator next = m_active_hit_effects.erase(he);
             he = next;
         }   // if hit effect finished
@@ -133,6 +152,61 @@ void ProjectileManager::update(int ticks)
     }   // while hit effect != end
 }   // update
 
+// -----------------------------------------------------------------------------
+/** Keeps a finished hit effect for reuse if possible, otherwise deletes it.
+ *  \param hit_effect The finished hit effect.
+ */
+void ProjectileManager::recycleHitEffect(HitEffect *hit_effect)
+{
+    const std::string &key = hit_effect->getPoolKey();
+    // Keeping a few effects of each kind is enough, since only a few
+    // effects are shown at the same time
+    if (key.empty() || m_hit_effect_pool[key].size() >= 8)
+    {
+        delete hit_effect;
+        return;
+    }
+    m_hit_effect_pool[key].push_back(hit_effect);
+}   // recycleHitEffect
+
+// -----------------------------------------------------------------------------
+/** Returns a hit effect that plays the given sound, reusing a finished one
+ *  if possible. The caller must add it with addHitEffect().
+ *  \param coord Where the sound is played.
+ *  \param sound Name of the sound.
+ */
+HitEffect* ProjectileManager::newHitSFX(const Vec3 &coord, const char *sound)
+{
+    HitEffects &pool = m_hit_effect_pool[HitSFX::makePoolKey(sound)];
+    if (pool.empty())
+        return new HitSFX(coord, sound);
+    HitEffect *he = pool.back();
+    pool.pop_back();
+    he->reset(coord);
+    return he;
+}   // newHitSFX
+
+// -----------------------------------------------------------------------------
+/** Returns an explosion, reusing a finished one with the same sound and
+ *  particles if possible. The caller must add it with addHitEffect().
+ *  \param coord Where the explosion happens.
+ *  \param sound Name of the sound.
+ *  \param particle_file Name of the particle file.
+ */
+HitEffect* ProjectileManager::newExplosion(const Vec3 &coord,
+                                           const char *sound,
+                                           const char *particle_file)
+{
+    HitEffects &pool =
+        m_hit_effect_pool[Explosion::makePoolKey(sound, particle_file)];
+    if (pool.empty())
+        return new Explosion(coord, sound, particle_file);
+    HitEffect *he = pool.back();
+    pool.pop_back();
+    he->reset(coord);
+    return he;
+}   // newExplosion
+
 // -----------------------------------------------------------------------------
 /** Updates all rockets on the server (or no networking). */
 void ProjectileManager::updateServer(int ticks)
@@ -173,41 +247,58 @@ std::shared_ptr<Flyable>
     ProjectileManager::newProjectile(AbstractKart *kart,
                                      PowerupManager::PowerupType type)
 {
-    const std::string& uid = getUniqueIdentity(kart, type);
-    auto it = m_active_projectiles.find(uid);
+    const uint64_t handle = getHandle(kart, type);
+    auto it = m_active_projectiles.find(handle);
     // Flyable has already created before and now rewinding, re-fire it
     if (it != m_active_projectiles.end())
     {
         it->second->onFireFlyable();
+        m_change_count++;
         return it->second;
     }
 
-    std::shared_ptr<Flyable> f;
+    std::shared_ptr<Flyable> f = createFlyable(kart, type);
+    if (!f)
+        return nullptr;
+    // This cannot be done in constructor because of virtual function
+    f->onFireFlyable();
+    m_active_projectiles[handle] = f;
+    m_change_count++;
+    if (RewindManager::get()->isEnabled())
+        f->addForRewind(handleToUID(handle));
+
+    return f;
+}   // newProjectile
+
+// -----------------------------------------------------------------------------
+/** Creates a flyable of the given type, using the memory pool of that type.
+ *  \param kart The kart which shoots the projectile.
+ *  \param type Type of projectile.
+ *  \return The flyable, or NULL if the type is not a flyable.
+ */
+std::shared_ptr<Flyable>
+    ProjectileManager::createFlyable(AbstractKart *kart,
+                                     PowerupManager::PowerupType type)
+{
+    const std::shared_ptr<MemoryPool> &pool = m_flyable_pools[type];
     switch(type)
     {
         case PowerupManager::POWERUP_BOWLING:
-            f = std::make_shared<Bowling>(kart);
-            break;
+            return std::allocate_shared<Bowling>(
+                PoolAllocator<Bowling>(pool), kart);
         case PowerupManager::POWERUP_PLUNGER:
-            f = std::make_shared<Plunger>(kart);
-            break;
+            return std::allocate_shared<Plunger>(
+                PoolAllocator<Plunger>(pool), kart);
         case PowerupManager::POWERUP_CAKE:
-            f = std::make_shared<Cake>(kart);
-            break;
+            return std::allocate_shared<Cake>(
+                PoolAllocator<Cake>(pool), kart);
         case PowerupManager::POWERUP_RUBBERBALL:
-            f = std::make_shared<RubberBall>(kart);
-            break;
+            return std::allocate_shared<RubberBall>(
+                PoolAllocator<RubberBall>(pool), kart);
         default:
             return nullptr;
     }
-    // This cannot be done in constructor because of virtual function
-    f->onFireFlyable();
-    m_active_projectiles[uid] = f;
-    if (RewindManager::get()->isEnabled())
-        f->addForRewind(uid);
-
-    return f;
-}   // newProjectile
+}   // createFlyable
 
 // -----------------------------------------------------------------------------
 /** Returns true if a projectile is within the given distance of the specified
@@ -219,11 +310,14 @@ bool ProjectileManager::projectileIsClose(const AbstractKart * const kart,
                                          float radius)
 {
     float r2 = radius * radius;
-    for (auto i = m_active_projectiles.begin(); i != m_active_projectiles.end(); i++)
+    std::vector<Flyable*> &candidates = m_nearby_projectiles;
+    World::getWorld()->getKartProximity()
+        ->getProjectilesInRadius(kart->getXYZ(), radius, &candidates);
+    for (Flyable *f : candidates)
     {
-        if (!i->second->hasServerState())
+        if (!f->hasServerState())
             continue;
-        float dist2 = i->second->getXYZ().distance2(kart->getXYZ());
+        float dist2 = f->getXYZ().distance2(kart->getXYZ());
         if (dist2 < r2)
             return true;
     }
@@ -243,16 +337,19 @@ int ProjectileManager::getNearbyProjectileCount(const AbstractKart * const kart,
 {
     float r2 = radius * radius;
     int projectile_count = 0;
-    for (auto i = m_active_projectiles.begin(); i != m_active_projectiles.end(); i++)
+    std::vector<Flyable*> &candidates = m_nearby_projectiles;
+    World::getWorld()->getKartProximity()
+        ->getProjectilesInRadius(kart->getXYZ(), radius, &candidates);
+    for (Flyable *f : candidates)
     {
-        if (!i->second->hasServerState())
+        if (!f->hasServerState())
             continue;
-        if (i->second->getType() == type)
+        if (f->getType() == type)
         {
-            if (exclude_owned && (i->second->getOwner() == kart))
+            if (exclude_owned && (f->getOwner() == kart))
                 continue;
 
-            float dist2 = i->second->getXYZ().distance2(kart->getXYZ());
+            float dist2 = f->getXYZ().distance2(kart->getXYZ());
             if (dist2 < r2)
             {
                 projectile_count++;
@@ -277,40 +374,54 @@ std::vector<Vec3> ProjectileManager::getBasketballPositions()
     return positions;
 } // getBasketballPositions
 // -----------------------------------------------------------------------------
-std::string ProjectileManager::getUniqueIdentity(AbstractKart* kart,
-                                                 PowerupManager::PowerupType t)
+/** Returns the handle of a projectile fired now by the given kart. It
+ *  contains (from the most significant byte) the rewinder name of the type,
+ *  the world id of the kart and the current tick, which is the same layout
+ *  as the unique identity of the flyable rewinder (see handleToUID()).
+ *  \param kart The kart which shoots the projectile.
+ *  \param t Type of projectile.
+ */
+uint64_t ProjectileManager::getHandle(AbstractKart* kart,
+                                      PowerupManager::PowerupType t) const
 {
-    BareNetworkString uid;
+    uint64_t rn;
     switch (t)
     {
-        case PowerupManager::POWERUP_BOWLING:
-        {
-            uid.addUInt8(RN_BOWLING);
-            break;
-        }
-        case PowerupManager::POWERUP_PLUNGER:
-        {
-            uid.addUInt8(RN_PLUNGER);
-            break;
-        }
-        case PowerupManager::POWERUP_CAKE:
-        {
-            uid.addUInt8(RN_CAKE);
-            break;
-        }
-        case PowerupManager::POWERUP_RUBBERBALL:
-        {
-            uid.addUInt8(RN_RUBBERBALL);
-            break;
-        }
+        case PowerupManager::POWERUP_BOWLING:    rn = RN_BOWLING;    break;
+        case PowerupManager::POWERUP_PLUNGER:    rn = RN_PLUNGER;    break;
+        case PowerupManager::POWERUP_CAKE:       rn = RN_CAKE;       break;
+        case PowerupManager::POWERUP_RUBBERBALL: rn = RN_RUBBERBALL; break;
         default:
             assert(false);
-            return "";
+            return 0;
     }
-    uid.addUInt8((uint8_t)kart->getWorldKartId())
-        .addUInt32(World::getWorld()->getTicksSinceStart());
-    return std::string((char*)uid.getBuffer().data(), uid.getBuffer().size());
-}   // getUniqueIdentity
+    return (rn << 40) | ((uint64_t)(uint8_t)kart->getWorldKartId() << 32) |
+           (uint32_t)World::getWorld()->getTicksSinceStart();
+}   // getHandle
+
+// -----------------------------------------------------------------------------
+/** Converts a projectile handle to the unique identity of its rewinder, i.e.
+ *  the 6 bytes of the handle in network byte order. */
+std::string ProjectileManager::handleToUID(uint64_t handle)
+{
+    std::string uid(6, '\0');
+    for (unsigned int i = 0; i < 6; i++)
+        uid[i] = (char)((handle >> (40 - 8 * i)) & 0xff);
+    return uid;
+}   // handleToUID
+
+// -----------------------------------------------------------------------------
+/** Converts the unique identity of a flyable rewinder to its projectile
+ *  handle, 0 if it's not the identity of a flyable. */
+uint64_t ProjectileManager::uidToHandle(const std::string &uid)
+{
+    if (uid.size() != 6)
+        return 0;
+    uint64_t handle = 0;
+    for (unsigned int i = 0; i < 6; i++)
+        handle = (handle << 8) | (uint8_t)uid[i];
+    return handle;
+}   // uidToHandle
 
 // -----------------------------------------------------------------------------
 /* If any flyable is not found in current game state, create it with respect to
@@ -329,34 +440,16 @@ std::shared_ptr<Rewinder>
 
     AbstractKart* kart = World::getWorld()->getKart(data.getUInt8());
     int created_ticks = data.getUInt32();
-    std::shared_ptr<Flyable> f;
+    PowerupManager::PowerupType type = PowerupManager::POWERUP_NOTHING;
     switch (rn)
     {
-        case RN_BOWLING:
-        {
-            f = std::make_shared<Bowling>(kart);
-            break;
-        }
-        case RN_PLUNGER:
-        {
-            f = std::make_shared<Plunger>(kart);
-            break;
-        }
-        case RN_CAKE:
-        {
-            f = std::make_shared<Cake>(kart);
-            break;
-        }
-        case RN_RUBBERBALL:
-        {
-            f = std::make_shared<RubberBall>(kart);
-            break;
-        }
-        default:
-        {
-            break;
-        }
+        case RN_BOWLING:    type = PowerupManager::POWERUP_BOWLING;    break;
+        case RN_PLUNGER:    type = PowerupManager::POWERUP_PLUNGER;    break;
+        case RN_CAKE:       type = PowerupManager::POWERUP_CAKE;       break;
+        case RN_RUBBERBALL: type = PowerupManager::POWERUP_RUBBERBALL; break;
+        default:            break;
     }
+    std::shared_ptr<Flyable> f = createFlyable(kart, type);
     assert(f);
     f->setCreatedTicks(created_ticks);
     f->onFireFlyable();
@@ -368,7 +461,7 @@ std::shared_ptr<Rewinder>
         StringUtils::wideToUtf8(kart->getController()->getName()).c_str(),
         created_ticks);
 
-    m_active_projectiles[uid] = f;
+    m_active_projectiles[uidToHandle(uid)] = f;
     return f;
 }   // addProjectileFromNetworkState
 
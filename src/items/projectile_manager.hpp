@@ -19,8 +19,10 @@
 #ifndef HEADER_PROJECTILEMANAGER_HPP
 #define HEADER_PROJECTILEMANAGER_HPP
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -35,6 +37,7 @@ namespace irr
 class AbstractKart;
 class Flyable;
 class HitEffect;
+class MemoryPool;
 class Rewinder;
 class Track;
 class Vec3;
@@ -48,16 +51,35 @@ private:
     typedef std::vector<HitEffect*> HitEffects;
 
     /** The list of all active projectiles, i.e. projectiles which are
-     *  currently moving on the track. */
-    std::map<std::string, std::shared_ptr<Flyable> > m_active_projectiles;
+     *  currently moving on the track, indexed by their handle (see
+     *  getHandle()). */
+    std::map<uint64_t, std::shared_ptr<Flyable> > m_active_projectiles;
+
+    /** For each flyable type a pool of memory blocks, so that firing does
+     *  not need a heap allocation each time. */
+    std::shared_ptr<MemoryPool> m_flyable_pools[PowerupManager::POWERUP_MAX];
 
     /** All active hit effects, i.e. hit effects which are currently
      *  being shown or have a sfx playing. */
     HitEffects       m_active_hit_effects;
 
-    std::string      getUniqueIdentity(AbstractKart* kart,
-                                       PowerupManager::PowerupType type);
+    /** Finished hit effects that can be reused, indexed by their pool key
+     *  (see HitEffect::getPoolKey()). */
+    std::map<std::string, HitEffects> m_hit_effect_pool;
+
+    /** Incremented whenever projectiles are added, removed or moved, so
+     *  that data derived from the projectile positions can be updated. */
+    unsigned int     m_change_count;
+
+    /** Used by the proximity queries to avoid reallocations. */
+    std::vector<Flyable*> m_nearby_projectiles;
+
+    uint64_t         getHandle(AbstractKart* kart,
+                               PowerupManager::PowerupType type) const;
+    std::shared_ptr<Flyable> createFlyable(AbstractKart *kart,
+                                           PowerupManager::PowerupType type);
     void             updateServer(int ticks);
+    void             recycleHitEffect(HitEffect *hit_effect);
 public:
     // ----------------------------------------------------------------------------------------
     static ProjectileManager* get();
@@ -68,7 +90,7 @@ public:
     // ----------------------------------------------------------------------------------------
     static void clear();
     // ----------------------------------------------------------------------------------------
-                     ProjectileManager() {}
+                     ProjectileManager();
                     ~ProjectileManager() {}
     void             loadData         ();
     void             cleanup          ();
@@ -87,6 +109,11 @@ public:
     void             addHitEffect(HitEffect *hit_effect)
                                 { m_active_hit_effects.push_back(hit_effect); }
     // ------------------------------------------------------------------------
+    HitEffect*       newHitSFX(const Vec3 &coord, const char *sound);
+    // ------------------------------------------------------------------------
+    HitEffect*       newExplosion(const Vec3 &coord, const char *sound,
+                                  const char *particle_file);
+    // ------------------------------------------------------------------------
     std::shared_ptr<Rewinder>
                            addRewinderFromNetworkState(const std::string& uid);
     // ------------------------------------------------------------------------
@@ -95,11 +122,29 @@ public:
     // ------------------------------------------------------------------------
     std::vector<Vec3> getBasketballPositions();
     // ------------------------------------------------------------------------
+    static uint64_t uidToHandle(const std::string &uid);
+    // ------------------------------------------------------------------------
+    static std::string handleToUID(uint64_t handle);
+    // ------------------------------------------------------------------------
     void addByUID(const std::string& uid, std::shared_ptr<Flyable> f)
-                                             { m_active_projectiles[uid] = f; }
+    {
+        m_active_projectiles[uidToHandle(uid)] = f;
+        m_change_count++;
+    }   // addByUID
     // ------------------------------------------------------------------------
     void removeByUID(const std::string& uid)
-                                           { m_active_projectiles.erase(uid); }
+    {
+        m_active_projectiles.erase(uidToHandle(uid));
+        m_change_count++;
+    }   // removeByUID
+    // ------------------------------------------------------------------------
+    /** Returns all active projectiles. */
+    const std::map<uint64_t, std::shared_ptr<Flyable> >&
+                        getActiveProjectiles() const { return m_active_projectiles; }
+    // ------------------------------------------------------------------------
+    /** Returns a counter that changes whenever projectiles are added,
+     *  removed or moved. */
+    unsigned int getChangeCount() const              { return m_change_count; }
 };
 
 #endif
@@ -30,7 +30,7 @@
 #include "audio/sfx_base.hpp"
 #include "audio/sfx_manager.hpp"
 #include "config/player_manager.hpp"
-#include "graphics/explosion.hpp"
+#include "graphics/hit_effect.hpp"
 #include "graphics/irr_driver.hpp"
 #include "io/file_manager.hpp"
 #include "items/attachment_manager.hpp"
@@ -431,7 +431,8 @@ void Swatter::squashThingsAround()
     if (!GUIEngine::isNoGraphics() && has_created_explosion_animation &&
         !RewindManager::get()->isRewinding())
     {
-        HitEffect *he = new Explosion(m_kart->getXYZ(),  "explosion", "explosion.xml");
+        HitEffect *he = ProjectileManager::get()->newExplosion(
+            m_kart->getXYZ(), "explosion", "explosion.xml");
         if(m_kart->getController()->isLocalPlayerController())
             he->setLocalPlayerKartHit();
         ProjectileManager::get()->addHitEffect(he);
@@ -109,6 +109,11 @@ public:
     void setNetworkAI(bool val)                 { m_enabled_network_ai = val; }
     // ------------------------------------------------------------------------
     virtual void update(int ticks) OVERRIDE;
+    // ------------------------------------------------------------------------
+    /** Returns true if the AI is in a state in which its decisions are not
+     *  likely to change soon (e.g. driving on a straight with nothing
+     *  around), so it can be updated less frequently. */
+    virtual bool isInStableState() const { return false; }
 
 };   // AIBaseController
 
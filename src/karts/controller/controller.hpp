@@ -62,6 +62,12 @@ public:
     virtual      ~Controller         () {};
     virtual void  reset              () = 0;
     virtual void  update             (int ticks) = 0;
+    // ------------------------------------------------------------------------
+    /** Called for all karts before any kart is updated, possibly from
+     *  several threads at the same time. A controller can compute parts of
+     *  its next update() here, but must only read the world and only write
+     *  to its own data. */
+    virtual void  precomputeUpdate   (int ticks) {}
     virtual void  handleZipper       (bool play_sound) = 0;
     virtual void  collectedItem      (const ItemState &item,
                                       float previous_energy=0) = 0;
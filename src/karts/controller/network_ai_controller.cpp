@@ -26,9 +26,30 @@
 #include "network/protocols/game_protocol.hpp"
 #include "network/network_config.hpp"
 #include "network/rewind_manager.hpp"
+#include "config/stk_config.hpp"
+#include "modes/kart_proximity.hpp"
+#include "utils/log.hpp"
+#include "utils/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 // ============================================================================
-int NetworkAIController::m_ai_frequency = 30;
+int    NetworkAIController::m_ai_frequency            = 30;
+bool   NetworkAIController::m_lod_enabled             = false;
+int    NetworkAIController::m_lod_far_frequency       = 60;
+int    NetworkAIController::m_lod_stable_frequency    = 90;
+float  NetworkAIController::m_lod_near_distance       = 50.0f;
+int    NetworkAIController::m_lod_budget              = 4;
+int    NetworkAIController::m_lod_interpolation_ticks = 10;
+bool   NetworkAIController::m_log_stats               = false;
+int    NetworkAIController::m_lod_updates_this_tick   = 0;
+int    NetworkAIController::m_current_tick            = -1;
+double NetworkAIController::m_ai_time_this_tick       = 0.0;
+double NetworkAIController::m_ai_time_total           = 0.0;
+double NetworkAIController::m_ai_time_max             = 0.0;
+int    NetworkAIController::m_stats_ticks             = 0;
+int    NetworkAIController::m_stats_updates           = 0;
 // ----------------------------------------------------------------------------
 NetworkAIController::NetworkAIController(AbstractKart *kart,
                                          int local_player_id,
@@ -51,33 +72,212 @@ NetworkAIController::~NetworkAIController()
     delete m_ai_controls;
 }   // ~NetworkAIController
 
+// ----------------------------------------------------------------------------
+/** Enables the level of detail scheduler.
+ *  \param far_frequency Ticks between updates of AIs far from any human.
+ *  \param stable_frequency Ticks between updates of AIs far from any human
+ *         which are in a stable state.
+ *  \param near_distance Distance to a human below which an AI is updated
+ *         every m_ai_frequency ticks.
+ *  \param budget Maximum number of reduced rate updates per tick, 0 for
+ *         no limit.
+ *  \param interpolation_ticks Number of ticks over which steering and
+ *         acceleration are interpolated, 1 or less disables it.
+ */
+void NetworkAIController::enableLOD(int far_frequency, int stable_frequency,
+                                    float near_distance, int budget,
+                                    int interpolation_ticks)
+{
+    m_lod_enabled             = true;
+    m_lod_far_frequency       = std::max(far_frequency, 1);
+    m_lod_stable_frequency    = std::max(stable_frequency, 1);
+    m_lod_near_distance       = near_distance;
+    m_lod_budget              = std::max(budget, 0);
+    m_lod_interpolation_ticks = std::max(interpolation_ticks, 1);
+}   // enableLOD
+
 // ----------------------------------------------------------------------------
 bool NetworkAIController::isLocalPlayerController() const
 {
     return NetworkConfig::get()->isNetworkAIInstance();
 }   // isLocalPlayerController
 
+// ----------------------------------------------------------------------------
+/** Called by the first AI controller updated in a new tick: resets the per
+ *  tick budget and updates (and if requested logs) the statistics.
+ *  \param now The current tick.
+ */
+void NetworkAIController::startTick(int now)
+{
+    if (now == m_current_tick)
+        return;
+    m_current_tick = now;
+    m_lod_updates_this_tick = 0;
+    m_ai_time_total += m_ai_time_this_tick;
+    m_ai_time_max = std::max(m_ai_time_max, m_ai_time_this_tick);
+    m_ai_time_this_tick = 0.0;
+    m_stats_ticks++;
+    if (m_stats_ticks < stk_config->time2Ticks(10.0f))
+        return;
+    if (m_log_stats)
+    {
+        Log::info("NetworkAIController",
+            "AI time per tick: average %.3f ms, max %.3f ms, "
+            "%.2f AI updates per tick.", m_ai_time_total / m_stats_ticks,
+            m_ai_time_max, (float)m_stats_updates / m_stats_ticks);
+    }
+    m_ai_time_total = 0.0;
+    m_ai_time_max   = 0.0;
+    m_stats_ticks   = 0;
+    m_stats_updates = 0;
+}   // startTick
+
+// ----------------------------------------------------------------------------
+/** Returns true if a kart not driven by an AI of this process is close to
+ *  this kart. */
+bool NetworkAIController::isCloseToHuman() const
+{
+    World *world = World::getWorld();
+    std::vector<unsigned int> karts;
+    world->getKartProximity()->getKartsInRadius(m_kart->getXYZ(),
+                                                m_lod_near_distance, &karts);
+    const float max_distance2 = m_lod_near_distance * m_lod_near_distance;
+    for (unsigned int id : karts)
+    {
+        const AbstractKart *kart = world->getKart(id);
+        if (kart == m_kart || kart->isEliminated() ||
+            dynamic_cast<const NetworkAIController*>(kart->getController()))
+            continue;
+        if ((kart->getXYZ() - m_kart->getXYZ()).length2() < max_distance2)
+            return true;
+    }
+    return false;
+}   // isCloseToHuman
+
+// ----------------------------------------------------------------------------
+/** Updates the AI and times it.
+ *  \param ticks Number of ticks since the last update of the AI.
+ *  \param now The current tick.
+ */
+void NetworkAIController::updateAI(int ticks, int now)
+{
+    PROFILER_PUSH_CPU_MARKER("NetworkAIController::update (AI)",
+                             0x80, 0x80, 0xFF);
+    const double start = getTimeMilliseconds();
+    m_ai_controller->update(ticks);
+    m_ai_time_this_tick += getTimeMilliseconds() - start;
+    m_stats_updates++;
+    m_last_update_ticks = now;
+    PROFILER_POP_CPU_MARKER();
+}   // updateAI
+
 // ----------------------------------------------------------------------------
 void NetworkAIController::update(int ticks)
 {
     if (!RewindManager::get()->isRewinding())
     {
-        if (World::getWorld()->isStartPhase() ||
-            World::getWorld()->getTicksSinceStart() > m_prev_update_ticks)
+        World *world = World::getWorld();
+        const int now = world->getTicksSinceStart();
+        startTick(now);
+        if (!m_lod_enabled)
+        {
+            if (world->isStartPhase() || now > m_prev_update_ticks)
+            {
+                m_prev_update_ticks = now + m_ai_frequency;
+                updateAI(m_ai_frequency, now);
+                convertAIToPlayerActions(m_ai_controls->getSteer(),
+                                         m_ai_controls->getAccel(),
+                                         /*all_actions*/true);
+            }
+        }
+        else
         {
-            m_prev_update_ticks = World::getWorld()->getTicksSinceStart() +
-                m_ai_frequency;
-            m_ai_controller->update(m_ai_frequency);
-            convertAIToPlayerActions();
+            const bool near = isCloseToHuman();
+            const int interval = near ? m_ai_frequency
+                               : m_ai_controller->isInStableState()
+                               ? m_lod_stable_frequency : m_lod_far_frequency;
+            if (world->isStartPhase())
+            {
+                // Stagger the first update after the start phase, so that
+                // not all AIs are updated in the same tick
+                m_prev_update_ticks = m_kart->getWorldKartId() % interval;
+                updateAI(interval, now);
+                m_interpolating = false;
+                convertAIToPlayerActions(m_ai_controls->getSteer(),
+                                         m_ai_controls->getAccel(),
+                                         /*all_actions*/true);
+            }
+            else if (now > m_prev_update_ticks &&
+                     (near || m_lod_budget == 0 ||
+                      m_lod_updates_this_tick < m_lod_budget))
+            {
+                // AIs close to a human are not limited by the budget, AIs
+                // exceeding it are updated in the next tick
+                if (!near)
+                    m_lod_updates_this_tick++;
+                m_prev_update_ticks = now + interval;
+                m_steer_from = m_controls->getSteer();
+                m_accel_from = m_controls->getAccel();
+                updateAI(m_last_update_ticks < 0 ? interval
+                                                 : now - m_last_update_ticks,
+                         now);
+                m_steer_to = m_ai_controls->getSteer();
+                m_accel_to = m_ai_controls->getAccel();
+                m_interpolating = !near && m_lod_interpolation_ticks > 1;
+                if (m_interpolating)
+                {
+                    interpolateControls(now);
+                    // Actions other than steering and acceleration are not
+                    // interpolated
+                    convertAIToPlayerActions(m_controls->getSteer(),
+                                             m_controls->getAccel(),
+                                             /*all_actions*/true);
+                }
+                else
+                {
+                    convertAIToPlayerActions(m_steer_to, m_accel_to,
+                                             /*all_actions*/true);
+                }
+            }
+            else if (m_interpolating)
+                interpolateControls(now);
         }
     }
     PlayerController::update(ticks);
 }   // update
 
+// ----------------------------------------------------------------------------
+/** Moves steering and acceleration from the values before the last AI
+ *  update towards the values computed by the AI. The values are quantized,
+ *  so that only a few actions need to be sent to the server.
+ *  \param now The current tick.
+ */
+void NetworkAIController::interpolateControls(int now)
+{
+    const float f = float(now - m_last_update_ticks + 1) /
+                    float(m_lod_interpolation_ticks);
+    if (f >= 1.0f)
+    {
+        m_interpolating = false;
+        convertAIToPlayerActions(m_steer_to, m_accel_to,
+                                 /*all_actions*/false);
+        return;
+    }
+    const float steer = m_steer_from + (m_steer_to - m_steer_from) * f;
+    const float accel = m_accel_from + (m_accel_to - m_accel_from) * f;
+    convertAIToPlayerActions(roundf(steer * 4.0f) * 0.25f,
+                             roundf(accel * 4.0f) * 0.25f,
+                             /*all_actions*/false);
+}   // interpolateControls
+
 // ----------------------------------------------------------------------------
 void NetworkAIController::reset()
 {
     m_prev_update_ticks = 0;
+    m_last_update_ticks = -1;
+    m_steer_from = m_steer_to = 0.0f;
+    m_accel_from = m_accel_to = 0.0f;
+    m_interpolating = false;
     m_ai_controller->reset();
     m_ai_controller->setNetworkAI(true);
     m_ai_controls->reset();
@@ -85,36 +285,44 @@ void NetworkAIController::reset()
 }   // reset
 
 // ----------------------------------------------------------------------------
-void NetworkAIController::convertAIToPlayerActions()
+/** Converts the AI controls to player actions.
+ *  \param steer The steering to use.
+ *  \param accel The acceleration to use.
+ *  \param all_actions If false only steering and acceleration are set.
+ */
+void NetworkAIController::convertAIToPlayerActions(float steer, float accel,
+                                                   bool all_actions)
 {
-    std::vector<std::pair<PlayerAction, int> > all_actions;
-    if (m_ai_controls->getSteer() < 0.0f)
+    std::vector<std::pair<PlayerAction, int> > actions;
+    if (steer < 0.0f)
     {
-        all_actions.emplace_back(PA_STEER_LEFT,
-            int(fabsf(m_ai_controls->getSteer()) * 32768));
+        actions.emplace_back(PA_STEER_LEFT,
+            int(fabsf(steer) * 32768));
     }
     else
     {
-        all_actions.emplace_back(PA_STEER_RIGHT,
-            int(fabsf(m_ai_controls->getSteer()) * 32768));
+        actions.emplace_back(PA_STEER_RIGHT,
+            int(fabsf(steer) * 32768));
+    }
+    actions.emplace_back(PA_ACCEL, int(accel * 32768));
+    if (all_actions)
+    {
+        actions.emplace_back(PA_BRAKE,
+            m_ai_controls->getBrake() ? 32768 : 0);
+        actions.emplace_back(PA_FIRE,
+            m_ai_controls->getFire() ? 32768 : 0);
+        actions.emplace_back(PA_NITRO,
+            m_ai_controls->getNitro() ? 32768 : 0);
+        actions.emplace_back(PA_DRIFT,
+            m_ai_controls->getSkidControl() == KartControl::SC_NONE ?
+            0 : 32768);
+        actions.emplace_back(PA_RESCUE,
+            m_ai_controls->getRescue() ? 32768 : 0);
+        actions.emplace_back(PA_LOOK_BACK,
+            m_ai_controls->getLookBack() ? 32768 : 0);
     }
-    all_actions.emplace_back(PA_ACCEL,
-        int(m_ai_controls->getAccel() * 32768));
-    all_actions.emplace_back(PA_BRAKE,
-        m_ai_controls->getBrake() ? 32768 : 0);
-    all_actions.emplace_back(PA_FIRE,
-        m_ai_controls->getFire() ? 32768 : 0);
-    all_actions.emplace_back(PA_NITRO,
-        m_ai_controls->getNitro() ? 32768 : 0);
-    all_actions.emplace_back(PA_DRIFT,
-        m_ai_controls->getSkidControl() == KartControl::SC_NONE ?
-        0 : 32768);
-    all_actions.emplace_back(PA_RESCUE,
-        m_ai_controls->getRescue() ? 32768 : 0);
-    all_actions.emplace_back(PA_LOOK_BACK,
-        m_ai_controls->getLookBack() ? 32768 : 0);
 
-    for (const auto& a : all_actions)
+    for (const auto& a : actions)
     {
         if (!PlayerController::action(a.first, a.second, /*dry_run*/true))
             continue;
@@ -24,14 +24,80 @@
 class AbstractKart;
 class AIBaseController;
 
+/** \brief Drives a network player kart with an AI, used for bots connected
+ *  with --network-ai.
+ *  By default each AI is updated every m_ai_frequency ticks. If the level
+ *  of detail scheduler is enabled (--network-ai-lod), AIs which are not
+ *  close to a human player are updated at a lower rate (even lower if the
+ *  AI is in a stable state), the updates are staggered across ticks, the
+ *  number of such updates per tick is limited by a budget, and between
+ *  updates the steering and acceleration are interpolated.
+ */
 class NetworkAIController : public PlayerController
 {
 private:
+    /** Number of ticks between AI updates (for AIs close to a human). */
     static int m_ai_frequency;
+
+    /** True if the level of detail scheduler is used. */
+    static bool m_lod_enabled;
+
+    /** Number of ticks between AI updates for AIs far from any human. */
+    static int m_lod_far_frequency;
+
+    /** Number of ticks between AI updates for AIs far from any human which
+     *  are in a stable state. */
+    static int m_lod_stable_frequency;
+
+    /** An AI within this distance of a human player is updated at full
+     *  rate. */
+    static float m_lod_near_distance;
+
+    /** Maximum number of reduced rate AI updates per tick, 0 if there is
+     *  no limit. AIs exceeding it are updated in the next tick. */
+    static int m_lod_budget;
+
+    /** Number of ticks over which steering and acceleration are
+     *  interpolated after an update. */
+    static int m_lod_interpolation_ticks;
+
+    /** If true the AI time per tick is logged periodically. */
+    static bool m_log_stats;
+
+    /** Number of reduced rate updates in the current tick. */
+    static int m_lod_updates_this_tick;
+
+    /** The tick that m_lod_updates_this_tick and the statistics refer to. */
+    static int m_current_tick;
+
+    /** Statistics: AI time in the current tick and the current reporting
+     *  interval (in ms), number of ticks and updates in the interval. */
+    static double m_ai_time_this_tick;
+    static double m_ai_time_total;
+    static double m_ai_time_max;
+    static int    m_stats_ticks;
+    static int    m_stats_updates;
+
     int m_prev_update_ticks;
+
+    /** Tick of the last AI update, -1 if not updated yet. */
+    int m_last_update_ticks;
+
+    /** Steering and acceleration when the last AI update was done, and
+     *  the values computed by the AI, which are interpolated. */
+    float m_steer_from, m_steer_to;
+    float m_accel_from, m_accel_to;
+
+    /** True if the values are currently interpolated. */
+    bool m_interpolating;
+
     AIBaseController* m_ai_controller;
     KartControl* m_ai_controls;
-    void convertAIToPlayerActions();
+    void convertAIToPlayerActions(float steer, float accel, bool all_actions);
+    bool isCloseToHuman() const;
+    void updateAI(int ticks, int now);
+    void interpolateControls(int now);
+    static void startTick(int now);
 public:
                  NetworkAIController(AbstractKart *kart, int local_player_id,
                                      AIBaseController* ai);
@@ -42,6 +108,13 @@ public:
     virtual bool isLocalPlayerController() const OVERRIDE;
     // ------------------------------------------------------------------------
     static void setAIFrequency(int freq) { m_ai_frequency = freq; }
+    // ------------------------------------------------------------------------
+    static void enableLOD(int far_frequency, int stable_frequency,
+                          float near_distance, int budget,
+                          int interpolation_ticks);
+    // ------------------------------------------------------------------------
+    /** Enables periodic logging of the AI time per tick. */
+    static void setLogStats(bool log_stats)      { m_log_stats = log_stats; }
 };   // class NetworkAIController
 
 #endif // HEADER_PLAYER_CONTROLLER_HPP
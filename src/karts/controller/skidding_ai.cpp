@@ -179,6 +179,7 @@ void SkiddingAI::reset()
     m_skid_probability_state     = SKID_PROBAB_NOT_YET;
     m_last_item_random           = NULL;
     m_burster                    = false;
+    m_precomputed.m_ticks        = -1;
 
     AIBaseLapController::reset();
     m_track_node               = Graph::UNKNOWN_SECTOR;
@@ -195,6 +196,29 @@ void SkiddingAI::reset()
     AIBaseLapController::reset();
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Recomputes the path to use (see AIBaseLapController::newLap). This
+ *  invalidates any precomputed data, since it depends on the path.
+ */
+void SkiddingAI::newLap(int lap)
+{
+    AIBaseLapController::newLap(lap);
+    m_precomputed.m_ticks = -1;
+}   // newLap
+
+//-----------------------------------------------------------------------------
+/** Returns true if the kart is driving on a straight part of the track and
+ *  there is nothing to react to: no predicted crash, no item to collect or
+ *  to avoid and no kart animation.
+ */
+bool SkiddingAI::isInStableState() const
+{
+    return m_current_track_direction == DriveNode::DIR_STRAIGHT &&
+           !m_crashes.m_road && m_crashes.m_kart == -1 &&
+           !m_item_to_collect && !m_avoid_item_close &&
+           !m_kart->getKartAnimation() && !isStuck();
+}   // isInStableState
+
 //-----------------------------------------------------------------------------
 /** Returns a name for the AI.
  *  This is used in profile mode when comparing different AI implementations
@@ -217,6 +241,56 @@ unsigned int SkiddingAI::getNextSector(unsigned int index)
     return m_successor_index[index];
 }   // getNextSector
 
+//-----------------------------------------------------------------------------
+/** Computes the parts of the next update() which only depend on this kart
+ *  and the drive graph: the road part of checkCrashes() and the point to aim
+ *  at. This is called before any kart is updated, possibly in parallel for
+ *  all AI karts, so it must not change anything but m_precomputed. Since
+ *  the kart is not updated yet, its position and velocity are taken from
+ *  the physics, which is what Kart::update will use. update() checks that
+ *  the values match before using any result.
+ *  \param ticks Number of physics time steps - should be 1.
+ */
+void SkiddingAI::precomputeUpdate(int ticks)
+{
+    m_precomputed.m_ticks = -1;
+    if (m_kart->getKartAnimation() || m_world->isStartPhase() ||
+        m_track_node == Graph::UNKNOWN_SECTOR)
+        return;
+
+    const btTransform trans = m_kart->getPhysicsTrans();
+    m_precomputed.m_xyz           = trans.getOrigin();
+    m_precomputed.m_velocity      = m_kart->getVelocity();
+    m_precomputed.m_velocity_lc_z =
+        (m_kart->getVelocity() * trans.getBasis()).getZ();
+    m_precomputed.m_track_node    = m_track_node;
+
+    switch(m_point_selection_algorithm)
+    {
+    case PSA_NEW:    findNonCrashingPointNew(m_precomputed.m_xyz,
+                                             &m_precomputed.m_aim_point,
+                                             &m_precomputed.m_last_node);
+                     break;
+    case PSA_DEFAULT:findNonCrashingPoint(m_precomputed.m_xyz,
+                                          &m_precomputed.m_aim_point,
+                                          &m_precomputed.m_last_node);
+                     break;
+    }
+
+    m_precomputed.m_road_crash_step = -1;
+    if (m_precomputed.m_velocity.length() > 0)
+    {
+        int steps = getNumCrashSteps(m_precomputed.m_velocity_lc_z);
+        // checkCrashes() prints a warning in this case
+        if (steps < 1 || steps > 1000)
+            steps = 1000;
+        m_precomputed.m_road_crash_step =
+            findRoadCrashStep(m_precomputed.m_xyz,
+                              m_precomputed.m_velocity.normalized(), steps);
+    }
+    m_precomputed.m_ticks = m_world->getTicksSinceStart();
+}   // precomputeUpdate
+
 //-----------------------------------------------------------------------------
 /** This is the main entry point for the AI.
  *  It is called once per frame for each AI and determines the behaviour of
@@ -469,12 +543,24 @@ void SkiddingAI::handleSteering(float dt)
         Vec3 aim_point;
         int last_node = Graph::UNKNOWN_SECTOR;
 
-        switch(m_point_selection_algorithm)
+        if (m_precomputed.m_ticks == m_world->getTicksSinceStart() &&
+            m_precomputed.m_xyz == m_kart->getXYZ() &&
+            m_precomputed.m_track_node == m_track_node)
+        {
+            aim_point = m_precomputed.m_aim_point;
+            last_node = m_precomputed.m_last_node;
+        }
+        else
         {
-        case PSA_NEW:    findNonCrashingPointNew(&aim_point, &last_node);
-                         break;
-        case PSA_DEFAULT:findNonCrashingPoint(&aim_point, &last_node);
-                         break;
+            switch(m_point_selection_algorithm)
+            {
+            case PSA_NEW:    findNonCrashingPointNew(m_kart->getXYZ(),
+                                                     &aim_point, &last_node);
+                             break;
+            case PSA_DEFAULT:findNonCrashingPoint(m_kart->getXYZ(),
+                                                  &aim_point, &last_node);
+                             break;
+            }
         }
 #ifdef AI_DEBUG
         m_debug_sphere[m_point_selection_algorithm]->setPosition(aim_point.toIrrVector());
@@ -848,13 +934,20 @@ bool SkiddingAI::steerToAvoid(const std::vector<const ItemState *> &items_to_avo
     const Vec3& left = items_to_avoid[index_left_most]->getXYZ();
     int node_index = items_to_avoid[index_left_most]->getGraphNode();
     const Vec3& normal = DriveGraph::get()->getNode(node_index)->getNormal();
-    Vec3 hit;
     Vec3 hit_nor(0, 1, 0);
-    const Material* m;
-    m_track->getPtrTriangleMesh()->castRay(
-        Vec3(line_to_target.getMiddle()) + normal,
-        Vec3(line_to_target.getMiddle()) + normal * -10000, &hit, &m,
-        &hit_nor);
+    // Use the ground normal from the road profile, only cast a ray into
+    // the track if the middle of the line is not covered by the profile
+    if (!DriveGraph::get()->getProfileGroundNormal(m_track_node,
+                                       line_to_target.getMiddle(),
+                                       m_next_node_index, &hit_nor))
+    {
+        Vec3 hit;
+        const Material* m;
+        m_track->getPtrTriangleMesh()->castRay(
+            Vec3(line_to_target.getMiddle()) + normal,
+            Vec3(line_to_target.getMiddle()) + normal * -10000, &hit, &m,
+            &hit_nor);
+    }
     Vec3 p1 = line_to_target.start,
          p2 = line_to_target.getMiddle() + hit_nor.toIrrVector(),
          p3 = line_to_target.end;
@@ -1928,13 +2021,8 @@ void SkiddingAI::computeNearestKarts()
     std::sort(overall_distance.begin(), overall_distance.end(), std::greater<float>());
    
     // Get the AI's position (the position update may not be done, leading to crashes)
-    int curr_position = 1;
-    for(unsigned int i=0; i<m_world->getNumKarts(); i++)
-    {
-        if(   m_world->getOverallDistance(i) > own_overall_distance
-           && !m_world->getKart(i)->isEliminated())
-            curr_position++;
-    }
+    int curr_position = 1 + m_world->getKartProximity()
+                              ->getNumKartsAhead(own_overall_distance);
 
     for(unsigned int i=0; i<n; i++)
     {
@@ -2452,12 +2540,7 @@ int SkiddingAI::computeSkill(SkillType type)
 //-----------------------------------------------------------------------------
 void SkiddingAI::checkCrashes(const Vec3& pos )
 {
-    int steps = int( m_kart->getVelocityLC().getZ() / m_kart_length );
-    if( steps < 2 ) steps = 2;
-
-    // The AI drives significantly better with more steps, so for now
-    // add 5 additional steps.
-    steps+=5;
+    int steps = getNumCrashSteps(m_kart->getVelocityLC().getZ());
 
     //Right now there are 2 kind of 'crashes': with other karts and another
     //with the track. The sight line is used to find if the karts crash with
@@ -2497,7 +2580,6 @@ void SkiddingAI::checkCrashes(const Vec3& pos )
     // Time it takes to drive for m_kart_length units.
     float dt = m_kart_length / speed;
 
-    int current_node = m_track_node;
     if(steps<1 || steps>1000)
     {
         Log::warn(getControllerName().c_str(),
@@ -2505,32 +2587,98 @@ void SkiddingAI::checkCrashes(const Vec3& pos )
                   steps, m_kart_length, m_kart->getVelocityLC().getZ());
         steps=1000;
     }
-    for(int i = 1; steps > i; ++i)
+
+    // The crash with the track only depends on this kart, so it might
+    // have been computed already in precomputeUpdate().
+    int road_crash_step;
+    if (m_precomputed.m_ticks == m_world->getTicksSinceStart() &&
+        m_precomputed.m_xyz == pos &&
+        m_precomputed.m_velocity == m_kart->getVelocity() &&
+        m_precomputed.m_velocity_lc_z == m_kart->getVelocityLC().getZ() &&
+        m_precomputed.m_track_node == m_track_node)
+    {
+        road_crash_step = m_precomputed.m_road_crash_step;
+    }
+    else
+        road_crash_step = findRoadCrashStep(pos, vel_normal, steps);
+
+    // Karts are only tested up to (including) the step at which the kart
+    // gets off the road.
+    int last_step = road_crash_step == -1 ? steps - 1 : road_crash_step;
+    for(int i = 1; i <= last_step && m_crashes.m_kart == -1; ++i)
     {
         Vec3 step_coord = pos + vel_normal* m_kart_length * float(i);
 
         /* Find if we crash with any kart, as long as we haven't found one
          * yet
          */
-        if( m_crashes.m_kart == -1 )
-        {
-            for( unsigned int j = 0; j < NUM_KARTS; ++j )
-            {
-                const AbstractKart* kart = m_world->getKart(j);
-                // Ignore eliminated karts
-                if(kart==m_kart||kart->isEliminated()||kart->isGhostKart()) continue;
-                const AbstractKart *other_kart = m_world->getKart(j);
-                // Ignore karts ahead that are faster than this kart.
-                if(m_kart->getVelocityLC().getZ() < other_kart->getVelocityLC().getZ())
-                    continue;
-                Vec3 other_kart_xyz = other_kart->getXYZ()
-                                    + other_kart->getVelocity()*(i*dt);
-                float kart_distance = (step_coord - other_kart_xyz).length();
-
-                if( kart_distance < m_kart_length)
-                    m_crashes.m_kart = j;
-            }
+        for( unsigned int j = 0; j < NUM_KARTS; ++j )
+        {
+            const AbstractKart* kart = m_world->getKart(j);
+            // Ignore eliminated karts
+            if(kart==m_kart||kart->isEliminated()||kart->isGhostKart()) continue;
+            const AbstractKart *other_kart = m_world->getKart(j);
+            // Ignore karts ahead that are faster than this kart.
+            if(m_kart->getVelocityLC().getZ() < other_kart->getVelocityLC().getZ())
+                continue;
+            Vec3 other_kart_xyz = other_kart->getXYZ()
+                                + other_kart->getVelocity()*(i*dt);
+            float kart_distance = (step_coord - other_kart_xyz).length();
+
+            if( kart_distance < m_kart_length)
+                m_crashes.m_kart = j;
         }
+    }
+
+    if (road_crash_step != -1)
+        m_crashes.m_road = true;
+}   // checkCrashes
+
+//-----------------------------------------------------------------------------
+/** Returns the number of steps (of one kart length each) that checkCrashes()
+ *  tests ahead of the kart.
+ *  \param velocity_lc_z The forward speed of the kart.
+ */
+int SkiddingAI::getNumCrashSteps(float velocity_lc_z) const
+{
+    int steps = int( velocity_lc_z / m_kart_length );
+    if( steps < 2 ) steps = 2;
+
+    // The AI drives significantly better with more steps, so for now
+    // add 5 additional steps.
+    steps+=5;
+    return steps;
+}   // getNumCrashSteps
+
+//-----------------------------------------------------------------------------
+/** Finds the first step along the driving direction at which the kart would
+ *  be off the road. This is looked up in the road profile of the current
+ *  node (see DriveGraph::findProfileCrashStep()); the steps are only tested
+ *  against the quads if the profile does not cover them. This only reads
+ *  the drive graph and the path data of this AI, so it can be called from
+ *  precomputeUpdate().
+ *  \param pos Position of the kart.
+ *  \param vel_normal Normalised velocity of the kart.
+ *  \param steps Number of steps to test.
+ *  \return The index of the step at which the kart is off the road, or -1
+ *          if it stays on the road.
+ */
+int SkiddingAI::findRoadCrashStep(const Vec3 &pos, const Vec3 &vel_normal,
+                                  int steps)
+{
+    // Look the result up in the road profile of the current node, only
+    // test the steps against the quads if the profile doesn't cover them
+    int crash_step;
+    if (DriveGraph::get()->findProfileCrashStep(m_track_node, pos,
+                                                vel_normal, m_kart_length,
+                                                steps, m_next_node_index,
+                                                &crash_step))
+        return crash_step;
+
+    int current_node = m_track_node;
+    for(int i = 1; steps > i; ++i)
+    {
+        Vec3 step_coord = pos + vel_normal* m_kart_length * float(i);
 
         /*Find if we crash with the drivelines*/
         if(current_node!=Graph::UNKNOWN_SECTOR &&
@@ -2539,12 +2687,10 @@ void SkiddingAI::checkCrashes(const Vec3& pos )
                         /* sectors to test*/ &m_all_look_aheads[current_node]);
 
         if( current_node == Graph::UNKNOWN_SECTOR)
-        {
-            m_crashes.m_road = true;
-            return;
-        }
+            return i;
     }
-}   // checkCrashes
+    return -1;
+}   // findRoadCrashStep
 
 //-----------------------------------------------------------------------------
 /** This is a new version of findNonCrashingPoint, which at this stage is
@@ -2577,14 +2723,29 @@ void SkiddingAI::checkCrashes(const Vec3& pos )
  *  a left turn, the kart will aim to the left point (and vice versa for
  *  right turn) - slightly offset by the width of the kart to avoid that
  *  the kart is getting off track.
+ *  The node is normally looked up in the road profile of the current node
+ *  (see DriveGraph::findProfileReachableNode()), which is based on the
+ *  center of the nodes instead of their end points. The test above is only
+ *  done if the path of the kart leaves the profile.
  *  \param aim_position The point to aim for, i.e. the point that can be
  *         driven to in a straight line.
  *  \param last_node The graph node index in which the aim_position is.
 */
-void SkiddingAI::findNonCrashingPointNew(Vec3 *result, int *last_node)
+void SkiddingAI::findNonCrashingPointNew(const Vec3 &xyz, Vec3 *result,
+                                         int *last_node)
 {
+    // Look the node up in the road profile of the current node, which is
+    // only not possible if the path of this kart leaves the profile
+    if (DriveGraph::get()->findProfileReachableNode(m_track_node, xyz,
+                                                    m_next_node_index,
+                                                    last_node))
+    {
+        *result = DriveGraph::get()->getNode(*last_node)->getCenter();
+        return;
+    }
+
     *last_node = m_next_node_index[m_track_node];
-    const core::vector2df xz = m_kart->getXYZ().toIrrVector2d();
+    const core::vector2df xz = xyz.toIrrVector2d();
 
     const DriveNode* dn = DriveGraph::get()->getNode(*last_node);
 
@@ -2692,7 +2853,8 @@ void SkiddingAI::findNonCrashingPointNew(Vec3 *result, int *last_node)
  *  \param aim_position On exit contains the point the AI should aim at.
  *  \param last_node On exit contais the graph node the AI is aiming at.
 */
- void SkiddingAI::findNonCrashingPoint(Vec3 *aim_position, int *last_node)
+ void SkiddingAI::findNonCrashingPoint(const Vec3 &xyz, Vec3 *aim_position,
+                                       int *last_node)
 {
 #ifdef AI_DEBUG_KART_HEADING
     const Vec3 eps(0,0.5f,0);
@@ -2731,7 +2893,7 @@ void SkiddingAI::findNonCrashingPointNew(Vec3 *result, int *last_node)
 
         //direction is a vector from our kart to the sectors we are testing
         direction = DriveGraph::get()->getNode(target_sector)->getCenter()
-                  - m_kart->getXYZ();
+                  - xyz;
 
         float len=direction.length();
         unsigned int steps = (unsigned int)( len / m_kart_length );
@@ -2751,7 +2913,7 @@ void SkiddingAI::findNonCrashingPointNew(Vec3 *result, int *last_node)
         //Test if we crash if we drive towards the target sector
         for(unsigned int i = 2; i < steps; ++i )
         {
-            step_coord = m_kart->getXYZ()+direction*m_kart_length * float(i);
+            step_coord = xyz+direction*m_kart_length * float(i);
 
             DriveGraph::get()->spatialToTrack(&step_track_coord, step_coord,
                                              *last_node );
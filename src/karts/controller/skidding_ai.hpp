@@ -236,6 +236,30 @@ private:
           m_point_selection_algorithm;
 
     ItemManager* m_item_manager;
+
+    /** Results of the parts of update() that only depend on this kart and
+     *  the drive graph, computed by precomputeUpdate() (in parallel for all
+     *  AI karts). Together with each result the inputs it was computed
+     *  from are stored, and the result is only used if update() sees the
+     *  same inputs - otherwise the value is computed again. This way the
+     *  AI behaves exactly the same as without precomputation. */
+    struct PrecomputedData
+    {
+        /** World ticks at which the data was computed, -1 if invalid. */
+        int   m_ticks;
+        /** The kart position, velocity and forward speed as predicted for
+         *  the next update. */
+        Vec3  m_xyz;
+        Vec3  m_velocity;
+        float m_velocity_lc_z;
+        /** The graph node the kart is on. */
+        int   m_track_node;
+        /** The result of findNonCrashingPoint*(). */
+        Vec3  m_aim_point;
+        int   m_last_node;
+        /** The result of findRoadCrashStep(). */
+        int   m_road_crash_step;
+    } m_precomputed;
 #ifdef AI_DEBUG
     /** For skidding debugging: shows the estimated turn shape. */
     ShowCurve **m_curve;
@@ -287,8 +311,13 @@ private:
                         std::vector<const ItemState *> *items_to_collect);
 
     void  checkCrashes(const Vec3& pos);
-    void  findNonCrashingPointNew(Vec3 *result, int *last_node);
-    void  findNonCrashingPoint(Vec3 *result, int *last_node);
+    int   getNumCrashSteps(float velocity_lc_z) const;
+    int   findRoadCrashStep(const Vec3 &pos, const Vec3 &vel_normal,
+                            int steps);
+    void  findNonCrashingPointNew(const Vec3 &xyz, Vec3 *result,
+                                  int *last_node);
+    void  findNonCrashingPoint(const Vec3 &xyz, Vec3 *result,
+                               int *last_node);
 
     void  determineTrackDirection();
     virtual bool canSkid(float steer_fraction);
@@ -302,7 +331,10 @@ public:
                  SkiddingAI(AbstractKart *kart);
                 ~SkiddingAI();
     virtual void update      (int ticks);
+    virtual void precomputeUpdate(int ticks);
     virtual void reset       ();
+    virtual void newLap      (int lap);
+    virtual bool isInStableState() const;
     virtual const irr::core::stringw& getNamePostfix() const;
 };
 
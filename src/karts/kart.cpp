@@ -29,7 +29,7 @@
 #include "font/font_manager.hpp"
 #include "graphics/camera/camera.hpp"
 #include "graphics/central_settings.hpp"
-#include "graphics/explosion.hpp"
+#include "graphics/hit_effect.hpp"
 #include "graphics/irr_driver.hpp"
 #include "graphics/material.hpp"
 #include "graphics/material_manager.hpp"
@@ -736,7 +736,8 @@ void Kart::createPhysics()
     trans.setIdentity();
     createBody(mass, trans, m_kart_chassis.get(),
                m_kart_properties->getRestitution(0.0f));
-    std::vector<float> ang_fact = m_kart_properties->getStabilityAngularFactor();
+    const std::vector<float>& ang_fact =
+        m_kart_properties->getStabilityAngularFactor();
     // The angular factor (with X and Z values <1) helps to keep the kart
     // upright, especially in case of a collision.
     m_body->setAngularFactor(Vec3(ang_fact[0], ang_fact[1], ang_fact[2]));
@@ -888,13 +889,8 @@ void Kart::updateWeight()
  *  \param radius The radius for which the speed needs to be computed. */
 float Kart::getSpeedForTurnRadius(float radius) const
 {
-    InterpolationArray turn_angle_at_speed = m_kart_properties->getTurnRadius();
-    // Convert the turn radius into turn angle
-    for(int i = 0; i < (int)turn_angle_at_speed.size(); i++)
-        turn_angle_at_speed.setY(i, sinf( 1.0f / turn_angle_at_speed.getY(i)));
-
     float angle = sinf(1.0f / radius);
-    return turn_angle_at_speed.getReverse(angle);
+    return m_kart_properties->getTurnAngleAtSpeed().getReverse(angle);
 }   // getSpeedForTurnRadius
 
 // ------------------------------------------------------------------------
@@ -904,16 +900,10 @@ float Kart::getSpeedForTurnRadius(float radius) const
     real raw steer angle. */
 float Kart::getMaxSteerAngle(float speed) const
 {
-    InterpolationArray turn_angle_at_speed = m_kart_properties->getTurnRadius();
-    // Convert the turn radius into turn angle
-    // We multiply by wheel base to keep turn radius identical
-    // across karts of different lengths sharing the same
+    // The turn angles are multiplied by the wheel base to keep the turn
+    // radius identical across karts of different lengths sharing the same
     // turn radius properties
-    for(int i = 0; i < (int)turn_angle_at_speed.size(); i++)
-        turn_angle_at_speed.setY(i, sinf( 1.0f / turn_angle_at_speed.getY(i))
-                                    * m_kart_properties->getWheelBase());
-
-    return turn_angle_at_speed.get(speed);
+    return m_kart_properties->getMaxSteerAngleAtSpeed().get(speed);
 }   // getMaxSteerAngle
 
 //-----------------------------------------------------------------------------
@@ -1193,7 +1183,8 @@ float Kart::getStartupBoostFromStartTicks(int ticks) const
     if (ticks_since_ready < 0)
         return 0.0f;
     float t = stk_config->ticks2Time(ticks_since_ready);
-    std::vector<float> startup_times = m_kart_properties->getStartupTime();
+    const std::vector<float>& startup_times =
+        m_kart_properties->getStartupTime();
     for (unsigned int i = 0; i < startup_times.size(); i++)
     {
         if (t <= startup_times[i])
@@ -1445,7 +1436,12 @@ void Kart::update(int ticks)
     // based on the collision speed.
     m_body->setRestitution(m_kart_properties->getRestitution(fabsf(m_speed)));
 
+    // The position and speed of this kart are now known for this time step
+    World::getWorld()->getKartProximity()->updateKart(this);
+
+    PROFILER_PUSH_CPU_MARKER("Kart::update (controller)", 0x60, 0x34, 0x7F);
     m_controller->update(ticks);
+    PROFILER_POP_CPU_MARKER();
 
 #ifndef SERVER_ONLY
 #undef DEBUG_CAMERA_SHAKE
@@ -1729,7 +1725,9 @@ void Kart::update(int ticks)
     }   // if there is material
     PROFILER_POP_CPU_MARKER();
 
+    PROFILER_PUSH_CPU_MARKER("Kart::update (item hits)", 0x60, 0x34, 0x7F);
     Track::getCurrentTrack()->getItemManager()->checkItemHit(this);
+    PROFILER_POP_CPU_MARKER();
 
     const bool emergency = has_animation_before;
 
@@ -1786,8 +1784,8 @@ void Kart::update(int ticks)
 
         if (!GUIEngine::isNoGraphics() && !has_animation_before)
         {
-            HitEffect *effect =  new Explosion(getXYZ(), "jump",
-                                              "jump_explosion.xml");
+            HitEffect *effect =  ProjectileManager::get()->newExplosion(
+                getXYZ(), "jump", "jump_explosion.xml");
             ProjectileManager::get()->addHitEffect(effect);
         }
     }
@@ -0,0 +1,64 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_KART_LOCAL_STATES_HPP
+#define HEADER_KART_LOCAL_STATES_HPP
+
+#include <cstdint>
+#include <vector>
+
+/**
+ *  \brief The local state of all karts at one time step, i.e. the values
+ *  which are not part of the network state, since they only depend on the
+ *  kart itself. A client saves them at each state time step and restores
+ *  them when rewinding (see KartRewinder::saveLocalState). The values are
+ *  stored as one array per value, indexed by the world kart id, so saving
+ *  and restoring needs no allocation once the arrays have grown.
+ *  \ingroup karts
+ */
+struct KartLocalStates
+{
+    /** 1 if the state of a kart was saved (i.e. it was not eliminated). */
+    std::vector<uint8_t>  m_saved;
+    std::vector<int>      m_brake_ticks;
+    std::vector<int8_t>   m_min_nitro_ticks;
+    /** Steering values of the player controller (0 for other controllers). */
+    std::vector<int>      m_steer_val_l;
+    std::vector<int>      m_steer_val_r;
+    /** The terrain slowdown of MaxSpeed. */
+    std::vector<float>    m_terrain_current_fraction;
+    std::vector<uint16_t> m_terrain_max_speed_fraction;
+    std::vector<float>    m_remaining_jump_time;
+
+    // ------------------------------------------------------------------------
+    /** Prepares the arrays for the given number of karts, and marks all
+     *  karts as not saved. */
+    void reset(unsigned int num_karts)
+    {
+        m_saved.assign(num_karts, 0);
+        m_brake_ticks.resize(num_karts);
+        m_min_nitro_ticks.resize(num_karts);
+        m_steer_val_l.resize(num_karts);
+        m_steer_val_r.resize(num_karts);
+        m_terrain_current_fraction.resize(num_karts);
+        m_terrain_max_speed_fraction.resize(num_karts);
+        m_remaining_jump_time.resize(num_karts);
+    }   // reset
+};   // KartLocalStates
+
+#endif
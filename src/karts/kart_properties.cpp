@@ -444,6 +444,7 @@ void KartProperties::combineCharacteristics(HandicapLevel handicap)
     m_combined_characteristic->addCharacteristic(m_characteristic.get());
     m_cached_characteristic = std::make_shared<CachedCharacteristic>
         (m_combined_characteristic.get());
+    updateCharacteristicTable();
 }   // combineCharacteristics
 
 //-----------------------------------------------------------------------------
@@ -722,653 +723,250 @@ core::stringw KartProperties::getName() const
 }   // getName
 
 // ----------------------------------------------------------------------------
-// Script-generated content generated by tools/create_kart_properties.py getter
-// Please don't change the following tag. It will be automatically detected
-// by the script and replace the contained content.
-// To update the code, use tools/update_characteristics.py
-/* <characteristics-start kpgetter> */
-// ----------------------------------------------------------------------------
-float KartProperties::getSuspensionStiffness() const
-{
-    return m_cached_characteristic->getSuspensionStiffness();
-}  // getSuspensionStiffness
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSuspensionRest() const
-{
-    return m_cached_characteristic->getSuspensionRest();
-}  // getSuspensionRest
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSuspensionTravel() const
-{
-    return m_cached_characteristic->getSuspensionTravel();
-}  // getSuspensionTravel
-
-// ----------------------------------------------------------------------------
-bool KartProperties::getSuspensionExpSpringResponse() const
-{
-    return m_cached_characteristic->getSuspensionExpSpringResponse();
-}  // getSuspensionExpSpringResponse
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSuspensionMaxForce() const
-{
-    return m_cached_characteristic->getSuspensionMaxForce();
-}  // getSuspensionMaxForce
-
-// ----------------------------------------------------------------------------
-float KartProperties::getStabilityRollInfluence() const
-{
-    return m_cached_characteristic->getStabilityRollInfluence();
-}  // getStabilityRollInfluence
-
-// ----------------------------------------------------------------------------
-float KartProperties::getStabilityChassisLinearDamping() const
-{
-    return m_cached_characteristic->getStabilityChassisLinearDamping();
-}  // getStabilityChassisLinearDamping
-
-// ----------------------------------------------------------------------------
-float KartProperties::getStabilityChassisAngularDamping() const
-{
-    return m_cached_characteristic->getStabilityChassisAngularDamping();
-}  // getStabilityChassisAngularDamping
-
-// ----------------------------------------------------------------------------
-float KartProperties::getStabilityDownwardImpulseFactor() const
-{
-    return m_cached_characteristic->getStabilityDownwardImpulseFactor();
-}  // getStabilityDownwardImpulseFactor
-
-// ----------------------------------------------------------------------------
-float KartProperties::getStabilityTrackConnectionAccel() const
-{
-    return m_cached_characteristic->getStabilityTrackConnectionAccel();
-}  // getStabilityTrackConnectionAccel
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getStabilityAngularFactor() const
-{
-    return m_cached_characteristic->getStabilityAngularFactor();
-}  // getStabilityAngularFactor
-
-// ----------------------------------------------------------------------------
-float KartProperties::getStabilitySmoothFlyingImpulse() const
-{
-    return m_cached_characteristic->getStabilitySmoothFlyingImpulse();
-}  // getStabilitySmoothFlyingImpulse
-
-// ----------------------------------------------------------------------------
-InterpolationArray KartProperties::getTurnRadius() const
-{
-    return m_cached_characteristic->getTurnRadius();
-}  // getTurnRadius
-
-// ----------------------------------------------------------------------------
-float KartProperties::getTurnTimeResetSteer() const
-{
-    return m_cached_characteristic->getTurnTimeResetSteer();
-}  // getTurnTimeResetSteer
-
-// ----------------------------------------------------------------------------
-InterpolationArray KartProperties::getTurnTimeFullSteer() const
-{
-    return m_cached_characteristic->getTurnTimeFullSteer();
-}  // getTurnTimeFullSteer
-
-// ----------------------------------------------------------------------------
-float KartProperties::getEnginePower() const
-{
-    return m_cached_characteristic->getEnginePower();
-}  // getEnginePower
-
-// ----------------------------------------------------------------------------
-float KartProperties::getEngineMaxSpeed() const
-{
-    return m_cached_characteristic->getEngineMaxSpeed();
-}  // getEngineMaxSpeed
-
-// ----------------------------------------------------------------------------
-float KartProperties::getEngineGenericMaxSpeed() const
-{
-    return m_cached_characteristic->getEngineGenericMaxSpeed();
-}  // getEngineGenericMaxSpeed
-
-// ----------------------------------------------------------------------------
-float KartProperties::getEngineBrakeFactor() const
-{
-    return m_cached_characteristic->getEngineBrakeFactor();
-}  // getEngineBrakeFactor
-
-// ----------------------------------------------------------------------------
-float KartProperties::getEngineBrakeTimeIncrease() const
-{
-    return m_cached_characteristic->getEngineBrakeTimeIncrease();
-}  // getEngineBrakeTimeIncrease
-
-// ----------------------------------------------------------------------------
-float KartProperties::getEngineMaxSpeedReverseRatio() const
-{
-    return m_cached_characteristic->getEngineMaxSpeedReverseRatio();
-}  // getEngineMaxSpeedReverseRatio
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getGearSwitchRatio() const
-{
-    return m_cached_characteristic->getGearSwitchRatio();
-}  // getGearSwitchRatio
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getGearPowerIncrease() const
-{
-    return m_cached_characteristic->getGearPowerIncrease();
-}  // getGearPowerIncrease
-
-// ----------------------------------------------------------------------------
-float KartProperties::getMass() const
-{
-    return m_cached_characteristic->getMass();
-}  // getMass
-
-// ----------------------------------------------------------------------------
-float KartProperties::getWheelsDampingRelaxation() const
-{
-    return m_cached_characteristic->getWheelsDampingRelaxation();
-}  // getWheelsDampingRelaxation
-
-// ----------------------------------------------------------------------------
-float KartProperties::getWheelsDampingCompression() const
-{
-    return m_cached_characteristic->getWheelsDampingCompression();
-}  // getWheelsDampingCompression
-
-// ----------------------------------------------------------------------------
-float KartProperties::getJumpAnimationTime() const
-{
-    return m_cached_characteristic->getJumpAnimationTime();
-}  // getJumpAnimationTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getLeanMax() const
-{
-    return m_cached_characteristic->getLeanMax();
-}  // getLeanMax
-
-// ----------------------------------------------------------------------------
-float KartProperties::getLeanSpeed() const
-{
-    return m_cached_characteristic->getLeanSpeed();
-}  // getLeanSpeed
-
-// ----------------------------------------------------------------------------
-float KartProperties::getAnvilDuration() const
-{
-    return m_cached_characteristic->getAnvilDuration();
-}  // getAnvilDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getAnvilWeight() const
-{
-    return m_cached_characteristic->getAnvilWeight();
-}  // getAnvilWeight
-
-// ----------------------------------------------------------------------------
-float KartProperties::getAnvilSpeedFactor() const
-{
-    return m_cached_characteristic->getAnvilSpeedFactor();
-}  // getAnvilSpeedFactor
-
-// ----------------------------------------------------------------------------
-float KartProperties::getParachuteFriction() const
-{
-    return m_cached_characteristic->getParachuteFriction();
-}  // getParachuteFriction
-
-// ----------------------------------------------------------------------------
-float KartProperties::getParachuteDuration() const
-{
-    return m_cached_characteristic->getParachuteDuration();
-}  // getParachuteDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getParachuteDurationOther() const
-{
-    return m_cached_characteristic->getParachuteDurationOther();
-}  // getParachuteDurationOther
-
-// ----------------------------------------------------------------------------
-float KartProperties::getParachuteDurationRankMult() const
-{
-    return m_cached_characteristic->getParachuteDurationRankMult();
-}  // getParachuteDurationRankMult
-
-// ----------------------------------------------------------------------------
-float KartProperties::getParachuteDurationSpeedMult() const
-{
-    return m_cached_characteristic->getParachuteDurationSpeedMult();
-}  // getParachuteDurationSpeedMult
-
-// ----------------------------------------------------------------------------
-float KartProperties::getParachuteLboundFraction() const
-{
-    return m_cached_characteristic->getParachuteLboundFraction();
-}  // getParachuteLboundFraction
-
-// ----------------------------------------------------------------------------
-float KartProperties::getParachuteUboundFraction() const
-{
-    return m_cached_characteristic->getParachuteUboundFraction();
-}  // getParachuteUboundFraction
-
-// ----------------------------------------------------------------------------
-float KartProperties::getParachuteMaxSpeed() const
-{
-    return m_cached_characteristic->getParachuteMaxSpeed();
-}  // getParachuteMaxSpeed
-
-// ----------------------------------------------------------------------------
-float KartProperties::getFrictionKartFriction() const
-{
-    return m_cached_characteristic->getFrictionKartFriction();
-}  // getFrictionKartFriction
-
-// ----------------------------------------------------------------------------
-float KartProperties::getBubblegumDuration() const
-{
-    return m_cached_characteristic->getBubblegumDuration();
-}  // getBubblegumDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getBubblegumSpeedFraction() const
-{
-    return m_cached_characteristic->getBubblegumSpeedFraction();
-}  // getBubblegumSpeedFraction
-
-// ----------------------------------------------------------------------------
-float KartProperties::getBubblegumTorque() const
-{
-    return m_cached_characteristic->getBubblegumTorque();
-}  // getBubblegumTorque
-
-// ----------------------------------------------------------------------------
-float KartProperties::getBubblegumFadeInTime() const
-{
-    return m_cached_characteristic->getBubblegumFadeInTime();
-}  // getBubblegumFadeInTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getBubblegumShieldDuration() const
-{
-    return m_cached_characteristic->getBubblegumShieldDuration();
-}  // getBubblegumShieldDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getZipperDuration() const
-{
-    return m_cached_characteristic->getZipperDuration();
-}  // getZipperDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getZipperForce() const
-{
-    return m_cached_characteristic->getZipperForce();
-}  // getZipperForce
-
-// ----------------------------------------------------------------------------
-float KartProperties::getZipperSpeedGain() const
-{
-    return m_cached_characteristic->getZipperSpeedGain();
-}  // getZipperSpeedGain
-
-// ----------------------------------------------------------------------------
-float KartProperties::getZipperMaxSpeedIncrease() const
-{
-    return m_cached_characteristic->getZipperMaxSpeedIncrease();
-}  // getZipperMaxSpeedIncrease
-
-// ----------------------------------------------------------------------------
-float KartProperties::getZipperFadeOutTime() const
-{
-    return m_cached_characteristic->getZipperFadeOutTime();
-}  // getZipperFadeOutTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSwatterDuration() const
-{
-    return m_cached_characteristic->getSwatterDuration();
-}  // getSwatterDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSwatterDistance() const
-{
-    return m_cached_characteristic->getSwatterDistance();
-}  // getSwatterDistance
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSwatterSquashDuration() const
-{
-    return m_cached_characteristic->getSwatterSquashDuration();
-}  // getSwatterSquashDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSwatterSquashSlowdown() const
-{
-    return m_cached_characteristic->getSwatterSquashSlowdown();
-}  // getSwatterSquashSlowdown
-
-// ----------------------------------------------------------------------------
-float KartProperties::getPlungerBandMaxLength() const
-{
-    return m_cached_characteristic->getPlungerBandMaxLength();
-}  // getPlungerBandMaxLength
-
-// ----------------------------------------------------------------------------
-float KartProperties::getPlungerBandForce() const
-{
-    return m_cached_characteristic->getPlungerBandForce();
-}  // getPlungerBandForce
-
-// ----------------------------------------------------------------------------
-float KartProperties::getPlungerBandDuration() const
-{
-    return m_cached_characteristic->getPlungerBandDuration();
-}  // getPlungerBandDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getPlungerBandSpeedIncrease() const
-{
-    return m_cached_characteristic->getPlungerBandSpeedIncrease();
-}  // getPlungerBandSpeedIncrease
-
-// ----------------------------------------------------------------------------
-float KartProperties::getPlungerBandFadeOutTime() const
-{
-    return m_cached_characteristic->getPlungerBandFadeOutTime();
-}  // getPlungerBandFadeOutTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getPlungerInFaceTime() const
-{
-    return m_cached_characteristic->getPlungerInFaceTime();
-}  // getPlungerInFaceTime
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getStartupTime() const
-{
-    return m_cached_characteristic->getStartupTime();
-}  // getStartupTime
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getStartupBoost() const
-{
-    return m_cached_characteristic->getStartupBoost();
-}  // getStartupBoost
-
-// ----------------------------------------------------------------------------
-float KartProperties::getRescueDuration() const
-{
-    return m_cached_characteristic->getRescueDuration();
-}  // getRescueDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getRescueVertOffset() const
-{
-    return m_cached_characteristic->getRescueVertOffset();
-}  // getRescueVertOffset
-
-// ----------------------------------------------------------------------------
-float KartProperties::getRescueHeight() const
-{
-    return m_cached_characteristic->getRescueHeight();
-}  // getRescueHeight
-
-// ----------------------------------------------------------------------------
-float KartProperties::getExplosionDuration() const
-{
-    return m_cached_characteristic->getExplosionDuration();
-}  // getExplosionDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getExplosionRadius() const
-{
-    return m_cached_characteristic->getExplosionRadius();
-}  // getExplosionRadius
-
-// ----------------------------------------------------------------------------
-float KartProperties::getExplosionInvulnerabilityTime() const
-{
-    return m_cached_characteristic->getExplosionInvulnerabilityTime();
-}  // getExplosionInvulnerabilityTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroDuration() const
-{
-    return m_cached_characteristic->getNitroDuration();
-}  // getNitroDuration
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroEngineForce() const
-{
-    return m_cached_characteristic->getNitroEngineForce();
-}  // getNitroEngineForce
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroEngineMult() const
-{
-    return m_cached_characteristic->getNitroEngineMult();
-}  // getNitroEngineMult
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroConsumption() const
-{
-    return m_cached_characteristic->getNitroConsumption();
-}  // getNitroConsumption
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroSmallContainer() const
-{
-    return m_cached_characteristic->getNitroSmallContainer();
-}  // getNitroSmallContainer
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroBigContainer() const
-{
-    return m_cached_characteristic->getNitroBigContainer();
-}  // getNitroBigContainer
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroMaxSpeedIncrease() const
-{
-    return m_cached_characteristic->getNitroMaxSpeedIncrease();
-}  // getNitroMaxSpeedIncrease
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroFadeOutTime() const
-{
-    return m_cached_characteristic->getNitroFadeOutTime();
-}  // getNitroFadeOutTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getNitroMax() const
-{
-    return m_cached_characteristic->getNitroMax();
-}  // getNitroMax
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamDurationFactor() const
-{
-    return m_cached_characteristic->getSlipstreamDurationFactor();
-}  // getSlipstreamDurationFactor
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamBaseSpeed() const
-{
-    return m_cached_characteristic->getSlipstreamBaseSpeed();
-}  // getSlipstreamBaseSpeed
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamLength() const
-{
-    return m_cached_characteristic->getSlipstreamLength();
-}  // getSlipstreamLength
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamWidth() const
-{
-    return m_cached_characteristic->getSlipstreamWidth();
-}  // getSlipstreamWidth
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamInnerFactor() const
-{
-    return m_cached_characteristic->getSlipstreamInnerFactor();
-}  // getSlipstreamInnerFactor
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamMinCollectTime() const
-{
-    return m_cached_characteristic->getSlipstreamMinCollectTime();
-}  // getSlipstreamMinCollectTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamMaxCollectTime() const
-{
-    return m_cached_characteristic->getSlipstreamMaxCollectTime();
-}  // getSlipstreamMaxCollectTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamAddPower() const
-{
-    return m_cached_characteristic->getSlipstreamAddPower();
-}  // getSlipstreamAddPower
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamMinSpeed() const
-{
-    return m_cached_characteristic->getSlipstreamMinSpeed();
-}  // getSlipstreamMinSpeed
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamMaxSpeedIncrease() const
-{
-    return m_cached_characteristic->getSlipstreamMaxSpeedIncrease();
-}  // getSlipstreamMaxSpeedIncrease
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSlipstreamFadeOutTime() const
-{
-    return m_cached_characteristic->getSlipstreamFadeOutTime();
-}  // getSlipstreamFadeOutTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidIncrease() const
-{
-    return m_cached_characteristic->getSkidIncrease();
-}  // getSkidIncrease
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidDecrease() const
-{
-    return m_cached_characteristic->getSkidDecrease();
-}  // getSkidDecrease
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidMax() const
-{
-    return m_cached_characteristic->getSkidMax();
-}  // getSkidMax
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidTimeTillMax() const
-{
-    return m_cached_characteristic->getSkidTimeTillMax();
-}  // getSkidTimeTillMax
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidVisual() const
-{
-    return m_cached_characteristic->getSkidVisual();
-}  // getSkidVisual
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidVisualTime() const
-{
-    return m_cached_characteristic->getSkidVisualTime();
-}  // getSkidVisualTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidRevertVisualTime() const
-{
-    return m_cached_characteristic->getSkidRevertVisualTime();
-}  // getSkidRevertVisualTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidMinSpeed() const
-{
-    return m_cached_characteristic->getSkidMinSpeed();
-}  // getSkidMinSpeed
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getSkidTimeTillBonus() const
-{
-    return m_cached_characteristic->getSkidTimeTillBonus();
-}  // getSkidTimeTillBonus
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getSkidBonusSpeed() const
-{
-    return m_cached_characteristic->getSkidBonusSpeed();
-}  // getSkidBonusSpeed
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getSkidBonusTime() const
-{
-    return m_cached_characteristic->getSkidBonusTime();
-}  // getSkidBonusTime
-
-// ----------------------------------------------------------------------------
-std::vector<float> KartProperties::getSkidBonusForce() const
-{
-    return m_cached_characteristic->getSkidBonusForce();
-}  // getSkidBonusForce
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidPhysicalJumpTime() const
-{
-    return m_cached_characteristic->getSkidPhysicalJumpTime();
-}  // getSkidPhysicalJumpTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidGraphicalJumpTime() const
-{
-    return m_cached_characteristic->getSkidGraphicalJumpTime();
-}  // getSkidGraphicalJumpTime
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidPostSkidRotateFactor() const
-{
-    return m_cached_characteristic->getSkidPostSkidRotateFactor();
-}  // getSkidPostSkidRotateFactor
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidReduceTurnMin() const
-{
-    return m_cached_characteristic->getSkidReduceTurnMin();
-}  // getSkidReduceTurnMin
-
-// ----------------------------------------------------------------------------
-float KartProperties::getSkidReduceTurnMax() const
-{
-    return m_cached_characteristic->getSkidReduceTurnMax();
-}  // getSkidReduceTurnMax
-
-// ----------------------------------------------------------------------------
-bool KartProperties::getSkidEnabled() const
+/** Copies all values of the cached characteristics into the characteristic
+ *  table, which is then used by all getters.
+ */
+void KartProperties::updateCharacteristicTable()
+{
+    // Script-generated content generated by tools/create_kart_properties.py kptablefill
+    // Please don't change the following tag. It will be automatically detected
+    // by the script and replace the contained content.
+    // To update the code, use tools/update_characteristics.py
+    /* <characteristics-start kptablefill> */
+    m_table.m_suspension_stiffness =
+        m_cached_characteristic->getSuspensionStiffness();
+    m_table.m_suspension_rest =
+        m_cached_characteristic->getSuspensionRest();
+    m_table.m_suspension_travel =
+        m_cached_characteristic->getSuspensionTravel();
+    m_table.m_suspension_exp_spring_response =
+        m_cached_characteristic->getSuspensionExpSpringResponse();
+    m_table.m_suspension_max_force =
+        m_cached_characteristic->getSuspensionMaxForce();
+    m_table.m_stability_roll_influence =
+        m_cached_characteristic->getStabilityRollInfluence();
+    m_table.m_stability_chassis_linear_damping =
+        m_cached_characteristic->getStabilityChassisLinearDamping();
+    m_table.m_stability_chassis_angular_damping =
+        m_cached_characteristic->getStabilityChassisAngularDamping();
+    m_table.m_stability_downward_impulse_factor =
+        m_cached_characteristic->getStabilityDownwardImpulseFactor();
+    m_table.m_stability_track_connection_accel =
+        m_cached_characteristic->getStabilityTrackConnectionAccel();
+    m_table.m_stability_smooth_flying_impulse =
+        m_cached_characteristic->getStabilitySmoothFlyingImpulse();
+    m_table.m_turn_time_reset_steer =
+        m_cached_characteristic->getTurnTimeResetSteer();
+    m_table.m_engine_power =
+        m_cached_characteristic->getEnginePower();
+    m_table.m_engine_max_speed =
+        m_cached_characteristic->getEngineMaxSpeed();
+    m_table.m_engine_generic_max_speed =
+        m_cached_characteristic->getEngineGenericMaxSpeed();
+    m_table.m_engine_brake_factor =
+        m_cached_characteristic->getEngineBrakeFactor();
+    m_table.m_engine_brake_time_increase =
+        m_cached_characteristic->getEngineBrakeTimeIncrease();
+    m_table.m_engine_max_speed_reverse_ratio =
+        m_cached_characteristic->getEngineMaxSpeedReverseRatio();
+    m_table.m_mass =
+        m_cached_characteristic->getMass();
+    m_table.m_wheels_damping_relaxation =
+        m_cached_characteristic->getWheelsDampingRelaxation();
+    m_table.m_wheels_damping_compression =
+        m_cached_characteristic->getWheelsDampingCompression();
+    m_table.m_jump_animation_time =
+        m_cached_characteristic->getJumpAnimationTime();
+    m_table.m_lean_max =
+        m_cached_characteristic->getLeanMax();
+    m_table.m_lean_speed =
+        m_cached_characteristic->getLeanSpeed();
+    m_table.m_anvil_duration =
+        m_cached_characteristic->getAnvilDuration();
+    m_table.m_anvil_weight =
+        m_cached_characteristic->getAnvilWeight();
+    m_table.m_anvil_speed_factor =
+        m_cached_characteristic->getAnvilSpeedFactor();
+    m_table.m_parachute_friction =
+        m_cached_characteristic->getParachuteFriction();
+    m_table.m_parachute_duration =
+        m_cached_characteristic->getParachuteDuration();
+    m_table.m_parachute_duration_other =
+        m_cached_characteristic->getParachuteDurationOther();
+    m_table.m_parachute_duration_rank_mult =
+        m_cached_characteristic->getParachuteDurationRankMult();
+    m_table.m_parachute_duration_speed_mult =
+        m_cached_characteristic->getParachuteDurationSpeedMult();
+    m_table.m_parachute_lbound_fraction =
+        m_cached_characteristic->getParachuteLboundFraction();
+    m_table.m_parachute_ubound_fraction =
+        m_cached_characteristic->getParachuteUboundFraction();
+    m_table.m_parachute_max_speed =
+        m_cached_characteristic->getParachuteMaxSpeed();
+    m_table.m_friction_kart_friction =
+        m_cached_characteristic->getFrictionKartFriction();
+    m_table.m_bubblegum_duration =
+        m_cached_characteristic->getBubblegumDuration();
+    m_table.m_bubblegum_speed_fraction =
+        m_cached_characteristic->getBubblegumSpeedFraction();
+    m_table.m_bubblegum_torque =
+        m_cached_characteristic->getBubblegumTorque();
+    m_table.m_bubblegum_fade_in_time =
+        m_cached_characteristic->getBubblegumFadeInTime();
+    m_table.m_bubblegum_shield_duration =
+        m_cached_characteristic->getBubblegumShieldDuration();
+    m_table.m_zipper_duration =
+        m_cached_characteristic->getZipperDuration();
+    m_table.m_zipper_force =
+        m_cached_characteristic->getZipperForce();
+    m_table.m_zipper_speed_gain =
+        m_cached_characteristic->getZipperSpeedGain();
+    m_table.m_zipper_max_speed_increase =
+        m_cached_characteristic->getZipperMaxSpeedIncrease();
+    m_table.m_zipper_fade_out_time =
+        m_cached_characteristic->getZipperFadeOutTime();
+    m_table.m_swatter_duration =
+        m_cached_characteristic->getSwatterDuration();
+    m_table.m_swatter_distance =
+        m_cached_characteristic->getSwatterDistance();
+    m_table.m_swatter_squash_duration =
+        m_cached_characteristic->getSwatterSquashDuration();
+    m_table.m_swatter_squash_slowdown =
+        m_cached_characteristic->getSwatterSquashSlowdown();
+    m_table.m_plunger_band_max_length =
+        m_cached_characteristic->getPlungerBandMaxLength();
+    m_table.m_plunger_band_force =
+        m_cached_characteristic->getPlungerBandForce();
+    m_table.m_plunger_band_duration =
+        m_cached_characteristic->getPlungerBandDuration();
+    m_table.m_plunger_band_speed_increase =
+        m_cached_characteristic->getPlungerBandSpeedIncrease();
+    m_table.m_plunger_band_fade_out_time =
+        m_cached_characteristic->getPlungerBandFadeOutTime();
+    m_table.m_plunger_in_face_time =
+        m_cached_characteristic->getPlungerInFaceTime();
+    m_table.m_rescue_duration =
+        m_cached_characteristic->getRescueDuration();
+    m_table.m_rescue_vert_offset =
+        m_cached_characteristic->getRescueVertOffset();
+    m_table.m_rescue_height =
+        m_cached_characteristic->getRescueHeight();
+    m_table.m_explosion_duration =
+        m_cached_characteristic->getExplosionDuration();
+    m_table.m_explosion_radius =
+        m_cached_characteristic->getExplosionRadius();
+    m_table.m_explosion_invulnerability_time =
+        m_cached_characteristic->getExplosionInvulnerabilityTime();
+    m_table.m_nitro_duration =
+        m_cached_characteristic->getNitroDuration();
+    m_table.m_nitro_engine_force =
+        m_cached_characteristic->getNitroEngineForce();
+    m_table.m_nitro_engine_mult =
+        m_cached_characteristic->getNitroEngineMult();
+    m_table.m_nitro_consumption =
+        m_cached_characteristic->getNitroConsumption();
+    m_table.m_nitro_small_container =
+        m_cached_characteristic->getNitroSmallContainer();
+    m_table.m_nitro_big_container =
+        m_cached_characteristic->getNitroBigContainer();
+    m_table.m_nitro_max_speed_increase =
+        m_cached_characteristic->getNitroMaxSpeedIncrease();
+    m_table.m_nitro_fade_out_time =
+        m_cached_characteristic->getNitroFadeOutTime();
+    m_table.m_nitro_max =
+        m_cached_characteristic->getNitroMax();
+    m_table.m_slipstream_duration_factor =
+        m_cached_characteristic->getSlipstreamDurationFactor();
+    m_table.m_slipstream_base_speed =
+        m_cached_characteristic->getSlipstreamBaseSpeed();
+    m_table.m_slipstream_length =
+        m_cached_characteristic->getSlipstreamLength();
+    m_table.m_slipstream_width =
+        m_cached_characteristic->getSlipstreamWidth();
+    m_table.m_slipstream_inner_factor =
+        m_cached_characteristic->getSlipstreamInnerFactor();
+    m_table.m_slipstream_min_collect_time =
+        m_cached_characteristic->getSlipstreamMinCollectTime();
+    m_table.m_slipstream_max_collect_time =
+        m_cached_characteristic->getSlipstreamMaxCollectTime();
+    m_table.m_slipstream_add_power =
+        m_cached_characteristic->getSlipstreamAddPower();
+    m_table.m_slipstream_min_speed =
+        m_cached_characteristic->getSlipstreamMinSpeed();
+    m_table.m_slipstream_max_speed_increase =
+        m_cached_characteristic->getSlipstreamMaxSpeedIncrease();
+    m_table.m_slipstream_fade_out_time =
+        m_cached_characteristic->getSlipstreamFadeOutTime();
+    m_table.m_skid_increase =
+        m_cached_characteristic->getSkidIncrease();
+    m_table.m_skid_decrease =
+        m_cached_characteristic->getSkidDecrease();
+    m_table.m_skid_max =
+        m_cached_characteristic->getSkidMax();
+    m_table.m_skid_time_till_max =
+        m_cached_characteristic->getSkidTimeTillMax();
+    m_table.m_skid_visual =
+        m_cached_characteristic->getSkidVisual();
+    m_table.m_skid_visual_time =
+        m_cached_characteristic->getSkidVisualTime();
+    m_table.m_skid_revert_visual_time =
+        m_cached_characteristic->getSkidRevertVisualTime();
+    m_table.m_skid_min_speed =
+        m_cached_characteristic->getSkidMinSpeed();
+    m_table.m_skid_physical_jump_time =
+        m_cached_characteristic->getSkidPhysicalJumpTime();
+    m_table.m_skid_graphical_jump_time =
+        m_cached_characteristic->getSkidGraphicalJumpTime();
+    m_table.m_skid_post_skid_rotate_factor =
+        m_cached_characteristic->getSkidPostSkidRotateFactor();
+    m_table.m_skid_reduce_turn_min =
+        m_cached_characteristic->getSkidReduceTurnMin();
+    m_table.m_skid_reduce_turn_max =
+        m_cached_characteristic->getSkidReduceTurnMax();
+    m_table.m_skid_enabled =
+        m_cached_characteristic->getSkidEnabled();
+    m_table.m_stability_angular_factor =
+        m_cached_characteristic->getStabilityAngularFactor();
+    m_table.m_turn_radius =
+        m_cached_characteristic->getTurnRadius();
+    m_table.m_turn_time_full_steer =
+        m_cached_characteristic->getTurnTimeFullSteer();
+    m_table.m_gear_switch_ratio =
+        m_cached_characteristic->getGearSwitchRatio();
+    m_table.m_gear_power_increase =
+        m_cached_characteristic->getGearPowerIncrease();
+    m_table.m_startup_time =
+        m_cached_characteristic->getStartupTime();
+    m_table.m_startup_boost =
+        m_cached_characteristic->getStartupBoost();
+    m_table.m_skid_time_till_bonus =
+        m_cached_characteristic->getSkidTimeTillBonus();
+    m_table.m_skid_bonus_speed =
+        m_cached_characteristic->getSkidBonusSpeed();
+    m_table.m_skid_bonus_time =
+        m_cached_characteristic->getSkidBonusTime();
+    m_table.m_skid_bonus_force =
+        m_cached_characteristic->getSkidBonusForce();
+
+    /* <characteristics-end kptablefill> */
+    updateTurnAngles();
+}   // updateCharacteristicTable
+
+// ----------------------------------------------------------------------------
+/** Converts the turn radius into the turn angles used by the kart each time
+ *  step. This depends on the characteristics and the wheel base, so it is
+ *  called when either of them changes.
+ */
+void KartProperties::updateTurnAngles()
 {
-    return m_cached_characteristic->getSkidEnabled();
-}  // getSkidEnabled
-
+    m_turn_angle_at_speed = m_table.m_turn_radius;
+    m_max_steer_angle_at_speed = m_table.m_turn_radius;
+    for (unsigned int i = 0; i < m_turn_angle_at_speed.size(); i++)
+    {
+        float angle = sinf(1.0f / m_turn_angle_at_speed.getY(i));
+        m_turn_angle_at_speed.setY(i, angle);
+        m_max_steer_angle_at_speed.setY(i, angle * m_wheel_base);
+    }
+}   // updateTurnAngles
 
-/* <characteristics-end kpgetter> */
 
@@ -128,6 +128,138 @@ private:
     /** The cached combined characteristics. */
     std::shared_ptr<CachedCharacteristic> m_cached_characteristic;
 
+    /** All values of m_cached_characteristic, resolved once when the
+     *  characteristics are combined (see updateCharacteristicTable()).
+     *  The getters only read a member of this table, which avoids the
+     *  virtual calls and the copies of vectors in the characteristics.
+     *  The scalar values come first, so they share few cache lines. */
+    struct CharacteristicTable
+    {
+        // Script-generated content generated by tools/create_kart_properties.py kptable
+        // Please don't change the following tag. It will be automatically detected
+        // by the script and replace the contained content.
+        // To update the code, use tools/update_characteristics.py
+        /* <characteristics-start kptable> */
+        float m_suspension_stiffness;
+        float m_suspension_rest;
+        float m_suspension_travel;
+        bool m_suspension_exp_spring_response;
+        float m_suspension_max_force;
+        float m_stability_roll_influence;
+        float m_stability_chassis_linear_damping;
+        float m_stability_chassis_angular_damping;
+        float m_stability_downward_impulse_factor;
+        float m_stability_track_connection_accel;
+        float m_stability_smooth_flying_impulse;
+        float m_turn_time_reset_steer;
+        float m_engine_power;
+        float m_engine_max_speed;
+        float m_engine_generic_max_speed;
+        float m_engine_brake_factor;
+        float m_engine_brake_time_increase;
+        float m_engine_max_speed_reverse_ratio;
+        float m_mass;
+        float m_wheels_damping_relaxation;
+        float m_wheels_damping_compression;
+        float m_jump_animation_time;
+        float m_lean_max;
+        float m_lean_speed;
+        float m_anvil_duration;
+        float m_anvil_weight;
+        float m_anvil_speed_factor;
+        float m_parachute_friction;
+        float m_parachute_duration;
+        float m_parachute_duration_other;
+        float m_parachute_duration_rank_mult;
+        float m_parachute_duration_speed_mult;
+        float m_parachute_lbound_fraction;
+        float m_parachute_ubound_fraction;
+        float m_parachute_max_speed;
+        float m_friction_kart_friction;
+        float m_bubblegum_duration;
+        float m_bubblegum_speed_fraction;
+        float m_bubblegum_torque;
+        float m_bubblegum_fade_in_time;
+        float m_bubblegum_shield_duration;
+        float m_zipper_duration;
+        float m_zipper_force;
+        float m_zipper_speed_gain;
+        float m_zipper_max_speed_increase;
+        float m_zipper_fade_out_time;
+        float m_swatter_duration;
+        float m_swatter_distance;
+        float m_swatter_squash_duration;
+        float m_swatter_squash_slowdown;
+        float m_plunger_band_max_length;
+        float m_plunger_band_force;
+        float m_plunger_band_duration;
+        float m_plunger_band_speed_increase;
+        float m_plunger_band_fade_out_time;
+        float m_plunger_in_face_time;
+        float m_rescue_duration;
+        float m_rescue_vert_offset;
+        float m_rescue_height;
+        float m_explosion_duration;
+        float m_explosion_radius;
+        float m_explosion_invulnerability_time;
+        float m_nitro_duration;
+        float m_nitro_engine_force;
+        float m_nitro_engine_mult;
+        float m_nitro_consumption;
+        float m_nitro_small_container;
+        float m_nitro_big_container;
+        float m_nitro_max_speed_increase;
+        float m_nitro_fade_out_time;
+        float m_nitro_max;
+        float m_slipstream_duration_factor;
+        float m_slipstream_base_speed;
+        float m_slipstream_length;
+        float m_slipstream_width;
+        float m_slipstream_inner_factor;
+        float m_slipstream_min_collect_time;
+        float m_slipstream_max_collect_time;
+        float m_slipstream_add_power;
+        float m_slipstream_min_speed;
+        float m_slipstream_max_speed_increase;
+        float m_slipstream_fade_out_time;
+        float m_skid_increase;
+        float m_skid_decrease;
+        float m_skid_max;
+        float m_skid_time_till_max;
+        float m_skid_visual;
+        float m_skid_visual_time;
+        float m_skid_revert_visual_time;
+        float m_skid_min_speed;
+        float m_skid_physical_jump_time;
+        float m_skid_graphical_jump_time;
+        float m_skid_post_skid_rotate_factor;
+        float m_skid_reduce_turn_min;
+        float m_skid_reduce_turn_max;
+        bool m_skid_enabled;
+        std::vector<float> m_stability_angular_factor;
+        InterpolationArray m_turn_radius;
+        InterpolationArray m_turn_time_full_steer;
+        std::vector<float> m_gear_switch_ratio;
+        std::vector<float> m_gear_power_increase;
+        std::vector<float> m_startup_time;
+        std::vector<float> m_startup_boost;
+        std::vector<float> m_skid_time_till_bonus;
+        std::vector<float> m_skid_bonus_speed;
+        std::vector<float> m_skid_bonus_time;
+        std::vector<float> m_skid_bonus_force;
+
+        /* <characteristics-end kptable> */
+    };
+    CharacteristicTable m_table;
+
+    /** The turn radius converted to turn angles, see
+     *  Kart::getSpeedForTurnRadius(). */
+    InterpolationArray m_turn_angle_at_speed;
+
+    /** The turn angles multiplied by the wheel base, see
+     *  Kart::getMaxSteerAngle(). */
+    InterpolationArray m_max_steer_angle_at_speed;
+
     // Physic properties
     // -----------------
     /** If != 0 a bevelled box shape is used by using a point cloud as a
@@ -199,6 +331,8 @@ private:
     void  load              (const std::string &filename,
                              const std::string &node);
     void combineCharacteristics(HandicapLevel h);
+    void updateCharacteristicTable();
+    void updateTurnAngles();
 
     void setWheelBase(float kart_length)
     {
@@ -208,6 +342,7 @@ private:
         // We divide by 1.425 to have a default turn radius which conforms
         // closely (+-0,1%) with the specifications in kart_characteristics.xml
         m_wheel_base = fabsf(kart_length / 1.425f);
+        updateTurnAngles();
     }
 
     void handleOnDemandLoadTexture();
@@ -324,6 +459,15 @@ public:
     // ------------------------------------------------------------------------
     /** Returns the wheel base (distance front to rear axis). */
     float getWheelBase              () const {return m_wheel_base;            }
+    // ------------------------------------------------------------------------
+    /** Returns the turn angle depending on speed. */
+    const InterpolationArray& getTurnAngleAtSpeed() const
+                                               { return m_turn_angle_at_speed; }
+    // ------------------------------------------------------------------------
+    /** Returns the turn angle multiplied by the wheel base depending on
+     *  speed. */
+    const InterpolationArray& getMaxSteerAngleAtSpeed() const
+                                          { return m_max_steer_angle_at_speed; }
 
     // ------------------------------------------------------------------------
     /** Returns a shift of the center of mass (lowering the center of mass
@@ -396,134 +540,241 @@ public:
     // To update the code, use tools/update_characteristics.py
     /* <characteristics-start kpdefs> */
 
-    float getSuspensionStiffness() const;
-    float getSuspensionRest() const;
-    float getSuspensionTravel() const;
-    bool getSuspensionExpSpringResponse() const;
-    float getSuspensionMaxForce() const;
-
-    float getStabilityRollInfluence() const;
-    float getStabilityChassisLinearDamping() const;
-    float getStabilityChassisAngularDamping() const;
-    float getStabilityDownwardImpulseFactor() const;
-    float getStabilityTrackConnectionAccel() const;
-    std::vector<float> getStabilityAngularFactor() const;
-    float getStabilitySmoothFlyingImpulse() const;
-
-    InterpolationArray getTurnRadius() const;
-    float getTurnTimeResetSteer() const;
-    InterpolationArray getTurnTimeFullSteer() const;
-
-    float getEnginePower() const;
-    float getEngineMaxSpeed() const;
-    float getEngineGenericMaxSpeed() const;
-    float getEngineBrakeFactor() const;
-    float getEngineBrakeTimeIncrease() const;
-    float getEngineMaxSpeedReverseRatio() const;
-
-    std::vector<float> getGearSwitchRatio() const;
-    std::vector<float> getGearPowerIncrease() const;
-
-    float getMass() const;
-
-    float getWheelsDampingRelaxation() const;
-    float getWheelsDampingCompression() const;
-
-    float getJumpAnimationTime() const;
-
-    float getLeanMax() const;
-    float getLeanSpeed() const;
-
-    float getAnvilDuration() const;
-    float getAnvilWeight() const;
-    float getAnvilSpeedFactor() const;
-
-    float getParachuteFriction() const;
-    float getParachuteDuration() const;
-    float getParachuteDurationOther() const;
-    float getParachuteDurationRankMult() const;
-    float getParachuteDurationSpeedMult() const;
-    float getParachuteLboundFraction() const;
-    float getParachuteUboundFraction() const;
-    float getParachuteMaxSpeed() const;
-
-    float getFrictionKartFriction() const;
-
-    float getBubblegumDuration() const;
-    float getBubblegumSpeedFraction() const;
-    float getBubblegumTorque() const;
-    float getBubblegumFadeInTime() const;
-    float getBubblegumShieldDuration() const;
-
-    float getZipperDuration() const;
-    float getZipperForce() const;
-    float getZipperSpeedGain() const;
-    float getZipperMaxSpeedIncrease() const;
-    float getZipperFadeOutTime() const;
-
-    float getSwatterDuration() const;
-    float getSwatterDistance() const;
-    float getSwatterSquashDuration() const;
-    float getSwatterSquashSlowdown() const;
-
-    float getPlungerBandMaxLength() const;
-    float getPlungerBandForce() const;
-    float getPlungerBandDuration() const;
-    float getPlungerBandSpeedIncrease() const;
-    float getPlungerBandFadeOutTime() const;
-    float getPlungerInFaceTime() const;
-
-    std::vector<float> getStartupTime() const;
-    std::vector<float> getStartupBoost() const;
-
-    float getRescueDuration() const;
-    float getRescueVertOffset() const;
-    float getRescueHeight() const;
-
-    float getExplosionDuration() const;
-    float getExplosionRadius() const;
-    float getExplosionInvulnerabilityTime() const;
-
-    float getNitroDuration() const;
-    float getNitroEngineForce() const;
-    float getNitroEngineMult() const;
-    float getNitroConsumption() const;
-    float getNitroSmallContainer() const;
-    float getNitroBigContainer() const;
-    float getNitroMaxSpeedIncrease() const;
-    float getNitroFadeOutTime() const;
-    float getNitroMax() const;
-
-    float getSlipstreamDurationFactor() const;
-    float getSlipstreamBaseSpeed() const;
-    float getSlipstreamLength() const;
-    float getSlipstreamWidth() const;
-    float getSlipstreamInnerFactor() const;
-    float getSlipstreamMinCollectTime() const;
-    float getSlipstreamMaxCollectTime() const;
-    float getSlipstreamAddPower() const;
-    float getSlipstreamMinSpeed() const;
-    float getSlipstreamMaxSpeedIncrease() const;
-    float getSlipstreamFadeOutTime() const;
-
-    float getSkidIncrease() const;
-    float getSkidDecrease() const;
-    float getSkidMax() const;
-    float getSkidTimeTillMax() const;
-    float getSkidVisual() const;
-    float getSkidVisualTime() const;
-    float getSkidRevertVisualTime() const;
-    float getSkidMinSpeed() const;
-    std::vector<float> getSkidTimeTillBonus() const;
-    std::vector<float> getSkidBonusSpeed() const;
-    std::vector<float> getSkidBonusTime() const;
-    std::vector<float> getSkidBonusForce() const;
-    float getSkidPhysicalJumpTime() const;
-    float getSkidGraphicalJumpTime() const;
-    float getSkidPostSkidRotateFactor() const;
-    float getSkidReduceTurnMin() const;
-    float getSkidReduceTurnMax() const;
-    bool getSkidEnabled() const;
+    float getSuspensionStiffness() const
+        { return m_table.m_suspension_stiffness; }
+    float getSuspensionRest() const
+        { return m_table.m_suspension_rest; }
+    float getSuspensionTravel() const
+        { return m_table.m_suspension_travel; }
+    bool getSuspensionExpSpringResponse() const
+        { return m_table.m_suspension_exp_spring_response; }
+    float getSuspensionMaxForce() const
+        { return m_table.m_suspension_max_force; }
+
+    float getStabilityRollInfluence() const
+        { return m_table.m_stability_roll_influence; }
+    float getStabilityChassisLinearDamping() const
+        { return m_table.m_stability_chassis_linear_damping; }
+    float getStabilityChassisAngularDamping() const
+        { return m_table.m_stability_chassis_angular_damping; }
+    float getStabilityDownwardImpulseFactor() const
+        { return m_table.m_stability_downward_impulse_factor; }
+    float getStabilityTrackConnectionAccel() const
+        { return m_table.m_stability_track_connection_accel; }
+    const std::vector<float>& getStabilityAngularFactor() const
+        { return m_table.m_stability_angular_factor; }
+    float getStabilitySmoothFlyingImpulse() const
+        { return m_table.m_stability_smooth_flying_impulse; }
+
+    const InterpolationArray& getTurnRadius() const
+        { return m_table.m_turn_radius; }
+    float getTurnTimeResetSteer() const
+        { return m_table.m_turn_time_reset_steer; }
+    const InterpolationArray& getTurnTimeFullSteer() const
+        { return m_table.m_turn_time_full_steer; }
+
+    float getEnginePower() const
+        { return m_table.m_engine_power; }
+    float getEngineMaxSpeed() const
+        { return m_table.m_engine_max_speed; }
+    float getEngineGenericMaxSpeed() const
+        { return m_table.m_engine_generic_max_speed; }
+    float getEngineBrakeFactor() const
+        { return m_table.m_engine_brake_factor; }
+    float getEngineBrakeTimeIncrease() const
+        { return m_table.m_engine_brake_time_increase; }
+    float getEngineMaxSpeedReverseRatio() const
+        { return m_table.m_engine_max_speed_reverse_ratio; }
+
+    const std::vector<float>& getGearSwitchRatio() const
+        { return m_table.m_gear_switch_ratio; }
+    const std::vector<float>& getGearPowerIncrease() const
+        { return m_table.m_gear_power_increase; }
+
+    float getMass() const
+        { return m_table.m_mass; }
+
+    float getWheelsDampingRelaxation() const
+        { return m_table.m_wheels_damping_relaxation; }
+    float getWheelsDampingCompression() const
+        { return m_table.m_wheels_damping_compression; }
+
+    float getJumpAnimationTime() const
+        { return m_table.m_jump_animation_time; }
+
+    float getLeanMax() const
+        { return m_table.m_lean_max; }
+    float getLeanSpeed() const
+        { return m_table.m_lean_speed; }
+
+    float getAnvilDuration() const
+        { return m_table.m_anvil_duration; }
+    float getAnvilWeight() const
+        { return m_table.m_anvil_weight; }
+    float getAnvilSpeedFactor() const
+        { return m_table.m_anvil_speed_factor; }
+
+    float getParachuteFriction() const
+        { return m_table.m_parachute_friction; }
+    float getParachuteDuration() const
+        { return m_table.m_parachute_duration; }
+    float getParachuteDurationOther() const
+        { return m_table.m_parachute_duration_other; }
+    float getParachuteDurationRankMult() const
+        { return m_table.m_parachute_duration_rank_mult; }
+    float getParachuteDurationSpeedMult() const
+        { return m_table.m_parachute_duration_speed_mult; }
+    float getParachuteLboundFraction() const
+        { return m_table.m_parachute_lbound_fraction; }
+    float getParachuteUboundFraction() const
+        { return m_table.m_parachute_ubound_fraction; }
+    float getParachuteMaxSpeed() const
+        { return m_table.m_parachute_max_speed; }
+
+    float getFrictionKartFriction() const
+        { return m_table.m_friction_kart_friction; }
+
+    float getBubblegumDuration() const
+        { return m_table.m_bubblegum_duration; }
+    float getBubblegumSpeedFraction() const
+        { return m_table.m_bubblegum_speed_fraction; }
+    float getBubblegumTorque() const
+        { return m_table.m_bubblegum_torque; }
+    float getBubblegumFadeInTime() const
+        { return m_table.m_bubblegum_fade_in_time; }
+    float getBubblegumShieldDuration() const
+        { return m_table.m_bubblegum_shield_duration; }
+
+    float getZipperDuration() const
+        { return m_table.m_zipper_duration; }
+    float getZipperForce() const
+        { return m_table.m_zipper_force; }
+    float getZipperSpeedGain() const
+        { return m_table.m_zipper_speed_gain; }
+    float getZipperMaxSpeedIncrease() const
+        { return m_table.m_zipper_max_speed_increase; }
+    float getZipperFadeOutTime() const
+        { return m_table.m_zipper_fade_out_time; }
+
+    float getSwatterDuration() const
+        { return m_table.m_swatter_duration; }
+    float getSwatterDistance() const
+        { return m_table.m_swatter_distance; }
+    float getSwatterSquashDuration() const
+        { return m_table.m_swatter_squash_duration; }
+    float getSwatterSquashSlowdown() const
+        { return m_table.m_swatter_squash_slowdown; }
+
+    float getPlungerBandMaxLength() const
+        { return m_table.m_plunger_band_max_length; }
+    float getPlungerBandForce() const
+        { return m_table.m_plunger_band_force; }
+    float getPlungerBandDuration() const
+        { return m_table.m_plunger_band_duration; }
+    float getPlungerBandSpeedIncrease() const
+        { return m_table.m_plunger_band_speed_increase; }
+    float getPlungerBandFadeOutTime() const
+        { return m_table.m_plunger_band_fade_out_time; }
+    float getPlungerInFaceTime() const
+        { return m_table.m_plunger_in_face_time; }
+
+    const std::vector<float>& getStartupTime() const
+        { return m_table.m_startup_time; }
+    const std::vector<float>& getStartupBoost() const
+        { return m_table.m_startup_boost; }
+
+    float getRescueDuration() const
+        { return m_table.m_rescue_duration; }
+    float getRescueVertOffset() const
+        { return m_table.m_rescue_vert_offset; }
+    float getRescueHeight() const
+        { return m_table.m_rescue_height; }
+
+    float getExplosionDuration() const
+        { return m_table.m_explosion_duration; }
+    float getExplosionRadius() const
+        { return m_table.m_explosion_radius; }
+    float getExplosionInvulnerabilityTime() const
+        { return m_table.m_explosion_invulnerability_time; }
+
+    float getNitroDuration() const
+        { return m_table.m_nitro_duration; }
+    float getNitroEngineForce() const
+        { return m_table.m_nitro_engine_force; }
+    float getNitroEngineMult() const
+        { return m_table.m_nitro_engine_mult; }
+    float getNitroConsumption() const
+        { return m_table.m_nitro_consumption; }
+    float getNitroSmallContainer() const
+        { return m_table.m_nitro_small_container; }
+    float getNitroBigContainer() const
+        { return m_table.m_nitro_big_container; }
+    float getNitroMaxSpeedIncrease() const
+        { return m_table.m_nitro_max_speed_increase; }
+    float getNitroFadeOutTime() const
+        { return m_table.m_nitro_fade_out_time; }
+    float getNitroMax() const
+        { return m_table.m_nitro_max; }
+
+    float getSlipstreamDurationFactor() const
+        { return m_table.m_slipstream_duration_factor; }
+    float getSlipstreamBaseSpeed() const
+        { return m_table.m_slipstream_base_speed; }
+    float getSlipstreamLength() const
+        { return m_table.m_slipstream_length; }
+    float getSlipstreamWidth() const
+        { return m_table.m_slipstream_width; }
+    float getSlipstreamInnerFactor() const
+        { return m_table.m_slipstream_inner_factor; }
+    float getSlipstreamMinCollectTime() const
+        { return m_table.m_slipstream_min_collect_time; }
+    float getSlipstreamMaxCollectTime() const
+        { return m_table.m_slipstream_max_collect_time; }
+    float getSlipstreamAddPower() const
+        { return m_table.m_slipstream_add_power; }
+    float getSlipstreamMinSpeed() const
+        { return m_table.m_slipstream_min_speed; }
+    float getSlipstreamMaxSpeedIncrease() const
+        { return m_table.m_slipstream_max_speed_increase; }
+    float getSlipstreamFadeOutTime() const
+        { return m_table.m_slipstream_fade_out_time; }
+
+    float getSkidIncrease() const
+        { return m_table.m_skid_increase; }
+    float getSkidDecrease() const
+        { return m_table.m_skid_decrease; }
+    float getSkidMax() const
+        { return m_table.m_skid_max; }
+    float getSkidTimeTillMax() const
+        { return m_table.m_skid_time_till_max; }
+    float getSkidVisual() const
+        { return m_table.m_skid_visual; }
+    float getSkidVisualTime() const
+        { return m_table.m_skid_visual_time; }
+    float getSkidRevertVisualTime() const
+        { return m_table.m_skid_revert_visual_time; }
+    float getSkidMinSpeed() const
+        { return m_table.m_skid_min_speed; }
+    const std::vector<float>& getSkidTimeTillBonus() const
+        { return m_table.m_skid_time_till_bonus; }
+    const std::vector<float>& getSkidBonusSpeed() const
+        { return m_table.m_skid_bonus_speed; }
+    const std::vector<float>& getSkidBonusTime() const
+        { return m_table.m_skid_bonus_time; }
+    const std::vector<float>& getSkidBonusForce() const
+        { return m_table.m_skid_bonus_force; }
+    float getSkidPhysicalJumpTime() const
+        { return m_table.m_skid_physical_jump_time; }
+    float getSkidGraphicalJumpTime() const
+        { return m_table.m_skid_graphical_jump_time; }
+    float getSkidPostSkidRotateFactor() const
+        { return m_table.m_skid_post_skid_rotate_factor; }
+    float getSkidReduceTurnMin() const
+        { return m_table.m_skid_reduce_turn_min; }
+    float getSkidReduceTurnMax() const
+        { return m_table.m_skid_reduce_turn_max; }
+    bool getSkidEnabled() const
+        { return m_table.m_skid_enabled; }
 
     /* <characteristics-end kpdefs> */
     
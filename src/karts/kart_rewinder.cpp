@@ -27,6 +27,7 @@
 #include "karts/explosion_animation.hpp"
 #include "karts/rescue_animation.hpp"
 #include "karts/controller/player_controller.hpp"
+#include "karts/kart_local_states.hpp"
 #include "karts/kart_properties.hpp"
 #include "karts/max_speed.hpp"
 #include "karts/skidding.hpp"
@@ -230,7 +231,8 @@ BareNetworkString* KartRewinder::saveState(std::vector<std::string>* ru)
     else
     {
         CompressNetworkBody::compress(
-            m_body.get(), m_motion_state.get(), buffer);
+            m_body.get(), m_motion_state.get(), buffer,
+            !RewindManager::get()->isSavingPrediction());
 
         if (m_vehicle->getTimedRotationTicks() > 0)
         {
@@ -450,51 +452,56 @@ void KartRewinder::update(int ticks)
 }   // update
 
 // ----------------------------------------------------------------------------
-std::function<void()> KartRewinder::getLocalStateRestoreFunction()
+/** Saves the values which only depend on the kart itself (and so are not
+ *  part of the network state) into the local states of all karts.
+ *  \param states The local states, which must have an entry for this kart.
+ */
+void KartRewinder::saveLocalState(KartLocalStates *states) const
 {
-    if (m_eliminated)
-        return nullptr;
+    const unsigned int id = getWorldKartId();
+    if (m_eliminated || id >= states->m_saved.size())
+        return;
 
-    // Variable can be saved locally if its adjustment only depends on the kart
-    // itself
-    int brake_ticks = m_brake_ticks;
-    int8_t min_nitro_ticks = m_min_nitro_ticks;
+    states->m_saved[id]           = 1;
+    states->m_brake_ticks[id]     = m_brake_ticks;
+    states->m_min_nitro_ticks[id] = m_min_nitro_ticks;
 
     // Controller local state
-    int steer_val_l = 0;
-    int steer_val_r = 0;
     PlayerController* pc = dynamic_cast<PlayerController*>(m_controller);
-    if (pc)
-    {
-        steer_val_l = pc->m_steer_val_l;
-        steer_val_r = pc->m_steer_val_r;
-    }
+    states->m_steer_val_l[id] = pc ? pc->m_steer_val_l : 0;
+    states->m_steer_val_r[id] = pc ? pc->m_steer_val_r : 0;
 
     // Max speed local state (terrain)
-    float current_fraction = m_max_speed->m_speed_decrease
-        [MaxSpeed::MS_DECREASE_TERRAIN].m_current_fraction;
-    uint16_t max_speed_fraction = m_max_speed->m_speed_decrease
-        [MaxSpeed::MS_DECREASE_TERRAIN].m_max_speed_fraction;
+    const MaxSpeed::SpeedDecrease &terrain =
+        m_max_speed->m_speed_decrease[MaxSpeed::MS_DECREASE_TERRAIN];
+    states->m_terrain_current_fraction[id]   = terrain.m_current_fraction;
+    states->m_terrain_max_speed_fraction[id] = terrain.m_max_speed_fraction;
 
     // Skidding local state
-    float remaining_jump_time = m_skidding->m_remaining_jump_time;
+    states->m_remaining_jump_time[id] = m_skidding->m_remaining_jump_time;
+}   // saveLocalState
 
-    return [brake_ticks, min_nitro_ticks,
-        steer_val_l, steer_val_r, current_fraction,
-        max_speed_fraction, remaining_jump_time, this]()
+// ----------------------------------------------------------------------------
+/** Restores the values saved with saveLocalState(), if this kart was saved.
+ *  \param states The local states of all karts.
+ */
+void KartRewinder::restoreLocalState(const KartLocalStates &states)
+{
+    const unsigned int id = getWorldKartId();
+    if (id >= states.m_saved.size() || !states.m_saved[id])
+        return;
+
+    m_brake_ticks     = states.m_brake_ticks[id];
+    m_min_nitro_ticks = states.m_min_nitro_ticks[id];
+    PlayerController* pc = dynamic_cast<PlayerController*>(m_controller);
+    if (pc)
     {
-        m_brake_ticks = brake_ticks;
-        m_min_nitro_ticks = min_nitro_ticks;
-        PlayerController* pc = dynamic_cast<PlayerController*>(m_controller);
-        if (pc)
-        {
-            pc->m_steer_val_l = steer_val_l;
-            pc->m_steer_val_r = steer_val_r;
-        }
-        m_max_speed->m_speed_decrease[MaxSpeed::MS_DECREASE_TERRAIN]
-            .m_current_fraction = current_fraction;
-        m_max_speed->m_speed_decrease[MaxSpeed::MS_DECREASE_TERRAIN]
-            .m_max_speed_fraction = max_speed_fraction;
-        m_skidding->m_remaining_jump_time = remaining_jump_time;
-    };
-}   // getLocalStateRestoreFunction
+        pc->m_steer_val_l = states.m_steer_val_l[id];
+        pc->m_steer_val_r = states.m_steer_val_r[id];
+    }
+    MaxSpeed::SpeedDecrease &terrain =
+        m_max_speed->m_speed_decrease[MaxSpeed::MS_DECREASE_TERRAIN];
+    terrain.m_current_fraction   = states.m_terrain_current_fraction[id];
+    terrain.m_max_speed_fraction = states.m_terrain_max_speed_fraction[id];
+    m_skidding->m_remaining_jump_time = states.m_remaining_jump_time[id];
+}   // restoreLocalState
@@ -25,6 +25,7 @@
 
 class AbstractKart;
 class BareNetworkString;
+struct KartLocalStates;
 
 class KartRewinder : public Rewinder, public Kart
 {
@@ -72,7 +73,9 @@ public:
     // -------------------------------------------------------------------------
     virtual void undoEvent(BareNetworkString *p) OVERRIDE {}
     // ------------------------------------------------------------------------
-    virtual std::function<void()> getLocalStateRestoreFunction() OVERRIDE;
+    void saveLocalState(KartLocalStates *states) const;
+    // ------------------------------------------------------------------------
+    void restoreLocalState(const KartLocalStates &states);
 
 
 };   // Rewinder
@@ -125,6 +125,17 @@ public:
                              float restitution);
     const btTransform
                  &getTrans() const {return m_transform;}
+    // ------------------------------------------------------------------------
+    /** Returns the transform that the next call to update() will take from
+     *  the physics body. */
+    btTransform   getPhysicsTrans() const
+    {
+        if (m_body->getInvMass() == 0)
+            return m_transform;
+        btTransform t;
+        m_motion_state->getWorldTransform(t);
+        return t;
+    }   // getPhysicsTrans
     void          setTrans(const btTransform& t);
     void          updatePosition();
     // ------------------------------------------------------------------------
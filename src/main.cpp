@@ -242,14 +242,20 @@ extern "C" {
 #include "karts/kart_properties.hpp"
 #include "karts/kart_properties_manager.hpp"
 #include "karts/official_karts.hpp"
+#include "modes/ai_race_runner.hpp"
 #include "modes/cutscene_world.hpp"
 #include "modes/demo_world.hpp"
+#include "modes/kart_proximity.hpp"
+#include "modes/simulation_benchmark.hpp"
+#include "network/connection_limiter.hpp"
+#include "network/database_connector.hpp"
 #include "network/protocols/connect_to_server.hpp"
 #include "network/protocols/client_lobby.hpp"
 #include "network/protocols/server_lobby.hpp"
 #include "network/network.hpp"
 #include "network/network_config.hpp"
 #include "network/network_string.hpp"
+#include "network/network_timer_synchronizer.hpp"
 #include "network/protocols/connect_to_server.hpp"
 #include "network/protocols/client_lobby.hpp"
 #include "network/protocols/server_lobby.hpp"
@@ -258,8 +264,10 @@ extern "C" {
 #include "network/rewind_queue.hpp"
 #include "network/server.hpp"
 #include "network/server_config.hpp"
+#include "network/server_metrics.hpp"
 #include "network/servers_manager.hpp"
 #include "network/socket_address.hpp"
+#include "network/state_checkpoint.hpp"
 #include "network/stk_host.hpp"
 #include "network/stk_peer.hpp"
 #include "online/profile_manager.hpp"
@@ -268,6 +276,7 @@ extern "C" {
 #include "race/highscore_manager.hpp"
 #include "race/history.hpp"
 #include "race/race_manager.hpp"
+#include "replay/replay_file.hpp"
 #include "replay/replay_play.hpp"
 #include "replay/replay_recorder.hpp"
 #include "states_screens/main_menu_screen.hpp"
@@ -279,7 +288,9 @@ extern "C" {
 #include "states_screens/dialogs/message_dialog.hpp"
 #include "tips/tips_manager.hpp"
 #include "tracks/arena_graph.hpp"
+#include "tracks/drive_graph.hpp"
 #include "tracks/track.hpp"
+#include "tracks/track_cache.hpp"
 #include "tracks/track_manager.hpp"
 #include "utils/command_line.hpp"
 #include "utils/constants.hpp"
@@ -592,6 +603,27 @@ void cmdLineHelp()
                               "laps.\n"
     "       --profile-time=n   Enable automatic driven profile mode for n "
                               "seconds.\n"
+    "       --profiler-trace=file Write all profiler markers of all threads\n"
+    "                          continuously to file in the Chrome trace\n"
+    "                          format (for chrome://tracing or Perfetto).\n"
+    "       --sim-benchmark=file Run the simulation without graphics for all\n"
+    "                          combinations of tracks and kart numbers, and\n"
+    "                          write the profiler timings as JSON to file.\n"
+    "       --sim-benchmark-tracks=t1,t2 Tracks to use (default all race tracks).\n"
+    "       --sim-benchmark-karts=n1,n2 Numbers of AI karts to use (default 4,8).\n"
+    "       --sim-benchmark-ticks=n Number of time steps to measure per race.\n"
+    "       --ai-races=file    Run AI-only races without graphics for all\n"
+    "                          combinations of tracks, karts, difficulties and seeds,\n"
+    "                          and write the results to file (.csv or .json).\n"
+    "       --ai-races-tracks=t1,t2 Tracks to use (default all race tracks).\n"
+    "       --ai-races-karts=k1+k2,k3+k4 Karts of each race (default 4 default karts).\n"
+    "       --ai-races-difficulties=d1,d2 Difficulties (easy, medium, hard, best).\n"
+    "       --ai-races-seeds=s1,s2 Random seeds to race each combination with.\n"
+    "       --ai-races-laps=n  Number of laps of each race (default 3).\n"
+    "       --ai-races-max-time=s Stop a race after s seconds (default 600).\n"
+    "       --ai-races-worker=i,n Only run every n-th race, starting with race i.\n"
+    "       --ai-threads=n     Number of threads used to compute the AI (0 = main\n"
+    "                          thread only).\n"
     "       --unlock-all       Permanently unlock all karts and tracks for testing.\n"
     "       --no-unlock-all    Disable unlock-all (i.e. base unlocking on player achievement).\n"
     "       --xmas=n           Toggle Xmas/Christmas mode. n=0 Use current date, n=1, Always enable,\n"
@@ -610,6 +642,10 @@ void cmdLineHelp()
     "       --server-config=file Specify the server_config.xml for server hosting, it will create\n"
     "                            one if not found.\n"
     "       --network-console  Enable network console.\n"
+    "       --db-benchmark=file Measure the database writes of 10000 player\n"
+    "                          connections with a new database file.\n"
+    "       --convert-replay=file Convert a replay file between the text\n"
+    "                          and the binary format.\n"
     "       --wan-server=name  Start a Wan server (not a playing client).\n"
     "       --public-server    Allow direct connection to the server (without stk server)\n"
     "       --lan-server=name  Start a LAN server (not a playing client).\n"
@@ -620,6 +656,14 @@ void cmdLineHelp()
     "       --server-id=n      Server id in stk addons for --connect-now.\n"
     "       --network-ai=n     Numbers of AI for connecting to linear race server, used\n"
     "                          together with --connect-now.\n"
+    "       --network-ai-lod[=a,b,d,n,i] Update network AIs far (more than d m,\n"
+    "                          default 50) from any human every a (default 60) ticks,\n"
+    "                          or every b (default 90) ticks when driving straight,\n"
+    "                          with at most n (default 4) such updates per tick,\n"
+    "                          interpolating steering over i (default 10) ticks.\n"
+    "       --network-ai-stats Log the time used by network AIs periodically.\n"
+    "       --rewind-stats     Log the number of rewinds (and rewinds skipped since\n"
+    "                          the prediction was correct) periodically.\n"
     "       --login=s          Automatically log in (set the login).\n"
     "       --password=s       Automatically log in (set the password).\n"
     "       --init-user        Save the above login and password (if set) in config.\n"
@@ -652,6 +696,9 @@ void cmdLineHelp()
     "       --log=N            Set the verbosity to a value between\n"
     "                          0 (Debug) and 5 (Only Fatal messages)\n"
     "       --logbuffer=N      Buffers up to N lines log lines before writing.\n"
+    "       --async-log        Write log lines in a separate thread, so that\n"
+    "                          logging does not block the game or network\n"
+    "                          threads (ignores --logbuffer).\n"
     "       --root=DIR         Path to add to the list of STK root directories.\n"
     "                          You can specify more than one by separating them\n"
     "                          with colons (:).\n"
@@ -792,6 +839,8 @@ int handleCmdLineOutputModifier()
         Log::setLogLevel(n);
     if (CommandLine::has("--logbuffer", &n))
         Log::setBufferSize(n);
+    if (CommandLine::has("--async-log"))
+        Log::setAsync(true);
 
     if(CommandLine::has("--log=nocolor"))
     {
@@ -801,6 +850,24 @@ int handleCmdLineOutputModifier()
     if(CommandLine::has("--no-console-log"))
         Log::toggleConsoleLog(false);
 
+    std::string s;
+    if (CommandLine::has("--db-benchmark", &s))
+    {
+#ifdef ENABLE_SQLITE3
+        DatabaseConnector::benchmark(s);
+#else
+        Log::error("main", "STK was compiled without sqlite3 support.");
+#endif
+        cleanUserConfig();
+        exit(0);
+    }
+    if (CommandLine::has("--convert-replay", &s))
+    {
+        const bool success = ReplayFile::convert(s);
+        cleanUserConfig();
+        exit(success ? 0 : 1);
+    }
+
     return 0;
 }
 
@@ -1001,9 +1068,13 @@ int handleCmdLinePreliminary()
     if (CommandLine::has("--seed", &n))
     {
         srand(n);
+        SimulationBenchmark::setSeed(n);
         Log::info("main", "STK using random seed (%d)", n);
     }
 
+    if (CommandLine::has("--ai-threads", &n))
+        UserConfigParams::m_ai_threads = n;
+
     if (CommandLine::has("--disable-addon-karts"))
         UserConfigParams::m_disable_addon_karts = true;
     if (CommandLine::has("--disable-addon-tracks"))
@@ -1155,6 +1226,24 @@ int handleCmdLine(bool has_server_config, bool has_parent_process)
     else
         NetworkAIController::setAIFrequency(30);
 
+    if (CommandLine::has("--network-ai-lod", &s))
+    {
+        std::vector<int> lod = { 60, 90, 50, 4, 10 };
+        std::vector<std::string> values = StringUtils::split(s, ',');
+        for (unsigned int i = 0; i < values.size() && i < lod.size(); i++)
+            StringUtils::fromString(values[i], lod[i]);
+        NetworkAIController::enableLOD(lod[0], lod[1], (float)lod[2], lod[3],
+                                       lod[4]);
+    }
+    else if (CommandLine::has("--network-ai-lod"))
+        NetworkAIController::enableLOD(60, 90, 50.0f, 4, 10);
+    if (CommandLine::has("--network-ai-stats"))
+        NetworkAIController::setLogStats(true);
+    if (CommandLine::has("--rewind-stats"))
+        RewindManager::setLogStats(true);
+    if (CommandLine::has("--profiler-trace", &s))
+        profiler.startTrace(s);
+
     if (!can_wan && CommandLine::has("--login-id", &n) &&
         CommandLine::has("--token", &s))
     {
@@ -1506,6 +1595,11 @@ int handleCmdLine(bool has_server_config, bool has_parent_process)
             Log::info("main", "Creating a LAN server '%s'.",
                 server_name.c_str());
         }
+        if (GUIEngine::isNoGraphics())
+        {
+            TrackCache::create(
+                (uint64_t)ServerConfig::m_track_cache_size * 1024 * 1024);
+        }
     }
 
     if (CommandLine::has("--auto-connect"))
@@ -1726,6 +1820,61 @@ int handleCmdLine(bool has_server_config, bool has_parent_process)
         RaceManager::get()->setNumLaps(999999); // profile end depends on time
     }   // --profile-time
 
+    if (SimulationBenchmark::isEnabled())
+    {
+        if (CommandLine::has("--sim-benchmark-tracks", &s))
+            SimulationBenchmark::setTracks(StringUtils::split(s, ','));
+        if (CommandLine::has("--sim-benchmark-karts", &s))
+        {
+            std::vector<int> num_karts;
+            for (const std::string &karts : StringUtils::split(s, ','))
+            {
+                int k = 0;
+                if (StringUtils::fromString(karts, k))
+                    num_karts.push_back(k);
+            }
+            SimulationBenchmark::setNumKarts(num_karts);
+        }
+        if (CommandLine::has("--sim-benchmark-ticks", &n) && n > 0)
+            SimulationBenchmark::setNumTicks(n);
+        UserConfigParams::m_no_start_screen = true;
+    }   // --sim-benchmark
+
+    if (AIRaceRunner::isEnabled())
+    {
+        if (CommandLine::has("--ai-races-tracks", &s))
+            AIRaceRunner::setTracks(StringUtils::split(s, ','));
+        if (CommandLine::has("--ai-races-karts", &s))
+        {
+            std::vector<std::vector<std::string> > kart_lists;
+            for (const std::string &karts : StringUtils::split(s, ','))
+                kart_lists.push_back(StringUtils::split(karts, '+'));
+            AIRaceRunner::setKartLists(kart_lists);
+        }
+        if (CommandLine::has("--ai-races-difficulties", &s) &&
+            !AIRaceRunner::setDifficulties(StringUtils::split(s, ',')))
+        {
+            cleanSuperTuxKart();
+            return false;
+        }
+        if (CommandLine::has("--ai-races-seeds", &s))
+            AIRaceRunner::setSeeds(StringUtils::splitToUInt(s, ','));
+        if (CommandLine::has("--ai-races-laps", &n) && n > 0)
+            AIRaceRunner::setNumLaps(n);
+        if (CommandLine::has("--ai-races-max-time", &n) && n > 0)
+            AIRaceRunner::setMaxTime((float)n);
+        if (CommandLine::has("--ai-races-worker", &s))
+        {
+            std::vector<uint32_t> worker = StringUtils::splitToUInt(s, ',');
+            if (worker.size() == 2 && worker[0] < worker[1])
+                AIRaceRunner::setWorker(worker[0], worker[1]);
+            else
+                Log::warn("main", "Invalid --ai-races-worker '%s'.",
+                          s.c_str());
+        }
+        UserConfigParams::m_no_start_screen = true;
+    }   // --ai-races
+
     if(CommandLine::has("--history"))
     {
         history->setReplayHistory(true);
@@ -2186,8 +2335,13 @@ int main(int argc, char *argv[])
         if (CommandLine::has("--stdout-dir", &s))
             FileManager::setStdoutDir(s);
 
+        if (CommandLine::has("--sim-benchmark", &s))
+            SimulationBenchmark::enable(s);
+        if (CommandLine::has("--ai-races", &s))
+            AIRaceRunner::enable(s);
 #ifndef SERVER_ONLY
-        if(CommandLine::has("--no-graphics") || CommandLine::has("-l"))
+        if(CommandLine::has("--no-graphics") || CommandLine::has("-l") ||
+           SimulationBenchmark::isEnabled() || AIRaceRunner::isEnabled())
 #endif
             GUIEngine::disableGraphics();
 
@@ -2561,9 +2715,23 @@ int main(int argc, char *argv[])
             }   // if !online
         }
 
+        // Simulation benchmark
+        // ====================
+        if (SimulationBenchmark::isEnabled())
+        {
+            SimulationBenchmark::run();
+            main_loop->abort();
+        }
+        // Batch of AI races
+        // =================
+        else if (AIRaceRunner::isEnabled())
+        {
+            AIRaceRunner::run();
+            main_loop->abort();
+        }
         // Not replaying
         // =============
-        if(!ProfileWorld::isProfileMode())
+        else if(!ProfileWorld::isProfileMode())
         {
             if(UserConfigParams::m_no_start_screen)
             {
@@ -2628,6 +2796,7 @@ int main(int argc, char *argv[])
     MemoryLeaks::checkForLeaks();
 #endif
 
+    Log::setAsync(false);
     Log::flushBuffers();
 
 #ifndef WIN32
@@ -2718,6 +2887,7 @@ static void cleanSuperTuxKart()
     if(powerup_manager)         delete powerup_manager;
     ProjectileManager::destroy();
     if(kart_properties_manager) delete kart_properties_manager;
+    TrackCache::destroy();
     if(track_manager)           delete track_manager;
     if(material_manager)        delete material_manager;
     if(history)                 delete history;
@@ -2774,6 +2944,7 @@ static void cleanSuperTuxKart()
 #endif
 
     ServersManager::deallocate();
+    profiler.stopTrace();
     cleanUserConfig();
 
     StateManager::deallocate();
@@ -2855,12 +3026,47 @@ void runUnitTests()
     Log::info("UnitTest", "Arena Graph");
     ArenaGraph::unitTesting();
 
+    Log::info("UnitTest", "Drive Graph");
+    DriveGraph::unitTesting();
+
     Log::info("UnitTest", "Fonts for translation");
     font_manager->unitTesting();
 
     Log::info("UnitTest", "RewindQueue");
     RewindQueue::unitTesting();
 
+    Log::info("UnitTest", "Race positions");
+    KartProximity::unitTesting();
+
+    Log::info("UnitTest", "ServerMetrics");
+    ServerMetrics::unitTesting();
+
+    Log::info("UnitTest", "Profiler trace");
+    Profiler::unitTesting();
+
+    Log::info("UnitTest", "NetworkTimerSynchronizer");
+    NetworkTimerSynchronizer::unitTesting();
+
+    Log::info("UnitTest", "ServersManager");
+    ServersManager::unitTesting();
+
+    Log::info("UnitTest", "ConnectionLimiter");
+    ConnectionLimiter::unitTesting();
+
+#ifdef ENABLE_SQLITE3
+    Log::info("UnitTest", "DatabaseConnector");
+    DatabaseConnector::unitTesting();
+#endif
+
+    Log::info("UnitTest", "StateCheckpoint");
+    StateCheckpoint::unitTesting();
+
+    Log::info("UnitTest", "ReplayFile");
+    ReplayFile::unitTesting();
+
+    Log::info("UnitTest", "TrackCache");
+    TrackCache::unitTesting();
+
     Log::info("UnitTest", "=====================");
     Log::info("UnitTest", "Testing successful   ");
     Log::info("UnitTest", "=====================");
@@ -45,6 +45,7 @@
 #include "network/race_event_manager.hpp"
 #include "network/rewind_manager.hpp"
 #include "network/server.hpp"
+#include "network/server_metrics.hpp"
 #include "network/stk_host.hpp"
 #include "online/request_manager.hpp"
 #include "race/history.hpp"
@@ -625,6 +626,8 @@ void MainLoop::run()
                 num_steps > stk_config->time2Ticks(1.0f);
             for (int i = 0; i < num_steps; i++)
             {
+                ServerMetrics::ScopedTimer tick_timer(
+                    ServerMetrics::HT_TICK_DURATION);
                 if (World::getWorld() && history->replayHistory())
                 {
                     history->updateReplay(
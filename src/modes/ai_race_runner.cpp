@@ -0,0 +1,317 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "modes/ai_race_runner.hpp"
+
+#include "config/stk_config.hpp"
+#include "config/user_config.hpp"
+#include "items/item_manager.hpp"
+#include "items/powerup_manager.hpp"
+#include "karts/abstract_kart.hpp"
+#include "karts/kart_properties_manager.hpp"
+#include "tracks/track.hpp"
+#include "tracks/track_manager.hpp"
+#include "utils/constants.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
+#include "utils/profiler.hpp"
+#include "utils/string_utils.hpp"
+
+#include <cstdlib>
+#include <fstream>
+
+std::string                            AIRaceRunner::m_output_file;
+std::vector<std::string>               AIRaceRunner::m_tracks;
+std::vector<std::vector<std::string> > AIRaceRunner::m_kart_lists;
+std::vector<RaceManager::Difficulty>   AIRaceRunner::m_difficulties;
+std::vector<uint32_t>                  AIRaceRunner::m_seeds;
+int                                    AIRaceRunner::m_num_laps     = 3;
+float                                  AIRaceRunner::m_max_time     = 600.0f;
+int                                    AIRaceRunner::m_worker_index = 0;
+int                                    AIRaceRunner::m_num_workers  = 1;
+uint32_t                               AIRaceRunner::m_seed         = 1;
+
+//-----------------------------------------------------------------------------
+AIRaceRunner::AIRaceRunner() : StandardRace()
+{
+    m_use_highscores = false;
+}   // AIRaceRunner
+
+//-----------------------------------------------------------------------------
+/** After the track is loaded the random number generators are seeded again
+ *  (the item manager uses the current time otherwise), so that races with
+ *  the same seed are reproducible.
+ */
+void AIRaceRunner::init()
+{
+    StandardRace::init();
+    srand(m_seed);
+    ItemManager::updateRandomSeed(m_seed);
+    powerup_manager->setRandomSeed(m_seed);
+}   // init
+
+//-----------------------------------------------------------------------------
+/** Sets the difficulties to race with.
+ *  \param names The difficulties as returned by getDifficultyAsString().
+ *  \return False if a name is unknown.
+ */
+bool AIRaceRunner::setDifficulties(const std::vector<std::string> &names)
+{
+    m_difficulties.clear();
+    for (const std::string &name : names)
+    {
+        bool found = false;
+        for (int d = RaceManager::DIFFICULTY_FIRST;
+             d <= RaceManager::DIFFICULTY_LAST; d++)
+        {
+            RaceManager::Difficulty diff = (RaceManager::Difficulty)d;
+            if (RaceManager::get()->getDifficultyAsString(diff) == name)
+            {
+                m_difficulties.push_back(diff);
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            Log::error("AIRaceRunner", "Unknown difficulty '%s'.",
+                       name.c_str());
+            return false;
+        }
+    }
+    return true;
+}   // setDifficulties
+
+//-----------------------------------------------------------------------------
+/** Runs all races of this process and writes the results to the output
+ *  file.
+ */
+void AIRaceRunner::run()
+{
+    if (m_tracks.empty())
+    {
+        std::vector<std::string> all_tracks =
+            track_manager->getAllTrackIdentifiers();
+        for (const std::string &ident : all_tracks)
+        {
+            Track *track = track_manager->getTrack(ident);
+            if (track && track->isRaceTrack() && !track->isAddon())
+                m_tracks.push_back(ident);
+        }
+    }
+    if (m_kart_lists.empty())
+    {
+        m_kart_lists.push_back(std::vector<std::string>(4,
+                                           UserConfigParams::m_default_kart));
+    }
+    if (m_difficulties.empty())
+        m_difficulties.push_back(RaceManager::DIFFICULTY_HARD);
+    if (m_seeds.empty())
+        m_seeds.push_back(1);
+
+    std::vector<RaceResult> results;
+    int index = 0;
+    const double start = getTimeMilliseconds();
+    for (const std::string &track : m_tracks)
+    {
+        for (const std::vector<std::string> &karts : m_kart_lists)
+        {
+            for (RaceManager::Difficulty difficulty : m_difficulties)
+            {
+                for (uint32_t seed : m_seeds)
+                {
+                    if (index++ % m_num_workers != m_worker_index)
+                        continue;
+                    m_seed = seed;
+                    RaceResult result;
+                    result.m_index = index - 1;
+                    if (runRace(track, karts, difficulty, &result))
+                        results.push_back(result);
+                }
+            }
+        }
+    }
+    Log::info("AIRaceRunner", "%d races run in %f s.", (int)results.size(),
+              (getTimeMilliseconds() - start) / 1000.0);
+
+    std::ofstream f(FileUtils::getPortableWritingPath(m_output_file));
+    if (!f.is_open())
+    {
+        Log::error("AIRaceRunner", "Can't write results to '%s'.",
+                   m_output_file.c_str());
+        return;
+    }
+    if (StringUtils::getExtension(m_output_file) == "csv")
+        writeCSV(results, f);
+    else
+        writeJSON(results, f);
+    f.close();
+    Log::info("AIRaceRunner", "Results written to '%s'.",
+              m_output_file.c_str());
+}   // run
+
+//-----------------------------------------------------------------------------
+/** Runs one race till all karts have finished or m_max_time is reached.
+ *  The world is deleted with RaceManager::exitRace, so the next race reuses
+ *  all loaded karts and managers.
+ *  \param track Identifier of the track.
+ *  \param karts The karts of the race.
+ *  \param difficulty The difficulty to use.
+ *  \param result On return the result of the race.
+ *  \return False if the race could not be run.
+ */
+bool AIRaceRunner::runRace(const std::string &track,
+                           const std::vector<std::string> &karts,
+                           RaceManager::Difficulty difficulty,
+                           RaceResult *result)
+{
+    if (!track_manager->getTrack(track))
+    {
+        Log::error("AIRaceRunner", "Unknown track '%s'.", track.c_str());
+        return false;
+    }
+    for (const std::string &kart : karts)
+    {
+        if (!kart_properties_manager->getKart(kart))
+        {
+            Log::error("AIRaceRunner", "Unknown kart '%s'.", kart.c_str());
+            return false;
+        }
+    }
+    if (karts.empty() || (int)karts.size() > stk_config->m_max_karts)
+    {
+        Log::error("AIRaceRunner", "Invalid number of karts %d.",
+                   (int)karts.size());
+        return false;
+    }
+
+    RaceManager *rm = RaceManager::get();
+    rm->setMajorMode(RaceManager::MAJOR_MODE_SINGLE);
+    rm->setMinorMode(RaceManager::MINOR_MODE_NORMAL_RACE);
+    rm->setDifficulty(difficulty);
+    rm->setNumPlayers(0);
+    rm->setNumKarts((int)karts.size());
+    rm->clearDefaultAIKartList();
+    rm->setDefaultAIKartList(karts);
+    rm->setTrack(track);
+    rm->setReverseTrack(false);
+    rm->setNumLaps(m_num_laps);
+    rm->setupPlayerKartInfo();
+    rm->startNew(false);
+
+    LinearWorld *world = dynamic_cast<LinearWorld*>(World::getWorld());
+    const int max_ticks = stk_config->time2Ticks(m_max_time);
+    const double start = getTimeMilliseconds();
+    int ticks = 0;
+    while (ticks < max_ticks)
+    {
+        world->updateWorld(1);
+        world->updateTime(1);
+        ticks++;
+        bool all_finished = true;
+        for (unsigned int i = 0; i < world->getNumKarts(); i++)
+        {
+            const AbstractKart *kart = world->getKart(i);
+            if (!kart->isEliminated() && !kart->hasFinishedRace())
+            {
+                all_finished = false;
+                break;
+            }
+        }
+        if (all_finished)
+            break;
+    }
+
+    result->m_track      = track;
+    result->m_difficulty = rm->getDifficultyAsString(difficulty);
+    result->m_seed       = m_seed;
+    result->m_ticks      = ticks;
+    result->m_wall_time  = getTimeMilliseconds() - start;
+    result->m_karts.clear();
+    for (unsigned int i = 0; i < world->getNumKarts(); i++)
+    {
+        const AbstractKart *kart = world->getKart(i);
+        KartResult kr;
+        kr.m_kart        = kart->getIdent();
+        kr.m_position    = kart->getPosition();
+        kr.m_finished    = kart->hasFinishedRace();
+        kr.m_finish_time = kr.m_finished ? kart->getFinishTime() : -1.0f;
+        kr.m_distance    = world->getOverallDistance(i);
+        result->m_karts.push_back(kr);
+    }
+    rm->exitRace();
+
+    Log::info("AIRaceRunner", "Race %d on %s (%s, seed %u): %d ticks in "
+              "%f ms.", result->m_index, track.c_str(),
+              result->m_difficulty.c_str(), m_seed, ticks,
+              result->m_wall_time);
+    return true;
+}   // runRace
+
+//-----------------------------------------------------------------------------
+/** Writes one line per kart and race. */
+void AIRaceRunner::writeCSV(const std::vector<RaceResult> &results,
+                            std::ostream &out)
+{
+    out << "race,track,difficulty,seed,laps,ticks,wall_time_ms,kart_index,"
+        << "kart,position,finished,finish_time,distance\n";
+    for (const RaceResult &r : results)
+    {
+        for (unsigned int i = 0; i < r.m_karts.size(); i++)
+        {
+            const KartResult &k = r.m_karts[i];
+            out << r.m_index << "," << r.m_track << "," << r.m_difficulty
+                << "," << r.m_seed << "," << m_num_laps << "," << r.m_ticks
+                << "," << r.m_wall_time << "," << i << "," << k.m_kart
+                << "," << k.m_position << "," << (k.m_finished ? 1 : 0)
+                << "," << k.m_finish_time << "," << k.m_distance << "\n";
+        }
+    }
+}   // writeCSV
+
+//-----------------------------------------------------------------------------
+/** Writes all results as one JSON object. */
+void AIRaceRunner::writeJSON(const std::vector<RaceResult> &results,
+                             std::ostream &out)
+{
+    out << "{\n  \"version\": " << StringUtils::jsonEncode(STK_VERSION)
+        << ",\n  \"physics_fps\": " << stk_config->getPhysicsFPS()
+        << ",\n  \"laps\": " << m_num_laps << ",\n  \"races\": [";
+    for (unsigned int i = 0; i < results.size(); i++)
+    {
+        const RaceResult &r = results[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"race\": " << r.m_index
+            << ", \"track\": " << StringUtils::jsonEncode(r.m_track)
+            << ", \"difficulty\": " << StringUtils::jsonEncode(r.m_difficulty)
+            << ", \"seed\": " << r.m_seed << ", \"ticks\": " << r.m_ticks
+            << ", \"wall_time_ms\": " << r.m_wall_time
+            << ",\n     \"karts\": [";
+        for (unsigned int j = 0; j < r.m_karts.size(); j++)
+        {
+            const KartResult &k = r.m_karts[j];
+            out << (j == 0 ? "\n" : ",\n")
+                << "       {\"kart\": " << StringUtils::jsonEncode(k.m_kart)
+                << ", \"position\": " << k.m_position
+                << ", \"finished\": " << (k.m_finished ? "true" : "false")
+                << ", \"finish_time\": " << k.m_finish_time
+                << ", \"distance\": " << k.m_distance << "}";
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}   // writeJSON
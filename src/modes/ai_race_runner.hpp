@@ -0,0 +1,158 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_AI_RACE_RUNNER_HPP
+#define HEADER_AI_RACE_RUNNER_HPP
+
+#include "modes/standard_race.hpp"
+#include "race/race_manager.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Runs a batch of AI-only races without graphics (--ai-races), e.g.
+ *  to tune kart characteristics or to test tracks.
+ *  The races are all combinations of the given tracks, kart lists,
+ *  difficulties and seeds. They are run back to back in one process, each
+ *  race is simulated as fast as possible (no frame limiting) till all karts
+ *  have finished or a time limit is reached. The result of each kart and the
+ *  timing of each race are written to a CSV or (if the file name does not
+ *  end in .csv) JSON file.
+ *  To use more than one core, several processes can each run a subset of
+ *  the races (--ai-races-worker), see tools/ai_test/run_races.sh.
+ * \ingroup modes
+ */
+class AIRaceRunner : public StandardRace
+{
+private:
+    /** Name of the file to write the results to, empty if the batch runner
+     *  is not enabled. */
+    static std::string m_output_file;
+
+    /** The tracks to race on. */
+    static std::vector<std::string> m_tracks;
+
+    /** Each entry is the list of karts of one race. */
+    static std::vector<std::vector<std::string> > m_kart_lists;
+
+    /** The difficulties to race with. */
+    static std::vector<RaceManager::Difficulty> m_difficulties;
+
+    /** The random seeds, each combination is raced with each seed. */
+    static std::vector<uint32_t> m_seeds;
+
+    /** Number of laps of each race. */
+    static int m_num_laps;
+
+    /** Maximum race time in seconds, after that the race is stopped even if
+     *  not all karts have finished. */
+    static float m_max_time;
+
+    /** This process only runs the races with index % m_num_workers ==
+     *  m_worker_index. */
+    static int m_worker_index;
+    static int m_num_workers;
+
+    /** The seed of the race currently being run. */
+    static uint32_t m_seed;
+
+    /** Results of one kart in a race. */
+    struct KartResult
+    {
+        std::string m_kart;
+        int         m_position;
+        bool        m_finished;
+        float       m_finish_time;
+        float       m_distance;
+    };
+
+    /** Results and timing of one race. */
+    struct RaceResult
+    {
+        int                     m_index;
+        std::string             m_track;
+        std::string             m_difficulty;
+        uint32_t                m_seed;
+        int                     m_ticks;
+        double                  m_wall_time;
+        std::vector<KartResult> m_karts;
+    };
+
+    static bool runRace(const std::string &track,
+                        const std::vector<std::string> &karts,
+                        RaceManager::Difficulty difficulty,
+                        RaceResult *result);
+    static void writeCSV(const std::vector<RaceResult> &results,
+                         std::ostream &out);
+    static void writeJSON(const std::vector<RaceResult> &results,
+                          std::ostream &out);
+
+protected:
+    /** The race is ended by the runner, see runRace(). */
+    virtual bool isRaceOver() OVERRIDE { return false; }
+
+public:
+                         AIRaceRunner();
+    virtual             ~AIRaceRunner() {}
+    virtual void         init() OVERRIDE;
+    // ------------------------------------------------------------------------
+    static void run();
+    // ------------------------------------------------------------------------
+    static bool setDifficulties(const std::vector<std::string> &names);
+    // ------------------------------------------------------------------------
+    /** Enables the batch runner.
+     *  \param output_file The file to write the results to. */
+    static void enable(const std::string &output_file)
+    {
+        m_output_file = output_file;
+    }   // enable
+    // ------------------------------------------------------------------------
+    /** Returns true if the batch runner was requested. */
+    static bool isEnabled() { return !m_output_file.empty(); }
+    // ------------------------------------------------------------------------
+    static void setTracks(const std::vector<std::string> &tracks)
+    {
+        m_tracks = tracks;
+    }   // setTracks
+    // ------------------------------------------------------------------------
+    static void setKartLists(const std::vector<std::vector<std::string> > &l)
+    {
+        m_kart_lists = l;
+    }   // setKartLists
+    // ------------------------------------------------------------------------
+    static void setSeeds(const std::vector<uint32_t> &seeds)
+    {
+        m_seeds = seeds;
+    }   // setSeeds
+    // ------------------------------------------------------------------------
+    static void setNumLaps(int laps)                     { m_num_laps = laps; }
+    // ------------------------------------------------------------------------
+    static void setMaxTime(float t)                        { m_max_time = t; }
+    // ------------------------------------------------------------------------
+    /** Only run every num_workers-th race, starting with race index. */
+    static void setWorker(int index, int num_workers)
+    {
+        m_worker_index = index;
+        m_num_workers  = num_workers;
+    }   // setWorker
+};   // AIRaceRunner
+
+#endif
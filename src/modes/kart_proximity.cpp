@@ -0,0 +1,415 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "modes/kart_proximity.hpp"
+
+#include "items/flyable.hpp"
+#include "items/projectile_manager.hpp"
+#include "karts/abstract_kart.hpp"
+#include "karts/kart_properties.hpp"
+#include "modes/linear_world.hpp"
+#include "utils/log.hpp"
+#include "utils/random_generator.hpp"
+#include "utils/vec3.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+
+namespace
+{
+    /** Size of a grid cell. It is a bit larger than the usual slipstream
+     *  reach, so a slipstream test only needs a few cells. */
+    const float PROXIMITY_CELL_SIZE = 20.0f;
+
+    /** If a query would cover more cells than this, all objects are
+     *  returned instead. */
+    const int MAX_QUERY_CELLS = 64;
+
+    // ------------------------------------------------------------------------
+    int getCellCoord(float f)
+    {
+        return (int)floorf(f / PROXIMITY_CELL_SIZE);
+    }   // getCellCoord
+
+    // ------------------------------------------------------------------------
+    uint64_t getCellKey(int x, int z)
+    {
+        return ((uint64_t)(uint32_t)x << 32) | (uint32_t)z;
+    }   // getCellKey
+
+    // ------------------------------------------------------------------------
+    uint64_t getCellKey(const Vec3 &xyz)
+    {
+        return getCellKey(getCellCoord(xyz.getX()), getCellCoord(xyz.getZ()));
+    }   // getCellKey
+}   // namespace
+
+// ----------------------------------------------------------------------------
+KartProximity::KartProximity()
+{
+    m_max_slipstream_reach    = 0.0f;
+    m_projectile_change_count = 0;
+}   // KartProximity
+
+// ----------------------------------------------------------------------------
+/** Rebuilds all data. This is called once per time step before the karts
+ *  are updated.
+ *  \param world The world the karts are in.
+ */
+void KartProximity::update(const World *world)
+{
+    updateKartGrid(world);
+    updateRanking(world);
+    updateProjectileGrid();
+}   // update
+
+// ----------------------------------------------------------------------------
+/** Returns an upper bound of the distance at which the given kart can give
+ *  slipstream to another kart (see SlipStream::update), not including the
+ *  length of the other kart. */
+float KartProximity::getSlipstreamReach(const AbstractKart *kart) const
+{
+    const KartProperties *kp = kart->getKartProperties();
+    // The speed of the kart is not updated yet when the grid is rebuilt, but
+    // it can't be more than the speed of the physics body.
+    float speed = std::max(fabsf(kart->getSpeed()),
+                           kart->getVelocity().length());
+    return kp->getSlipstreamLength() * 1.1f * speed /
+           kp->getSlipstreamBaseSpeed() + kart->getKartLength();
+}   // getSlipstreamReach
+
+// ----------------------------------------------------------------------------
+void KartProximity::updateKartGrid(const World *world)
+{
+    const unsigned int num_karts = world->getNumKarts();
+    m_kart_grid.clear();
+    m_kart_cell.resize(num_karts);
+    m_max_slipstream_reach = 0.0f;
+    for (unsigned int i = 0; i < num_karts; i++)
+    {
+        const AbstractKart *kart = world->getKart(i);
+        m_kart_cell[i] = getCellKey(kart->getXYZ());
+        m_kart_grid.emplace_back(m_kart_cell[i], i);
+        m_max_slipstream_reach = std::max(m_max_slipstream_reach,
+                                          getSlipstreamReach(kart));
+    }
+    std::sort(m_kart_grid.begin(), m_kart_grid.end());
+}   // updateKartGrid
+
+// ----------------------------------------------------------------------------
+/** Updates the grid entry of a kart after its position has changed. This is
+ *  called in Kart::update, once the new position and speed of the kart are
+ *  known.
+ */
+void KartProximity::updateKart(const AbstractKart *kart)
+{
+    const unsigned int id = kart->getWorldKartId();
+    if (id >= m_kart_cell.size())
+        return;
+    m_max_slipstream_reach = std::max(m_max_slipstream_reach,
+                                      getSlipstreamReach(kart));
+    const uint64_t cell = getCellKey(kart->getXYZ());
+    if (cell == m_kart_cell[id])
+        return;
+
+    auto old_entry = std::lower_bound(m_kart_grid.begin(), m_kart_grid.end(),
+                                      GridEntry(m_kart_cell[id], id));
+    if (old_entry != m_kart_grid.end() && old_entry->second == id)
+        m_kart_grid.erase(old_entry);
+    m_kart_cell[id] = cell;
+    GridEntry new_entry(cell, id);
+    m_kart_grid.insert(std::upper_bound(m_kart_grid.begin(),
+                                        m_kart_grid.end(), new_entry),
+                       new_entry);
+}   // updateKart
+
+// ----------------------------------------------------------------------------
+/** Rebuilds the projectile grid. */
+void KartProximity::updateProjectileGrid()
+{
+    ProjectileManager *pm = ProjectileManager::get();
+    m_projectile_grid.clear();
+    m_projectiles.clear();
+    m_projectile_change_count = pm->getChangeCount();
+    for (auto &p : pm->getActiveProjectiles())
+    {
+        m_projectile_grid.emplace_back(getCellKey(p.second->getXYZ()),
+                                       (unsigned int)m_projectiles.size());
+        m_projectiles.push_back(p.second.get());
+    }
+    std::sort(m_projectile_grid.begin(), m_projectile_grid.end());
+}   // updateProjectileGrid
+
+// ----------------------------------------------------------------------------
+/** Sorts the karts by overall distance and computes the race position of
+ *  all karts that are still racing (see computeRanking()). Nothing is done
+ *  if the world is not a linear world.
+ */
+void KartProximity::updateRanking(const World *world)
+{
+    const LinearWorld *lw = dynamic_cast<const LinearWorld*>(world);
+    if (!lw)
+    {
+        m_ranking_info.clear();
+        m_ranking.clear();
+        m_ranking_distance.clear();
+        m_race_position.clear();
+        return;
+    }
+
+    const unsigned int num_karts = lw->getNumKarts();
+    m_ranking_info.resize(num_karts);
+    for (unsigned int i = 0; i < num_karts; i++)
+    {
+        const AbstractKart *kart = lw->getKart(i);
+        RankingInfo &info       = m_ranking_info[i];
+        info.m_overall_distance = lw->getOverallDistance(i);
+        info.m_initial_position = kart->getInitialPosition();
+        info.m_finished         = kart->hasFinishedRace();
+        info.m_eliminated       = kart->isEliminated();
+    }
+    computeRanking();
+}   // updateRanking
+
+// ----------------------------------------------------------------------------
+/** Sorts the karts in m_ranking_info by overall distance and computes the
+ *  race position of all karts that are neither eliminated nor finished.
+ *  Karts that have finished the race are ahead of all other karts, and
+ *  karts with the same distance are sorted by their initial position.
+ *  The order of the previous call is used as start, and then fixed with an
+ *  insertion sort, which only needs linear time if few karts overtook
+ *  each other since then.
+ */
+void KartProximity::computeRanking()
+{
+    const unsigned int num_karts = (unsigned int)m_ranking_info.size();
+
+    // Remove karts that were eliminated since the last call
+    m_ranking.erase(std::remove_if(m_ranking.begin(), m_ranking.end(),
+        [this, num_karts](unsigned int id)
+        {
+            return id >= num_karts || m_ranking_info[id].m_eliminated;
+        }), m_ranking.end());
+
+    int num_finished = 0;
+    unsigned int num_active = 0;
+    for (const RankingInfo &info : m_ranking_info)
+    {
+        if (info.m_eliminated)
+            continue;
+        num_active++;
+        if (info.m_finished)
+            num_finished++;
+    }
+    // If karts were added (e.g. a new race), start with all karts
+    if (m_ranking.size() != num_active)
+    {
+        m_ranking.clear();
+        for (unsigned int i = 0; i < num_karts; i++)
+        {
+            if (!m_ranking_info[i].m_eliminated)
+                m_ranking.push_back(i);
+        }
+    }
+
+    for (unsigned int i = 1; i < m_ranking.size(); i++)
+    {
+        const unsigned int id = m_ranking[i];
+        unsigned int j = i;
+        for (; j > 0 && isAhead(id, m_ranking[j - 1]); j--)
+            m_ranking[j] = m_ranking[j - 1];
+        m_ranking[j] = id;
+    }
+
+    m_ranking_distance.clear();
+    m_race_position.assign(num_karts, 0);
+    int position = num_finished + 1;
+    for (unsigned int id : m_ranking)
+    {
+        m_ranking_distance.push_back(m_ranking_info[id].m_overall_distance);
+        if (!m_ranking_info[id].m_finished)
+            m_race_position[id] = position++;
+    }
+}   // computeRanking
+
+// ----------------------------------------------------------------------------
+/** Returns the number of karts (that are not eliminated) which have covered
+ *  a larger overall distance than the given distance.
+ */
+int KartProximity::getNumKartsAhead(float overall_distance) const
+{
+    return (int)(std::lower_bound(m_ranking_distance.begin(),
+                                  m_ranking_distance.end(), overall_distance,
+                                  std::greater<float>())
+                 - m_ranking_distance.begin());
+}   // getNumKartsAhead
+
+// ----------------------------------------------------------------------------
+/** Collects the indices of all entries in cells that overlap the square
+ *  around xyz with the given radius.
+ */
+void KartProximity::findInGrid(const std::vector<GridEntry> &grid,
+                               const Vec3 &xyz, float radius,
+                               std::vector<unsigned int> *result)
+{
+    result->clear();
+    const int x0 = getCellCoord(xyz.getX() - radius);
+    const int x1 = getCellCoord(xyz.getX() + radius);
+    const int z0 = getCellCoord(xyz.getZ() - radius);
+    const int z1 = getCellCoord(xyz.getZ() + radius);
+    if (!(radius >= 0.0f && radius < PROXIMITY_CELL_SIZE * MAX_QUERY_CELLS) ||
+        (int64_t)(x1 - x0 + 1) * (z1 - z0 + 1) > MAX_QUERY_CELLS)
+    {
+        for (const GridEntry &entry : grid)
+            result->push_back(entry.second);
+        std::sort(result->begin(), result->end());
+        return;
+    }
+
+    for (int x = x0; x <= x1; x++)
+    {
+        for (int z = z0; z <= z1; z++)
+        {
+            const uint64_t key = getCellKey(x, z);
+            auto it = std::lower_bound(grid.begin(), grid.end(),
+                                       GridEntry(key, 0));
+            for (; it != grid.end() && it->first == key; it++)
+                result->push_back(it->second);
+        }
+    }
+    std::sort(result->begin(), result->end());
+}   // findInGrid
+
+// ----------------------------------------------------------------------------
+/** Returns (sorted by world kart id) all karts which might be within the
+ *  given radius of xyz. The caller must test the actual distance.
+ */
+void KartProximity::getKartsInRadius(const Vec3 &xyz, float radius,
+                                     std::vector<unsigned int> *result) const
+{
+    findInGrid(m_kart_grid, xyz, radius, result);
+}   // getKartsInRadius
+
+// ----------------------------------------------------------------------------
+/** Returns all projectiles which might be within the given radius of xyz.
+ *  The caller must test the actual distance.
+ */
+void KartProximity::getProjectilesInRadius(const Vec3 &xyz, float radius,
+                                           std::vector<Flyable*> *result)
+{
+    // Projectiles can be fired while the karts are updated
+    if (ProjectileManager::get()->getChangeCount() !=
+        m_projectile_change_count)
+        updateProjectileGrid();
+
+    std::vector<unsigned int> indices;
+    findInGrid(m_projectile_grid, xyz, radius, &indices);
+    result->clear();
+    for (unsigned int i : indices)
+        result->push_back(m_projectiles[i]);
+}   // getProjectilesInRadius
+
+// ----------------------------------------------------------------------------
+/** Compares the race positions of the incremental ranking with the
+ *  positions computed by comparing each kart with every other kart (which
+ *  is how LinearWorld used to compute them), using random races in which
+ *  karts overtake each other, finish and get eliminated.
+ */
+void KartProximity::unitTesting()
+{
+    RandomGenerator random;
+    KartProximity kp;
+    for (int race = 0; race < 200; race++)
+    {
+        const unsigned int num_karts = 1 + random.get(20);
+        // Initial positions are a permutation of 1..num_karts
+        std::vector<int> initial_positions;
+        for (unsigned int i = 0; i < num_karts; i++)
+            initial_positions.push_back(i + 1);
+        for (unsigned int i = num_karts - 1; i > 0; i--)
+        {
+            std::swap(initial_positions[i],
+                      initial_positions[random.get(i + 1)]);
+        }
+
+        kp.m_ranking_info.resize(num_karts);
+        for (unsigned int i = 0; i < num_karts; i++)
+        {
+            RankingInfo &info = kp.m_ranking_info[i];
+            // Use few different values, so there are many ties
+            info.m_overall_distance = (float)random.get(5);
+            info.m_initial_position = initial_positions[i];
+            info.m_finished         = false;
+            info.m_eliminated       = false;
+        }
+
+        for (int step = 0; step < 100; step++)
+        {
+            for (RankingInfo &info : kp.m_ranking_info)
+            {
+                if (info.m_finished || info.m_eliminated)
+                    continue;
+                // Karts move forward most of the time, but can be rescued
+                const int r = random.get(100);
+                if (r < 90)
+                    info.m_overall_distance += 0.5f * random.get(4);
+                else if (r < 95)
+                    info.m_overall_distance -= 2.0f;
+                else if (r < 97)
+                    info.m_finished = true;
+                else if (r < 98)
+                    info.m_eliminated = true;
+            }
+            kp.computeRanking();
+
+            for (unsigned int i = 0; i < num_karts; i++)
+            {
+                const RankingInfo &me = kp.m_ranking_info[i];
+                int expected = 0;
+                if (!me.m_finished && !me.m_eliminated)
+                {
+                    expected = 1;
+                    for (unsigned int j = 0; j < num_karts; j++)
+                    {
+                        const RankingInfo &other = kp.m_ranking_info[j];
+                        if (j == i || other.m_eliminated)
+                            continue;
+                        const float d = other.m_overall_distance;
+                        const float my_d = me.m_overall_distance;
+                        if (other.m_finished || d > my_d ||
+                            (d == my_d && other.m_initial_position <
+                                          me.m_initial_position))
+                            expected++;
+                    }
+                }
+                assert(kp.getRacePosition(i) == expected);
+                if (kp.getRacePosition(i) != expected)
+                {
+                    Log::error("KartProximity", "Kart %d has position %d "
+                               "instead of %d.", i, kp.getRacePosition(i),
+                               expected);
+                }
+            }
+            assert(std::is_sorted(kp.m_ranking_distance.begin(),
+                                  kp.m_ranking_distance.end(),
+                                  std::greater<float>()));
+        }   // for step
+    }   // for race
+}   // unitTesting
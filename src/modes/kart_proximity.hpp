@@ -0,0 +1,163 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_KART_PROXIMITY_HPP
+#define HEADER_KART_PROXIMITY_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class AbstractKart;
+class Flyable;
+class Vec3;
+class World;
+
+/**
+ *  \brief Per time step data about where karts and projectiles are, shared
+ *  by all code that would otherwise compare every kart with every other
+ *  kart (AI, slipstream, race positions).
+ *  It contains:
+ *  - the karts sorted by overall distance (in linear worlds), which gives
+ *    the race positions and the number of karts ahead of a distance. The
+ *    order of the previous time step is kept and only fixed up, since
+ *    karts rarely overtake each other;
+ *  - a uniform grid (in the XZ plane) of the kart positions. The world
+ *    rebuilds it before the karts are updated, and each kart updates its
+ *    own entry in Kart::update once its new position is known, so the grid
+ *    always matches the current kart positions;
+ *  - a uniform grid of the projectile positions, which is rebuilt whenever
+ *    the projectile manager reports a change.
+ *  The grids only return candidates (all objects in cells overlapping the
+ *  query area); the caller must still test the exact distance.
+ *  \ingroup modes
+ */
+class KartProximity : public NoCopy
+{
+public:
+    /** The data of a kart that determines its rank. */
+    struct RankingInfo
+    {
+        float m_overall_distance;
+        int   m_initial_position;
+        bool  m_finished;
+        bool  m_eliminated;
+    };
+
+private:
+    /** A grid entry: the cell key and the index of the object. The vectors
+     *  of entries are sorted, so all objects of one cell are adjacent. */
+    typedef std::pair<uint64_t, unsigned int> GridEntry;
+
+    /** Grid of all karts, sorted by cell and kart id. */
+    std::vector<GridEntry> m_kart_grid;
+
+    /** The cell each kart is stored in. */
+    std::vector<uint64_t> m_kart_cell;
+
+    /** Upper bound of the distance at which any kart can give slipstream
+     *  to another kart, not including the length of the other kart. */
+    float m_max_slipstream_reach;
+
+    /** Grid of all projectiles, the index refers to m_projectiles. */
+    std::vector<GridEntry> m_projectile_grid;
+
+    std::vector<Flyable*> m_projectiles;
+
+    /** The change count of the projectile manager when the projectile grid
+     *  was built. */
+    unsigned int m_projectile_change_count;
+
+    /** The ranking data of each kart, indexed by world kart id. */
+    std::vector<RankingInfo> m_ranking_info;
+
+    /** World ids of all karts that are not eliminated, sorted by overall
+     *  distance (decreasing) and initial position. */
+    std::vector<unsigned int> m_ranking;
+
+    /** The overall distance of each kart in m_ranking. */
+    std::vector<float> m_ranking_distance;
+
+    /** The race position of each kart that is neither eliminated nor has
+     *  finished the race, 0 for other karts. */
+    std::vector<int> m_race_position;
+
+    // ------------------------------------------------------------------------
+    void updateKartGrid(const World *world);
+    // ------------------------------------------------------------------------
+    void updateProjectileGrid();
+    // ------------------------------------------------------------------------
+    float getSlipstreamReach(const AbstractKart *kart) const;
+    // ------------------------------------------------------------------------
+    static void findInGrid(const std::vector<GridEntry> &grid,
+                           const Vec3 &xyz, float radius,
+                           std::vector<unsigned int> *result);
+    // ------------------------------------------------------------------------
+    void computeRanking();
+    // ------------------------------------------------------------------------
+    /** Returns true if kart a is ranked ahead of kart b (ignoring whether
+     *  the karts have finished). */
+    bool isAhead(unsigned int a, unsigned int b) const
+    {
+        const RankingInfo &info_a = m_ranking_info[a];
+        const RankingInfo &info_b = m_ranking_info[b];
+        if (info_a.m_overall_distance != info_b.m_overall_distance)
+            return info_a.m_overall_distance > info_b.m_overall_distance;
+        return info_a.m_initial_position < info_b.m_initial_position;
+    }   // isAhead
+
+public:
+    KartProximity();
+    // ------------------------------------------------------------------------
+    static void unitTesting();
+    // ------------------------------------------------------------------------
+    void update(const World *world);
+    // ------------------------------------------------------------------------
+    void updateKart(const AbstractKart *kart);
+    // ------------------------------------------------------------------------
+    void updateRanking(const World *world);
+    // ------------------------------------------------------------------------
+    void getKartsInRadius(const Vec3 &xyz, float radius,
+                          std::vector<unsigned int> *result) const;
+    // ------------------------------------------------------------------------
+    void getProjectilesInRadius(const Vec3 &xyz, float radius,
+                                std::vector<Flyable*> *result);
+    // ------------------------------------------------------------------------
+    int getNumKartsAhead(float overall_distance) const;
+    // ------------------------------------------------------------------------
+    /** Returns the maximum distance at which a kart can give slipstream,
+     *  not including the length of the kart receiving slipstream. */
+    float getMaxSlipstreamReach() const     { return m_max_slipstream_reach; }
+    // ------------------------------------------------------------------------
+    /** Returns the world ids of all karts that are not eliminated, sorted
+     *  by overall distance. */
+    const std::vector<unsigned int> &getRanking() const { return m_ranking; }
+    // ------------------------------------------------------------------------
+    /** Returns the race position of a kart based on the last call to
+     *  updateRanking(), 0 if the kart is eliminated or has finished. */
+    int getRacePosition(unsigned int kart_id) const
+    {
+        return kart_id < m_race_position.size() ? m_race_position[kart_id]
+                                                : 0;
+    }   // getRacePosition
+
+};   // KartProximity
+
+#endif
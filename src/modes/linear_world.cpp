@@ -48,6 +48,7 @@
 #include "tracks/track_sector.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
+#include "utils/profiler.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/translation.hpp"
 
@@ -209,7 +210,10 @@ void LinearWorld::update(int ticks)
 
     // Do stuff specific to this subtype of race.
     // ------------------------------------------
+    PROFILER_PUSH_CPU_MARKER("LinearWorld::update (track sectors)",
+                             0x20, 0x7F, 0x60);
     updateTrackSectors();
+    PROFILER_POP_CPU_MARKER();
     // Run generic parent stuff that applies to all modes.
     // It especially updates the kart positions.
     // It MUST be done after the update of the distances
@@ -874,6 +878,8 @@ void LinearWorld::updateRacePosition()
     bool rank_changed = false;
 #endif
 
+    m_kart_proximity.updateRanking(this);
+
     // NOTE: if you do any changes to this loop, the next loop (see
     // DEBUG_KART_RANK below) needs to have the same changes applied
     // so that debug output is still correct!!!!!!!!!!!
@@ -894,33 +900,12 @@ void LinearWorld::updateRacePosition()
         }
         KartInfo& kart_info = m_kart_info[i];
 
-        int p = 1 ;
-
-        const unsigned int my_id = kart->getWorldKartId();
-        const float my_distance  = m_kart_info[my_id].m_overall_distance;
-
-        // Count karts ahead of the current kart, i.e. kart that are
-        // already finished or have covered a larger overall distance.
-        for (unsigned int j = 0 ; j < kart_amount ; j++)
-        {
-            // don't compare a kart with itself and ignore eliminated karts
-            if(j == my_id || m_karts[j]->isEliminated())
-                continue;
-
-            // If the other kart has:
-            // - finished the race (but this kart hasn't)
-            // - or is ahead
-            // - or has the same distance (very unlikely) but started earlier
-            // it is ahead --> increase position
-            if((!kart->hasFinishedRace() && m_karts[j]->hasFinishedRace()) ||
-                m_kart_info[j].m_overall_distance > my_distance            ||
-               (m_kart_info[j].m_overall_distance == my_distance &&
-                m_karts[j]->getInitialPosition()<kart->getInitialPosition() ) )
-            {
-                p++;
-            }
-
-        } //next kart
+        // The position is one more than the number of karts ahead of the
+        // current kart, i.e. kart that are already finished or have covered
+        // a larger overall distance (or have the same distance, which is
+        // very unlikely, but started earlier). This is determined by
+        // sorting all karts by distance (see KartProximity::updateRanking).
+        const int p = m_kart_proximity.getRacePosition(i);
 
 #ifndef DEBUG
         setKartPosition(i, p);
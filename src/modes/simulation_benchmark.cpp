@@ -0,0 +1,262 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "modes/simulation_benchmark.hpp"
+
+#include "config/stk_config.hpp"
+#include "config/user_config.hpp"
+#include "items/item_manager.hpp"
+#include "items/powerup_manager.hpp"
+#include "network/rewind_manager.hpp"
+#include "race/race_manager.hpp"
+#include "tracks/track.hpp"
+#include "tracks/track_manager.hpp"
+#include "utils/constants.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
+#include "utils/profiler.hpp"
+#include "utils/string_utils.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+
+std::string              SimulationBenchmark::m_output_file;
+std::vector<std::string> SimulationBenchmark::m_tracks;
+std::vector<int>         SimulationBenchmark::m_num_karts;
+int                      SimulationBenchmark::m_num_ticks = 3600;
+uint32_t                 SimulationBenchmark::m_seed      = 1;
+
+namespace
+{
+    /** Maps the profiler markers to the subsystems reported in the results.
+     *  A subsystem can consist of more than one marker. */
+    struct SubsystemMarker
+    {
+        const char *m_subsystem;
+        const char *m_marker;
+    };
+    const SubsystemMarker g_subsystem_markers[] =
+    {
+        { "world_update",  "World::update()"                     },
+        { "physics",       "World::update (physics)"             },
+        { "kart_update",   "World::update (Kart::update)"        },
+        { "ai",            "Kart::update (controller)"           },
+        { "items",         "Track::update (items)"               },
+        { "items",         "Kart::update (item hits)"            },
+        { "track_sectors", "LinearWorld::update (track sectors)" },
+        { "rewind_save",   "RewindManager - save state"          },
+    };
+
+    // ------------------------------------------------------------------------
+    /** Returns the JSON object describing one time total. */
+    std::string jsonTiming(double total_ms, int count, int ticks)
+    {
+        return "{\"total_ms\": " + StringUtils::toString(total_ms) +
+               ", \"us_per_tick\": " +
+               StringUtils::toString(total_ms * 1000.0 / ticks) +
+               ", \"count\": " + StringUtils::toString(count) + "}";
+    }   // jsonTiming
+}   // namespace
+
+//-----------------------------------------------------------------------------
+/** The constructor enables the rewind manager (which is otherwise only
+ *  enabled in networked games), so that karts and physical objects are
+ *  created as rewinders and states are saved as they are on a server.
+ */
+SimulationBenchmark::SimulationBenchmark() : StandardRace()
+{
+    RewindManager::setEnable(true);
+    m_use_highscores = false;
+}   // SimulationBenchmark
+
+//-----------------------------------------------------------------------------
+/** After the track is loaded the random number generators are seeded again
+ *  (the item manager uses the current time otherwise), so that all runs
+ *  with the same seed simulate the same race.
+ */
+void SimulationBenchmark::init()
+{
+    StandardRace::init();
+    srand(m_seed);
+    ItemManager::updateRandomSeed(m_seed);
+    powerup_manager->setRandomSeed(m_seed);
+}   // init
+
+//-----------------------------------------------------------------------------
+/** Runs the benchmark for all combinations of tracks and kart numbers, and
+ *  writes the results to the output file.
+ */
+void SimulationBenchmark::run()
+{
+    if (m_tracks.empty())
+    {
+        std::vector<std::string> all_tracks =
+            track_manager->getAllTrackIdentifiers();
+        for (const std::string &ident : all_tracks)
+        {
+            Track *track = track_manager->getTrack(ident);
+            if (track && track->isRaceTrack() && !track->isAddon())
+                m_tracks.push_back(ident);
+        }
+    }
+    if (m_num_karts.empty())
+    {
+        m_num_karts.push_back(4);
+        m_num_karts.push_back(8);
+    }
+
+    // The profiler is not initialised in no-graphics mode
+    profiler.init();
+    UserConfigParams::m_profiler_enabled = true;
+
+    std::string results;
+    for (const std::string &track : m_tracks)
+    {
+        for (int num_karts : m_num_karts)
+        {
+            std::string json;
+            if (!runRace(track, num_karts, &json))
+                continue;
+            if (!results.empty())
+                results += ",\n";
+            results += json;
+        }
+    }
+
+    UserConfigParams::m_profiler_enabled = false;
+    RewindManager::setEnable(false);
+
+    std::ofstream f(FileUtils::getPortableWritingPath(m_output_file));
+    if (!f.is_open())
+    {
+        Log::error("SimulationBenchmark", "Can't write results to '%s'.",
+                   m_output_file.c_str());
+        return;
+    }
+    f << "{\n  \"version\": " << StringUtils::jsonEncode(STK_VERSION) << ",\n"
+      << "  \"physics_fps\": " << stk_config->getPhysicsFPS() << ",\n"
+      << "  \"ticks\": " << m_num_ticks << ",\n"
+      << "  \"seed\": " << m_seed << ",\n"
+      << "  \"results\": [\n" << results << "\n  ]\n}\n";
+    f.close();
+    Log::info("SimulationBenchmark", "Results written to '%s'.",
+              m_output_file.c_str());
+}   // run
+
+//-----------------------------------------------------------------------------
+/** Loads the given track with the given number of AI karts, runs the
+ *  simulation for m_num_ticks time steps, and removes the race again.
+ *  \param track Identifier of the track.
+ *  \param num_karts Number of AI karts.
+ *  \param json On return contains the JSON object with the results.
+ *  \return False if the race could not be run.
+ */
+bool SimulationBenchmark::runRace(const std::string &track, int num_karts,
+                                  std::string *json)
+{
+    if (!track_manager->getTrack(track))
+    {
+        Log::error("SimulationBenchmark", "Unknown track '%s'.",
+                   track.c_str());
+        return false;
+    }
+    if (num_karts < 1 || num_karts > stk_config->m_max_karts)
+    {
+        Log::error("SimulationBenchmark", "Invalid number of karts %d.",
+                   num_karts);
+        return false;
+    }
+
+    RaceManager *rm = RaceManager::get();
+    rm->setMajorMode(RaceManager::MAJOR_MODE_SINGLE);
+    rm->setMinorMode(RaceManager::MINOR_MODE_NORMAL_RACE);
+    rm->setNumPlayers(0);
+    rm->setNumKarts(num_karts);
+    // Always use the same karts so that results are comparable
+    rm->setDefaultAIKartList(std::vector<std::string>(num_karts,
+                                           UserConfigParams::m_default_kart));
+    rm->setTrack(track);
+    rm->setReverseTrack(false);
+    rm->setNumLaps(99999);
+    rm->setupPlayerKartInfo();
+    rm->startNew(false);
+
+    World *world = World::getWorld();
+    // Skip the track intro and ready-set-go phases
+    while (!world->isRacePhase())
+    {
+        world->updateWorld(1);
+        world->updateTime(1);
+    }
+
+    profiler.clearEventTotals();
+    const double start = getTimeMilliseconds();
+    for (int i = 0; i < m_num_ticks; i++)
+    {
+        world->updateWorld(1);
+        world->updateTime(1);
+    }
+    const double wall_time = getTimeMilliseconds() - start;
+    std::map<std::string, Profiler::EventTotal> totals =
+        profiler.getEventTotals();
+
+    rm->exitRace();
+
+    std::map<std::string, Profiler::EventTotal> subsystems;
+    for (const SubsystemMarker &sm : g_subsystem_markers)
+    {
+        Profiler::EventTotal &total = subsystems[sm.m_subsystem];
+        auto it = totals.find(sm.m_marker);
+        if (it == totals.end())
+            continue;
+        total.m_duration += it->second.m_duration;
+        total.m_count    += it->second.m_count;
+    }
+
+    *json = "    {\"track\": " + StringUtils::jsonEncode(track) +
+            ", \"karts\": " + StringUtils::toString(num_karts) +
+            ", \"wall_time_ms\": " + StringUtils::toString(wall_time) +
+            ", \"ticks_per_second\": " +
+            StringUtils::toString(m_num_ticks * 1000.0 / wall_time) +
+            ",\n     \"subsystems\": {";
+    bool first = true;
+    for (auto &s : subsystems)
+    {
+        *json += (first ? "\n       " : ",\n       ") +
+                 StringUtils::jsonEncode(s.first) + ": " +
+                 jsonTiming(s.second.m_duration, s.second.m_count,
+                            m_num_ticks);
+        first = false;
+    }
+    *json += "},\n     \"markers\": {";
+    first = true;
+    for (auto &t : totals)
+    {
+        *json += (first ? "\n       " : ",\n       ") +
+                 StringUtils::jsonEncode(t.first) + ": " +
+                 jsonTiming(t.second.m_duration, t.second.m_count,
+                            m_num_ticks);
+        first = false;
+    }
+    *json += "}}";
+
+    Log::info("SimulationBenchmark", "%s with %d karts: %d ticks in %f ms.",
+              track.c_str(), num_karts, m_num_ticks, wall_time);
+    return true;
+}   // runRace
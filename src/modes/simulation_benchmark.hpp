@@ -0,0 +1,97 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_SIMULATION_BENCHMARK_HPP
+#define HEADER_SIMULATION_BENCHMARK_HPP
+
+#include "modes/standard_race.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * \brief A world used to measure the cost of the simulation without any
+ *  rendering. In contrast to ProfileWorld, which measures a full graphical
+ *  race, this is run (with --sim-benchmark) on the no-graphics path used
+ *  by the server: for each combination of track and number of AI karts a
+ *  race is loaded, World::updateWorld is called as fast as possible for a
+ *  fixed number of time steps, and the times of the profiler markers of the
+ *  main subsystems are written to a JSON file.
+ *  The rewind manager is enabled, so the cost of saving the state (as done
+ *  on a server) is included.
+ * \ingroup modes
+ */
+class SimulationBenchmark : public StandardRace
+{
+private:
+    /** Name of the JSON file to write the results to, empty if the
+     *  benchmark is not enabled. */
+    static std::string m_output_file;
+
+    /** The tracks to run the benchmark on. */
+    static std::vector<std::string> m_tracks;
+
+    /** The number of karts to run the benchmark with. */
+    static std::vector<int> m_num_karts;
+
+    /** Number of time steps to measure for each race. */
+    static int m_num_ticks;
+
+    /** Seed for all random number generators, so that runs are
+     *  reproducible. */
+    static uint32_t m_seed;
+
+    static bool runRace(const std::string &track, int num_karts,
+                        std::string *json);
+
+protected:
+    virtual bool isRaceOver() OVERRIDE { return false; }
+
+public:
+                         SimulationBenchmark();
+    virtual             ~SimulationBenchmark() {}
+    virtual void         init() OVERRIDE;
+    // ------------------------------------------------------------------------
+    static void run();
+    // ------------------------------------------------------------------------
+    /** Enables the benchmark.
+     *  \param output_file The JSON file to write the results to. */
+    static void enable(const std::string &output_file)
+    {
+        m_output_file = output_file;
+    }   // enable
+    // ------------------------------------------------------------------------
+    /** Returns true if the simulation benchmark was requested. */
+    static bool isEnabled() { return !m_output_file.empty(); }
+    // ------------------------------------------------------------------------
+    static void setTracks(const std::vector<std::string> &tracks)
+    {
+        m_tracks = tracks;
+    }   // setTracks
+    // ------------------------------------------------------------------------
+    static void setNumKarts(const std::vector<int> &num_karts)
+    {
+        m_num_karts = num_karts;
+    }   // setNumKarts
+    // ------------------------------------------------------------------------
+    static void setNumTicks(int ticks)                  { m_num_ticks = ticks; }
+    // ------------------------------------------------------------------------
+    static void setSeed(uint32_t seed)                       { m_seed = seed; }
+};   // SimulationBenchmark
+
+#endif
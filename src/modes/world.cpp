@@ -82,6 +82,7 @@
 #include "utils/profiler.hpp"
 #include "utils/translation.hpp"
 #include "utils/string_utils.hpp"
+#include "utils/worker_pool.hpp"
 
 #include <IrrlichtDevice.h>
 #include <ISceneManager.h>
@@ -190,6 +191,13 @@ void World::init()
         Scripting::ScriptEngine::getInstance()->loadScript(script_path, true);
     }
     main_loop->renderGUI(1200);
+    if (UserConfigParams::m_ai_threads > 1)
+    {
+        m_ai_worker_pool.reset(
+            new WorkerPool(UserConfigParams::m_ai_threads - 1, "AIWorker"));
+    }
+    else
+        m_ai_worker_pool.reset();
     // Create the physics
     Physics::create();
     main_loop->renderGUI(1300);
@@ -1168,12 +1176,33 @@ void World::update(int ticks)
     Track::getCurrentTrack()->getTrackObjectManager()->update(stk_config->ticks2Time(ticks));
     PROFILER_POP_CPU_MARKER();
 
-    PROFILER_PUSH_CPU_MARKER("World::update (Kart::upate)", 0x40, 0x7F, 0x00);
+    const int kart_amount = (int)m_karts.size();
+    PROFILER_PUSH_CPU_MARKER("World::update (kart proximity)",
+                             0x40, 0x7F, 0x20);
+    m_kart_proximity.update(this);
+    PROFILER_POP_CPU_MARKER();
+
+    // Let the controllers compute the parts of their update that only read
+    // the world in parallel. The serial kart updates below only use these
+    // results if they are still valid, so the outcome is the same as without
+    // precomputation.
+    if (m_ai_worker_pool)
+    {
+        PROFILER_PUSH_CPU_MARKER("World::update (AI precompute)",
+                                 0x40, 0x7F, 0x40);
+        m_ai_worker_pool->run(kart_amount, [this, ticks](int i)
+            {
+                if (!m_karts[i]->isEliminated())
+                    m_karts[i]->getController()->precomputeUpdate(ticks);
+            });
+        PROFILER_POP_CPU_MARKER();
+    }
+
+    PROFILER_PUSH_CPU_MARKER("World::update (Kart::update)", 0x40, 0x7F, 0x00);
 
     // Update all the karts. This in turn will also update the controller,
     // which causes all AI steering commands set. So in the following
     // physics update the new steering is taken into account.
-    const int kart_amount = (int)m_karts.size();
     for (int i = 0 ; i < kart_amount; ++i)
     {
         SpareTireAI* sta =
@@ -33,6 +33,7 @@
 #include <stdexcept>
 
 #include "graphics/weather.hpp"
+#include "modes/kart_proximity.hpp"
 #include "modes/world_status.hpp"
 #include "race/highscores.hpp"
 #include "states_screens/race_gui_base.hpp"
@@ -49,6 +50,7 @@ class Controller;
 class ItemState;
 class PhysicalObject;
 class STKPeer;
+class WorkerPool;
 
 namespace Scripting
 {
@@ -115,6 +117,13 @@ protected:
     KartList                  m_karts;
     RandomGenerator           m_random;
 
+    /** Threads used to precompute the AI updates in parallel, NULL if the
+     *  AI is only updated in the main thread. */
+    std::unique_ptr<WorkerPool> m_ai_worker_pool;
+
+    /** Positions and ranking of the karts, rebuilt each time step. */
+    KartProximity             m_kart_proximity;
+
     AbstractKart* m_fastest_kart;
     /** Number of eliminated karts. */
     int         m_eliminated_karts;
@@ -346,6 +355,9 @@ public:
     /** Returns all karts. */
     const KartList & getKarts() const { return m_karts; }
     // ------------------------------------------------------------------------
+    /** Returns the per time step proximity data of karts and projectiles. */
+    KartProximity* getKartProximity() { return &m_kart_proximity; }
+    // ------------------------------------------------------------------------
     /** Returns the number of currently active (i.e.non-elikminated) karts. */
     unsigned int    getCurrentNumKarts() const { return (int)m_karts.size() -
                                                          m_eliminated_karts; }
@@ -25,6 +25,7 @@
 #include "network/protocols/server_lobby.hpp"
 #include "network/race_event_manager.hpp"
 #include "network/server_config.hpp"
+#include "network/server_metrics.hpp"
 #include "network/stk_host.hpp"
 #include "race/race_manager.hpp"
 #include "states_screens/state_manager.hpp"
@@ -135,6 +136,8 @@ void ChildLoop::run()
 
         for (int i = 0; i < num_steps; i++)
         {
+            ServerMetrics::ScopedTimer tick_timer(
+                ServerMetrics::HT_TICK_DURATION);
             if (auto pm = ProtocolManager::lock())
                 pm->update(1);
 
@@ -57,10 +57,12 @@ namespace CompressNetworkBody
      *  transformation and convert linear and angular velocities to half floats
      *  it can be used by client to locally round values to make sure client
      *  and server have similar state when saving state if you don't provoide
-     *  bns.
+     *  bns. If round_body is false the compressed values are only written to
+     *  bns, and the body and motion state are left unchanged.
      */
     inline void compress(btRigidBody* body, btMotionState* ms,
-                         BareNetworkString* bns = NULL)
+                         BareNetworkString* bns = NULL,
+                         bool round_body = true)
     {
         float x = body->getWorldTransform().getOrigin().x();
         float y = body->getWorldTransform().getOrigin().y();
@@ -73,8 +75,11 @@ namespace CompressNetworkBody
         short avx = toFloat16(body->getAngularVelocity().x());
         short avy = toFloat16(body->getAngularVelocity().y());
         short avz = toFloat16(body->getAngularVelocity().z());
-        setCompressedValues(x, y, z, compressed_q, lvx, lvy, lvz, avx, avy,
-            avz, body, ms);
+        if (round_body)
+        {
+            setCompressedValues(x, y, z, compressed_q, lvx, lvy, lvz, avx,
+                avy, avz, body, ms);
+        }
         // if bns is null, it's locally compress (for rounding values)
         if (!bns)
             return;
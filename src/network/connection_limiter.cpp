@@ -0,0 +1,420 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/connection_limiter.hpp"
+
+#include "network/crypto.hpp"
+#include "network/socket_address.hpp"
+#include "utils/log.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+    /** Number of buckets in each table, must be a power of 2. */
+    const size_t TABLE_SIZE = 4096;
+
+    /** Number of slots searched for a key. */
+    const size_t MAX_PROBE = 8;
+
+    /** Time in ms between two log messages about challenged or dropped
+     *  requests. */
+    const uint64_t LOG_INTERVAL = 10000;
+
+    // ------------------------------------------------------------------------
+    /** Mixes the bits of a key (splitmix64 finalizer), so that the slots of
+     *  the table are used evenly. */
+    uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }   // mix
+
+    // ------------------------------------------------------------------------
+    uint64_t randomSeed()
+    {
+        std::random_device rd;
+        return ((uint64_t)rd() << 32) | rd();
+    }   // randomSeed
+}   // namespace
+
+// ----------------------------------------------------------------------------
+ConnectionLimiter::Buckets::Buckets(uint64_t seed, float rate, float burst)
+                          : m_table(TABLE_SIZE), m_seed(seed), m_rate(rate),
+                            m_burst(std::max(burst, 1.0f))
+{
+    for (Bucket& b : m_table)
+        b.m_used = false;
+}   // Buckets
+
+// ----------------------------------------------------------------------------
+/** Takes a token from the bucket of a key, the bucket is created (full) if
+ *  it does not exist.
+ *  \param key The key of the address.
+ *  \param now Current time in ms.
+ *  \return False if the bucket is empty.
+ */
+bool ConnectionLimiter::Buckets::take(uint64_t key, uint64_t now)
+{
+    const size_t mask = m_table.size() - 1;
+    // The seed is secret, so senders cannot choose colliding keys
+    const size_t index = (size_t)mix(key ^ m_seed);
+    Bucket* found = NULL;
+    Bucket* replace = NULL;
+    for (size_t i = 0; i < MAX_PROBE; i++)
+    {
+        Bucket& b = m_table[(index + i) & mask];
+        if (!b.m_used)
+        {
+            if (!replace || replace->m_used)
+                replace = &b;
+            continue;
+        }
+        if (b.m_key == key)
+        {
+            found = &b;
+            break;
+        }
+        if (!replace || (replace->m_used &&
+            b.m_last_time < replace->m_last_time))
+            replace = &b;
+    }
+    if (!found)
+    {
+        found = replace;
+        found->m_key = key;
+        found->m_used = true;
+        found->m_tokens = m_burst;
+    }
+    else if (now > found->m_last_time)
+    {
+        found->m_tokens = std::min(m_burst, found->m_tokens +
+            (float)(now - found->m_last_time) * m_rate / 1000.0f);
+    }
+    found->m_last_time = now;
+    if (found->m_tokens < 1.0f)
+        return false;
+    found->m_tokens -= 1.0f;
+    return true;
+}   // take
+
+// ----------------------------------------------------------------------------
+/** Creates the limiter.
+ *  \param rate Number of connection requests per second allowed from one
+ *         address on average, 0 disables the limiter.
+ *  \param burst Number of connection requests allowed at once.
+ */
+ConnectionLimiter::ConnectionLimiter(float rate, float burst)
+                 : m_verified(randomSeed(), rate, burst),
+                   m_unverified(randomSeed(), rate, burst)
+{
+    std::random_device rd;
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (int i = 0; i < 16; i++)
+        m_secret.push_back((char)byte(rd));
+    m_challenged = 0;
+    m_dropped = 0;
+    m_last_log_time = 0;
+    m_enabled = rate > 0.0f;
+}   // ConnectionLimiter
+
+// ----------------------------------------------------------------------------
+/** Returns the key of the bucket of an address: the IPv4 address, or the
+ *  first 64 bits of an IPv6 address (a single host usually has a whole /64
+ *  network).
+ */
+uint64_t ConnectionLimiter::getKey(const SocketAddress& addr)
+{
+    // Also returns the IPv4 address of an IPv4 mapped IPv6 address
+    const uint32_t ip = addr.getIP();
+    if (ip != 0 || addr.getFamily() != AF_INET6)
+        return ip;
+    const sockaddr_in6* in6 = (const sockaddr_in6*)addr.getSockaddr();
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++)
+        key = (key << 8) | in6->sin6_addr.s6_addr[i];
+    // Keep IPv6 keys apart from IPv4 keys
+    return key | (1ULL << 63);
+}   // getKey
+
+// ----------------------------------------------------------------------------
+uint32_t ConnectionLimiter::getCookieForSlot(const SocketAddress& addr,
+                                             uint64_t slot) const
+{
+    std::string input = m_secret;
+    if (addr.getFamily() == AF_INET6)
+    {
+        const sockaddr_in6* in6 = (const sockaddr_in6*)addr.getSockaddr();
+        input.append((const char*)in6->sin6_addr.s6_addr, 16);
+    }
+    else
+    {
+        const uint32_t ip = addr.getIP();
+        input.append((const char*)&ip, sizeof(ip));
+    }
+    const uint16_t port = addr.getPort();
+    input.append((const char*)&port, sizeof(port));
+    input.append((const char*)&slot, sizeof(slot));
+    std::array<uint8_t, 32> hash = Crypto::sha256(input);
+    uint32_t cookie = ((uint32_t)hash[0] << 24) | ((uint32_t)hash[1] << 16) |
+        ((uint32_t)hash[2] << 8) | hash[3];
+    // 0 is the connection data of a request without cookie
+    return cookie == 0 ? 1 : cookie;
+}   // getCookieForSlot
+
+// ----------------------------------------------------------------------------
+/** Returns the cookie which is sent to an address (including the port)
+ *  which needs to prove that it can receive packets.
+ *  \param addr The address of the sender of a connection request.
+ *  \param now Current time in ms.
+ */
+uint32_t ConnectionLimiter::getCookie(const SocketAddress& addr,
+                                      uint64_t now) const
+{
+    return getCookieForSlot(addr, now / COOKIE_TIME_SLOT);
+}   // getCookie
+
+// ----------------------------------------------------------------------------
+/** Checks if a cookie was sent to the address in the current or the
+ *  previous time slot.
+ */
+bool ConnectionLimiter::checkCookie(const SocketAddress& addr,
+                                    uint32_t cookie, uint64_t now) const
+{
+    if (cookie == 0)
+        return false;
+    const uint64_t slot = now / COOKIE_TIME_SLOT;
+    return cookie == getCookieForSlot(addr, slot) ||
+        (slot > 0 && cookie == getCookieForSlot(addr, slot - 1));
+}   // checkCookie
+
+// ----------------------------------------------------------------------------
+/** Decides what to do with an ENet connection request, before ENet
+ *  allocates a peer for it.
+ *  \param addr The address of the sender.
+ *  \param cookie The data of the connection request, a cookie if it was
+ *         sent by the client.
+ *  \param half_open Number of peers of which the connection is not yet
+ *         acknowledged.
+ *  \param now Current time in ms.
+ */
+ConnectionLimiter::Decision
+    ConnectionLimiter::handleConnect(const SocketAddress& addr,
+                                     uint32_t cookie, unsigned half_open,
+                                     uint64_t now)
+{
+    if (!m_enabled)
+        return CD_ACCEPT;
+    Decision decision;
+    if (checkCookie(addr, cookie, now))
+    {
+        // The sender can receive packets, so the address is not spoofed
+        decision = m_verified.take(getKey(addr), now) ? CD_ACCEPT : CD_DROP;
+    }
+    else if (half_open < MAX_HALF_OPEN &&
+        m_unverified.take(getKey(addr), now))
+    {
+        decision = CD_ACCEPT;
+    }
+    else
+        decision = CD_CHALLENGE;
+
+    if (decision == CD_CHALLENGE)
+        m_challenged++;
+    else if (decision == CD_DROP)
+        m_dropped++;
+    logStatistics(now);
+    return decision;
+}   // handleConnect
+
+// ----------------------------------------------------------------------------
+/** Rate limits a request which cannot be challenged (like a connection
+ *  request to the LAN discovery socket).
+ *  \return True if the request should be handled.
+ */
+bool ConnectionLimiter::allowRequest(const SocketAddress& addr, uint64_t now)
+{
+    if (!m_enabled || m_unverified.take(getKey(addr), now))
+        return true;
+    m_dropped++;
+    logStatistics(now);
+    return false;
+}   // allowRequest
+
+// ----------------------------------------------------------------------------
+void ConnectionLimiter::logStatistics(uint64_t now)
+{
+    if (m_challenged + m_dropped == 0 ||
+        now < m_last_log_time + LOG_INTERVAL)
+        return;
+    Log::warn("ConnectionLimiter", "%u connection requests challenged and "
+        "%u dropped, the server may be flooded.", m_challenged, m_dropped);
+    m_challenged = 0;
+    m_dropped = 0;
+    m_last_log_time = now;
+}   // logStatistics
+
+// ----------------------------------------------------------------------------
+/** Checks a condition of the unit test. Unlike assert() this also works in
+ *  release builds. */
+#define CL_TEST(condition)                                                  \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+            Log::fatal("ConnectionLimiter", "Unit test failed: %s",         \
+                       #condition);                                         \
+    } while (false)
+
+// ----------------------------------------------------------------------------
+/** Simulates floods of connection requests and checks that legitimate
+ *  clients can still connect.
+ */
+void ConnectionLimiter::unitTesting()
+{
+    const uint64_t start = 1000000;
+    // Cookies
+    {
+        ConnectionLimiter cl(1.0f, 5.0f);
+        SocketAddress client(10, 0, 0, 1, 2759);
+        uint32_t cookie = cl.getCookie(client, start);
+        CL_TEST(cookie != 0);
+        CL_TEST(cl.checkCookie(client, cookie, start));
+        CL_TEST(cl.checkCookie(client, cookie, start + COOKIE_TIME_SLOT));
+        CL_TEST(!cl.checkCookie(client, cookie,
+            start + 2 * COOKIE_TIME_SLOT));
+        CL_TEST(!cl.checkCookie(SocketAddress(10, 0, 0, 2, 2759), cookie,
+            start));
+        CL_TEST(!cl.checkCookie(SocketAddress(10, 0, 0, 1, 2760), cookie,
+            start));
+        CL_TEST(!cl.checkCookie(client, 0, start));
+        ConnectionLimiter other(1.0f, 5.0f);
+        CL_TEST(!other.checkCookie(client, cookie, start));
+    }
+
+    // Token buckets of a single address
+    {
+        ConnectionLimiter cl(1.0f, 5.0f);
+        SocketAddress client(192, 168, 0, 10, 2759);
+        for (int i = 0; i < 5; i++)
+            CL_TEST(cl.handleConnect(client, 0, 0, start) == CD_ACCEPT);
+        // The next request needs to prove its address
+        CL_TEST(cl.handleConnect(client, 0, 0, start) == CD_CHALLENGE);
+        uint32_t cookie = cl.getCookie(client, start);
+        for (int i = 0; i < 5; i++)
+        {
+            CL_TEST(cl.handleConnect(client, cookie, 0, start + 100) ==
+                CD_ACCEPT);
+        }
+        CL_TEST(cl.handleConnect(client, cookie, 0, start + 100) == CD_DROP);
+        // One more token per second, and the port does not matter
+        CL_TEST(cl.handleConnect(SocketAddress(192, 168, 0, 10, 1234), 0, 0,
+            start + 1000) == CD_ACCEPT);
+        CL_TEST(cl.handleConnect(client, 0, 0, start + 1000) == CD_CHALLENGE);
+        CL_TEST(cl.handleConnect(client, cookie, 0, start + 1100) ==
+            CD_ACCEPT);
+        // A disabled limiter accepts everything
+        ConnectionLimiter disabled(0.0f, 5.0f);
+        for (int i = 0; i < 100; i++)
+        {
+            CL_TEST(disabled.handleConnect(client, 0, 100, start) ==
+                CD_ACCEPT);
+        }
+    }
+
+    // Flood with spoofed addresses, which include the address of the client
+    {
+        ConnectionLimiter cl(1.0f, 5.0f);
+        SocketAddress client(172, 16, 5, 5, 2759);
+        std::mt19937 rng(42);
+        unsigned half_open = 0;
+        int accepted = 0, challenged = 0;
+        for (int i = 0; i < 200000; i++)
+        {
+            uint64_t now = start + i / 100;
+            SocketAddress spoofed = i % 10 == 0 ? client :
+                SocketAddress((uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng(),
+                (uint8_t)rng(), (uint16_t)rng());
+            Decision d = cl.handleConnect(spoofed, (uint32_t)rng(),
+                half_open, now);
+            if (d == CD_ACCEPT)
+            {
+                // Spoofed senders never finish the connection
+                accepted++;
+                half_open++;
+            }
+            else if (d == CD_CHALLENGE)
+                challenged++;
+        }
+        // Only requests till the half open connections are too many are
+        // accepted, all others are challenged
+        CL_TEST(accepted == (int)MAX_HALF_OPEN);
+        CL_TEST(challenged == 200000 - accepted);
+        // The real client can answer the challenge and connect
+        const uint64_t now = start + 2000;
+        uint32_t cookie = cl.getCookie(client, now);
+        CL_TEST(cl.handleConnect(client, 0, half_open, now) == CD_CHALLENGE);
+        CL_TEST(cl.handleConnect(client, cookie, half_open, now) ==
+            CD_ACCEPT);
+    }
+
+    // Many different senders, without half open connections: each one is
+    // limited
+    {
+        ConnectionLimiter cl(1.0f, 5.0f);
+        SocketAddress attacker(10, 1, 1, 1, 4000);
+        int accepted = 0;
+        uint64_t now = start;
+        for (int i = 0; i < 100000; i++)
+        {
+            // 10 seconds in total
+            now = start + i / 10;
+            uint32_t ip = 0x0b000000 + i;
+            SocketAddress sender((uint8_t)(ip >> 24), (uint8_t)(ip >> 16),
+                (uint8_t)(ip >> 8), (uint8_t)ip, 4000);
+            CL_TEST(cl.handleConnect(sender, 0, 0, now) == CD_ACCEPT);
+            if (cl.handleConnect(attacker, 0, 0, now) == CD_ACCEPT)
+                accepted++;
+        }
+        // The bucket of a sender which keeps sending is not replaced, so
+        // it gets the burst and one request per second only
+        CL_TEST(accepted <= 5 + 10 + 1);
+        CL_TEST(!cl.allowRequest(attacker, now));
+    }
+
+    // IPv6 senders share a bucket per /64 network
+    {
+        ConnectionLimiter cl(1.0f, 2.0f);
+        SocketAddress a("2001:db8:1:2::1", 2759, AF_INET6);
+        SocketAddress b("2001:db8:1:2::2", 2759, AF_INET6);
+        SocketAddress c("2001:db8:1:3::1", 2759, AF_INET6);
+        if (a.getFamily() == AF_INET6)
+        {
+            CL_TEST(cl.handleConnect(a, 0, 0, start) == CD_ACCEPT);
+            CL_TEST(cl.handleConnect(b, 0, 0, start) == CD_ACCEPT);
+            CL_TEST(cl.handleConnect(a, 0, 0, start) == CD_CHALLENGE);
+            CL_TEST(cl.handleConnect(c, 0, 0, start) == CD_ACCEPT);
+        }
+    }
+}   // unitTesting
+
+#undef CL_TEST
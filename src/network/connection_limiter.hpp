@@ -0,0 +1,134 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_CONNECTION_LIMITER_HPP
+#define HEADER_CONNECTION_LIMITER_HPP
+
+#include "utils/no_copy.hpp"
+#include "utils/types.hpp"
+
+#include <string>
+#include <vector>
+
+class SocketAddress;
+
+/** \ingroup network
+ *  Protects a server against floods of connection requests, before ENet
+ *  allocates a peer for them (and the lobby starts its much more expensive
+ *  work for a connected peer).
+ *  Each IP address (or IPv6 /64 network) has a token bucket, which allows
+ *  a few connection attempts in a burst and a small rate afterwards. The
+ *  buckets are kept in a fixed size open addressing hash table, so neither
+ *  memory nor time per request grows with the number of (spoofed) senders:
+ *  if the probed slots are all used, the least recently used one is
+ *  replaced.
+ *  While many connections are half open (which happens with spoofed
+ *  senders, they never acknowledge the connection), new connection requests
+ *  are answered with a stateless cookie instead, i.e. a keyed hash of the
+ *  address and the current time slot. Only a client which received it (so
+ *  it does not use a spoofed address) can send it back in the data of its
+ *  next ENet connection request. Such a request is rate limited by a
+ *  separate table, so spoofed requests cannot use up the tokens of the
+ *  address they pretend to be.
+ */
+class ConnectionLimiter : public NoCopy
+{
+public:
+    enum Decision
+    {
+        /** Let ENet handle the connection request. */
+        CD_ACCEPT,
+        /** Send a cookie and drop the request. */
+        CD_CHALLENGE,
+        /** Drop the request silently. */
+        CD_DROP
+    };
+
+private:
+    /** The token buckets of one table. */
+    class Buckets
+    {
+    private:
+        struct Bucket
+        {
+            uint64_t m_key;
+            uint64_t m_last_time;
+            float m_tokens;
+            bool m_used;
+        };
+        std::vector<Bucket> m_table;
+        uint64_t m_seed;
+        float m_rate;
+        float m_burst;
+    public:
+        Buckets(uint64_t seed, float rate, float burst);
+        // --------------------------------------------------------------------
+        bool take(uint64_t key, uint64_t now);
+    };   // Buckets
+
+    /** Secret which is hashed together with the address for the cookies. */
+    std::string m_secret;
+
+    /** Buckets of requests with a valid cookie. */
+    Buckets m_verified;
+
+    /** Buckets of all other requests. */
+    Buckets m_unverified;
+
+    /** Statistics since the last time they were logged. */
+    uint32_t m_challenged;
+    uint32_t m_dropped;
+    uint64_t m_last_log_time;
+
+    /** False if the rate was set to 0, i.e. there is no limit. */
+    bool m_enabled;
+
+    // ------------------------------------------------------------------------
+    static uint64_t getKey(const SocketAddress& addr);
+    // ------------------------------------------------------------------------
+    uint32_t getCookieForSlot(const SocketAddress& addr,
+                              uint64_t slot) const;
+    // ------------------------------------------------------------------------
+    void logStatistics(uint64_t now);
+
+public:
+    /** Length of a time slot for cookies in ms, a cookie is valid in its
+     *  time slot and the next one. */
+    static const uint64_t COOKIE_TIME_SLOT = 10000;
+
+    /** Number of half open connections from which on connection requests
+     *  without a valid cookie are challenged. */
+    static const unsigned MAX_HALF_OPEN = 2;
+
+    // ------------------------------------------------------------------------
+    ConnectionLimiter(float rate, float burst);
+    // ------------------------------------------------------------------------
+    uint32_t getCookie(const SocketAddress& addr, uint64_t now) const;
+    // ------------------------------------------------------------------------
+    bool checkCookie(const SocketAddress& addr, uint32_t cookie,
+                     uint64_t now) const;
+    // ------------------------------------------------------------------------
+    Decision handleConnect(const SocketAddress& addr, uint32_t cookie,
+                           unsigned half_open, uint64_t now);
+    // ------------------------------------------------------------------------
+    bool allowRequest(const SocketAddress& addr, uint64_t now);
+    // ------------------------------------------------------------------------
+    static void unitTesting();
+};   // ConnectionLimiter
+
+#endif
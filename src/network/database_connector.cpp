@@ -0,0 +1,651 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifdef ENABLE_SQLITE3
+
+#include "network/database_connector.hpp"
+
+#include "network/server_metrics.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
+#include "utils/string_utils.hpp"
+#include "utils/time.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <sys/stat.h>
+
+// ----------------------------------------------------------------------------
+int DatabaseConnector::Value::bind(sqlite3_stmt* stmt, int index) const
+{
+    switch (m_type)
+    {
+    case VT_NULL:
+        return sqlite3_bind_null(stmt, index);
+    case VT_INT:
+        return sqlite3_bind_int64(stmt, index, m_int);
+    case VT_TEXT:
+        // The values are kept until the statement is reset
+        return sqlite3_bind_text(stmt, index, m_text.c_str(),
+            (int)m_text.size(), SQLITE_STATIC);
+    }
+    return SQLITE_MISUSE;
+}   // bind
+
+// ============================================================================
+DatabaseConnector::DatabaseConnector()
+{
+    m_db = NULL;
+    m_batch_time = 0;
+    m_timeout = 0;
+    m_now = 0;
+    m_transaction_start = 0;
+    m_in_transaction = false;
+    m_pending_writes = 0;
+    m_update_writes = 0;
+}   // DatabaseConnector
+
+// ----------------------------------------------------------------------------
+DatabaseConnector::~DatabaseConnector()
+{
+    close();
+}   // ~DatabaseConnector
+
+// ----------------------------------------------------------------------------
+/** Opens an existing database.
+ *  \param path Path of the database file.
+ *  \param wal Use write-ahead logging, otherwise the journal mode of the
+ *         database is not changed.
+ *  \param timeout Maximum time in ms to wait for a database locked by
+ *         another connection.
+ *  \param batch_time Time in ms for which writes are collected in one
+ *         transaction.
+ *  \return True if the database was opened.
+ */
+bool DatabaseConnector::open(const std::string& path, bool wal, int timeout,
+                             unsigned batch_time)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    assert(!m_db);
+    m_timeout = timeout;
+    m_batch_time = batch_time;
+    int ret = sqlite3_open_v2(path.c_str(), &m_db,
+        SQLITE_OPEN_SHAREDCACHE | SQLITE_OPEN_FULLMUTEX |
+        SQLITE_OPEN_READWRITE, NULL);
+    if (ret != SQLITE_OK)
+    {
+        Log::error("DatabaseConnector", "Cannot open database: %s.",
+            sqlite3_errmsg(m_db));
+        sqlite3_close(m_db);
+        m_db = NULL;
+        return false;
+    }
+    sqlite3_busy_handler(m_db, [](void* data, int retry)
+        {
+            DatabaseConnector* dc = (DatabaseConnector*)data;
+            int retry_count = dc->m_timeout / 100;
+            if (retry < retry_count)
+            {
+                sqlite3_sleep(100);
+                // Return non-zero to let caller retry again
+                return 1;
+            }
+            // Return zero to let caller return SQLITE_BUSY immediately
+            return 0;
+        }, this);
+
+    if (wal)
+    {
+        std::string mode;
+        sqlite3_exec(m_db, "PRAGMA journal_mode=WAL;",
+            [](void* ptr, int count, char** data, char** columns)
+            {
+                if (count > 0 && data[0])
+                    *(std::string*)ptr = data[0];
+                return 0;
+            }, &mode, NULL);
+        if (mode == "wal")
+        {
+            // Only a power loss can lose the last transactions in WAL mode
+            executeLocked("PRAGMA synchronous=NORMAL;");
+            Log::info("DatabaseConnector", "Using write-ahead logging.");
+        }
+        else
+        {
+            Log::warn("DatabaseConnector",
+                "Cannot use write-ahead logging: %s.", sqlite3_errmsg(m_db));
+        }
+    }
+    if (m_batch_time > 0)
+    {
+        Log::info("DatabaseConnector", "Writes are committed every %ums.",
+            (unsigned)m_batch_time);
+    }
+    return true;
+}   // open
+
+// ----------------------------------------------------------------------------
+/** Commits all pending writes and closes the database. */
+void DatabaseConnector::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_db)
+        return;
+    commitLocked();
+    if (m_in_transaction)
+    {
+        Log::error("DatabaseConnector", "%u writes are lost.",
+            m_pending_writes);
+    }
+    for (auto& statement : m_statements)
+        sqlite3_finalize(statement.second);
+    m_statements.clear();
+    sqlite3_close(m_db);
+    m_db = NULL;
+    m_in_transaction = false;
+    m_pending_writes = 0;
+}   // close
+
+// ----------------------------------------------------------------------------
+/** Returns the prepared statement of a query, or NULL if the query is
+ *  invalid. */
+sqlite3_stmt* DatabaseConnector::getStatement(const std::string& query)
+{
+    auto it = m_statements.find(query);
+    if (it != m_statements.end())
+        return it->second;
+    sqlite3_stmt* stmt = NULL;
+    if (sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0) != SQLITE_OK)
+    {
+        Log::error("DatabaseConnector",
+            "Error preparing database for query %s: %s",
+            query.c_str(), sqlite3_errmsg(m_db));
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+    m_statements[query] = stmt;
+    return stmt;
+}   // getStatement
+
+// ----------------------------------------------------------------------------
+bool DatabaseConnector::bindValues(sqlite3_stmt* stmt,
+                                   const std::string& query,
+                                   const std::vector<Value>& values)
+{
+    if (sqlite3_bind_parameter_count(stmt) != (int)values.size())
+    {
+        Log::error("DatabaseConnector", "Query %s needs %d values, not %d.",
+            query.c_str(), sqlite3_bind_parameter_count(stmt),
+            (int)values.size());
+        return false;
+    }
+    for (unsigned i = 0; i < values.size(); i++)
+    {
+        if (values[i].bind(stmt, i + 1) != SQLITE_OK)
+        {
+            Log::error("DatabaseConnector",
+                "Failed to bind value %u for query %s: %s", i + 1,
+                query.c_str(), sqlite3_errmsg(m_db));
+            return false;
+        }
+    }
+    return true;
+}   // bindValues
+
+// ----------------------------------------------------------------------------
+bool DatabaseConnector::executeLocked(const std::string& query)
+{
+    char* error = NULL;
+    if (sqlite3_exec(m_db, query.c_str(), NULL, NULL, &error) != SQLITE_OK)
+    {
+        Log::error("DatabaseConnector", "Error executing query %s: %s",
+            query.c_str(), error ? error : "");
+        sqlite3_free(error);
+        return false;
+    }
+    return true;
+}   // executeLocked
+
+// ----------------------------------------------------------------------------
+/** Executes a query (or several separated by ;) once, without keeping its
+ *  prepared statement, e.g. to create tables or for queries with a
+ *  different text each time. Pending writes are committed first.
+ *  \return True if no error occurs.
+ */
+bool DatabaseConnector::execute(const std::string& query)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_db)
+        return false;
+    ServerMetrics::ScopedTimer sql_timer(ServerMetrics::HT_SQL_QUERY);
+    commitLocked();
+    return executeLocked(query);
+}   // execute
+
+// ----------------------------------------------------------------------------
+/** Executes a query which changes the database, it is written to disk with
+ *  the next commit.
+ *  \param query The query with a ? for each value.
+ *  \param values The values for the parameters.
+ *  \return True if no error occurs.
+ */
+bool DatabaseConnector::write(const std::string& query,
+                              const std::vector<Value>& values)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_db)
+        return false;
+    ServerMetrics::ScopedTimer sql_timer(ServerMetrics::HT_SQL_QUERY);
+    sqlite3_stmt* stmt = getStatement(query);
+    if (!stmt)
+        return false;
+    if (m_batch_time > 0 && !m_in_transaction && executeLocked("BEGIN;"))
+    {
+        m_in_transaction = true;
+        m_transaction_start = m_now;
+    }
+
+    bool written = false;
+    if (bindValues(stmt, query, values))
+    {
+        int ret = sqlite3_step(stmt);
+        written = ret == SQLITE_DONE || ret == SQLITE_ROW;
+        if (!written)
+        {
+            Log::error("DatabaseConnector",
+                "Error writing database for query %s: %s",
+                query.c_str(), sqlite3_errmsg(m_db));
+        }
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    if (m_in_transaction)
+    {
+        // Some errors (like a full disk) roll back the whole transaction
+        if (sqlite3_get_autocommit(m_db))
+        {
+            Log::error("DatabaseConnector", "%u writes were rolled back.",
+                m_pending_writes);
+            m_in_transaction = false;
+            m_pending_writes = 0;
+        }
+        else if (written)
+            m_pending_writes++;
+    }
+    return written;
+}   // write
+
+// ----------------------------------------------------------------------------
+/** Executes a query which reads from the database (it sees the pending
+ *  writes too).
+ *  \param query The query with a ? for each value.
+ *  \param values The values for the parameters.
+ *  \param row_function Called for each row of the result, it must not use
+ *         this connector.
+ *  \return True if no error occurs.
+ */
+bool DatabaseConnector::read(const std::string& query,
+                             const std::vector<Value>& values,
+                             std::function<void(sqlite3_stmt* stmt)>
+                             row_function)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_db)
+        return false;
+    ServerMetrics::ScopedTimer sql_timer(ServerMetrics::HT_SQL_QUERY);
+    sqlite3_stmt* stmt = getStatement(query);
+    if (!stmt)
+        return false;
+
+    bool success = false;
+    if (bindValues(stmt, query, values))
+    {
+        int ret = sqlite3_step(stmt);
+        while (ret == SQLITE_ROW)
+        {
+            row_function(stmt);
+            ret = sqlite3_step(stmt);
+        }
+        success = ret == SQLITE_DONE;
+        if (!success)
+        {
+            Log::error("DatabaseConnector",
+                "Error reading database for query %s: %s",
+                query.c_str(), sqlite3_errmsg(m_db));
+        }
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return success;
+}   // read
+
+// ----------------------------------------------------------------------------
+/** Commits the pending writes if the batch time is over, or if there was
+ *  no write since the previous call. It is called every frame, so the
+ *  database is not locked for the whole batch time after a single write.
+ *  \param now Current time in ms.
+ */
+void DatabaseConnector::update(uint64_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_now = now;
+    if (m_db && m_in_transaction &&
+        (now >= m_transaction_start + m_batch_time ||
+         m_pending_writes == m_update_writes))
+    {
+        ServerMetrics::ScopedTimer sql_timer(ServerMetrics::HT_SQL_QUERY);
+        commitLocked();
+    }
+    m_update_writes = m_pending_writes;
+}   // update
+
+// ----------------------------------------------------------------------------
+/** Commits the pending writes now. */
+void DatabaseConnector::commit()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_db)
+        commitLocked();
+}   // commit
+
+// ----------------------------------------------------------------------------
+void DatabaseConnector::commitLocked()
+{
+    if (!m_in_transaction)
+        return;
+    // If the database is locked by another connection for longer than the
+    // timeout, the transaction stays open and is committed next time
+    if (executeLocked("COMMIT;") || sqlite3_get_autocommit(m_db))
+    {
+        m_in_transaction = false;
+        m_pending_writes = 0;
+    }
+}   // commitLocked
+
+// ----------------------------------------------------------------------------
+/** Simulates the database writes of a busy server: 10000 players connect
+ *  and disconnect, with 100 of them connected at the same time and one
+ *  event every 10ms. For each connection the IP ban table is checked and a
+ *  row is added to the stats table, which is updated when the player
+ *  disconnects. It is run with the queries of old versions (which were
+ *  prepared each time and written in their own transaction), and with
+ *  this connector with and without batches and write-ahead logging.
+ *  \param path A new database file, it is removed afterwards.
+ */
+void DatabaseConnector::benchmark(const std::string& path)
+{
+    struct stat st;
+    if (FileUtils::statU8Path(path, &st) == 0)
+    {
+        Log::error("DatabaseConnector",
+            "'%s' exists already, the benchmark needs a new file.",
+            path.c_str());
+        return;
+    }
+
+    const unsigned num_hosts = 10000;
+    const unsigned num_connected = 100;
+    const uint64_t event_time = 10;
+    const char* modes[] = { "Prepared each time, one transaction per write",
+                            "Cached statements, one transaction per write",
+                            "Cached statements, batches of 500ms",
+                            "Cached statements, batches of 500ms, WAL" };
+    for (unsigned mode = 0; mode < 4; mode++)
+    {
+        // Create the database like an operator would
+        sqlite3* db = NULL;
+        sqlite3_open(path.c_str(), &db);
+        sqlite3_close(db);
+
+        DatabaseConnector dc;
+        if (!dc.open(path, mode == 3, 1000, mode >= 2 ? 500 : 0))
+            return;
+        dc.execute("CREATE TABLE stats (\n"
+            "    host_id INTEGER UNSIGNED NOT NULL PRIMARY KEY,\n"
+            "    ip INTEGER UNSIGNED NOT NULL,\n"
+            "    port INTEGER UNSIGNED NOT NULL,\n"
+            "    online_id INTEGER UNSIGNED NOT NULL,\n"
+            "    username TEXT NOT NULL,\n"
+            "    player_num INTEGER UNSIGNED NOT NULL,\n"
+            "    country_code TEXT NULL DEFAULT NULL,\n"
+            "    version TEXT NOT NULL,\n"
+            "    os TEXT NOT NULL,\n"
+            "    connected_time TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,\n"
+            "    disconnected_time TIMESTAMP NOT NULL\n"
+            "        DEFAULT CURRENT_TIMESTAMP,\n"
+            "    ping INTEGER UNSIGNED NOT NULL DEFAULT 0,\n"
+            "    packet_loss INTEGER NOT NULL DEFAULT 0\n"
+            ") WITHOUT ROWID;\n"
+            "CREATE TABLE ip_ban (\n"
+            "    ip_start INTEGER UNSIGNED NOT NULL UNIQUE,\n"
+            "    ip_end INTEGER UNSIGNED NOT NULL UNIQUE,\n"
+            "    starting_time TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,\n"
+            "    expired_days REAL NULL DEFAULT NULL,\n"
+            "    reason TEXT NOT NULL DEFAULT '',\n"
+            "    description TEXT NOT NULL DEFAULT '',\n"
+            "    trigger_count INTEGER UNSIGNED NOT NULL DEFAULT 0,\n"
+            "    last_trigger TIMESTAMP NULL DEFAULT NULL\n"
+            ");\n"
+            "INSERT INTO ip_ban (ip_start, ip_end, starting_time, reason) "
+            "VALUES (167772160, 167772415, '2000-01-01', 'Spam');");
+
+        const std::string ban_query = "SELECT rowid, reason FROM ip_ban "
+            "WHERE ip_start <= ? AND ip_end >= ? "
+            "AND datetime('now') > datetime(starting_time) AND "
+            "(expired_days is NULL OR datetime"
+            "(starting_time, '+'||expired_days||' days') > datetime('now')) "
+            "LIMIT 1;";
+        const std::string connect_query = "INSERT INTO stats "
+            "(host_id, ip, port, online_id, username, player_num, "
+            "country_code, version, os) VALUES (?, ?, ?, ?, ?, 1, ?, ?, ?);";
+        const std::string disconnect_query = "UPDATE stats SET "
+            "disconnected_time = datetime('now'), ping = ?, packet_loss = ? "
+            "WHERE host_id = ?;";
+        // The queries of old versions, with the values in their text
+        auto old_query = [&dc](const std::string& query)
+            {
+                sqlite3_stmt* stmt = NULL;
+                if (sqlite3_prepare_v2(dc.getDB(), query.c_str(), -1, &stmt,
+                    0) == SQLITE_OK)
+                {
+                    while (sqlite3_step(stmt) == SQLITE_ROW) {}
+                }
+                sqlite3_finalize(stmt);
+            };
+        auto connect = [&](unsigned host_id)
+            {
+                const uint32_t ip = 0x0B000000 + host_id;
+                const std::string name = "Player " +
+                    StringUtils::toString(host_id);
+                if (mode == 0)
+                {
+                    old_query(StringUtils::insertValues(
+                        "SELECT rowid, reason FROM ip_ban "
+                        "WHERE ip_start <= %u AND ip_end >= %u "
+                        "AND datetime('now') > datetime(starting_time) AND "
+                        "(expired_days is NULL OR datetime"
+                        "(starting_time, '+'||expired_days||' days') > "
+                        "datetime('now')) LIMIT 1;", ip, ip));
+                    old_query(StringUtils::insertValues(
+                        "INSERT INTO stats "
+                        "(host_id, ip, port, online_id, username, "
+                        "player_num, country_code, version, os) "
+                        "VALUES (%u, %u, %u, %u, '%s', 1, 'DE', 'git', "
+                        "'Linux');", host_id, ip, 2759, host_id,
+                        name.c_str()));
+                    return;
+                }
+                dc.read(ban_query, { (int64_t)ip, (int64_t)ip },
+                    [](sqlite3_stmt* stmt) {});
+                dc.write(connect_query, { (int64_t)host_id, (int64_t)ip,
+                    (int64_t)2759, (int64_t)host_id, name, "DE", "git",
+                    "Linux" });
+            };
+        auto disconnect = [&](unsigned host_id)
+            {
+                if (mode == 0)
+                {
+                    old_query(StringUtils::insertValues(
+                        "UPDATE stats SET "
+                        "disconnected_time = datetime('now'), ping = %d, "
+                        "packet_loss = %d WHERE host_id = %u;", 50, 0,
+                        host_id));
+                    return;
+                }
+                dc.write(disconnect_query,
+                    { (int64_t)50, (int64_t)0, (int64_t)host_id });
+            };
+
+        const uint64_t start = StkTime::getMonoTimeMs();
+        uint64_t now = 0;
+        for (unsigned i = 0; i < num_hosts + num_connected; i++)
+        {
+            if (i < num_hosts)
+                connect(i + 1);
+            if (i >= num_connected)
+                disconnect(i + 1 - num_connected);
+            now += event_time;
+            dc.update(now);
+        }
+        dc.commit();
+        const uint64_t elapsed = StkTime::getMonoTimeMs() - start;
+
+        unsigned rows = 0;
+        dc.read("SELECT COUNT(*) FROM stats WHERE ping = 50;", {},
+            [&rows](sqlite3_stmt* stmt)
+            {
+                rows = (unsigned)sqlite3_column_int(stmt, 0);
+            });
+        dc.close();
+        Log::info("DatabaseConnector", "%s: %u connects and disconnects in "
+            "%ums (%.1fus each), %u rows written.", modes[mode], num_hosts,
+            (unsigned)elapsed, elapsed * 1000.0f / (num_hosts * 2), rows);
+
+        remove(FileUtils::getPortableWritingPath(path).c_str());
+        remove(FileUtils::getPortableWritingPath(path + "-wal").c_str());
+        remove(FileUtils::getPortableWritingPath(path + "-shm").c_str());
+    }
+}   // benchmark
+
+// ----------------------------------------------------------------------------
+void DatabaseConnector::unitTesting()
+{
+    // The results are stored first, so the calls are still made if asserts
+    // are compiled out
+    DatabaseConnector dc;
+    bool success = dc.open(":memory:", false, 0, 100);
+    assert(success);
+    dc.update(1000);
+    success = dc.execute("CREATE TABLE test (id INTEGER PRIMARY KEY, "
+        "name TEXT NOT NULL, country TEXT NULL DEFAULT NULL);");
+    assert(success);
+    assert(dc.getNumStatements() == 0);
+
+    // Values are bound, so quotes in them do not matter, and each query
+    // is only prepared once
+    const std::string insert =
+        "INSERT INTO test (id, name, country) VALUES (?, ?, ?);";
+    success = dc.write(insert, { (int64_t)1, "a'b\"c", "DE" });
+    assert(success);
+    success = dc.write(insert, { (int64_t)2, "x", DatabaseConnector::Value() });
+    assert(success);
+    assert(dc.getNumStatements() == 1);
+    // Wrong number of values, a constraint error and an invalid query
+    success = dc.write(insert, { (int64_t)3 });
+    assert(!success);
+    success = dc.write(insert, { (int64_t)1, "y", "FR" });
+    assert(!success);
+    success = dc.write("INSERT INTO nothing VALUES (?);", { (int64_t)1 });
+    assert(!success);
+    assert(dc.getNumStatements() == 1);
+
+    // The writes are in one transaction, but they can be read already
+    assert(!sqlite3_get_autocommit(dc.getDB()));
+    std::vector<std::string> names;
+    unsigned nulls = 0;
+    success = dc.read("SELECT name, country FROM test ORDER BY id;",
+        {},
+        [&names, &nulls](sqlite3_stmt* stmt)
+        {
+            names.push_back((const char*)sqlite3_column_text(stmt, 0));
+            if (sqlite3_column_type(stmt, 1) == SQLITE_NULL)
+                nulls++;
+        });
+    assert(success);
+    assert(names.size() == 2);
+    assert(names[0] == "a'b\"c");
+    assert(nulls == 1);
+    // There were writes since the last update, so the transaction is kept
+    dc.update(1050);
+    assert(!sqlite3_get_autocommit(dc.getDB()));
+    // No more writes, so it is committed before the batch time is over
+    dc.update(1060);
+    assert(sqlite3_get_autocommit(dc.getDB()));
+
+    // Writes in every update are committed after the batch time
+    for (unsigned i = 0; i < 10; i++)
+    {
+        success = dc.write(insert,
+            { (int64_t)(10 + i), "b", DatabaseConnector::Value() });
+        assert(success);
+        dc.update(1070 + i * 10);
+        // The transaction started at 1060
+        assert((sqlite3_get_autocommit(dc.getDB()) != 0) == (i == 9));
+    }
+
+    // A new transaction starts with the next write
+    success = dc.write("UPDATE test SET name = ? WHERE id = ?;",
+        { "z", (int64_t)2 });
+    assert(success);
+    assert(!sqlite3_get_autocommit(dc.getDB()));
+    success = dc.execute("DELETE FROM test WHERE id = 1;");
+    assert(success);
+    assert(sqlite3_get_autocommit(dc.getDB()));
+    int count = -1;
+    success = dc.read("SELECT COUNT(*) FROM test WHERE name = ?;", { "z" },
+        [&count](sqlite3_stmt* stmt)
+        {
+            count = sqlite3_column_int(stmt, 0);
+        });
+    assert(success);
+    assert(count == 1);
+    success = dc.read("SELECT COUNT(*) FROM test WHERE name = ?;", { "b" },
+        [&count](sqlite3_stmt* stmt)
+        {
+            count = sqlite3_column_int(stmt, 0);
+        });
+    assert(success);
+    assert(count == 10);
+    dc.close();
+    success = dc.write(insert, { (int64_t)4, "w", "DE" });
+    assert(!success);
+
+    // Without batches each write is committed immediately
+    DatabaseConnector single;
+    success = single.open(":memory:", false, 0, 0);
+    assert(success);
+    success = single.execute("CREATE TABLE test (id INTEGER PRIMARY KEY);");
+    assert(success);
+    success = single.write("INSERT INTO test VALUES (?);", { (int64_t)1 });
+    assert(success);
+    assert(sqlite3_get_autocommit(single.getDB()));
+    (void)success;
+}   // unitTesting
+
+#endif
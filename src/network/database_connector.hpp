@@ -0,0 +1,145 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_DATABASE_CONNECTOR_HPP
+#define HEADER_DATABASE_CONNECTOR_HPP
+
+#ifdef ENABLE_SQLITE3
+
+#include "utils/no_copy.hpp"
+#include "utils/types.hpp"
+
+#include <sqlite3.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** \ingroup network
+ *  The sqlite database connection of a server.
+ *  Each query is prepared once and the statement is kept (keyed by the
+ *  query text), so queries must use ? parameters for their values, which
+ *  are bound for each execution. Only identifiers (like table names from
+ *  the server config) may be part of the query text.
+ *  Writes are collected in a transaction, which is committed by update()
+ *  after the batch time, instead of a transaction (and disk sync) for
+ *  each write. The transaction is committed earlier if there was no write
+ *  since the previous update() call, so other connections (like the sqlite3
+ *  command line tool) are only locked out while writes keep coming in.
+ *  All functions can be called from any thread.
+ */
+class DatabaseConnector : public NoCopy
+{
+public:
+    /** A value which is bound to a ? parameter of a query. */
+    class Value
+    {
+    private:
+        enum ValueType { VT_NULL, VT_INT, VT_TEXT };
+        ValueType m_type;
+        int64_t m_int;
+        std::string m_text;
+    public:
+        /** A NULL value. */
+        Value() : m_type(VT_NULL), m_int(0)                                {}
+        Value(int64_t i) : m_type(VT_INT), m_int(i)                        {}
+        Value(const std::string& s) : m_type(VT_TEXT), m_int(0), m_text(s) {}
+        Value(const char* s) : m_type(VT_TEXT), m_int(0), m_text(s)        {}
+        // --------------------------------------------------------------------
+        int bind(sqlite3_stmt* stmt, int index) const;
+    };   // Value
+
+private:
+    sqlite3* m_db;
+
+    /** All prepared statements, keyed by their query. */
+    std::map<std::string, sqlite3_stmt*> m_statements;
+
+    std::mutex m_mutex;
+
+    /** Time in ms for which writes are collected in one transaction, 0 to
+     *  write each of them in its own transaction. */
+    uint64_t m_batch_time;
+
+    /** Maximum time in ms to wait for the lock of the database. */
+    int m_timeout;
+
+    /** Time of the last update call. */
+    uint64_t m_now;
+
+    /** Time when the current transaction was started. */
+    uint64_t m_transaction_start;
+
+    bool m_in_transaction;
+
+    /** Number of writes in the current transaction. */
+    unsigned m_pending_writes;
+
+    /** m_pending_writes at the last update call. */
+    unsigned m_update_writes;
+
+    // ------------------------------------------------------------------------
+    sqlite3_stmt* getStatement(const std::string& query);
+    // ------------------------------------------------------------------------
+    bool bindValues(sqlite3_stmt* stmt, const std::string& query,
+                    const std::vector<Value>& values);
+    // ------------------------------------------------------------------------
+    bool executeLocked(const std::string& query);
+    // ------------------------------------------------------------------------
+    void commitLocked();
+
+public:
+    // ------------------------------------------------------------------------
+    DatabaseConnector();
+    // ------------------------------------------------------------------------
+    ~DatabaseConnector();
+    // ------------------------------------------------------------------------
+    bool open(const std::string& path, bool wal, int timeout,
+              unsigned batch_time);
+    // ------------------------------------------------------------------------
+    void close();
+    // ------------------------------------------------------------------------
+    /** Returns the sqlite connection, e.g. to add functions to it. */
+    sqlite3* getDB() const                                    { return m_db; }
+    // ------------------------------------------------------------------------
+    bool execute(const std::string& query);
+    // ------------------------------------------------------------------------
+    bool write(const std::string& query,
+               const std::vector<Value>& values = std::vector<Value>());
+    // ------------------------------------------------------------------------
+    bool read(const std::string& query, const std::vector<Value>& values,
+              std::function<void(sqlite3_stmt* stmt)> row_function);
+    // ------------------------------------------------------------------------
+    void update(uint64_t now);
+    // ------------------------------------------------------------------------
+    void commit();
+    // ------------------------------------------------------------------------
+    /** Returns the number of prepared statements. */
+    unsigned getNumStatements() const
+                                   { return (unsigned)m_statements.size(); }
+    // ------------------------------------------------------------------------
+    static void benchmark(const std::string& path);
+    // ------------------------------------------------------------------------
+    static void unitTesting();
+};   // DatabaseConnector
+
+#endif
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "network/crypto.hpp"
 #include "network/protocols/client_lobby.hpp"
+#include "network/server_metrics.hpp"
 #include "network/stk_peer.hpp"
 #include "utils/log.hpp"
 #include "utils/time.hpp"
@@ -78,6 +79,7 @@ Event::Event(ENetEvent* event, std::shared_ptr<STKPeer> peer)
         if (m_peer->getCrypto() && (event->channelID == EVENT_CHANNEL_NORMAL ||
             event->channelID == EVENT_CHANNEL_DATA_TRANSFER))
         {
+            ServerMetrics::ScopedTimer timer(ServerMetrics::HT_DECRYPTION);
             m_data = m_peer->getCrypto()->decryptRecieve(event->packet);
         }
         else
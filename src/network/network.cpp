@@ -118,9 +118,14 @@ Network::~Network()
 }   // ~Network
 
 // ----------------------------------------------------------------------------
-ENetPeer* Network::connectTo(const ENetAddress &address)
+/** Starts connecting to a host.
+ *  \param address The address of the host.
+ *  \param data The data of the connection request, the cookie of a server
+ *         if it sent one (see STKHost::interceptCallback).
+ */
+ENetPeer* Network::connectTo(const ENetAddress &address, uint32_t data)
 {
-    return enet_host_connect(m_host, &address, EVENT_CHANNEL_COUNT, 0);
+    return enet_host_connect(m_host, &address, EVENT_CHANNEL_COUNT, data);
 }   // connectTo
 
 // ----------------------------------------------------------------------------
@@ -66,7 +66,7 @@ public:
     static void openLog();
     static void logPacket(const BareNetworkString &ns, bool incoming);
     static void closeLog();
-    ENetPeer *connectTo(const ENetAddress &address);
+    ENetPeer *connectTo(const ENetAddress &address, uint32_t data = 0);
     void     sendRawPacket(const BareNetworkString &buffer,
                            const SocketAddress& dst);
     int receiveRawPacket(char *buffer, int buf_len,
@@ -53,6 +53,8 @@ void showHelp()
     std::cout << "listpeers, List all peers with host ID and IP." << std::endl;
     std::cout << "listban, List IP ban list of server." << std::endl;
     std::cout << "speedstats, Show upload and download speed." << std::endl;
+    std::cout << "metrics, Show server metrics (if metrics-file is set)."
+        << std::endl;
 }   // showHelp
 
 // ----------------------------------------------------------------------------
@@ -178,6 +180,10 @@ void mainLoop(STKHost* host)
                 "   Download speed (KBps): " <<
                 (float)host->getDownloadSpeed() / 1024.0f  << std::endl;
         }
+        else if (str == "metrics")
+        {
+            std::cout << host->getMetricsText();
+        }
         else
         {
             std::cout << "Unknown command: " << str << std::endl;
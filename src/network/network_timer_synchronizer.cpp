@@ -0,0 +1,275 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/network_timer_synchronizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /** Number of recent samples of which the best ones are used. */
+    const unsigned int SAMPLE_WINDOW = 32;
+
+    /** Number of samples needed before the timer is set the first time. */
+    const unsigned int MIN_SAMPLES = 10;
+
+    /** Number of seconds (with one sample each) used to estimate the
+     *  drift, and how many are needed for an estimation. */
+    const unsigned int DRIFT_WINDOW = 30;
+    const unsigned int MIN_DRIFT_SAMPLES = 5;
+
+    /** The maximum drift accepted, more is most likely caused by changing
+     *  network conditions. */
+    const double MAX_DRIFT = 0.0005;
+
+    /** The timer is slewed by at most this fraction of the elapsed time. */
+    const double MAX_SLEW_RATE = 0.01;
+
+    /** A larger difference (in ms) sets the timer immediately. */
+    const double MAX_SLEW_DIFFERENCE = 500.0;
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Estimates the drift between the clocks with a least squares fit of the
+ *  best sample of each second.
+ */
+void NetworkTimerSynchronizer::estimateDrift()
+{
+    if (m_drift_samples.size() < MIN_DRIFT_SAMPLES)
+        return;
+    // Use times relative to the first sample to keep the precision
+    const ClockSample& first = m_drift_samples.front();
+    double mean_t = 0.0, mean_o = 0.0;
+    for (const ClockSample& s : m_drift_samples)
+    {
+        mean_t += (double)(s.m_local_time - first.m_local_time);
+        mean_o += (double)(s.m_offset - first.m_offset);
+    }
+    mean_t /= m_drift_samples.size();
+    mean_o /= m_drift_samples.size();
+    double cov = 0.0, var = 0.0;
+    for (const ClockSample& s : m_drift_samples)
+    {
+        double t = (double)(s.m_local_time - first.m_local_time) - mean_t;
+        double o = (double)(s.m_offset - first.m_offset) - mean_o;
+        cov += t * o;
+        var += t * t;
+    }
+    if (var <= 0.0)
+        return;
+    m_drift = std::max(-MAX_DRIFT, std::min(MAX_DRIFT, cov / var));
+}   // estimateDrift
+
+// ----------------------------------------------------------------------------
+/** Returns the offset estimated from the recent samples with the lowest
+ *  delay (i.e. the largest offset after correcting the drift).
+ *  \param local_time The local time for which the offset is estimated.
+ */
+double NetworkTimerSynchronizer::getFilteredOffset(uint64_t local_time) const
+{
+    std::vector<double> offsets;
+    offsets.reserve(m_samples.size());
+    for (const ClockSample& s : m_samples)
+    {
+        offsets.push_back((double)s.m_offset +
+            m_drift * (double)(local_time - s.m_local_time));
+    }
+    std::sort(offsets.begin(), offsets.end(), std::greater<double>());
+    const size_t count = std::max((size_t)1, offsets.size() / 4);
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++)
+        sum += offsets[i];
+    return sum / (double)count;
+}   // getFilteredOffset
+
+// ----------------------------------------------------------------------------
+/** Adds a sample in the filtered mode.
+ *  \param ping Round trip time measured by the server in ms.
+ *  \param server_time Network timer of the server when it sent the ping.
+ *  \param local_time Local monotonic time in ms when the ping was received.
+ *  \param offset Set to the offset of the network timer to the local time
+ *         if true is returned.
+ *  \return True if the network timer should be set.
+ */
+bool NetworkTimerSynchronizer::addSample(uint32_t ping, uint64_t server_time,
+                                         uint64_t local_time, int64_t *offset)
+{
+    if (!m_synchronised.load() && m_offset_set)
+    {
+        // Resynchronise, the local clock may have jumped
+        m_samples.clear();
+        m_drift_samples.clear();
+        m_offset_set = false;
+        m_drift = 0.0;
+    }
+
+    // Discard too close time compared to last ping
+    // (due to resend when packet loss)
+    if (!m_samples.empty() &&
+        (local_time < m_samples.back().m_local_time ||
+         local_time - m_samples.back().m_local_time < 50))
+        return false;
+
+    ClockSample sample;
+    sample.m_local_time = local_time;
+    sample.m_offset = (int64_t)server_time + (int64_t)(ping / 2) -
+        (int64_t)local_time;
+    m_samples.push_back(sample);
+    if (m_samples.size() > SAMPLE_WINDOW)
+        m_samples.pop_front();
+
+    if (m_drift_samples.empty() ||
+        local_time - m_drift_samples.back().m_local_time >= 1000)
+    {
+        m_drift_samples.push_back(sample);
+        if (m_drift_samples.size() > DRIFT_WINDOW)
+            m_drift_samples.pop_front();
+        estimateDrift();
+    }
+    else if (sample.m_offset > m_drift_samples.back().m_offset)
+    {
+        // Keep the sample with the lowest delay of this second
+        m_drift_samples.back().m_offset = sample.m_offset;
+    }
+
+    const double estimated = getFilteredOffset(local_time);
+    if (!m_offset_set)
+    {
+        if (m_samples.size() < MIN_SAMPLES && !m_force_set_timer.load())
+            return false;
+        m_force_set_timer.store(false);
+        m_offset = estimated;
+        m_offset_set = true;
+        m_last_update = local_time;
+        m_synchronised.store(true);
+        Log::info("NetworkTimerSynchronizer", "Network timer synchronized "
+            "with %d samples.", (int)m_samples.size());
+        *offset = (int64_t)std::llround(m_offset);
+        return true;
+    }
+
+    const double dt = (double)(local_time - m_last_update);
+    m_last_update = local_time;
+    m_offset += m_drift * dt;
+    const double difference = estimated - m_offset;
+    if (std::fabs(difference) > MAX_SLEW_DIFFERENCE)
+    {
+        Log::warn("NetworkTimerSynchronizer", "Network timer differs by "
+            "%dms, setting it.", (int)difference);
+        m_offset = estimated;
+    }
+    else
+    {
+        const double max_step = dt * MAX_SLEW_RATE;
+        m_offset += std::max(-max_step, std::min(max_step, difference));
+    }
+    *offset = (int64_t)std::llround(m_offset);
+    return true;
+}   // addSample
+
+// ----------------------------------------------------------------------------
+/** Simulates links with different delay, jitter and clock drift, and checks
+ *  the time until the filtered mode converges and the remaining error.
+ */
+void NetworkTimerSynchronizer::unitTesting()
+{
+    struct Link
+    {
+        const char* m_name;
+        /** One way delay without jitter in ms. */
+        double m_delay;
+        /** Mean of the exponentially distributed jitter in ms. */
+        double m_jitter;
+        /** Drift of the server clock in ppm. */
+        double m_drift;
+        /** Maximum error allowed after the convergence in ms. */
+        double m_max_error;
+    };
+    const Link links[] =
+    {
+        { "LAN",          0.5,  0.5,    0.0,  3.0 },
+        { "DSL",         15.0,  4.0,   50.0,  6.0 },
+        { "Jittery WiFi",25.0, 20.0, -100.0, 25.0 },
+        { "Mobile",      60.0, 40.0,  200.0, 45.0 },
+    };
+    std::mt19937 rng(42);
+    for (const Link& link : links)
+    {
+        std::exponential_distribution<double> jitter(1.0 / link.m_jitter);
+        std::uniform_real_distribution<double> ping_noise(-2.0, 2.0);
+        NetworkTimerSynchronizer nts(/*filtered*/true);
+        // The server timer started 12345.6ms before the local clock is 0
+        const double start_offset = 12345.6;
+        const double drift = link.m_drift * 1e-6;
+        bool has_offset = false;
+        int64_t offset = 0;
+        double converged = -1.0, max_error = 0.0, sum_error = 0.0;
+        int error_count = 0;
+        const double duration = 120000.0;
+        // The server sends a ping every 100ms, which are handled in the
+        // order they arrive
+        std::vector<std::pair<double, double> > packets;
+        for (double send = 0.0; send < duration; send += 100.0)
+            packets.emplace_back(send + link.m_delay + jitter(rng), send);
+        std::sort(packets.begin(), packets.end());
+        for (auto& packet : packets)
+        {
+            const double receive = packet.first;
+            const double send = packet.second;
+            // The server ping is the smoothed round trip time
+            double ping = 2.0 * (link.m_delay + link.m_jitter) +
+                ping_noise(rng);
+            uint64_t server_time = (uint64_t)(start_offset + send *
+                (1.0 + drift));
+            uint64_t local_time = (uint64_t)receive + 1000000;
+            int64_t new_offset = 0;
+            if (nts.addSample((uint32_t)ping, server_time, local_time,
+                &new_offset))
+            {
+                has_offset = true;
+                offset = new_offset;
+            }
+            if (!has_offset)
+                continue;
+            const double correct = start_offset + receive * (1.0 + drift);
+            const double error = std::fabs((double)((int64_t)local_time +
+                offset) - correct);
+            if (error > link.m_max_error)
+                converged = -1.0;
+            else if (converged < 0.0)
+                converged = receive;
+            if (receive > duration / 2)
+            {
+                max_error = std::max(max_error, error);
+                sum_error += error;
+                error_count++;
+            }
+        }
+        Log::info("NetworkTimerSynchronizer", "%s: converged after %dms, "
+            "mean error %.1fms, max error %.1fms, drift %.0fppm (%.0fppm).",
+            link.m_name, (int)converged, sum_error / error_count, max_error,
+            nts.getDrift(), link.m_drift);
+        assert(nts.isSynchronised());
+        assert(converged >= 0.0 && converged < 3000.0);
+        assert(max_error <= link.m_max_error);
+    }
+}   // unitTesting
@@ -19,6 +19,7 @@
 #ifndef HEADER_NETWORK_TIMER_SYNCHRONIZER_HPP
 #define HEADER_NETWORK_TIMER_SYNCHRONIZER_HPP
 
+#include "config/user_config.hpp"
 #include "network/stk_host.hpp"
 #include "utils/log.hpp"
 #include "utils/time.hpp"
@@ -30,6 +31,16 @@
 #include <numeric>
 #include <tuple>
 
+/** \ingroup network
+ *  Synchronizes the network timer of a client with the server, using the
+ *  server time and ping sent in the ping packets of STKHost (10 per second).
+ *  The original mode averages 20 samples and sets the timer once if they
+ *  agree. The filtered mode (default, see timer-sync-filter in the user
+ *  config) only uses the samples with the lowest delay (a delayed packet
+ *  makes the server time look older, but it can never arrive too early),
+ *  estimates the drift between the two clocks, and keeps adjusting the timer
+ *  smoothly (by at most 1% of the elapsed time) after it was set.
+ */
 class NetworkTimerSynchronizer
 {
 private:
@@ -37,13 +48,63 @@ private:
 
     std::atomic_bool m_synchronised, m_force_set_timer;
 
+    /** An estimated offset of the network timer to the local time. */
+    struct ClockSample
+    {
+        uint64_t m_local_time;
+        int64_t  m_offset;
+    };
+
+    /** True if the filtered mode is used. */
+    bool m_filtered;
+
+    /** The recent samples, of which the ones with the lowest delay are
+     *  used. */
+    std::deque<ClockSample> m_samples;
+
+    /** The sample with the lowest delay of each second, used to estimate
+     *  the drift. */
+    std::deque<ClockSample> m_drift_samples;
+
+    /** True if m_offset was set in the filtered mode. Unlike m_synchronised
+     *  this is only used by the thread adding the samples. */
+    bool m_offset_set;
+
+    /** The offset of the network timer currently used. */
+    double m_offset;
+
+    /** Estimated drift of the server clock (ms per local ms). */
+    double m_drift;
+
+    /** Local time when m_offset was last updated. */
+    uint64_t m_last_update;
+
+    // ------------------------------------------------------------------------
+    void estimateDrift();
+    // ------------------------------------------------------------------------
+    double getFilteredOffset(uint64_t local_time) const;
+
 public:
-    NetworkTimerSynchronizer()
+    NetworkTimerSynchronizer(bool filtered =
+                             UserConfigParams::m_timer_sync_filter)
     {
         m_synchronised.store(false);
         m_force_set_timer.store(false);
+        m_filtered    = filtered;
+        m_offset_set  = false;
+        m_offset      = 0.0;
+        m_drift       = 0.0;
+        m_last_update = 0;
     }
     // ------------------------------------------------------------------------
+    static void unitTesting();
+    // ------------------------------------------------------------------------
+    bool addSample(uint32_t ping, uint64_t server_time, uint64_t local_time,
+                   int64_t *offset);
+    // ------------------------------------------------------------------------
+    /** Returns the estimated drift of the server clock in ppm. */
+    double getDrift() const                         { return m_drift * 1e6; }
+    // ------------------------------------------------------------------------
     bool isSynchronised() const               { return m_synchronised.load(); }
     // ------------------------------------------------------------------------
     void enableForceSetTimer()
@@ -57,6 +118,18 @@ public:
     // ------------------------------------------------------------------------
     void addAndSetTime(uint32_t ping, uint64_t server_time)
     {
+        if (m_filtered)
+        {
+            const uint64_t cur_time = StkTime::getMonoTimeMs();
+            int64_t offset = 0;
+            if (addSample(ping, server_time, cur_time, &offset))
+            {
+                STKHost::get()->setNetworkTimer(
+                    (uint64_t)((int64_t)cur_time + offset));
+            }
+            return;
+        }
+
         if (m_synchronised.load() == true)
             return;
 
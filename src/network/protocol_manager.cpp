@@ -22,6 +22,7 @@
 #include "network/network_config.hpp"
 #include "network/protocols/game_protocol.hpp"
 #include "network/protocols/server_lobby.hpp"
+#include "network/server_metrics.hpp"
 #include "network/socket_address.hpp"
 #include "network/stk_peer.hpp"
 #include "utils/log.hpp"
@@ -340,6 +341,19 @@ bool ProtocolManager::sendEvent(Event* event,
                               >= TIME_TO_KEEP_EVENTS;
 }   // sendEvent
 
+// ----------------------------------------------------------------------------
+/** Adds the time between the arrival of an event and now to the latency
+ *  histogram of the server metrics.
+ */
+static void observeLatency(ServerMetrics* sm,
+                           ServerMetrics::HistogramType type,
+                           const Event* event)
+{
+    const uint64_t now = StkTime::getMonoTimeMs();
+    const uint64_t arrival = event->getArrivalTime();
+    sm->observe(type, now > arrival ? (now - arrival) * 1000 : 0);
+}   // observeLatency
+
 // ----------------------------------------------------------------------------
 /** Calls either the synchronous update or asynchronous update function in all
  *  protocols of this type.
@@ -378,6 +392,7 @@ void ProtocolManager::update(int ticks)
     ul.unlock();
 
     // before updating, notify protocols that they have received events
+    ServerMetrics* sm = ServerMetrics::get();
     m_sync_events_to_process.lock();
     EventList::iterator i = m_sync_events_to_process.getData().begin();
 
@@ -399,6 +414,8 @@ void ProtocolManager::update(int ticks)
         m_sync_events_to_process.lock();
         if (can_be_deleted)
         {
+            if (sm)
+                observeLatency(sm, ServerMetrics::HT_SYNC_EVENT_LATENCY, *i);
             delete *i;
             i = m_sync_events_to_process.getData().erase(i);
         }
@@ -408,6 +425,11 @@ void ProtocolManager::update(int ticks)
             ++i;
         }
     }
+    if (sm)
+    {
+        sm->setGauge(ServerMetrics::GT_SYNC_EVENT_QUEUE,
+            m_sync_events_to_process.getData().size());
+    }
     m_sync_events_to_process.unlock();
 
     // Now update all protocols.
@@ -437,6 +459,7 @@ void ProtocolManager::asynchronousUpdate()
     auto all_protocols = m_all_protocols;
     ul.unlock();
 
+    ServerMetrics* sm = ServerMetrics::get();
     m_async_events_to_process.lock();
     EventList::iterator i = m_async_events_to_process.getData().begin();
     while (i != m_async_events_to_process.getData().end())
@@ -460,6 +483,8 @@ void ProtocolManager::asynchronousUpdate()
         m_async_events_to_process.lock();
         if (result)
         {
+            if (sm)
+                observeLatency(sm, ServerMetrics::HT_ASYNC_EVENT_LATENCY, *i);
             delete *i;
             i = m_async_events_to_process.getData().erase(i);
         }
@@ -470,6 +495,11 @@ void ProtocolManager::asynchronousUpdate()
             ++i;
         }
     }   // while i != m_events_to_process.end()
+    if (sm)
+    {
+        sm->setGauge(ServerMetrics::GT_ASYNC_EVENT_QUEUE,
+            m_async_events_to_process.getData().size());
+    }
     m_async_events_to_process.unlock();
 
     PROFILER_POP_CPU_MARKER();
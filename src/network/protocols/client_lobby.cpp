@@ -54,6 +54,7 @@
 #include "network/race_event_manager.hpp"
 #include "network/server.hpp"
 #include "network/server_config.hpp"
+#include "network/state_checkpoint.hpp"
 #include "network/stk_host.hpp"
 #include "network/stk_peer.hpp"
 #include "race/grand_prix_manager.hpp"
@@ -1315,7 +1316,19 @@ void ClientLobby::liveJoinAcknowledged(Event* event)
     NetworkItemManager* nim = dynamic_cast<NetworkItemManager*>
         (Track::getCurrentTrack()->getItemManager());
     assert(nim);
-    nim->restoreCompleteState(data);
+    if (NetworkConfig::get()->getServerCapabilities().find(
+        "compressed_checkpoint") !=
+        NetworkConfig::get()->getServerCapabilities().end() &&
+        event->data().getUInt8() == 1)
+    {
+        // The item state of the latest checkpoint of the server, the item
+        // events since it are sent with the next states
+        BareNetworkString checkpoint;
+        StateCheckpoint::decompress(&event->data(), &checkpoint);
+        nim->restoreCompleteState(checkpoint);
+    }
+    else
+        nim->restoreCompleteState(data);
     w->restoreCompleteState(data);
 
     if (RaceManager::get()->supportsLiveJoining() && data.size() > 0)
@@ -71,10 +71,12 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
 // ============================================================================
 ENetAddress ConnectToServer::m_server_address;
 int ConnectToServer::m_retry_count = 0;
 bool ConnectToServer::m_done_intecept = false;
+uint32_t ConnectToServer::m_cookie = 0;
 // ----------------------------------------------------------------------------
 /** Specify server to connect to.
  *  \param server Server to connect to (if nullptr than we use quick play).
@@ -397,10 +399,30 @@ void ConnectToServer::update(int ticks)
 
 // ----------------------------------------------------------------------------
 /** Intercept callback in enet to allow change server address and port if
- *  needed (Happens when there is firewall in between)
+ *  needed (Happens when there is firewall in between), and to receive the
+ *  cookie of a server which limits connection requests (see
+ *  STKHost::interceptCallback), which is sent in the next request.
  */
 int ConnectToServer::interceptCallback(ENetHost* host, ENetEvent* event)
 {
+    // "0xFFFF", then the string "stk-cookie" and the cookie
+    if (host->receivedDataLength == 17 &&
+        host->receivedData[0] == 0xFF && host->receivedData[1] == 0xFF &&
+        host->receivedData[2] == 0x0A &&
+        memcmp(host->receivedData + 3, "stk-cookie", 10) == 0 &&
+#if defined(ENABLE_IPV6) || defined(__SWITCH__)
+        enet_ip_equal(host->receivedAddress.host, m_server_address.host) &&
+#else
+        host->receivedAddress.host == m_server_address.host &&
+#endif
+        host->receivedAddress.port == m_server_address.port)
+    {
+        const enet_uint8* cookie = host->receivedData + 13;
+        m_cookie = ((uint32_t)cookie[0] << 24) | ((uint32_t)cookie[1] << 16) |
+            ((uint32_t)cookie[2] << 8) | cookie[3];
+        Log::info("ConnectToServer", "Server requires a cookie to connect.");
+        return 1;
+    }
     if (m_done_intecept)
         return 0;
     // The first two bytes of a valid ENet protocol packet will never be 0xFFFF
@@ -447,6 +469,7 @@ bool ConnectToServer::tryConnect(int timeout, int retry, bool another_port,
     assert(nw);
 
     m_done_intecept = false;
+    m_cookie = 0;
     nw->getENetHost()->intercept = ConnectToServer::interceptCallback;
 
     const SocketAddress* sa;
@@ -464,7 +487,7 @@ bool ConnectToServer::tryConnect(int timeout, int retry, bool another_port,
     {
         std::string connecting_address =
             SocketAddress(m_server_address).toString();
-        ENetPeer* p = nw->connectTo(m_server_address);
+        ENetPeer* p = nw->connectTo(m_server_address, m_cookie);
         if (!p)
             break;
         Log::info("ConnectToServer", "Trying connecting to %s from port %d, "
@@ -60,6 +60,7 @@ private:
     static int interceptCallback(ENetHost* host, ENetEvent* event);
     static int m_retry_count;
     static bool m_done_intecept;
+    static uint32_t m_cookie;
     bool detectPort();
 public:
              ConnectToServer(std::shared_ptr<Server> server);
@@ -166,13 +166,13 @@ void GameProtocol::controllerAction(int kart_id, PlayerAction action,
 
     m_all_actions.push_back(a);
     const auto& c = compressAction(a);
-    // Store the event in the rewind manager, which is responsible
-    // for freeing the allocated memory
-    BareNetworkString *s = new BareNetworkString(4);
-    s->addUInt8(kart_id).addUInt8(std::get<0>(c)).addUInt16(std::get<1>(c))
+    // Store the event in the rewind manager, which copies the data
+    BareNetworkString s(8);
+    s.addUInt8(kart_id).addUInt8(std::get<0>(c)).addUInt16(std::get<1>(c))
         .addUInt16(std::get<2>(c)).addUInt16(std::get<3>(c));
 
-    RewindManager::get()->addEvent(this, s, /*confirmed*/true,
+    RewindManager::get()->addEvent(this, s.getData(), s.getTotalSize(),
+                                   /*confirmed*/true,
                                    World::getWorld()->getTicksSinceStart());
 }   // controllerAction
 
@@ -206,6 +206,8 @@ void GameProtocol::handleControllerAction(Event *event)
             will_trigger_rewind = true;
             //rewind_delta = not_rewound - cur_ticks;
         }
+        // The event data is stored as it was sent, without the time
+        const char *event_data = data.getCurrentData();
         uint8_t kart_id = data.getUInt8();
         if (NetworkConfig::get()->isServer() &&
             !peer->availableKartID(kart_id))
@@ -227,10 +229,8 @@ void GameProtocol::handleControllerAction(Event *event)
                 cur_ticks, kart_id, std::get<0>(a), std::get<1>(a),
                 std::get<2>(a), std::get<3>(a));
         }
-        BareNetworkString *s = new BareNetworkString(3);
-        s->addUInt8(kart_id).addUInt8(w).addUInt16(x).addUInt16(y)
-            .addUInt16(z);
-        RewindManager::get()->addNetworkEvent(this, s, cur_ticks);
+        RewindManager::get()->addNetworkEvent(this, event_data,
+            int(data.getCurrentData() - event_data), cur_ticks);
     }
 
     if (data.size() > 0)
@@ -30,6 +30,7 @@
 #include "modes/capture_the_flag.hpp"
 #include "modes/linear_world.hpp"
 #include "network/crypto.hpp"
+#include "network/database_connector.hpp"
 #include "network/event.hpp"
 #include "network/game_setup.hpp"
 #include "network/network.hpp"
@@ -42,7 +43,9 @@
 #include "network/protocols/game_events_protocol.hpp"
 #include "network/race_event_manager.hpp"
 #include "network/server_config.hpp"
+#include "network/server_metrics.hpp"
 #include "network/socket_address.hpp"
+#include "network/state_checkpoint.hpp"
 #include "network/stk_host.hpp"
 #include "network/stk_ipv6.hpp"
 #include "network/stk_peer.hpp"
@@ -143,6 +146,14 @@ void insideIPv6CIDRSQL(sqlite3_context* context, int argc,
     sqlite3_result_int(context, insideIPv6CIDR(ipv6_cidr, ipv6_in));
 }   // insideIPv6CIDRSQL
 
+// ----------------------------------------------------------------------------
+/** Returns a text column of a row, or an empty string for NULL. */
+static std::string getColumnText(sqlite3_stmt* stmt, int column)
+{
+    const char* text = (const char*)sqlite3_column_text(stmt, column);
+    return text ? text : "";
+}   // getColumnText
+
 // ----------------------------------------------------------------------------
 /*
 Copy below code so it can be use as loadable extension to be used in sqlite3
@@ -244,6 +255,12 @@ ServerLobby::ServerLobby() : LobbyProtocol()
     m_result_ns = getNetworkString();
     m_result_ns->setSynchronous(true);
     m_items_complete_state = new BareNetworkString();
+    if (ServerConfig::m_live_players &&
+        ServerConfig::m_checkpoint_interval > 0.0f)
+    {
+        m_state_checkpoint.reset(new StateCheckpoint(
+            stk_config->time2Ticks(ServerConfig::m_checkpoint_interval)));
+    }
     m_server_id_online.store(0);
     m_difficulty.store(ServerConfig::m_server_difficulty);
     m_game_mode.store(ServerConfig::m_server_mode);
@@ -275,7 +292,6 @@ void ServerLobby::initDatabase()
 {
 #ifdef ENABLE_SQLITE3
     m_last_poll_db_time = StkTime::getMonoTimeMs();
-    m_db = NULL;
     m_ip_ban_table_exists = false;
     m_ipv6_ban_table_exists = false;
     m_online_id_ban_table_exists = false;
@@ -285,32 +301,18 @@ void ServerLobby::initDatabase()
         return;
     const std::string& path = ServerConfig::getConfigDirectory() + "/" +
         ServerConfig::m_database_file.c_str();
-    int ret = sqlite3_open_v2(path.c_str(), &m_db,
-        SQLITE_OPEN_SHAREDCACHE | SQLITE_OPEN_FULLMUTEX |
-        SQLITE_OPEN_READWRITE, NULL);
-    if (ret != SQLITE_OK)
-    {
-        Log::error("ServerLobby", "Cannot open database: %s.",
-            sqlite3_errmsg(m_db));
-        sqlite3_close(m_db);
-        m_db = NULL;
+    m_db.reset(new DatabaseConnector());
+    if (!m_db->open(path, ServerConfig::m_database_wal,
+        ServerConfig::m_database_timeout,
+        std::max((int)ServerConfig::m_database_batch_time, 0)))
+    {
+        m_db.reset();
         return;
     }
-    sqlite3_busy_handler(m_db, [](void* data, int retry)
-        {
-            int retry_count = ServerConfig::m_database_timeout / 100;
-            if (retry < retry_count)
-            {
-                sqlite3_sleep(100);
-                // Return non-zero to let caller retry again
-                return 1;
-            }
-            // Return zero to let caller return SQLITE_BUSY immediately
-            return 0;
-        }, NULL);
-    sqlite3_create_function(m_db, "insideIPv6CIDR", 2, SQLITE_UTF8, NULL,
-        &insideIPv6CIDRSQL, NULL, NULL);
-    sqlite3_create_function(m_db, "upperIPv6", 1, SQLITE_UTF8, NULL,
+    m_db->update(StkTime::getMonoTimeMs());
+    sqlite3_create_function(m_db->getDB(), "insideIPv6CIDR", 2, SQLITE_UTF8,
+        NULL, &insideIPv6CIDRSQL, NULL, NULL);
+    sqlite3_create_function(m_db->getDB(), "upperIPv6", 1, SQLITE_UTF8, NULL,
         &upperIPv6SQL, NULL, NULL);
     checkTableExists(ServerConfig::m_ip_ban_table, m_ip_ban_table_exists);
     checkTableExists(ServerConfig::m_ipv6_ban_table, m_ipv6_ban_table_exists);
@@ -354,28 +356,9 @@ void ServerLobby::initServerStatsTable()
         "    packet_loss INTEGER NOT NULL DEFAULT 0 -- Mean packet loss count from ENet (saved when disconnected)\n"
         ") WITHOUT ROWID;";
     std::string query = oss.str();
-    sqlite3_stmt* stmt = NULL;
-    int ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-    if (ret == SQLITE_OK)
-    {
-        ret = sqlite3_step(stmt);
-        ret = sqlite3_finalize(stmt);
-        if (ret == SQLITE_OK)
-            m_server_stats_table = table_name;
-        else
-        {
-            Log::error("ServerLobby",
-                "Error finalize database for query %s: %s",
-                query.c_str(), sqlite3_errmsg(m_db));
-        }
-    }
-    else
-    {
-        Log::error("ServerLobby", "Error preparing database for query %s: %s",
-            query.c_str(), sqlite3_errmsg(m_db));
-    }
-    if (m_server_stats_table.empty())
+    if (!m_db->execute(query))
         return;
+    m_server_stats_table = table_name;
 
     // Extra default table _countries:
     // Server owner need to initialise this table himself, check NETWORKING.md
@@ -387,7 +370,7 @@ void ServerLobby::initServerStatsTable()
         "    country_flag TEXT NOT NULL, -- Unicode country flag representation of 2-letter country code\n"
         "    country_name TEXT NOT NULL -- Readable name of this country\n"
         ") WITHOUT ROWID;", country_table_name.c_str());
-    easySQLQuery(query);
+    m_db->execute(query);
 
     // Default views:
     // _full_stats
@@ -410,7 +393,7 @@ void ServerLobby::initServerStatsTable()
         <<      country_table_name << ".country_code = " << m_server_stats_table << ".country_code\n"
         << "    ORDER BY connected_time DESC;";
     query = oss.str();
-    easySQLQuery(query);
+    m_db->execute(query);
 
     // _current_players
     // Current players in server with ip in human readable format and time
@@ -433,7 +416,7 @@ void ServerLobby::initServerStatsTable()
         <<      country_table_name << ".country_code = " << m_server_stats_table << ".country_code\n"
         << "    WHERE connected_time = disconnected_time;";
     query = oss.str();
-    easySQLQuery(query);
+    m_db->execute(query);
 
     // _player_stats
     // All players with online id and username with their time played stats
@@ -494,44 +477,33 @@ void ServerLobby::initServerStatsTable()
             << "    WHERE RowNum = 1 ORDER BY num_connections DESC;\n";
     }
     query = oss.str();
-    easySQLQuery(query);
+    m_db->execute(query);
 
     uint32_t last_host_id = 0;
     query = StringUtils::insertValues("SELECT MAX(host_id) FROM %s;",
         m_server_stats_table.c_str());
-    ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-    if (ret == SQLITE_OK)
-    {
-        ret = sqlite3_step(stmt);
-        if (ret == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+    bool success = m_db->read(query, {}, [&last_host_id](sqlite3_stmt* stmt)
         {
-            last_host_id = (unsigned)sqlite3_column_int64(stmt, 0);
-            Log::info("ServerLobby", "%u was last server session max host id.",
-                last_host_id);
-        }
-        ret = sqlite3_finalize(stmt);
-        if (ret != SQLITE_OK)
-        {
-            Log::error("ServerLobby",
-                "Error finalize database for query %s: %s",
-                query.c_str(), sqlite3_errmsg(m_db));
-            m_server_stats_table = "";
-        }
-    }
-    else
+            if (sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+            {
+                last_host_id = (unsigned)sqlite3_column_int64(stmt, 0);
+                Log::info("ServerLobby",
+                    "%u was last server session max host id.", last_host_id);
+            }
+        });
+    STKHost::get()->setNextHostId(last_host_id);
+    if (!success)
     {
-        Log::error("ServerLobby", "Error preparing database for query %s: %s",
-            query.c_str(), sqlite3_errmsg(m_db));
         m_server_stats_table = "";
+        return;
     }
-    STKHost::get()->setNextHostId(last_host_id);
 
     // Update disconnected time (if stk crashed it will not be written)
     query = StringUtils::insertValues(
         "UPDATE %s SET disconnected_time = datetime('now') "
         "WHERE connected_time = disconnected_time;",
         m_server_stats_table.c_str());
-    easySQLQuery(query);
+    m_db->write(query);
 #endif
 }   // initServerStatsTable
 
@@ -542,8 +514,8 @@ void ServerLobby::destroyDatabase()
     auto peers = STKHost::get()->getPeers();
     for (auto& peer : peers)
         writeDisconnectInfoTable(peer.get());
-    if (m_db != NULL)
-        sqlite3_close(m_db);
+    // Commits the pending writes
+    m_db.reset();
 #endif
 }   // destroyDatabase
 
@@ -555,11 +527,10 @@ void ServerLobby::writeDisconnectInfoTable(STKPeer* peer)
         return;
     std::string query = StringUtils::insertValues(
         "UPDATE %s SET disconnected_time = datetime('now'), "
-        "ping = %d, packet_loss = %d "
-        "WHERE host_id = %u;", m_server_stats_table.c_str(),
-        peer->getAveragePing(), peer->getPacketLoss(),
-        peer->getHostId());
-    easySQLQuery(query);
+        "ping = ?, packet_loss = ? "
+        "WHERE host_id = ?;", m_server_stats_table.c_str());
+    m_db->write(query, { (int64_t)peer->getAveragePing(),
+        (int64_t)peer->getPacketLoss(), (int64_t)peer->getHostId() });
 #endif
 }   // writeDisconnectInfoTable
 
@@ -967,6 +938,7 @@ void ServerLobby::pollDatabase()
     if (!ServerConfig::m_sql_management || !m_db)
         return;
 
+    m_db->update(StkTime::getMonoTimeMs());
     if (StkTime::getMonoTimeMs() < m_last_poll_db_time + 60000)
         return;
 
@@ -981,35 +953,29 @@ void ServerLobby::pollDatabase()
             "(expired_days is NULL OR datetime"
             "(starting_time, '+'||expired_days||' days') > datetime('now'));";
         auto peers = STKHost::get()->getPeers();
-        sqlite3_exec(m_db, query.c_str(),
-            [](void* ptr, int count, char** data, char** columns)
+        m_db->read(query, {}, [&peers](sqlite3_stmt* stmt)
             {
-                std::vector<std::shared_ptr<STKPeer> >* peers_ptr =
-                    (std::vector<std::shared_ptr<STKPeer> >*)ptr;
-                for (std::shared_ptr<STKPeer>& p : *peers_ptr)
+                uint32_t ip_start = (uint32_t)sqlite3_column_int64(stmt, 0);
+                uint32_t ip_end = (uint32_t)sqlite3_column_int64(stmt, 1);
+                const char* reason = (char*)sqlite3_column_text(stmt, 2);
+                const char* desc = (char*)sqlite3_column_text(stmt, 3);
+                for (std::shared_ptr<STKPeer>& p : peers)
                 {
                     // IPv4 ban list atm
                     if (p->isAIPeer() || p->getAddress().isIPv6())
                         continue;
 
-                    uint32_t ip_start = 0;
-                    uint32_t ip_end = 0;
-                    if (!StringUtils::fromString(data[0], ip_start))
-                        continue;
-                    if (!StringUtils::fromString(data[1], ip_end))
-                        continue;
                     uint32_t peer_addr = p->getAddress().getIP();
                     if (ip_start <= peer_addr && ip_end >= peer_addr)
                     {
                         Log::info("ServerLobby",
                             "Kick %s, reason: %s, description: %s",
                             p->getAddress().toString().c_str(),
-                            data[2], data[3]);
+                            reason, desc);
                         p->kick();
                     }
                 }
-                return 0;
-            }, &peers, NULL);
+            });
     }
 
     if (m_ipv6_ban_table_exists)
@@ -1021,12 +987,14 @@ void ServerLobby::pollDatabase()
             "(expired_days is NULL OR datetime"
             "(starting_time, '+'||expired_days||' days') > datetime('now'));";
         auto peers = STKHost::get()->getPeers();
-        sqlite3_exec(m_db, query.c_str(),
-            [](void* ptr, int count, char** data, char** columns)
+        m_db->read(query, {}, [&peers](sqlite3_stmt* stmt)
             {
-                std::vector<std::shared_ptr<STKPeer> >* peers_ptr =
-                    (std::vector<std::shared_ptr<STKPeer> >*)ptr;
-                for (std::shared_ptr<STKPeer>& p : *peers_ptr)
+                const char* ipv6_cidr = (char*)sqlite3_column_text(stmt, 0);
+                const char* reason = (char*)sqlite3_column_text(stmt, 1);
+                const char* desc = (char*)sqlite3_column_text(stmt, 2);
+                if (!ipv6_cidr)
+                    return;
+                for (std::shared_ptr<STKPeer>& p : peers)
                 {
                     std::string ipv6;
                     if (p->getAddress().isIPv6())
@@ -1035,17 +1003,15 @@ void ServerLobby::pollDatabase()
                     if (p->isAIPeer() || ipv6.empty())
                         continue;
 
-                    char* ipv6_cidr = data[0];
                     if (insideIPv6CIDR(ipv6_cidr, ipv6.c_str()) == 1)
                     {
                         Log::info("ServerLobby",
                             "Kick %s, reason: %s, description: %s",
-                            ipv6.c_str(), data[1], data[2]);
+                            ipv6.c_str(), reason, desc);
                         p->kick();
                     }
                 }
-                return 0;
-            }, &peers, NULL);
+            });
     }
 
     if (m_online_id_ban_table_exists)
@@ -1056,31 +1022,27 @@ void ServerLobby::pollDatabase()
             "(expired_days is NULL OR datetime"
             "(starting_time, '+'||expired_days||' days') > datetime('now'));";
         auto peers = STKHost::get()->getPeers();
-        sqlite3_exec(m_db, query.c_str(),
-            [](void* ptr, int count, char** data, char** columns)
+        m_db->read(query, {}, [&peers](sqlite3_stmt* stmt)
             {
-                std::vector<std::shared_ptr<STKPeer> >* peers_ptr =
-                    (std::vector<std::shared_ptr<STKPeer> >*)ptr;
-                for (std::shared_ptr<STKPeer>& p : *peers_ptr)
+                uint32_t online_id = (uint32_t)sqlite3_column_int64(stmt, 0);
+                const char* reason = (char*)sqlite3_column_text(stmt, 1);
+                const char* desc = (char*)sqlite3_column_text(stmt, 2);
+                for (std::shared_ptr<STKPeer>& p : peers)
                 {
                     if (p->isAIPeer()
                         || p->getPlayerProfiles().empty())
                         continue;
 
-                    uint32_t online_id = 0;
-                    if (!StringUtils::fromString(data[0], online_id))
-                        continue;
                     if (online_id == p->getPlayerProfiles()[0]->getOnlineId())
                     {
                         Log::info("ServerLobby",
                             "Kick %s, reason: %s, description: %s",
                             p->getAddress().toString().c_str(),
-                            data[1], data[2]);
+                            reason, desc);
                         p->kick();
                     }
                 }
-                return 0;
-            }, &peers, NULL);
+            });
     }
 
     if (m_player_reports_table_exists &&
@@ -1089,10 +1051,10 @@ void ServerLobby::pollDatabase()
         std::string query = StringUtils::insertValues(
             "DELETE FROM %s "
             "WHERE datetime"
-            "(reported_time, '+%f days') < datetime('now');",
-            ServerConfig::m_player_reports_table.c_str(),
-            ServerConfig::m_player_reports_expired_days);
-        easySQLQuery(query);
+            "(reported_time, '+'||?||' days') < datetime('now');",
+            ServerConfig::m_player_reports_table.c_str());
+        m_db->write(query, { StringUtils::toString(
+            (float)ServerConfig::m_player_reports_expired_days) });
     }
     if (m_server_stats_table.empty())
         return;
@@ -1115,6 +1077,7 @@ void ServerLobby::pollDatabase()
             "UPDATE %s SET disconnected_time = datetime('now') "
             "WHERE connected_time = disconnected_time;",
             m_server_stats_table.c_str());
+        m_db->write(query);
     }
     else
     {
@@ -1130,81 +1093,32 @@ void ServerLobby::pollDatabase()
                 oss << ",";
         }
         oss << ");";
+        // Not kept as prepared statement, the list of hosts changes
         query = oss.str();
+        m_db->execute(query);
     }
-    easySQLQuery(query);
 }   // pollDatabase
 
-//-----------------------------------------------------------------------------
-/** Run simple query with write lock waiting and optional function, this
- *  function has no callback for the return (if any) by the query.
- *  Return true if no error occurs
- */
-bool ServerLobby::easySQLQuery(const std::string& query,
-                   std::function<void(sqlite3_stmt* stmt)> bind_function) const
-{
-    if (!m_db)
-        return false;
-    sqlite3_stmt* stmt = NULL;
-    int ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-    if (ret == SQLITE_OK)
-    {
-        if (bind_function)
-            bind_function(stmt);
-        ret = sqlite3_step(stmt);
-        ret = sqlite3_finalize(stmt);
-        if (ret != SQLITE_OK)
-        {
-            Log::error("ServerLobby",
-                "Error finalize database for easy query %s: %s",
-                query.c_str(), sqlite3_errmsg(m_db));
-            return false;
-        }
-    }
-    else
-    {
-        Log::error("ServerLobby",
-            "Error preparing database for easy query %s: %s",
-            query.c_str(), sqlite3_errmsg(m_db));
-        return false;
-    }
-    return true;
-}   // easySQLQuery
-
 //-----------------------------------------------------------------------------
 /* Write true to result if table name exists in database. */
 void ServerLobby::checkTableExists(const std::string& table, bool& result)
 {
     if (!m_db)
         return;
-    sqlite3_stmt* stmt = NULL;
     if (!table.empty())
     {
-        std::string query = StringUtils::insertValues(
-            "SELECT count(type) FROM sqlite_master "
-            "WHERE type='table' AND name='%s';", table.c_str());
-
-        int ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-        if (ret == SQLITE_OK)
-        {
-            ret = sqlite3_step(stmt);
-            if (ret == SQLITE_ROW)
-            {
-                int number = sqlite3_column_int(stmt, 0);
-                if (number == 1)
-                {
-                    Log::info("ServerLobby", "Table named %s will used.",
-                        table.c_str());
-                    result = true;
-                }
-            }
-            ret = sqlite3_finalize(stmt);
-            if (ret != SQLITE_OK)
+        int number = 0;
+        m_db->read("SELECT count(type) FROM sqlite_master "
+            "WHERE type='table' AND name=?;", { table },
+            [&number](sqlite3_stmt* stmt)
             {
-                Log::error("ServerLobby",
-                    "Error finalize database for query %s: %s",
-                    query.c_str(), sqlite3_errmsg(m_db));
-            }
+                number = sqlite3_column_int(stmt, 0);
+            });
+        if (number == 1)
+        {
+            Log::info("ServerLobby", "Table named %s will used.",
+                table.c_str());
+            result = true;
         }
     }
     if (!result && !table.empty())
@@ -1223,35 +1137,16 @@ std::string ServerLobby::ip2Country(const SocketAddress& addr) const
     std::string cc_code;
     std::string query = StringUtils::insertValues(
         "SELECT country_code FROM %s "
-        "WHERE `ip_start` <= %d AND `ip_end` >= %d "
+        "WHERE `ip_start` <= ? AND `ip_end` >= ? "
         "ORDER BY `ip_start` DESC LIMIT 1;",
-        ServerConfig::m_ip_geolocation_table.c_str(), addr.getIP(),
-        addr.getIP());
-
-    sqlite3_stmt* stmt = NULL;
-    int ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-    if (ret == SQLITE_OK)
-    {
-        ret = sqlite3_step(stmt);
-        if (ret == SQLITE_ROW)
+        ServerConfig::m_ip_geolocation_table.c_str());
+    m_db->read(query, { (int64_t)addr.getIP(), (int64_t)addr.getIP() },
+        [&cc_code](sqlite3_stmt* stmt)
         {
             const char* country_code = (char*)sqlite3_column_text(stmt, 0);
-            cc_code = country_code;
-        }
-        ret = sqlite3_finalize(stmt);
-        if (ret != SQLITE_OK)
-        {
-            Log::error("ServerLobby",
-                "Error finalize database for query %s: %s",
-                query.c_str(), sqlite3_errmsg(m_db));
-        }
-    }
-    else
-    {
-        Log::error("ServerLobby", "Error preparing database for query %s: %s",
-            query.c_str(), sqlite3_errmsg(m_db));
-        return "";
-    }
+            if (country_code)
+                cc_code = country_code;
+        });
     return cc_code;
 }   // ip2Country
 
@@ -1265,35 +1160,15 @@ std::string ServerLobby::ipv62Country(const SocketAddress& addr) const
     const std::string& ipv6 = addr.toString(false/*show_port*/);
     std::string query = StringUtils::insertValues(
         "SELECT country_code FROM %s "
-        "WHERE `ip_start` <= upperIPv6(\"%s\") AND `ip_end` >= upperIPv6(\"%s\") "
+        "WHERE `ip_start` <= upperIPv6(?) AND `ip_end` >= upperIPv6(?) "
         "ORDER BY `ip_start` DESC LIMIT 1;",
-        ServerConfig::m_ipv6_geolocation_table.c_str(), ipv6.c_str(),
-        ipv6.c_str());
-
-    sqlite3_stmt* stmt = NULL;
-    int ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-    if (ret == SQLITE_OK)
-    {
-        ret = sqlite3_step(stmt);
-        if (ret == SQLITE_ROW)
+        ServerConfig::m_ipv6_geolocation_table.c_str());
+    m_db->read(query, { ipv6, ipv6 }, [&cc_code](sqlite3_stmt* stmt)
         {
             const char* country_code = (char*)sqlite3_column_text(stmt, 0);
-            cc_code = country_code;
-        }
-        ret = sqlite3_finalize(stmt);
-        if (ret != SQLITE_OK)
-        {
-            Log::error("ServerLobby",
-                "Error finalize database for query %s: %s",
-                query.c_str(), sqlite3_errmsg(m_db));
-        }
-    }
-    else
-    {
-        Log::error("ServerLobby", "Error preparing database for query %s: %s",
-            query.c_str(), sqlite3_errmsg(m_db));
-        return "";
-    }
+            if (country_code)
+                cc_code = country_code;
+        });
     return cc_code;
 }   // ipv62Country
 
@@ -1321,21 +1196,23 @@ void ServerLobby::writePlayerReport(Event* event)
         return;
     auto reporting_npp = reporting_peer->getPlayerProfiles()[0];
 
+    const SocketAddress& reporter_addr = reporter->getAddress();
+    const SocketAddress& reporting_addr = reporting_peer->getAddress();
     std::string query;
+    std::vector<DatabaseConnector::Value> values;
+    values.emplace_back(ServerConfig::m_server_uid);
+    values.emplace_back(!reporter_addr.isIPv6() ?
+        (int64_t)reporter_addr.getIP() : 0);
     if (ServerConfig::m_ipv6_connection)
     {
         query = StringUtils::insertValues(
             "INSERT INTO %s "
             "(server_uid, reporter_ip, reporter_ipv6, reporter_online_id, reporter_username, "
             "info, reporting_ip, reporting_ipv6, reporting_online_id, reporting_username) "
-            "VALUES (?, %u, \"%s\", %u, ?, ?, %u, \"%s\", %u, ?);",
-            ServerConfig::m_player_reports_table.c_str(),
-            !reporter->getAddress().isIPv6() ? reporter->getAddress().getIP() : 0,
-            reporter->getAddress().isIPv6() ? reporter->getAddress().toString(false) : "",
-            reporter_npp->getOnlineId(),
-            !reporting_peer->getAddress().isIPv6() ? reporting_peer->getAddress().getIP() : 0,
-            reporting_peer->getAddress().isIPv6() ? reporting_peer->getAddress().toString(false) : "",
-            reporting_npp->getOnlineId());
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);",
+            ServerConfig::m_player_reports_table.c_str());
+        values.emplace_back(reporter_addr.isIPv6() ?
+            reporter_addr.toString(false) : "");
     }
     else
     {
@@ -1343,43 +1220,22 @@ void ServerLobby::writePlayerReport(Event* event)
             "INSERT INTO %s "
             "(server_uid, reporter_ip, reporter_online_id, reporter_username, "
             "info, reporting_ip, reporting_online_id, reporting_username) "
-            "VALUES (?, %u, %u, ?, ?, %u, %u, ?);",
-            ServerConfig::m_player_reports_table.c_str(),
-            reporter->getAddress().getIP(), reporter_npp->getOnlineId(),
-            reporting_peer->getAddress().getIP(), reporting_npp->getOnlineId());
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?);",
+            ServerConfig::m_player_reports_table.c_str());
+    }
+    values.emplace_back((int64_t)reporter_npp->getOnlineId());
+    values.emplace_back(StringUtils::wideToUtf8(reporter_npp->getName()));
+    values.emplace_back(StringUtils::wideToUtf8(info));
+    values.emplace_back(!reporting_addr.isIPv6() ?
+        (int64_t)reporting_addr.getIP() : 0);
+    if (ServerConfig::m_ipv6_connection)
+    {
+        values.emplace_back(reporting_addr.isIPv6() ?
+            reporting_addr.toString(false) : "");
     }
-    bool written = easySQLQuery(query,
-        [reporter_npp, reporting_npp, info](sqlite3_stmt* stmt)
-        {
-            // SQLITE_TRANSIENT to copy string
-            if (sqlite3_bind_text(stmt, 1, ServerConfig::m_server_uid.c_str(),
-                -1, SQLITE_TRANSIENT) != SQLITE_OK)
-            {
-                Log::error("easySQLQuery", "Failed to bind %s.",
-                    ServerConfig::m_server_uid.c_str());
-            }
-            if (sqlite3_bind_text(stmt, 2,
-                StringUtils::wideToUtf8(reporter_npp->getName()).c_str(),
-                -1, SQLITE_TRANSIENT) != SQLITE_OK)
-            {
-                Log::error("easySQLQuery", "Failed to bind %s.",
-                    StringUtils::wideToUtf8(reporter_npp->getName()).c_str());
-            }
-            if (sqlite3_bind_text(stmt, 3,
-                StringUtils::wideToUtf8(info).c_str(),
-                -1, SQLITE_TRANSIENT) != SQLITE_OK)
-            {
-                Log::error("easySQLQuery", "Failed to bind %s.",
-                    StringUtils::wideToUtf8(info).c_str());
-            }
-            if (sqlite3_bind_text(stmt, 4,
-                StringUtils::wideToUtf8(reporting_npp->getName()).c_str(),
-                -1, SQLITE_TRANSIENT) != SQLITE_OK)
-            {
-                Log::error("easySQLQuery", "Failed to bind %s.",
-                    StringUtils::wideToUtf8(reporting_npp->getName()).c_str());
-            }
-        });
+    values.emplace_back((int64_t)reporting_npp->getOnlineId());
+    values.emplace_back(StringUtils::wideToUtf8(reporting_npp->getName()));
+    bool written = m_db->write(query, values);
     if (written)
     {
         NetworkString* success = getNetworkString();
@@ -2057,8 +1913,28 @@ void ServerLobby::finishedLoadingLiveJoinClient(Event* event)
     NetworkItemManager* nim = dynamic_cast<NetworkItemManager*>
         (Track::getCurrentTrack()->getItemManager());
     assert(nim);
-    nim->saveCompleteState(ns);
+    // A client which supports it gets the latest compressed checkpoint, and
+    // the item events since it with the next states
+    int checkpoint_ticks = -1;
+    if (peer->getClientCapabilities().find("compressed_checkpoint") !=
+        peer->getClientCapabilities().end())
+    {
+        BareNetworkString checkpoint;
+        if (m_state_checkpoint)
+            checkpoint_ticks = m_state_checkpoint->addCheckpoint(&checkpoint);
+        ns->addUInt8(checkpoint_ticks == -1 ? 0 : 1);
+        if (checkpoint_ticks != -1)
+            *ns += checkpoint;
+    }
+    if (checkpoint_ticks == -1)
+        nim->saveCompleteState(ns);
     nim->addLiveJoinPeer(peer);
+    if (checkpoint_ticks != -1)
+    {
+        nim->restoreCheckpointEvents();
+        Log::info("ServerLobby", "%s live joins with the checkpoint at %d.",
+            peer->getAddress().toString().c_str(), checkpoint_ticks);
+    }
 
     w->saveCompleteState(ns, peer.get());
     if (RaceManager::get()->supportsLiveJoining())
@@ -2250,6 +2126,16 @@ void ServerLobby::update(int ticks)
         {
             checkRaceFinished();
         }
+        if (m_state_checkpoint && worldIsActive())
+        {
+            NetworkItemManager* nim = dynamic_cast<NetworkItemManager*>
+                (Track::getCurrentTrack()->getItemManager());
+            if (nim)
+            {
+                m_state_checkpoint->update(nim,
+                    World::getWorld()->getTicksSinceStart());
+            }
+        }
         break;
     case WAIT_FOR_RACE_STOPPED:
         if (!RaceEventManager::get()->protocolStopped() ||
@@ -3406,10 +3292,9 @@ void ServerLobby::saveIPBanTable(const SocketAddress& addr)
         return;
 
     std::string query = StringUtils::insertValues(
-        "INSERT INTO %s (ip_start, ip_end) "
-        "VALUES (%u, %u);",
-        ServerConfig::m_ip_ban_table.c_str(), addr.getIP(), addr.getIP());
-    easySQLQuery(query);
+        "INSERT INTO %s (ip_start, ip_end) VALUES (?, ?);",
+        ServerConfig::m_ip_ban_table.c_str());
+    m_db->write(query, { (int64_t)addr.getIP(), (int64_t)addr.getIP() });
 #endif
 }   // saveIPBanTable
 
@@ -3891,6 +3776,9 @@ void ServerLobby::handleUnencryptedConnection(std::shared_ptr<STKPeer> peer,
 #ifdef ENABLE_SQLITE3
     if (m_server_stats_table.empty() || peer->isAIPeer())
         return;
+    auto version_os = StringUtils::extractVersionOS(peer->getUserVersion());
+    std::vector<DatabaseConnector::Value> values;
+    values.emplace_back((int64_t)peer->getHostId());
     std::string query;
     if (ServerConfig::m_ipv6_connection && peer->getAddress().isIPv6())
     {
@@ -3898,10 +3786,9 @@ void ServerLobby::handleUnencryptedConnection(std::shared_ptr<STKPeer> peer,
             "INSERT INTO %s "
             "(host_id, ip, ipv6 ,port, online_id, username, player_num, "
             "country_code, version, os, ping) "
-            "VALUES (%u, 0, \"%s\" ,%u, %u, ?, %u, ?, ?, ?, %u);",
-            m_server_stats_table.c_str(), peer->getHostId(),
-            peer->getAddress().toString(false), peer->getAddress().getPort(),
-            online_id, player_count, peer->getAveragePing());
+            "VALUES (?, 0, ?, ?, ?, ?, ?, ?, ?, ?, ?);",
+            m_server_stats_table.c_str());
+        values.emplace_back(peer->getAddress().toString(false));
     }
     else
     {
@@ -3909,54 +3796,23 @@ void ServerLobby::handleUnencryptedConnection(std::shared_ptr<STKPeer> peer,
             "INSERT INTO %s "
             "(host_id, ip, port, online_id, username, player_num, "
             "country_code, version, os, ping) "
-            "VALUES (%u, %u, %u, %u, ?, %u, ?, ?, ?, %u);",
-            m_server_stats_table.c_str(), peer->getHostId(),
-            peer->getAddress().getIP(), peer->getAddress().getPort(),
-            online_id, player_count, peer->getAveragePing());
-    }
-    easySQLQuery(query, [peer, country_code](sqlite3_stmt* stmt)
-        {
-            if (sqlite3_bind_text(stmt, 1, StringUtils::wideToUtf8(
-                peer->getPlayerProfiles()[0]->getName()).c_str(),
-                -1, SQLITE_TRANSIENT) != SQLITE_OK)
-            {
-                Log::error("easySQLQuery", "Failed to bind %s.",
-                    StringUtils::wideToUtf8(
-                    peer->getPlayerProfiles()[0]->getName()).c_str());
-            }
-            if (country_code.empty())
-            {
-                if (sqlite3_bind_null(stmt, 2) != SQLITE_OK)
-                {
-                    Log::error("easySQLQuery",
-                        "Failed to bind NULL for country code.");
-                }
-            }
-            else
-            {
-                if (sqlite3_bind_text(stmt, 2, country_code.c_str(),
-                    -1, SQLITE_TRANSIENT) != SQLITE_OK)
-                {
-                    Log::error("easySQLQuery", "Failed to bind country: %s.",
-                        country_code.c_str());
-                }
-            }
-            auto version_os =
-                StringUtils::extractVersionOS(peer->getUserVersion());
-            if (sqlite3_bind_text(stmt, 3, version_os.first.c_str(),
-                -1, SQLITE_TRANSIENT) != SQLITE_OK)
-            {
-                Log::error("easySQLQuery", "Failed to bind %s.",
-                    version_os.first.c_str());
-            }
-            if (sqlite3_bind_text(stmt, 4, version_os.second.c_str(),
-                -1, SQLITE_TRANSIENT) != SQLITE_OK)
-            {
-                Log::error("easySQLQuery", "Failed to bind %s.",
-                    version_os.second.c_str());
-            }
-        }
-    );
+            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);",
+            m_server_stats_table.c_str());
+        values.emplace_back((int64_t)peer->getAddress().getIP());
+    }
+    values.emplace_back((int64_t)peer->getAddress().getPort());
+    values.emplace_back((int64_t)online_id);
+    values.emplace_back(StringUtils::wideToUtf8(
+        peer->getPlayerProfiles()[0]->getName()));
+    values.emplace_back((int64_t)player_count);
+    if (country_code.empty())
+        values.emplace_back();
+    else
+        values.emplace_back(country_code);
+    values.emplace_back(version_os.first);
+    values.emplace_back(version_os.second);
+    values.emplace_back((int64_t)peer->getAveragePing());
+    m_db->write(query, values);
 #endif
 }   // handleUnencryptedConnection
 
@@ -4806,55 +4662,38 @@ void ServerLobby::testBannedForIP(STKPeer* peer) const
     int row_id = -1;
     unsigned ip_start = 0;
     unsigned ip_end = 0;
+    std::string reason, desc;
     std::string query = StringUtils::insertValues(
         "SELECT rowid, ip_start, ip_end, reason, description FROM %s "
-        "WHERE ip_start <= %u AND ip_end >= %u "
+        "WHERE ip_start <= ? AND ip_end >= ? "
         "AND datetime('now') > datetime(starting_time) AND "
         "(expired_days is NULL OR datetime"
         "(starting_time, '+'||expired_days||' days') > datetime('now')) "
         "LIMIT 1;",
-        ServerConfig::m_ip_ban_table.c_str(),
-        peer->getAddress().getIP(), peer->getAddress().getIP());
-
-    sqlite3_stmt* stmt = NULL;
-    int ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-    if (ret == SQLITE_OK)
-    {
-        ret = sqlite3_step(stmt);
-        if (ret == SQLITE_ROW)
+        ServerConfig::m_ip_ban_table.c_str());
+    const int64_t ip = peer->getAddress().getIP();
+    m_db->read(query, { ip, ip },
+        [&row_id, &ip_start, &ip_end, &reason, &desc](sqlite3_stmt* stmt)
         {
             row_id = sqlite3_column_int(stmt, 0);
             ip_start = (unsigned)sqlite3_column_int64(stmt, 1);
             ip_end = (unsigned)sqlite3_column_int64(stmt, 2);
-            const char* reason = (char*)sqlite3_column_text(stmt, 3);
-            const char* desc = (char*)sqlite3_column_text(stmt, 4);
-            Log::info("ServerLobby", "%s banned by IP: %s "
-                "(rowid: %d, description: %s).",
-                peer->getAddress().toString().c_str(), reason, row_id, desc);
-            kickPlayerWithReason(peer, reason);
-        }
-        ret = sqlite3_finalize(stmt);
-        if (ret != SQLITE_OK)
-        {
-            Log::error("ServerLobby",
-                "Error finalize database for query %s: %s",
-                query.c_str(), sqlite3_errmsg(m_db));
-        }
-    }
-    else
-    {
-        Log::error("ServerLobby", "Error preparing database for query %s: %s",
-            query.c_str(), sqlite3_errmsg(m_db));
-        return;
-    }
+            reason = getColumnText(stmt, 3);
+            desc = getColumnText(stmt, 4);
+        });
     if (row_id != -1)
     {
+        Log::info("ServerLobby", "%s banned by IP: %s "
+            "(rowid: %d, description: %s).",
+            peer->getAddress().toString().c_str(), reason.c_str(), row_id,
+            desc.c_str());
+        kickPlayerWithReason(peer, reason.c_str());
         query = StringUtils::insertValues(
             "UPDATE %s SET trigger_count = trigger_count + 1, "
             "last_trigger = datetime('now') "
-            "WHERE ip_start = %u AND ip_end = %u;",
-            ServerConfig::m_ip_ban_table.c_str(), ip_start, ip_end);
-        easySQLQuery(query);
+            "WHERE ip_start = ? AND ip_end = ?;",
+            ServerConfig::m_ip_ban_table.c_str());
+        m_db->write(query, { (int64_t)ip_start, (int64_t)ip_end });
     }
 #endif
 }   // testBannedForIP
@@ -4871,7 +4710,7 @@ void ServerLobby::testBannedForIPv6(STKPeer* peer) const
         return;
 
     int row_id = -1;
-    std::string ipv6_cidr;
+    std::string ipv6_cidr, reason, desc;
     std::string query = StringUtils::insertValues(
         "SELECT rowid, ipv6_cidr, reason, description FROM %s "
         "WHERE insideIPv6CIDR(ipv6_cidr, ?) = 1 "
@@ -4880,60 +4719,26 @@ void ServerLobby::testBannedForIPv6(STKPeer* peer) const
         "(starting_time, '+'||expired_days||' days') > datetime('now')) "
         "LIMIT 1;",
         ServerConfig::m_ipv6_ban_table.c_str());
-
-    sqlite3_stmt* stmt = NULL;
-    int ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-    if (ret == SQLITE_OK)
-    {
-        if (sqlite3_bind_text(stmt, 1,
-            peer->getAddress().toString(false).c_str(), -1, SQLITE_TRANSIENT)
-            != SQLITE_OK)
-        {
-            Log::error("ServerLobby", "Error binding ipv6 addr for query: %s",
-                sqlite3_errmsg(m_db));
-        }
-
-        ret = sqlite3_step(stmt);
-        if (ret == SQLITE_ROW)
+    m_db->read(query, { peer->getAddress().toString(false) },
+        [&row_id, &ipv6_cidr, &reason, &desc](sqlite3_stmt* stmt)
         {
             row_id = sqlite3_column_int(stmt, 0);
-            ipv6_cidr = (char*)sqlite3_column_text(stmt, 1);
-            const char* reason = (char*)sqlite3_column_text(stmt, 2);
-            const char* desc = (char*)sqlite3_column_text(stmt, 3);
-            Log::info("ServerLobby", "%s banned by IP: %s "
-                "(rowid: %d, description: %s).",
-                peer->getAddress().toString().c_str(), reason, row_id, desc);
-            kickPlayerWithReason(peer, reason);
-        }
-        ret = sqlite3_finalize(stmt);
-        if (ret != SQLITE_OK)
-        {
-            Log::error("ServerLobby",
-                "Error finalize database for query %s: %s",
-                query.c_str(), sqlite3_errmsg(m_db));
-        }
-    }
-    else
-    {
-        Log::error("ServerLobby", "Error preparing database for query %s: %s",
-            query.c_str(), sqlite3_errmsg(m_db));
-        return;
-    }
+            ipv6_cidr = getColumnText(stmt, 1);
+            reason = getColumnText(stmt, 2);
+            desc = getColumnText(stmt, 3);
+        });
     if (row_id != -1)
     {
+        Log::info("ServerLobby", "%s banned by IP: %s "
+            "(rowid: %d, description: %s).",
+            peer->getAddress().toString().c_str(), reason.c_str(), row_id,
+            desc.c_str());
+        kickPlayerWithReason(peer, reason.c_str());
         query = StringUtils::insertValues(
             "UPDATE %s SET trigger_count = trigger_count + 1, "
             "last_trigger = datetime('now') "
             "WHERE ipv6_cidr = ?;", ServerConfig::m_ipv6_ban_table.c_str());
-        easySQLQuery(query, [ipv6_cidr](sqlite3_stmt* stmt)
-            {
-                if (sqlite3_bind_text(stmt, 1, ipv6_cidr.c_str(),
-                    -1, SQLITE_TRANSIENT) != SQLITE_OK)
-                {
-                    Log::error("easySQLQuery", "Failed to bind %s.",
-                        ipv6_cidr.c_str());
-                }
-            });
+        m_db->write(query, { ipv6_cidr });
     }
 #endif
 }   // testBannedForIPv6
@@ -4947,52 +4752,35 @@ void ServerLobby::testBannedForOnlineId(STKPeer* peer,
         return;
 
     int row_id = -1;
+    std::string reason, desc;
     std::string query = StringUtils::insertValues(
         "SELECT rowid, reason, description FROM %s "
-        "WHERE online_id = %u "
+        "WHERE online_id = ? "
         "AND datetime('now') > datetime(starting_time) AND "
         "(expired_days is NULL OR datetime"
         "(starting_time, '+'||expired_days||' days') > datetime('now')) "
         "LIMIT 1;",
-        ServerConfig::m_online_id_ban_table.c_str(), online_id);
-
-    sqlite3_stmt* stmt = NULL;
-    int ret = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, 0);
-    if (ret == SQLITE_OK)
-    {
-        ret = sqlite3_step(stmt);
-        if (ret == SQLITE_ROW)
+        ServerConfig::m_online_id_ban_table.c_str());
+    m_db->read(query, { (int64_t)online_id },
+        [&row_id, &reason, &desc](sqlite3_stmt* stmt)
         {
             row_id = sqlite3_column_int(stmt, 0);
-            const char* reason = (char*)sqlite3_column_text(stmt, 1);
-            const char* desc = (char*)sqlite3_column_text(stmt, 2);
-            Log::info("ServerLobby", "%s banned by online id: %s "
-                "(online id: %u rowid: %d, description: %s).",
-                peer->getAddress().toString().c_str(), reason, online_id,
-                row_id, desc);
-            kickPlayerWithReason(peer, reason);
-        }
-        ret = sqlite3_finalize(stmt);
-        if (ret != SQLITE_OK)
-        {
-            Log::error("ServerLobby", "Error finalize database: %s",
-                sqlite3_errmsg(m_db));
-        }
-    }
-    else
-    {
-        Log::error("ServerLobby", "Error preparing database: %s",
-            sqlite3_errmsg(m_db));
-        return;
-    }
+            reason = getColumnText(stmt, 1);
+            desc = getColumnText(stmt, 2);
+        });
     if (row_id != -1)
     {
+        Log::info("ServerLobby", "%s banned by online id: %s "
+            "(online id: %u rowid: %d, description: %s).",
+            peer->getAddress().toString().c_str(), reason.c_str(), online_id,
+            row_id, desc.c_str());
+        kickPlayerWithReason(peer, reason.c_str());
         query = StringUtils::insertValues(
             "UPDATE %s SET trigger_count = trigger_count + 1, "
             "last_trigger = datetime('now') "
-            "WHERE online_id = %u;",
-            ServerConfig::m_online_id_ban_table.c_str(), online_id);
-        easySQLQuery(query);
+            "WHERE online_id = ?;",
+            ServerConfig::m_online_id_ban_table.c_str());
+        m_db->write(query, { (int64_t)online_id });
     }
 #endif
 }   // testBannedForOnlineId
@@ -5003,15 +4791,15 @@ void ServerLobby::listBanTable()
 #ifdef ENABLE_SQLITE3
     if (!m_db)
         return;
-    auto printer = [](void* data, int argc, char** argv, char** name)
+    auto printer = [](sqlite3_stmt* stmt)
         {
-            for (int i = 0; i < argc; i++)
+            for (int i = 0; i < sqlite3_column_count(stmt); i++)
             {
-                std::cout << name[i] << " = " << (argv[i] ? argv[i] : "NULL")
-                    << "\n";
+                const char* value = (char*)sqlite3_column_text(stmt, i);
+                std::cout << sqlite3_column_name(stmt, i) << " = "
+                    << (value ? value : "NULL") << "\n";
             }
             std::cout << "\n";
-            return 0;
         };
     if (m_ip_ban_table_exists)
     {
@@ -5019,7 +4807,7 @@ void ServerLobby::listBanTable()
         query += ServerConfig::m_ip_ban_table;
         query += ";";
         std::cout << "IP ban list:\n";
-        sqlite3_exec(m_db, query.c_str(), printer, NULL, NULL);
+        m_db->read(query, {}, printer);
     }
     if (m_online_id_ban_table_exists)
     {
@@ -5027,7 +4815,7 @@ void ServerLobby::listBanTable()
         query += ServerConfig::m_online_id_ban_table;
         query += ";";
         std::cout << "Online Id ban list:\n";
-        sqlite3_exec(m_db, query.c_str(), printer, NULL, NULL);
+        m_db->read(query, {}, printer);
     }
 #endif
 }   // listBanTable
@@ -5610,6 +5398,8 @@ void ServerLobby::saveInitialItems(std::shared_ptr<NetworkItemManager> nim)
     m_items_complete_state->getBuffer().clear();
     m_items_complete_state->reset();
     nim->saveCompleteState(m_items_complete_state);
+    if (m_state_checkpoint)
+        m_state_checkpoint->clear();
 }   // saveInitialItems
 
 //-----------------------------------------------------------------------------
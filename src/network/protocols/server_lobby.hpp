@@ -34,16 +34,16 @@
 #include <mutex>
 #include <set>
 
+class BareNetworkString;
 #ifdef ENABLE_SQLITE3
-#include <sqlite3.h>
+class DatabaseConnector;
 #endif
-
-class BareNetworkString;
 class NetworkItemManager;
 class NetworkString;
 class NetworkPlayerProfile;
 class STKPeer;
 class SocketAddress;
+class StateCheckpoint;
 
 namespace Online
 {
@@ -81,7 +81,7 @@ private:
     bool m_player_reports_table_exists;
 
 #ifdef ENABLE_SQLITE3
-    sqlite3* m_db;
+    std::unique_ptr<DatabaseConnector> m_db;
 
     std::string m_server_stats_table;
 
@@ -99,9 +99,6 @@ private:
 
     void pollDatabase();
 
-    bool easySQLQuery(const std::string& query,
-        std::function<void(sqlite3_stmt* stmt)> bind_function = nullptr) const;
-
     void checkTableExists(const std::string& table, bool& result);
 
     std::string ip2Country(const SocketAddress& addr) const;
@@ -224,6 +221,10 @@ private:
     /* Used to make sure clients are having same item list at start */
     BareNetworkString* m_items_complete_state;
 
+    /* Compressed item states which are sent to live-joining clients, NULL
+     * if disabled. */
+    std::unique_ptr<StateCheckpoint> m_state_checkpoint;
+
     std::atomic<uint32_t> m_server_id_online;
 
     std::atomic<uint32_t> m_client_server_host_id;
@@ -24,6 +24,8 @@
 #include "items/projectile_manager.hpp"
 #include "utils/log.hpp"
 
+#include <cstring>
+
 /** Constructor for a state: it only takes the size, and allocates a buffer
  *  for all state info.
  *  \param size Necessary buffer size for a state.
@@ -125,12 +127,47 @@ void RewindInfoState::restore()
     }   // for all rewinder
 }   // restore
 
+// ------------------------------------------------------------------------
+/** Returns true if this state is identical to a state predicted on this
+ *  client, i.e. it contains the same rewinders and the same bytes (so the
+ *  comparison is done at the precision in which states are sent).
+ *  \param rewinder_using Unique identities of the predicted rewinders.
+ *  \param state The predicted state data, in the same format as sent by
+ *         the server (the size of each rewinder state followed by it).
+ */
+bool RewindInfoState::matches(const std::vector<std::string>& rewinder_using,
+                              const std::vector<uint8_t>& state) const
+{
+    if (m_rewinder_using != rewinder_using ||
+        m_buffer->getTotalSize() - m_start_offset != state.size())
+        return false;
+    return state.empty() ||
+        memcmp(m_buffer->getData() + m_start_offset, state.data(),
+               state.size()) == 0;
+}   // matches
+
 // ============================================================================
-RewindInfoEvent::RewindInfoEvent(int ticks, EventRewinder *event_rewinder,
-                                 BareNetworkString *buffer, bool is_confirmed)
-               : RewindInfo(ticks, is_confirmed)
+RewindInfoEvent::RewindInfoEvent()
+               : RewindInfo(0, /*is_confirmed*/false)
 {
-    m_event_rewinder = event_rewinder;
-    m_buffer         = buffer;
+    m_event_rewinder = NULL;
 }   // RewindInfoEvent
 
+// ------------------------------------------------------------------------
+/** Sets the data of this event. The event data is copied into the buffer
+ *  of this object, which keeps its memory when the object is reused.
+ *  \param ticks Time at which the event happened.
+ *  \param event_rewinder The rewinder responsible for this event.
+ *  \param data Pointer to the event data.
+ *  \param size Number of bytes of event data.
+ *  \param is_confirmed If the event was received from the server.
+ */
+void RewindInfoEvent::set(int ticks, EventRewinder *event_rewinder,
+                          const char *data, int size, bool is_confirmed)
+{
+    init(ticks, is_confirmed);
+    m_event_rewinder = event_rewinder;
+    m_buffer.getBuffer().assign(data, data + size);
+    m_buffer.reset();
+}   // set
+
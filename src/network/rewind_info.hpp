@@ -54,6 +54,15 @@ private:
      *  object.  */
     bool m_is_confirmed;
 
+protected:
+    // ------------------------------------------------------------------------
+    /** Sets the time and confirmed flag when a RewindInfo is reused. */
+    void init(int ticks, bool is_confirmed)
+    {
+        m_ticks        = ticks;
+        m_is_confirmed = is_confirmed;
+    }   // init
+
 public:
     RewindInfo(int ticks, bool is_confirmed);
 
@@ -111,6 +120,9 @@ public:
     // ------------------------------------------------------------------------
     virtual void restore();
     // ------------------------------------------------------------------------
+    bool matches(const std::vector<std::string>& rewinder_using,
+                 const std::vector<uint8_t>& state) const;
+    // ------------------------------------------------------------------------
     /** Returns a pointer to the state buffer. */
     BareNetworkString *getBuffer() const { return m_buffer; }
     // ------------------------------------------------------------------------
@@ -132,6 +144,10 @@ public:
 };   // class RewindInfoState
 
 // ============================================================================
+/** An event. Events are very frequent, so the RewindQueue reuses these
+ *  objects (see RewindQueue::createEvent), and the event data is copied
+ *  into a buffer that is part of this object.
+ */
 class RewindInfoEvent : public RewindInfo
 {
 private:
@@ -139,15 +155,12 @@ private:
     EventRewinder *m_event_rewinder;
 
     /** Buffer with the event data. */
-    BareNetworkString *m_buffer;
+    BareNetworkString m_buffer;
 public:
-             RewindInfoEvent(int ticks, EventRewinder *event_rewinder,
-                             BareNetworkString *buffer, bool is_confirmed);
-    virtual ~RewindInfoEvent()
-    {
-        delete m_buffer;
-    }   // ~RewindInfoEvent
-
+             RewindInfoEvent();
+    // ------------------------------------------------------------------------
+    void set(int ticks, EventRewinder *event_rewinder, const char *data,
+             int size, bool is_confirmed);
     // ------------------------------------------------------------------------
     /** An event is never 'restored', it is only rewound. */
     void restore() {}
@@ -158,8 +171,8 @@ public:
      *  It calls undoEvent in the rewinder. */
     virtual void undo()
     {
-        m_buffer->reset();
-        m_event_rewinder->undo(m_buffer);
+        m_buffer.reset();
+        m_event_rewinder->undo(&m_buffer);
     }   // undo
     // ------------------------------------------------------------------------
     /** This is called while going forwards in time again to reach current
@@ -168,12 +181,12 @@ public:
     virtual void replay()
     {
         // Make sure to reset the buffer so we read from the beginning
-        m_buffer->reset();
-        m_event_rewinder->rewind(m_buffer);
+        m_buffer.reset();
+        m_event_rewinder->rewind(&m_buffer);
     }   // rewind
     // ------------------------------------------------------------------------
     /** Returns the buffer with the event information in it. */
-    BareNetworkString *getBuffer() { return m_buffer; }
+    BareNetworkString *getBuffer() { return &m_buffer; }
 };   // class RewindIndoEvent
 
 
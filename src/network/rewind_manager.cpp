@@ -19,12 +19,14 @@
 #include "network/rewind_manager.hpp"
 
 #include "graphics/irr_driver.hpp"
+#include "karts/kart_rewinder.hpp"
 #include "modes/soccer_world.hpp"
 #include "network/network_config.hpp"
 #include "network/network_string.hpp"
 #include "network/protocols/game_protocol.hpp"
 #include "network/rewinder.hpp"
 #include "network/rewind_info.hpp"
+#include "network/server_metrics.hpp"
 #include "network/smooth_network_body.hpp"
 #include "physics/physics.hpp"
 #include "race/history.hpp"
@@ -39,6 +41,7 @@
 
 RewindManager* RewindManager::m_rewind_manager[PT_COUNT];
 std::atomic_bool RewindManager::m_enable_rewind_manager(false);
+bool RewindManager::m_log_stats = false;
 
 /** Creates the singleton. */
 RewindManager *RewindManager::create()
@@ -85,8 +88,13 @@ void RewindManager::reset()
 {
     m_schedule_reset_network_body = false;
     m_is_rewinding = false;
+    m_is_saving_prediction = false;
     m_not_rewound_ticks.store(0);
     m_overall_state_size = 0;
+    m_stats_rewinds = 0;
+    m_stats_skipped_rewinds = 0;
+    m_stats_replayed_ticks = 0;
+    m_stats_ticks = 0;
     m_state_frequency = stk_config->getPhysicsFPS() /
         NetworkConfig::get()->getStateFrequency();
 
@@ -98,40 +106,39 @@ void RewindManager::reset()
 }   // reset
 
 // ----------------------------------------------------------------------------    
-/** Adds an event to the rewind data. The data to be stored must be allocated
- *  and not freed by the caller!
+/** Adds an event to the rewind data. The event data is copied.
  *  \param time Time at which the event was recorded. If time is not specified
  *          (or set to -1), the current world time is used.
- *  \param buffer Pointer to the event data.
+ *  \param data Pointer to the event data.
+ *  \param size Number of bytes of event data.
  */
-void RewindManager::addEvent(EventRewinder *event_rewinder,
-                             BareNetworkString *buffer, bool confirmed,
-                             int ticks)
+void RewindManager::addEvent(EventRewinder *event_rewinder, const char *data,
+                             int size, bool confirmed, int ticks)
 {
     if (m_is_rewinding)
     {
-        delete buffer;
         Log::error("RewindManager", "Adding event when rewinding");
         return;
     }
 
     if (ticks < 0)
         ticks = World::getWorld()->getTicksSinceStart();
-    m_rewind_queue.addLocalEvent(event_rewinder, buffer, confirmed, ticks);
+    m_rewind_queue.addLocalEvent(event_rewinder, data, size, confirmed,
+                                 ticks);
 }   // addEvent
 
 // ----------------------------------------------------------------------------
 /** Adds an event to the list of network rewind data. This function is
  *  threadsafe so can be called by the network thread. The data is synched
- *  to m_rewind_info by the main thread. The data to be stored must be
- *  allocated and not freed by the caller!
+ *  to m_rewind_info by the main thread. The event data is copied.
  *  \param time Time at which the event was recorded.
- *  \param buffer Pointer to the event data.
+ *  \param data Pointer to the event data.
+ *  \param size Number of bytes of event data.
  */
 void RewindManager::addNetworkEvent(EventRewinder *event_rewinder,
-                                     BareNetworkString *buffer, int ticks)
+                                    const char *data, int size, int ticks)
 {
-    m_rewind_queue.addNetworkEvent(event_rewinder, buffer, ticks);
+    m_rewind_queue.addNetworkEvent(event_rewinder, data, size, ticks);
 }   // addNetworkEvent
 
 // ----------------------------------------------------------------------------
@@ -155,10 +162,11 @@ void RewindManager::addNetworkState(BareNetworkString *buffer, int ticks)
 void RewindManager::saveState()
 {
     PROFILER_PUSH_CPU_MARKER("RewindManager - save state", 0x20, 0x7F, 0x20);
+    // Without a GameProtocol (e.g. in the simulation benchmark) the states
+    // are still created, so the cost of saving them can be measured.
     auto gp = GameProtocol::lock();
-    if (!gp)
-        return;
-    gp->startNewState();
+    if (gp)
+        gp->startNewState();
 
     m_overall_state_size = 0;
     std::vector<std::string> rewinder_using;
@@ -173,11 +181,15 @@ void RewindManager::saveState()
         if (buffer != NULL)
         {
             m_overall_state_size += buffer->size();
-            gp->addState(buffer);
+            if (gp)
+                gp->addState(buffer);
         }
         delete buffer;    // buffer can be freed
     }
-    gp->finalizeState(rewinder_using);
+    if (gp)
+        gp->finalizeState(rewinder_using);
+    if (ServerMetrics* sm = ServerMetrics::get())
+        sm->setGauge(ServerMetrics::GT_STATE_SIZE, m_overall_state_size);
     PROFILER_POP_CPU_MARKER();
 }   // saveState
 
@@ -189,27 +201,33 @@ void RewindManager::saveState()
 void RewindManager::update(int ticks_not_used)
 {
     // FIXME: rename ticks_not_used
-    if (!m_enable_rewind_manager ||
-        m_all_rewinder.size() == 0 ||
-        m_is_rewinding)  return;
+    if (!m_enable_rewind_manager || m_all_rewinder.size() == 0)
+        return;
 
     int ticks = World::getWorld()->getTicksSinceStart();
+    const bool is_client = NetworkConfig::get()->isClient();
+
+    if (m_is_rewinding)
+    {
+        // Replace the local state and prediction of the time steps that
+        // are simulated again with the corrected ones
+        if (is_client && shouldSaveState(ticks))
+            saveLocalState(ticks);
+        return;
+    }
 
     m_not_rewound_ticks.store(ticks, std::memory_order_relaxed);
+    if (is_client)
+        updateStats();
 
     if (!shouldSaveState(ticks))
         return;
 
     // Save state, remove expired rewinder first
     clearExpiredRewinder();
-    if (NetworkConfig::get()->isClient())
+    if (is_client)
     {
-        auto& ret = m_local_state[ticks];
-        for (auto& p : m_all_rewinder)
-        {
-            if (auto r = p.second.lock())
-                ret.push_back(r->getLocalStateRestoreFunction());
-        }
+        saveLocalState(ticks);
     }
     else
     {
@@ -217,10 +235,133 @@ void RewindManager::update(int ticks_not_used)
         PROFILER_PUSH_CPU_MARKER("RewindManager - send state", 0x20, 0x7F, 0x40);
         if (auto gp = GameProtocol::lock())
             gp->sendState();
+        PROFILER_POP_CPU_MARKER();
     }
-    PROFILER_POP_CPU_MARKER();
 }   // update
 
+// ----------------------------------------------------------------------------
+/** Saves the local state of all rewinders on a client, and the state a
+ *  server would send for this time step if its simulation matched the one
+ *  of this client. Physical objects are not included in the prediction,
+ *  since saving their state changes the last saved transform (which the
+ *  server uses to only send moved objects). Bodies are compressed into the
+ *  prediction without rounding the live bodies, the prediction does not
+ *  change the simulation of this client.
+ *  \param ticks The current world time.
+ */
+void RewindManager::saveLocalState(int ticks)
+{
+    PROFILER_PUSH_CPU_MARKER("RewindManager - save local state",
+                             0x20, 0x7F, 0x60);
+    auto ret = m_local_state.emplace(ticks, LocalState());
+    LocalState& ls = ret.first->second;
+    if (ret.second && !m_unused_local_states.empty())
+    {
+        ls = std::move(m_unused_local_states.back());
+        m_unused_local_states.pop_back();
+    }
+    ls.m_karts.reset(World::getWorld()->getNumKarts());
+    ls.m_functions.clear();
+    ls.m_predicted_rewinders.clear();
+    BareNetworkString prediction;
+    for (auto& p : m_all_rewinder)
+    {
+        auto r = p.second.lock();
+        if (!r)
+            continue;
+        // Karts write into the shared arrays, see KartLocalStates
+        if (p.first[0] == RN_KART)
+        {
+            static_cast<KartRewinder*>(r.get())
+                ->saveLocalState(&ls.m_karts);
+        }
+        else
+        {
+            std::function<void()> f = r->getLocalStateRestoreFunction();
+            if (f)
+                ls.m_functions.push_back(f);
+        }
+        if (p.first[0] == RN_PHYSICAL_OBJ)
+            continue;
+        m_is_saving_prediction = true;
+        BareNetworkString* buffer = r->saveState(&ls.m_predicted_rewinders);
+        m_is_saving_prediction = false;
+        if (buffer)
+        {
+            // Same format as GameProtocol::addState
+            prediction.addUInt16(buffer->size());
+            prediction += *buffer;
+            delete buffer;
+        }
+    }
+    ls.m_predicted_state.assign(prediction.getData(),
+                                prediction.getData() +
+                                prediction.getTotalSize());
+    PROFILER_POP_CPU_MARKER();
+}   // saveLocalState
+
+// ----------------------------------------------------------------------------
+/** Moves all local states up to (and including) the specified time to the
+ *  list of unused local states, they will not be needed anymore.
+ *  \param ticks Time of the latest confirmed state.
+ */
+void RewindManager::recycleLocalStates(int ticks)
+{
+    for (auto it = m_local_state.begin(); it != m_local_state.end();)
+    {
+        if (it->first > ticks)
+            break;
+        m_unused_local_states.push_back(std::move(it->second));
+        it = m_local_state.erase(it);
+    }
+}   // recycleLocalStates
+
+// ----------------------------------------------------------------------------
+/** Returns true if the confirmed state at the specified time is identical
+ *  to the state predicted by this client, and no event for this or a later
+ *  (already simulated) time step was received. In this case a rewind would
+ *  only compute the same states again.
+ *  \param ticks Time of the confirmed state.
+ */
+bool RewindManager::isPredictionConfirmed(int ticks)
+{
+    // Events received for already simulated time steps were not used in
+    // the prediction, they must be replayed
+    if (m_rewind_queue.getLatestPastEventTicks() >= ticks)
+        return false;
+
+    auto it = m_local_state.find(ticks);
+    if (it == m_local_state.end())
+        return false;
+
+    RewindInfoState* state = m_rewind_queue.getConfirmedState(ticks);
+    return state && state->matches(it->second.m_predicted_rewinders,
+                                   it->second.m_predicted_state);
+}   // isPredictionConfirmed
+
+// ----------------------------------------------------------------------------
+/** Called once per (not rewound) time step on a client, logs statistics
+ *  about rewinds every 10 seconds if enabled.
+ */
+void RewindManager::updateStats()
+{
+    m_stats_ticks++;
+    if (m_stats_ticks < stk_config->time2Ticks(10.0f))
+        return;
+    if (m_log_stats)
+    {
+        Log::info("RewindManager",
+            "%d rewinds, %d rewinds skipped (confirmed state matched the "
+            "prediction), %.1f ticks replayed per second.", m_stats_rewinds,
+            m_stats_skipped_rewinds,
+            m_stats_replayed_ticks / stk_config->ticks2Time(m_stats_ticks));
+    }
+    m_stats_rewinds         = 0;
+    m_stats_skipped_rewinds = 0;
+    m_stats_replayed_ticks  = 0;
+    m_stats_ticks           = 0;
+}   // updateStats
+
 // ----------------------------------------------------------------------------
 /** Replays all events from the last event played till the specified time.
  *  \param world_ticks Up to (and inclusive) which time events will be replayed.
@@ -242,7 +383,15 @@ void RewindManager::playEventsTill(int world_ticks, bool fast_forward)
     // be getTime()+dt - world time has not been updated yet).
     m_rewind_queue.mergeNetworkData(world_ticks, &needs_rewind, &rewind_ticks);
 
-    if (needs_rewind)
+    if (needs_rewind && !fast_forward && isPredictionConfirmed(rewind_ticks))
+    {
+        // The client predicted the confirmed state correctly, so only
+        // the queue needs to catch up with the current time
+        m_rewind_queue.skipUntil(world_ticks);
+        recycleLocalStates(rewind_ticks);
+        m_stats_skipped_rewinds++;
+    }
+    else if (needs_rewind)
     {
         Log::setPrefix("Rewind");
         PROFILER_PUSH_CPU_MARKER("Rewind", 128, 128, 128);
@@ -334,18 +483,23 @@ void RewindManager::rewindTo(int rewind_ticks, int now_ticks,
     auto it = m_local_state.find(exact_rewind_ticks);
     if (it != m_local_state.end())
     {
-        for (auto& restore_local_state : it->second)
-        {
-            if (restore_local_state)
-                restore_local_state();
-        }
-        for (auto it = m_local_state.begin(); it != m_local_state.end();)
+        PROFILER_PUSH_CPU_MARKER("RewindManager - restore local state",
+                                 0x20, 0x7F, 0x80);
+        for (auto& p : m_all_rewinder)
         {
-            if (it->first <= exact_rewind_ticks)
-                it = m_local_state.erase(it);
-            else
-                break;
+            if (p.first[0] != RN_KART)
+                continue;
+            if (auto r = p.second.lock())
+            {
+                static_cast<KartRewinder*>(r.get())
+                    ->restoreLocalState(it->second.m_karts);
+            }
         }
+        for (auto& restore_local_state : it->second.m_functions)
+            restore_local_state();
+        PROFILER_POP_CPU_MARKER();
+
+        recycleLocalStates(exact_rewind_ticks);
     }
     else if (!fast_forward)
     {
@@ -379,6 +533,18 @@ void RewindManager::rewindTo(int rewind_ticks, int now_ticks,
         world->setTicksForRewind(exact_rewind_ticks);
     }
 
+    m_stats_rewinds++;
+    m_stats_replayed_ticks += now_ticks - exact_rewind_ticks;
+    // All past events are replayed below
+    m_rewind_queue.clearPastEventTicks();
+    // Without simulation the local states of the following time steps are
+    // not saved again, so their predictions are not valid anymore
+    if (fast_forward)
+    {
+        for (auto& ls : m_local_state)
+            ls.second.m_predicted_rewinders.clear();
+    }
+
     // Now go forward through the list of rewind infos till we reach 'now':
     while (world->getTicksSinceStart() < now_ticks)
     { 
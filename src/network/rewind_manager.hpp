@@ -19,6 +19,7 @@
 #ifndef HEADER_REWIND_MANAGER_HPP
 #define HEADER_REWIND_MANAGER_HPP
 
+#include "karts/kart_local_states.hpp"
 #include "network/rewind_queue.hpp"
 #include "utils/stk_process.hpp"
 
@@ -91,7 +92,30 @@ private:
      *  rewind data in case of local races only. */
     static std::atomic_bool m_enable_rewind_manager;
 
-    std::map<int, std::vector<std::function<void()> > > m_local_state;
+    /** If set, statistics about rewinds are logged periodically. */
+    static bool m_log_stats;
+
+    /** The local state of all rewinders at one time step, which is saved
+     *  on a client and restored when rewinding to that time step. */
+    struct LocalState
+    {
+        /** Local state of all karts. */
+        KartLocalStates m_karts;
+
+        /** Functions restoring the local state of all other rewinders. */
+        std::vector<std::function<void()> > m_functions;
+
+        /** The rewinders and their states as a server would send them,
+         *  based on the simulation of this client. If the confirmed state
+         *  is identical, no rewind to this time step is necessary. */
+        std::vector<std::string> m_predicted_rewinders;
+        std::vector<uint8_t> m_predicted_state;
+    };
+    std::map<int, LocalState> m_local_state;
+
+    /** Local states that are not used anymore, kept to reuse the memory
+     *  of their arrays. */
+    std::vector<LocalState> m_unused_local_states;
 
     /** A list of all objects that can be rewound. */
     std::map<std::string, std::weak_ptr<Rewinder> > m_all_rewinder;
@@ -105,6 +129,10 @@ private:
     /** Indicates if currently a rewind is happening. */
     bool m_is_rewinding;
 
+    /** True while a client saves the state it predicts a server to send.
+     *  Rewinders must then not change their (physics) state. */
+    bool m_is_saving_prediction;
+
     /** How much time between consecutive state saves. */
     int m_state_frequency;
 
@@ -119,6 +147,16 @@ private:
 
     std::set<std::string> m_missing_rewinders;
 
+    /** Number of rewinds done and skipped (because the confirmed state
+     *  matched the prediction), and the number of time steps simulated
+     *  again in rewinds, since the stats were last logged. */
+    int m_stats_rewinds;
+    int m_stats_skipped_rewinds;
+    int m_stats_replayed_ticks;
+
+    /** Number of time steps since the stats were last logged. */
+    int m_stats_ticks;
+
     RewindManager();
    ~RewindManager();
     // ------------------------------------------------------------------------
@@ -136,6 +174,14 @@ private:
     }
     // ------------------------------------------------------------------------
     void mergeRewindInfoEventFunction();
+    // ------------------------------------------------------------------------
+    void saveLocalState(int ticks);
+    // ------------------------------------------------------------------------
+    void recycleLocalStates(int ticks);
+    // ------------------------------------------------------------------------
+    bool isPredictionConfirmed(int ticks);
+    // ------------------------------------------------------------------------
+    void updateStats();
 
 public:
     // First static functions to manage rewinding.
@@ -149,6 +195,9 @@ public:
     /** Returns if rewinding is enabled or not. */
     static bool isEnabled() { return m_enable_rewind_manager; }
     // ------------------------------------------------------------------------
+    /** Enables periodically logging statistics about rewinds. */
+    static void setLogStats(bool log_stats)      { m_log_stats = log_stats; }
+    // ------------------------------------------------------------------------
     static bool exists()
     {
         ProcessType pt = STKProcess::getType();
@@ -170,10 +219,10 @@ public:
     void update(int ticks);
     void rewindTo(int target_ticks, int ticks_now, bool fast_forward);
     void playEventsTill(int world_ticks, bool fast_forward);
-    void addEvent(EventRewinder *event_rewinder, BareNetworkString *buffer,
+    void addEvent(EventRewinder *event_rewinder, const char *data, int size,
                   bool confirmed, int ticks = -1);
-    void addNetworkEvent(EventRewinder *event_rewinder,
-                         BareNetworkString *buffer, int ticks);
+    void addNetworkEvent(EventRewinder *event_rewinder, const char *data,
+                         int size, int ticks);
     void addNetworkState(BareNetworkString *buffer, int ticks);
     void saveState();
     // ------------------------------------------------------------------------
@@ -192,6 +241,9 @@ public:
     // ------------------------------------------------------------------------
     /** Returns true if currently a rewind is happening. */
     bool isRewinding() const { return m_is_rewinding; }
+    // ------------------------------------------------------------------------
+    /** Returns true if a client currently saves its predicted state. */
+    bool isSavingPrediction() const { return m_is_saving_prediction; }
 
     // ------------------------------------------------------------------------
     int getNotRewoundWorldTicks() const
@@ -26,25 +26,27 @@
 #include "network/rewinder.hpp"
 #include "network/rewind_info.hpp"
 #include "network/rewind_manager.hpp"
+#include "utils/random_generator.hpp"
 
 #include <algorithm>
+#include <cstring>
+#include <list>
 
-/** The RewindQueue stores one TimeStepInfo for each time step done.
- *  The TimeStepInfo stores all states and events to be used at the
- *  given timestep. 
+/** The RewindQueue stores all states and events sorted by time step, in
+ *  a ring buffer indexed by the time step (see m_ring).
  *  All network events (i.e. new states or client events) are stored in a
- *  separate list m_network_events. At the very start of a new time step
- *  a new TimeStepInfo object is added. Then all network events that are
- *  supposed to happen between t and t+dt are added to this newly added
- *  TimeStep (see mergeNetworkData), and are then being executed.
- *  In case of a rewind the RewindQueue finds the last TimeStepInfo with
+ *  separate structure m_network_data. At the very start of a new time step
+ *  all network events that are supposed to happen up to this time step are
+ *  added to the ring buffer (see mergeNetworkData), and are then being
+ *  executed.
+ *  In case of a rewind the RewindQueue finds the last time step with
  *  a confirmed server state (undoing the events, see undoUntil). Then
- *  the state is restored from the TimeStepInfo object (see replayAllStates)
- *  then the rewind manager re-executes the time steps (using the events
- *  stored at each timestep).
+ *  the state is restored, and the rewind manager re-executes the time steps
+ *  (using the events stored at each timestep).
  */
 RewindQueue::RewindQueue()
 {
+    m_num_rewind_info = 0;
     reset();
 }   // RewindQueue
 
@@ -63,76 +65,201 @@ RewindQueue::~RewindQueue()
  */
 void RewindQueue::reset()
 {
-    m_network_events.lock();
+    m_network_data.lock();
 
-    AllNetworkRewindInfo &info = m_network_events.getData();
-    for (AllNetworkRewindInfo::const_iterator i  = info.begin(); 
-                                              i != info.end(); ++i)
+    NetworkData &data = m_network_data.getData();
+    for (RewindInfo *ri : data.m_rewind_info)
+        delete ri;
+    data.m_rewind_info.clear();
+    data.m_events.clear();
+    data.m_event_data.clear();
+    m_network_data.unlock();
+
+    if (m_num_rewind_info > 0)
     {
-        delete *i;
+        for (int ticks = m_first_ticks; ticks <= m_last_ticks; ticks++)
+        {
+            TickRewindInfo &tri = getTick(ticks);
+            for (RewindInfo *ri : tri)
+                freeRewindInfo(ri);
+            tri.clear();
+        }
     }
-    m_network_events.getData().clear();
-    m_network_events.unlock();
-
-    AllRewindInfo::const_iterator i;
-    for (i = m_all_rewind_info.begin(); i != m_all_rewind_info.end(); ++i)
-        delete *i;
-
-    m_all_rewind_info.clear();
-    m_current = m_all_rewind_info.end();
+    m_num_rewind_info = 0;
+    m_first_ticks = m_last_ticks = 0;
+    if (m_ring.empty())
+        m_ring.resize(64);
+    m_current.m_ticks = NO_TICKS;
     m_latest_confirmed_state_time = -1;
+    m_latest_past_event_ticks = -1;
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Returns an event, reusing an unused one if possible.
+ */
+RewindInfoEvent* RewindQueue::createEvent(int ticks,
+                                          EventRewinder *event_rewinder,
+                                          const char *data, int size,
+                                          bool confirmed)
+{
+    RewindInfoEvent *rie;
+    if (m_unused_events.empty())
+    {
+        m_event_slab.emplace_back();
+        rie = &m_event_slab.back();
+    }
+    else
+    {
+        rie = m_unused_events.back();
+        m_unused_events.pop_back();
+    }
+    rie->set(ticks, event_rewinder, data, size, confirmed);
+    return rie;
+}   // createEvent
+
+// ----------------------------------------------------------------------------
+/** Frees a RewindInfo that is not needed anymore. Events are kept for
+ *  reuse.
+ */
+void RewindQueue::freeRewindInfo(RewindInfo *ri)
+{
+    RewindInfoEvent *rie = dynamic_cast<RewindInfoEvent*>(ri);
+    if (rie)
+        m_unused_events.push_back(rie);
+    else
+        delete ri;
+}   // freeRewindInfo
+
+// ----------------------------------------------------------------------------
+/** Makes sure that the ring buffer can store the RewindInfos of the
+ *  specified time step, and adjusts the oldest and newest time step.
+ *  \param ticks The time step to add.
+ */
+void RewindQueue::makeRoom(int ticks)
+{
+    if (m_num_rewind_info == 0)
+    {
+        m_first_ticks = m_last_ticks = ticks;
+        return;
+    }
+    const int first = std::min(m_first_ticks, ticks);
+    const int last  = std::max(m_last_ticks, ticks);
+    if (last - first >= (int)m_ring.size())
+    {
+        size_t size = m_ring.size();
+        while ((int)size <= last - first)
+            size *= 2;
+        std::vector<TickRewindInfo> ring(size);
+        for (int t = m_first_ticks; t <= m_last_ticks; t++)
+            std::swap(ring[t & (size - 1)], getTick(t));
+        m_ring.swap(ring);
+    }
+    m_first_ticks = first;
+    m_last_ticks  = last;
+}   // makeRoom
+
+// ----------------------------------------------------------------------------
+/** Moves a position to the next RewindInfo.
+ *  \return False if there is no next RewindInfo (p is then not modified).
+ */
+bool RewindQueue::findNext(Position *p) const
+{
+    if (p->m_index + 1 < getTick(p->m_ticks).size())
+    {
+        p->m_index++;
+        return true;
+    }
+    for (int ticks = p->m_ticks + 1; ticks <= m_last_ticks; ticks++)
+    {
+        if (!getTick(ticks).empty())
+        {
+            p->m_ticks = ticks;
+            p->m_index = 0;
+            return true;
+        }
+    }
+    return false;
+}   // findNext
+
+// ----------------------------------------------------------------------------
+/** Moves a position to the previous RewindInfo.
+ *  \return False if there is no previous RewindInfo (p is then not
+ *          modified).
+ */
+bool RewindQueue::findPrevious(Position *p) const
+{
+    if (p->m_index > 0)
+    {
+        p->m_index--;
+        return true;
+    }
+    for (int ticks = p->m_ticks - 1; ticks >= m_first_ticks; ticks--)
+    {
+        const TickRewindInfo &tri = getTick(ticks);
+        if (!tri.empty())
+        {
+            p->m_ticks = ticks;
+            p->m_index = (unsigned int)tri.size() - 1;
+            return true;
+        }
+    }
+    return false;
+}   // findPrevious
+
 // ----------------------------------------------------------------------------
 /** Inserts a RewindInfo object in the list of all events at the correct time.
  *  If there are several RewindInfo at the exact same time, state RewindInfo
  *  will be insert at the front, and event info at the end of the RewindInfo
- *  with the same time.
+ *  with the same time. If all RewindInfos have been handled, the new one
+ *  becomes the current RewindInfo.
  *  \param ri The RewindInfo object to insert.
- *  \param update_current If set, the current pointer will be updated if
- *         necessary to point to the new event
  */
 void RewindQueue::insertRewindInfo(RewindInfo *ri)
 {
-    AllRewindInfo::iterator i = m_all_rewind_info.end();
-
-    while (i != m_all_rewind_info.begin())
+    const int ticks = ri->getTicks();
+    makeRoom(ticks);
+    TickRewindInfo &tri = getTick(ticks);
+    unsigned int index = 0;
+    if (ri->isEvent())
     {
-        AllRewindInfo::iterator i_prev = i;
-        i_prev--;
-        // Now test if 'ri' needs to be inserted after the
-        // previous element, i.e. before the current element:
-        if ((*i_prev)->getTicks() < ri->getTicks()) break;
-        if ((*i_prev)->getTicks() == ri->getTicks() &&
-            ri->isEvent()                              ) break;
-        i = i_prev;
+        index = (unsigned int)tri.size();
+        tri.push_back(ri);
     }
-    if(m_current == m_all_rewind_info.end())
-        m_current = m_all_rewind_info.insert(i, ri);
     else
-        m_all_rewind_info.insert(i, ri);  
+    {
+        tri.insert(tri.begin(), ri);
+        // Keep the current position at the same RewindInfo
+        if (m_current.m_ticks == ticks)
+            m_current.m_index++;
+    }
+    m_num_rewind_info++;
+
+    if (m_current.m_ticks == NO_TICKS)
+    {
+        m_current.m_ticks = ticks;
+        m_current.m_index = index;
+    }
 }   // insertRewindInfo
 
 // ----------------------------------------------------------------------------
-/** Adds an event to the rewind data. The data to be stored must be allocated
- *  and not freed by the caller!
- *  \param buffer Pointer to the event data. 
+/** Adds an event to the rewind data. The event data is copied.
+ *  \param event_rewinder The rewinder responsible for the event.
+ *  \param data Pointer to the event data.
+ *  \param size Number of bytes of event data.
+ *  \param confirmed If this event is confirmed by the server.
  *  \param ticks Time at which the event happened.
  */
 void RewindQueue::addLocalEvent(EventRewinder *event_rewinder,
-                                BareNetworkString *buffer, bool confirmed,
+                                const char *data, int size, bool confirmed,
                                 int ticks                                  )
 {
-    RewindInfo *ri = new RewindInfoEvent(ticks, event_rewinder,
-                                         buffer, confirmed);
-    insertRewindInfo(ri);
+    insertRewindInfo(createEvent(ticks, event_rewinder, data, size,
+                                 confirmed));
 }   // addLocalEvent
 
 // ----------------------------------------------------------------------------
-/** Adds a state from the local simulation to the last created TimeStepInfo
- *  container with the current world time. It is not thread-safe, so needs
- *  to be called from the main thread.
- *  \param rewinder The rewinder object for this state.
+/** Adds a state from the local simulation at the specified time. It is not
+ *  thread-safe, so needs to be called from the main thread.
  *  \param buffer The state information.
  *  \param confirmed If this state is confirmed to be correct (e.g. is
  *         being received from the servrer), or just a local state for
@@ -154,37 +281,40 @@ void RewindQueue::addLocalState(BareNetworkString *buffer,
 // ----------------------------------------------------------------------------
 /** Adds an event to the list of network rewind data. This function is
  *  threadsafe so can be called by the network thread. The data is synched
- *  to m_tRewindInformation list by the main thread. The data to be stored
- *  must be allocated and not freed by the caller!
- *  \param buffer Pointer to the event data.
+ *  to the ring buffer by the main thread. The event data is copied, without
+ *  allocating memory for each event.
+ *  \param event_rewinder The rewinder responsible for the event.
+ *  \param data Pointer to the event data.
+ *  \param size Number of bytes of event data.
  *  \param ticks Time at which the event happened.
  */
 void RewindQueue::addNetworkEvent(EventRewinder *event_rewinder,
-                                  BareNetworkString *buffer, int ticks)
+                                  const char *data, int size, int ticks)
 {
-    RewindInfo *ri = new RewindInfoEvent(ticks, event_rewinder,
-                                         buffer, /*confirmed*/true);
-
-    m_network_events.lock();
-    m_network_events.getData().push_back(ri);
-    m_network_events.unlock();
+    m_network_data.lock();
+    NetworkData &nd = m_network_data.getData();
+    NetworkEvent event;
+    event.m_event_rewinder = event_rewinder;
+    event.m_ticks          = ticks;
+    event.m_offset         = (unsigned int)nd.m_event_data.size();
+    event.m_size           = size;
+    nd.m_events.push_back(event);
+    nd.m_event_data.insert(nd.m_event_data.end(), data, data + size);
+    m_network_data.unlock();
 }   // addNetworkEvent
 
 // ----------------------------------------------------------------------------
 /** Adds a state to the list of network rewind data. This function is
  *  threadsafe so can be called by the network thread. The data is synched
- *  to RewindInfo list by the main thread. The data to be stored must be
+ *  to the ring buffer by the main thread. The data to be stored must be
  *  allocated and not freed by the caller!
  *  \param buffer Pointer to the event data.
  *  \param ticks Time at which the event happened.
  */
 void RewindQueue::addNetworkState(BareNetworkString *buffer, int ticks)
 {
-    RewindInfo *ri = new RewindInfoState(ticks, buffer, /*confirmed*/true);
-
-    m_network_events.lock();
-    m_network_events.getData().push_back(ri);
-    m_network_events.unlock();
+    addNetworkRewindInfo(new RewindInfoState(ticks, buffer,
+                                             /*confirmed*/true));
 }   // addNetworkState
 
 // ----------------------------------------------------------------------------
@@ -202,10 +332,11 @@ void RewindQueue::mergeNetworkData(int world_ticks, bool *needs_rewind,
                                    int *rewind_ticks)
 {
     *needs_rewind = false;
-    m_network_events.lock();
-    if(m_network_events.getData().empty())
+    m_network_data.lock();
+    NetworkData &data = m_network_data.getData();
+    if (data.m_rewind_info.empty() && data.m_events.empty())
     {
-        m_network_events.unlock();
+        m_network_data.unlock();
         return;
     }
 
@@ -214,30 +345,29 @@ void RewindQueue::mergeNetworkData(int world_ticks, bool *needs_rewind,
     // received state before current world time (if any)
     *rewind_ticks = -9999;
 
-    // FIXME: making m_network_events sorted would prevent the need to 
-    // go through the whole list of events
+    // RewindInfos that will happen in the future are kept at the front
+    // of the vectors.
+    unsigned int num_kept = 0;
     int latest_confirmed_state = -1;
-    AllNetworkRewindInfo::iterator i = m_network_events.getData().begin();
-    while (i != m_network_events.getData().end())
+    for (RewindInfo *ri : data.m_rewind_info)
     {
         // Ignore any events that will happen in the future. The current
         // time step is world_ticks.
-        if ((*i)->getTicks() > world_ticks)
+        if (ri->getTicks() > world_ticks)
         {
-            i++;
+            data.m_rewind_info[num_kept++] = ri;
             continue;
         }
         // Any state of event that is received before the latest confirmed
         // state can be deleted.
-        if ((*i)->getTicks() < m_latest_confirmed_state_time)
+        if (ri->getTicks() < m_latest_confirmed_state_time)
         {
             Log::info("RewindQueue",
                       "Deleting %s at %d because it's before confirmed state %d",
-                      (*i)->isEvent() ? "event" : "state",
-                      (*i)->getTicks(),
+                      ri->isEvent() ? "event" : "state",
+                      ri->getTicks(),
                       m_latest_confirmed_state_time);
-            delete *i;
-            i = m_network_events.getData().erase(i);
+            delete ri;
             continue;
         }
 
@@ -245,21 +375,21 @@ void RewindQueue::mergeNetworkData(int world_ticks, bool *needs_rewind,
         // duplicated states, which in the best case would then have
         // a negative effect for every player, when in fact only one
         // player might have a network hickup).
-        if (NetworkConfig::get()->isServer() && (*i)->getTicks() < world_ticks)
+        if (NetworkConfig::get()->isServer() && ri->getTicks() < world_ticks)
         {
             if (Network::m_connection_debug)
             {
                 Log::warn("RewindQueue",
                     "Server received at %d message from %d",
-                    world_ticks, (*i)->getTicks());
+                    world_ticks, ri->getTicks());
             }
             // Server received an event in the past. Adjust this event
             // to be executed 'now' - at least we get a bit closer to the
             // client state.
-            (*i)->setTicks(world_ticks);
+            ri->setTicks(world_ticks);
         }
 
-        insertRewindInfo(*i);
+        insertRewindInfo(ri);
 
         // Check if a rewind is necessary, i.e. a message is received in the
         // past of client (server never rewinds). Even if
@@ -268,7 +398,7 @@ void RewindQueue::mergeNetworkData(int world_ticks, bool *needs_rewind,
         // happen during debugging) we need to rewind to getTicks (in order
         // to get the latest state).
         if (NetworkConfig::get()->isClient() &&
-            (*i)->getTicks() <= world_ticks && (*i)->isState())
+            ri->getTicks() <= world_ticks && ri->isState())
         {
             // We need rewind if we receive an event in the past. This will
             // then trigger a rewind later. Note that we only rewind to the
@@ -279,20 +409,72 @@ void RewindQueue::mergeNetworkData(int world_ticks, bool *needs_rewind,
             // the earlier event, and the event will be replayed anyway. This
             // makes it easy to handle lost event messages.
             *needs_rewind = true;
-            if ((*i)->getTicks() > *rewind_ticks)
-                *rewind_ticks = (*i)->getTicks();
+            if (ri->getTicks() > *rewind_ticks)
+                *rewind_ticks = ri->getTicks();
         }   // if client and ticks < world_ticks
 
-        if ((*i)->isState() && (*i)->getTicks() > latest_confirmed_state &&
-            (*i)->isConfirmed())
+        if (ri->isState() && ri->getTicks() > latest_confirmed_state &&
+            ri->isConfirmed())
         {
-            latest_confirmed_state = (*i)->getTicks();
+            latest_confirmed_state = ri->getTicks();
+        }
+    }   // for ri in m_rewind_info
+    data.m_rewind_info.resize(num_kept);
+
+    // Now the events, using the same rules. The data of the events that
+    // are kept is moved to the front of m_event_data.
+    num_kept = 0;
+    unsigned int data_kept = 0;
+    for (unsigned int i = 0; i < data.m_events.size(); i++)
+    {
+        NetworkEvent &event = data.m_events[i];
+        if (event.m_ticks > world_ticks)
+        {
+            if (event.m_offset != data_kept)
+            {
+                memmove(data.m_event_data.data() + data_kept,
+                        data.m_event_data.data() + event.m_offset,
+                        event.m_size);
+                event.m_offset = data_kept;
+            }
+            data_kept += event.m_size;
+            data.m_events[num_kept++] = event;
+            continue;
+        }
+        if (event.m_ticks < m_latest_confirmed_state_time)
+        {
+            Log::info("RewindQueue",
+                      "Deleting event at %d because it's before confirmed "
+                      "state %d", event.m_ticks,
+                      m_latest_confirmed_state_time);
+            continue;
         }
 
-        i = m_network_events.getData().erase(i);
-    }   // for i in m_network_events
+        int ticks = event.m_ticks;
+        if (NetworkConfig::get()->isServer() && ticks < world_ticks)
+        {
+            if (Network::m_connection_debug)
+            {
+                Log::warn("RewindQueue",
+                    "Server received at %d message from %d",
+                    world_ticks, ticks);
+            }
+            ticks = world_ticks;
+        }
+        else if (NetworkConfig::get()->isClient() && ticks < world_ticks)
+        {
+            m_latest_past_event_ticks = std::max(m_latest_past_event_ticks,
+                                                 ticks);
+        }
+        insertRewindInfo(createEvent(ticks, event.m_event_rewinder,
+                                     data.m_event_data.data() +
+                                     event.m_offset,
+                                     event.m_size, /*confirmed*/true));
+    }   // for i in m_events
+    data.m_events.resize(num_kept);
+    data.m_event_data.resize(data_kept);
 
-    m_network_events.unlock();
+    m_network_data.unlock();
 
     if (latest_confirmed_state > m_latest_confirmed_state_time)
     {
@@ -322,30 +504,46 @@ void RewindQueue::mergeNetworkData(int world_ticks, bool *needs_rewind,
 }   // mergeNetworkData
 
 // ----------------------------------------------------------------------------
-/** Deletes all states and event before the given time.
+/** Deletes all states and event before the given time. If the current
+ *  RewindInfo is deleted, the first remaining RewindInfo becomes the
+ *  current one.
  *  \param ticks Time (in ticks).
  */
 void RewindQueue::cleanupOldRewindInfo(int ticks)
 {
-    auto i = m_all_rewind_info.begin();
+    if (m_num_rewind_info == 0)
+        return;
 
-    while (!m_all_rewind_info.empty() &&
-        (*i)->getTicks() < ticks)
+    int t = m_first_ticks;
+    for (; t < ticks && t <= m_last_ticks; t++)
     {
-        if (m_current == i) next();
-        delete *i;
-        i = m_all_rewind_info.erase(i);
+        TickRewindInfo &tri = getTick(t);
+        for (RewindInfo *ri : tri)
+            freeRewindInfo(ri);
+        m_num_rewind_info -= (unsigned int)tri.size();
+        tri.clear();
     }
 
-    if (m_all_rewind_info.empty())
-        m_current = m_all_rewind_info.end();
+    if (m_num_rewind_info == 0)
+    {
+        m_current.m_ticks = NO_TICKS;
+        return;
+    }
+    while (getTick(t).empty())
+        t++;
+    m_first_ticks = t;
 
+    if (m_current.m_ticks != NO_TICKS && m_current.m_ticks < m_first_ticks)
+    {
+        m_current.m_ticks = m_first_ticks;
+        m_current.m_index = 0;
+    }
 }   // cleanupOldRewindInfo
 
 // ----------------------------------------------------------------------------
 bool RewindQueue::isEmpty() const
 {
-    return m_current == m_all_rewind_info.end();
+    return m_current.m_ticks == NO_TICKS;
 }   // isEmpty
 
 // ----------------------------------------------------------------------------
@@ -353,7 +551,7 @@ bool RewindQueue::isEmpty() const
  */
 bool RewindQueue::hasMoreRewindInfo() const
 {
-    return m_current != m_all_rewind_info.end();
+    return m_current.m_ticks != NO_TICKS;
 }   // hasMoreRewindInfo
 
 // ----------------------------------------------------------------------------
@@ -365,31 +563,71 @@ bool RewindQueue::hasMoreRewindInfo() const
  */
 int RewindQueue::undoUntil(int undo_ticks)
 {
-    // A rewind is done after a state in the past is inserted. This function
-    // makes sure that m_current is not end()
-    //assert(m_current != m_all_rewind_info.end());
-    assert(!m_all_rewind_info.empty());
-    m_current = m_all_rewind_info.end();
-    m_current--;
-    while((*m_current)->getTicks() > undo_ticks ||
-        (*m_current)->isEvent() || !(*m_current)->isConfirmed())
+    // A rewind is done after a state in the past is inserted, so there
+    // is at least one RewindInfo
+    assert(m_num_rewind_info > 0);
+    m_current.m_ticks = m_last_ticks;
+    m_current.m_index = (unsigned int)getTick(m_last_ticks).size() - 1;
+    RewindInfo *ri = getRewindInfo(m_current);
+    while (ri->getTicks() > undo_ticks || ri->isEvent() || !ri->isConfirmed())
     {
         // Undo all events and states from the current time
-        (*m_current)->undo();
-        if(m_current == m_all_rewind_info.begin())
+        ri->undo();
+        if (!findPrevious(&m_current))
         {
             // This shouldn't happen, but add some debug info just in case
             Log::error("undoUntil",
                        "At %d rewinding to %d current = %d = begin",
                        World::getWorld()->getTicksSinceStart(), undo_ticks, 
-                       (*m_current)->getTicks());
+                       ri->getTicks());
+            break;
         }
-        m_current--;
+        ri = getRewindInfo(m_current);
     }
 
-    return (*m_current)->getTicks();
+    return ri->getTicks();
 }   // undoUntil
 
+// ----------------------------------------------------------------------------
+/** Sets the current pointer to the first RewindInfo at or after the
+ *  specified time, without undoing or replaying anything. This is used
+ *  instead of a rewind when the newly received states do not require one.
+ *  \param ticks The current world time.
+ */
+void RewindQueue::skipUntil(int ticks)
+{
+    m_current.m_ticks = NO_TICKS;
+    if (m_num_rewind_info == 0)
+        return;
+    for (int t = std::max(ticks, m_first_ticks); t <= m_last_ticks; t++)
+    {
+        if (!getTick(t).empty())
+        {
+            m_current.m_ticks = t;
+            m_current.m_index = 0;
+            return;
+        }
+    }
+}   // skipUntil
+
+// ----------------------------------------------------------------------------
+/** Returns the confirmed state at the specified time, or NULL if there is
+ *  none.
+ *  \param ticks Time of the state.
+ */
+RewindInfoState* RewindQueue::getConfirmedState(int ticks)
+{
+    if (m_num_rewind_info == 0 || ticks < m_first_ticks ||
+        ticks > m_last_ticks)
+        return NULL;
+    for (RewindInfo *ri : getTick(ticks))
+    {
+        if (ri->isState() && ri->isConfirmed())
+            return dynamic_cast<RewindInfoState*>(ri);
+    }
+    return NULL;
+}   // getConfirmedState
+
 // ----------------------------------------------------------------------------
 /** Replays all events (not states) that happened at the specified time.
  *  \param ticks Time in ticks.
@@ -397,15 +635,32 @@ int RewindQueue::undoUntil(int undo_ticks)
 void RewindQueue::replayAllEvents(int ticks)
 {
     // Replay all events that happened at the current time step
-    while ( hasMoreRewindInfo() && (*m_current)->getTicks() == ticks )
+    while (hasMoreRewindInfo() && m_current.m_ticks == ticks)
     {
-        if ((*m_current)->isEvent())
-            (*m_current)->replay();
-        m_current++;
+        RewindInfo *ri = getRewindInfo(m_current);
+        if (ri->isEvent())
+            ri->replay();
+        next();
     }   // while current->getTIcks == ticks
 
 }   // replayAllEvents
 
+// ----------------------------------------------------------------------------
+/** Returns all RewindInfos sorted by time, used in unit testing.
+ */
+std::vector<RewindInfo*> RewindQueue::getAllRewindInfo() const
+{
+    std::vector<RewindInfo*> all;
+    if (m_num_rewind_info == 0)
+        return all;
+    for (int ticks = m_first_ticks; ticks <= m_last_ticks; ticks++)
+    {
+        const TickRewindInfo &tri = getTick(ticks);
+        all.insert(all.end(), tri.begin(), tri.end());
+    }
+    return all;
+}   // getAllRewindInfo
+
 // ----------------------------------------------------------------------------
 /** Unit tests for RewindQueue. It tests:
  *  - Sorting order of RewindInfos at the same time (i.e. state before time
@@ -413,6 +668,9 @@ void RewindQueue::replayAllEvents(int ticks)
  *  - Sorting order of RewindInfos with different timestamps (and a mixture
  *    of types).
  *  - Special cases that triggered incorrect behaviour previously.
+ *  - The order and current RewindInfo after random operations, compared
+ *    with a sorted list (which is how RewindInfos were stored before the
+ *    ring buffer was used).
  */
 void RewindQueue::unitTesting()
 {
@@ -427,67 +685,61 @@ void RewindQueue::unitTesting()
     assert(!q0.hasMoreRewindInfo());
 
     q0.addLocalState(NULL, /*confirmed*/true, 0);
-    assert(q0.m_all_rewind_info.front()->isState());
-    assert(!q0.m_all_rewind_info.front()->isEvent());
+    assert(q0.getAllRewindInfo().front()->isState());
+    assert(!q0.getAllRewindInfo().front()->isEvent());
     assert(q0.hasMoreRewindInfo());
     assert(q0.undoUntil(0) == 0);
 
-    q0.addNetworkEvent(dummy_rewinder.get(), NULL, 0);
+    q0.addNetworkEvent(dummy_rewinder.get(), NULL, 0, 0);
     // Network events are not immediately merged
-    assert(q0.m_all_rewind_info.size() == 1);
+    assert(q0.getAllRewindInfo().size() == 1);
 
     bool needs_rewind;
     int rewind_ticks;
     int world_ticks = 0;
     q0.mergeNetworkData(world_ticks, &needs_rewind, &rewind_ticks);
     assert(q0.hasMoreRewindInfo());
-    assert(q0.m_all_rewind_info.size() == 2);
-    AllRewindInfo::iterator rii = q0.m_all_rewind_info.begin();
-    assert((*rii)->isState());
-    rii++;
-    assert((*rii)->isEvent());
+    std::vector<RewindInfo*> all = q0.getAllRewindInfo();
+    assert(all.size() == 2);
+    assert(all[0]->isState());
+    assert(all[1]->isEvent());
 
     // Another state must be sorted before the event:
     q0.addNetworkState(NULL, 0);
     assert(q0.hasMoreRewindInfo());
     q0.mergeNetworkData(world_ticks, &needs_rewind, &rewind_ticks);
-    assert(q0.m_all_rewind_info.size() == 3);
-    rii = q0.m_all_rewind_info.begin();
-    assert((*rii)->isState());
-    rii++;
-    assert((*rii)->isState());
-    rii++;
-    assert((*rii)->isEvent());
+    all = q0.getAllRewindInfo();
+    assert(all.size() == 3);
+    assert(all[0]->isState());
+    assert(all[1]->isState());
+    assert(all[2]->isEvent());
 
     // Test time base comparisons: adding an event to the end
-    q0.addLocalEvent(dummy_rewinder.get(), NULL, true, 4);
+    q0.addLocalEvent(dummy_rewinder.get(), NULL, 0, true, 4);
     // Then adding an earlier event
-    q0.addLocalEvent(dummy_rewinder.get(), NULL, false, 1);
-    // rii points to the 3rd element, the ones added just now
-    // should be elements4 and 5:
-    rii++;
-    assert((*rii)->getTicks()==1);
-    rii++;
-    assert((*rii)->getTicks()==4);
+    q0.addLocalEvent(dummy_rewinder.get(), NULL, 0, false, 1);
+    // The ones added just now should be elements 4 and 5:
+    all = q0.getAllRewindInfo();
+    assert(all[3]->getTicks()==1);
+    assert(all[4]->getTicks()==4);
 
     // Now test inserting an event first, then the state
     RewindQueue q1;
-    q1.addLocalEvent(NULL, NULL, true, 5);
+    q1.addLocalEvent(NULL, NULL, 0, true, 5);
     q1.addLocalState(NULL, true, 5);
-    rii = q1.m_all_rewind_info.begin();
-    assert((*rii)->isState());
-    rii++;
-    assert((*rii)->isEvent());
+    all = q1.getAllRewindInfo();
+    assert(all[0]->isState());
+    assert(all[1]->isEvent());
 
     // Bugs seen before
     // ----------------
     // 1) Current pointer was not reset from end of list when an event
     //    was added and the pointer was already at end of list
     RewindQueue b1;
-    b1.addLocalEvent(NULL, NULL, true, 1);
+    b1.addLocalEvent(NULL, NULL, 0, true, 1);
     b1.next();    // Should now point at end of list
     assert(!b1.hasMoreRewindInfo());
-    b1.addLocalEvent(NULL, NULL, true, 2);
+    b1.addLocalEvent(NULL, NULL, 0, true, 2);
     RewindInfo *ri = b1.getCurrent();
     if (ri->getTicks() != 2)
         Log::fatal("RewindQueue", "ri->getTicks() != 2");
@@ -496,11 +748,11 @@ void RewindQueue::unitTesting()
     //    event, that m_current pooints to the first event, otherwise
     //    events with same time stamp will not be handled correctly.
     //    At this stage current points to the event at time 2 from above
-    AllRewindInfo::iterator current_old = b1.m_current;
-    b1.addLocalEvent(NULL, NULL, true, 2);
+    RewindInfo *current_old = b1.getCurrent();
+    b1.addLocalEvent(NULL, NULL, 0, true, 2);
     // Make sure that current was not modified, i.e. the new event at time
     // 2 was added at the end of the list:
-    if (current_old != b1.m_current)
+    if (current_old != b1.getCurrent())
         Log::fatal("RewindQueue", "current_old != b1.m_current");
 
     // This should not trigger an exception, now current points to the
@@ -509,7 +761,7 @@ void RewindQueue::unitTesting()
     assert(ri->getTicks() == 2);
     assert(ri->isEvent());
     b1.next();
-    assert(b1.m_current == b1.m_all_rewind_info.end());
+    assert(!b1.hasMoreRewindInfo());
 
     // 3) Test that if cleanupOldRewindInfo is called, it will if necessary
     //    adjust m_current to point to the latest confirmed state.
@@ -518,7 +770,180 @@ void RewindQueue::unitTesting()
     b2.addNetworkState(NULL, 2);
     b2.addNetworkState(NULL, 3);
     b2.mergeNetworkData(4, &needs_rewind, &rewind_ticks);
-    assert((*b2.m_current)->getTicks() == 3);
+    assert(b2.getCurrent()->getTicks() == 3);
+
+    // 4) When a rewind is skipped, current must be moved to the first
+    //    RewindInfo at the world time, and states must be found by time.
+    b2.addLocalEvent(NULL, NULL, 0, true, 5);
+    assert(b2.getConfirmedState(3) != NULL);
+    assert(b2.getConfirmedState(4) == NULL);
+    b2.skipUntil(5);
+    assert(b2.getCurrent()->getTicks() == 5 && b2.getCurrent()->isEvent());
+
+    // Random operations compared with a sorted list
+    // ---------------------------------------------
+    // The time base moves forward, so the ring buffer wraps around, and
+    // RewindInfos are added up to 200 time steps apart, so it has to grow.
+    struct ListInfo
+    {
+        int  m_ticks;
+        bool m_is_event;
+        bool m_is_confirmed;
+        int  m_id;
+    };
+    std::list<ListInfo> list;
+    std::list<ListInfo>::iterator list_current = list.end();
+    std::vector<ListInfo> list_network_events;
+
+    auto list_insert = [&list, &list_current](const ListInfo &li)
+    {
+        std::list<ListInfo>::iterator i = list.end();
+        while (i != list.begin())
+        {
+            std::list<ListInfo>::iterator i_prev = i;
+            i_prev--;
+            if (i_prev->m_ticks < li.m_ticks) break;
+            if (i_prev->m_ticks == li.m_ticks && li.m_is_event) break;
+            i = i_prev;
+        }
+        if (list_current == list.end())
+            list_current = list.insert(i, li);
+        else
+            list.insert(i, li);
+    };
+    auto list_cleanup = [&list, &list_current](int ticks)
+    {
+        std::list<ListInfo>::iterator i = list.begin();
+        while (i != list.end() && i->m_ticks < ticks)
+        {
+            if (list_current == i) list_current++;
+            i = list.erase(i);
+        }
+    };
 
+    RandomGenerator random;
+    RewindQueue q;
+    int base = 0;
+    int id = 0;
+    for (int n = 0; n < 20000; n++)
+    {
+        base += random.get(3);
+        const int ticks = base + (random.get(10) == 0 ? random.get(200)
+                                                      : random.get(20));
+        const int op = random.get(100);
+        if (op < 30)
+        {
+            id++;
+            q.addLocalEvent(dummy_rewinder.get(), (const char*)&id,
+                            sizeof(id), /*confirmed*/true, ticks);
+            list_insert({ ticks, true, true, id });
+        }
+        else if (op < 45)
+        {
+            id++;
+            q.addNetworkEvent(dummy_rewinder.get(), (const char*)&id,
+                              sizeof(id), ticks);
+            list_network_events.push_back({ ticks, true, true, id });
+            const int world = base + 10;
+            q.mergeNetworkData(world, &needs_rewind, &rewind_ticks);
+            std::vector<ListInfo> future;
+            for (ListInfo li : list_network_events)
+            {
+                if (li.m_ticks > world)
+                {
+                    future.push_back(li);
+                    continue;
+                }
+                if (NetworkConfig::get()->isServer() && li.m_ticks < world)
+                    li.m_ticks = world;
+                list_insert(li);
+            }
+            list_network_events = future;
+            if (NetworkConfig::get()->isServer())
+                list_cleanup(world);
+        }
+        else if (op < 60)
+        {
+            const bool confirmed = random.get(3) == 0;
+            const bool cleanup = confirmed &&
+                                 q.getLatestConfirmedState() < ticks;
+            q.addLocalState(NULL, confirmed, ticks);
+            list_insert({ ticks, false, confirmed, 0 });
+            if (cleanup)
+                list_cleanup(ticks);
+        }
+        else if (op < 80)
+        {
+            if (q.hasMoreRewindInfo())
+                q.next();
+            if (list_current != list.end())
+                list_current++;
+        }
+        else if (op < 88)
+        {
+            if (q.hasMoreRewindInfo())
+            {
+                const int current_ticks = q.getCurrent()->getTicks();
+                q.replayAllEvents(current_ticks);
+                while (list_current != list.end() &&
+                       list_current->m_ticks == current_ticks)
+                    list_current++;
+            }
+        }
+        else if (op < 93)
+        {
+            q.cleanupOldRewindInfo(base - 5);
+            list_cleanup(base - 5);
+        }
+        else
+        {
+            // Only rewind if there is a confirmed state to rewind to
+            std::list<ListInfo>::iterator i = list.end();
+            while (i != list.begin())
+            {
+                i--;
+                if (i->m_ticks <= ticks && !i->m_is_event &&
+                    i->m_is_confirmed)
+                {
+                    if (q.undoUntil(ticks) != i->m_ticks)
+                        Log::fatal("RewindQueue", "Wrong rewind time");
+                    list_current = i;
+                    break;
+                }
+            }
+        }
 
+        all = q.getAllRewindInfo();
+        if (all.size() != list.size())
+            Log::fatal("RewindQueue", "Wrong number of RewindInfos");
+        unsigned int index = 0;
+        int list_current_index = -1;
+        for (std::list<ListInfo>::iterator i = list.begin(); i != list.end();
+             i++, index++)
+        {
+            if (i == list_current)
+                list_current_index = index;
+            RewindInfo *ri = all[index];
+            int ri_id = 0;
+            if (ri->isEvent())
+            {
+                memcpy(&ri_id,
+                       static_cast<RewindInfoEvent*>(ri)->getBuffer()
+                                                        ->getData(),
+                       sizeof(ri_id));
+            }
+            if (ri->getTicks() != i->m_ticks ||
+                ri->isEvent() != i->m_is_event ||
+                ri->isConfirmed() != i->m_is_confirmed || ri_id != i->m_id)
+                Log::fatal("RewindQueue", "Wrong RewindInfo at %d", index);
+        }
+        int current_index = -1;
+        if (q.hasMoreRewindInfo())
+        {
+            current_index = int(std::find(all.begin(), all.end(),
+                                          q.getCurrent()) - all.begin());
+        }
+        if (current_index != list_current_index)
+            Log::fatal("RewindQueue", "Wrong current RewindInfo");
+    }
 }   // unitTesting
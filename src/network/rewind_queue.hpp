@@ -22,12 +22,15 @@
 #include "utils/synchronised.hpp"
 
 #include <assert.h>
-#include <list>
+#include <deque>
+#include <limits>
 #include <vector>
 
 class BareNetworkString;
 class EventRewinder;
 class RewindInfo;
+class RewindInfoEvent;
+class RewindInfoState;
 class TimeStepInfo;
 
 /** \ingroup network
@@ -36,27 +39,110 @@ class TimeStepInfo;
 class RewindQueue
 {
 private:
+    /** All RewindInfos of one time step: first the states (the most
+     *  recently added state first), then the events in the order in which
+     *  they were added. */
+    typedef std::vector<RewindInfo*> TickRewindInfo;
+
+    /** A ring buffer with the RewindInfos of all time steps from
+     *  m_first_ticks to m_last_ticks. Time step t is stored at index
+     *  t & (m_ring.size()-1), the size is a power of 2 and increased when
+     *  necessary. The vectors keep their memory when they are reused for a
+     *  later time step. */
+    std::vector<TickRewindInfo> m_ring;
+
+    /** Oldest and newest time step with a RewindInfo. */
+    int m_first_ticks;
+    int m_last_ticks;
+
+    /** Number of all RewindInfos in m_ring. */
+    unsigned int m_num_rewind_info;
+
+    /** The position of a RewindInfo: its time step and the index in the
+     *  TickRewindInfo of this time step. */
+    struct Position
+    {
+        int          m_ticks;
+        unsigned int m_index;
+    };
+
+    /** Position of the current RewindInfo to be handled. m_ticks is
+     *  NO_TICKS if all RewindInfos have been handled. */
+    Position m_current;
 
-    typedef std::list<RewindInfo*> AllRewindInfo;
+    static const int NO_TICKS = std::numeric_limits<int>::max();
 
-    AllRewindInfo m_all_rewind_info;
+    /** All events are allocated in this container, which never moves its
+     *  elements. They are reused (see m_unused_events) instead of being
+     *  freed, so no memory is allocated for an event once enough events
+     *  exist. */
+    std::deque<RewindInfoEvent> m_event_slab;
 
-    /** The list of all events received from the network. They are stored
-     *  in a separate thread (so this data structure is thread-save), and
-     *  merged into m_rewind_info from the main thread. This design (as
-     *  opposed to locking m_rewind_info) reduces the synchronisation
-     *  between main thread and network thread. */
-    typedef std::vector<RewindInfo*> AllNetworkRewindInfo;
-    Synchronised<AllNetworkRewindInfo> m_network_events;
+    /** Events in m_event_slab that are not used. */
+    std::vector<RewindInfoEvent*> m_unused_events;
 
-    /** Iterator to the curren time step info to be handled. */
-    AllRewindInfo::iterator m_current;
+    /** An event received from the network, but not merged yet. */
+    struct NetworkEvent
+    {
+        EventRewinder *m_event_rewinder;
+        int            m_ticks;
+        /** Position and size of the event data in m_event_data. */
+        unsigned int   m_offset;
+        unsigned int   m_size;
+    };
+
+    /** All data received from the network. They are stored in a separate
+     *  thread (so this data structure is thread-save), and merged into
+     *  m_ring from the main thread. This design (as opposed to locking
+     *  m_ring) reduces the synchronisation between main thread and network
+     *  thread. Events are stored without any allocation for each event:
+     *  the data of all events is appended to m_event_data. */
+    struct NetworkData
+    {
+        /** States (and other RewindInfos) received. */
+        std::vector<RewindInfo*> m_rewind_info;
+        std::vector<NetworkEvent> m_events;
+        std::vector<char> m_event_data;
+    };
+    Synchronised<NetworkData> m_network_data;
 
     /** Time at which the latest confirmed state is at. */
     int m_latest_confirmed_state_time;
 
+    /** Time of the latest event that was received from the network for a
+     *  time before the client's world time (i.e. an event that was not
+     *  used when the client simulated that time), -1 if there is none
+     *  since the last call to clearPastEventTicks(). */
+    int m_latest_past_event_ticks;
 
     void cleanupOldRewindInfo(int ticks);
+    void makeRoom(int ticks);
+    bool findNext(Position *p) const;
+    bool findPrevious(Position *p) const;
+    RewindInfoEvent* createEvent(int ticks, EventRewinder *event_rewinder,
+                                 const char *data, int size,
+                                 bool confirmed);
+    void freeRewindInfo(RewindInfo *ri);
+    std::vector<RewindInfo*> getAllRewindInfo() const;
+
+    // ------------------------------------------------------------------------
+    /** Returns the RewindInfos of the specified time step, which must be
+     *  between m_first_ticks and m_last_ticks. */
+    TickRewindInfo& getTick(int ticks)
+    {
+        return m_ring[ticks & (m_ring.size() - 1)];
+    }   // getTick
+    // ------------------------------------------------------------------------
+    const TickRewindInfo& getTick(int ticks) const
+    {
+        return m_ring[ticks & (m_ring.size() - 1)];
+    }   // getTick
+    // ------------------------------------------------------------------------
+    /** Returns the RewindInfo at the specified position. */
+    RewindInfo* getRewindInfo(const Position &p) const
+    {
+        return getTick(p.m_ticks)[p.m_index];
+    }   // getRewindInfo
 
 public:
         static void unitTesting();
@@ -64,17 +150,17 @@ public:
          RewindQueue();
         ~RewindQueue();
     void reset();
-    void addLocalEvent(EventRewinder *event_rewinder, BareNetworkString *buffer,
-                       bool confirmed, int ticks);
+    void addLocalEvent(EventRewinder *event_rewinder, const char *data,
+                       int size, bool confirmed, int ticks);
     void addLocalState(BareNetworkString *buffer, bool confirmed, int ticks);
-    void addNetworkEvent(EventRewinder *event_rewinder,
-                         BareNetworkString *buffer, int ticks);
+    void addNetworkEvent(EventRewinder *event_rewinder, const char *data,
+                         int size, int ticks);
     void addNetworkState(BareNetworkString *buffer, int ticks);
     void addNetworkRewindInfo(RewindInfo* ri)
     {
-        m_network_events.lock();
-        m_network_events.getData().push_back(ri);
-        m_network_events.unlock();
+        m_network_data.lock();
+        m_network_data.getData().m_rewind_info.push_back(ri);
+        m_network_data.unlock();
     }
     void mergeNetworkData(int world_ticks,  bool *needs_rewind, 
                           int *rewind_ticks);
@@ -82,7 +168,17 @@ public:
     bool isEmpty() const;
     bool hasMoreRewindInfo() const;
     int  undoUntil(int undo_ticks);
+    void skipUntil(int ticks);
     void insertRewindInfo(RewindInfo *ri);
+    RewindInfoState* getConfirmedState(int ticks);
+
+    // ------------------------------------------------------------------------
+    /** Returns the time of the latest event received for a time step that
+     *  was already simulated (see m_latest_past_event_ticks). */
+    int getLatestPastEventTicks() const { return m_latest_past_event_ticks; }
+    // ------------------------------------------------------------------------
+    /** Called after a rewind, which replayed all past events. */
+    void clearPastEventTicks()             { m_latest_past_event_ticks = -1; }
 
     // ------------------------------------------------------------------------
     /** Returns the time of the latest confirmed state. */
@@ -91,25 +187,24 @@ public:
         return m_latest_confirmed_state_time;
     }
     // ------------------------------------------------------------------------
-    /** Sets the current element to be the next one and returns the next
-     *  RewindInfo element. */
+    /** Sets the current element to be the next one. */
     void next()
     {
-        assert(m_current != m_all_rewind_info.end());
-        m_current++;
-        return;
-    }   // operator++
+        assert(m_current.m_ticks != NO_TICKS);
+        if (!findNext(&m_current))
+            m_current.m_ticks = NO_TICKS;
+    }   // next
 
     // ------------------------------------------------------------------------
-    /** Returns the current RewindInfo. Caller must make sure that there is at
-     *  least one more RewindInfo (see hasMoreRewindInfo()). */
+    /** Returns the current RewindInfo, or NULL if all RewindInfos have
+     *  been handled (see hasMoreRewindInfo()). */
     RewindInfo* getCurrent()
     {
-        return (m_current != m_all_rewind_info.end() ) ? *m_current : NULL;
-    }   // getNext
+        return m_current.m_ticks != NO_TICKS ? getRewindInfo(m_current)
+                                             : NULL;
+    }   // getCurrent
 
 };   // RewindQueue
 
 
 #endif
-
@@ -156,8 +156,8 @@ Server::Server(const XMLNode& server_info) : m_supports_encrytion(true)
     }
 
     // Display server owner name if they're your friend or localhost
-    Online::OnlineProfile* opp =
-        PlayerManager::getCurrentPlayer()->getProfile();
+    Online::OnlineProfile* opp = PlayerManager::getCurrentPlayer() ?
+        PlayerManager::getCurrentPlayer()->getProfile() : NULL;
     // Check localhost owner
     if (opp && opp->getID() == m_server_owner)
     {
@@ -183,6 +183,17 @@ namespace ServerConfig
         "By default WAN server will always validate player and LAN will not, "
         "disable it to allow non-validated player in WAN."));
 
+    SERVER_CFG_PREFIX FloatServerConfigParam m_connection_rate
+        SERVER_CFG_DEFAULT(FloatServerConfigParam(1.0f, "connection-rate",
+        "Number of connection requests per second allowed from one IP address "
+        "(or IPv6 /64 network) on average, more are dropped or need to answer "
+        "a cookie first. Set it to 0 to disable the limit."));
+
+    SERVER_CFG_PREFIX IntServerConfigParam m_connection_burst
+        SERVER_CFG_DEFAULT(IntServerConfigParam(5, "connection-burst",
+        "Number of connection requests allowed at once from one IP address "
+        "(or IPv6 /64 network), before connection-rate applies."));
+
     SERVER_CFG_PREFIX BoolServerConfigParam m_firewalled_server
         SERVER_CFG_DEFAULT(BoolServerConfigParam(true, "firewalled-server",
         "Disable it to turn off all stun related code in server, "
@@ -273,6 +284,13 @@ namespace ServerConfig
         "will be made 1.0. If false addon karts will use their original "
         "hitbox other than tux, all players having it restriction applies."));
 
+    SERVER_CFG_PREFIX FloatServerConfigParam m_checkpoint_interval
+        SERVER_CFG_DEFAULT(FloatServerConfigParam(5.0f, "checkpoint-interval",
+        "Time in seconds between compressed checkpoints of the item state "
+        "of a game in progress, which is sent to players live joining (or "
+        "reconnecting) together with the item events since it. 0 disables "
+        "checkpoints, the current state is saved for each live join then."));
+
     SERVER_CFG_PREFIX BoolServerConfigParam m_real_addon_karts
         SERVER_CFG_DEFAULT(BoolServerConfigParam(true, "real-addon-karts",
         "If true, server will send its addon karts real physics (kart size, "
@@ -378,6 +396,24 @@ namespace ServerConfig
         "sqlite3_busy_handler. You may need a higher value if your database "
         "is shared by many servers or having a slow hard disk."));
 
+    SERVER_CFG_PREFIX BoolServerConfigParam m_database_wal
+        SERVER_CFG_DEFAULT(BoolServerConfigParam(false,
+        "database-wal",
+        "Use write-ahead logging for the database, which needs less disk "
+        "syncs and lets other programs read the database while a server "
+        "writes to it. All servers and programs using the database must "
+        "run on the same machine (not on a network file system)."));
+
+    SERVER_CFG_PREFIX IntServerConfigParam m_database_batch_time
+        SERVER_CFG_DEFAULT(IntServerConfigParam(500,
+        "database-batch-time",
+        "Specified in millisecond for how long writes to the database (player "
+        "stats, ban trigger counts, reports) are collected and then written "
+        "in one transaction, 0 to write each of them immediately. The "
+        "transaction is written earlier when no more writes come in. The "
+        "database is locked for writing meanwhile, so keep it lower than "
+        "database-timeout if your database is shared by many servers."));
+
     SERVER_CFG_PREFIX StringServerConfigParam m_ip_ban_table
         SERVER_CFG_DEFAULT(StringServerConfigParam("ip_ban",
         "ip-ban-table",
@@ -449,6 +485,23 @@ namespace ServerConfig
         "If true this server will allow AI instance to be connected from "
         "anywhere. (other than LAN network only)"));
 
+    SERVER_CFG_PREFIX IntServerConfigParam m_track_cache_size
+        SERVER_CFG_DEFAULT(IntServerConfigParam(256, "track-cache-size",
+        "Size in MB of the meshes of recently played tracks which a server "
+        "without graphics keeps loaded between races, so the next race on "
+        "one of these tracks starts faster. 0 disables the cache."));
+
+    SERVER_CFG_PREFIX StringServerConfigParam m_metrics_file
+        SERVER_CFG_DEFAULT(StringServerConfigParam("", "metrics-file",
+        "File to periodically write server metrics (tick duration, traffic "
+        "per peer, event latency, database query time, player counts...) "
+        "to, in the Prometheus text format, empty to disable. It can be read "
+        "by the textfile collector of node_exporter for example."));
+
+    SERVER_CFG_PREFIX FloatServerConfigParam m_metrics_interval
+        SERVER_CFG_DEFAULT(FloatServerConfigParam(5.0f, "metrics-interval",
+        "Time in seconds between two updates of the metrics file."));
+
     // ========================================================================
     /** Server version, will be advanced if there are protocol changes. */
     static const uint32_t m_server_version = 6;
@@ -0,0 +1,347 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/server_metrics.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
+
+#include <assert.h>
+#include <cstdio>
+#include <string.h>
+
+ServerMetrics ServerMetrics::m_server_metrics[PT_COUNT];
+
+const uint64_t ServerMetrics::m_bucket_bounds[BUCKET_COUNT] =
+{
+    10, 50, 100, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000,
+    250000, 500000, 1000000
+};
+
+namespace
+{
+    /** Name, label and help text of a metric. Consecutive metrics with the
+     *  same name are exported as one metric family. */
+    struct MetricInfo
+    {
+        const char *m_name;
+        const char *m_label;
+        const char *m_help;
+    };
+
+    const MetricInfo g_histograms[ServerMetrics::HT_COUNT] =
+    {
+        { "stk_server_tick_duration_seconds", "",
+          "Time to update the protocols and the world for one time step." },
+        { "stk_crypto_duration_seconds", "op=\"encrypt\"",
+          "Time to encrypt or decrypt a packet." },
+        { "stk_crypto_duration_seconds", "op=\"decrypt\"", "" },
+        { "stk_protocol_event_latency_seconds", "queue=\"sync\"",
+          "Time from receiving an event till it is handled by a protocol." },
+        { "stk_protocol_event_latency_seconds", "queue=\"async\"", "" },
+        { "stk_sql_query_duration_seconds", "",
+          "Time to execute a database query." },
+    };
+
+    const MetricInfo g_gauges[ServerMetrics::GT_COUNT] =
+    {
+        { "stk_rewind_state_size_bytes", "",
+          "Size of the last saved state of all rewinders." },
+        { "stk_protocol_event_queue_depth", "queue=\"sync\"",
+          "Number of events not yet handled by the protocols." },
+        { "stk_protocol_event_queue_depth", "queue=\"async\"", "" },
+        { "stk_players", "state=\"in_game\"",
+          "Number of players on the server." },
+        { "stk_players", "state=\"waiting\"", "" },
+        { "stk_players", "state=\"total\"", "" },
+        { "stk_track_cache_loads", "result=\"hit\"",
+          "Number of tracks loaded with (or without) their meshes cached." },
+        { "stk_track_cache_loads", "result=\"miss\"", "" },
+        { "stk_track_cache_size_bytes", "",
+          "Size of the track meshes kept loaded between races." },
+    };
+
+    const char *g_channel_names[EVENT_CHANNEL_COUNT] =
+    {
+        "normal", "unencrypted", "data_transfer"
+    };
+
+    // ------------------------------------------------------------------------
+    void addHeader(const char *name, const char *help, const char *type,
+                   std::string *text)
+    {
+        *text += "# HELP ";
+        *text += name;
+        *text += " ";
+        *text += help;
+        *text += "\n# TYPE ";
+        *text += name;
+        *text += " ";
+        *text += type;
+        *text += "\n";
+    }   // addHeader
+
+    // ------------------------------------------------------------------------
+    /** Adds one sample, the labels are combined from two (possibly empty)
+     *  lists. */
+    void addSample(const std::string &name, const std::string &label1,
+                   const std::string &label2, const std::string &value,
+                   std::string *text)
+    {
+        *text += name;
+        if (!label1.empty() || !label2.empty())
+        {
+            *text += "{";
+            *text += label1;
+            if (!label1.empty() && !label2.empty())
+                *text += ",";
+            *text += label2;
+            *text += "}";
+        }
+        *text += " ";
+        *text += value;
+        *text += "\n";
+    }   // addSample
+
+    // ------------------------------------------------------------------------
+    std::string microsecondsToSeconds(uint64_t microseconds)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.6f", microseconds / 1000000.0);
+        return buffer;
+    }   // microsecondsToSeconds
+
+}   // namespace
+
+// ----------------------------------------------------------------------------
+ServerMetrics::ServerMetrics()
+{
+    m_enabled.store(false);
+    reset();
+}   // ServerMetrics
+
+// ----------------------------------------------------------------------------
+void ServerMetrics::reset()
+{
+    for (unsigned int i = 0; i < HT_COUNT; i++)
+    {
+        for (unsigned int j = 0; j <= BUCKET_COUNT; j++)
+            m_buckets[i][j].store(0);
+        m_sum[i].store(0);
+    }
+    for (unsigned int i = 0; i < GT_COUNT; i++)
+        m_gauges[i].store(0);
+}   // reset
+
+// ----------------------------------------------------------------------------
+/** Enables or disables the metrics of the current process. Enabling resets
+ *  all values, since they belong to a new server.
+ */
+void ServerMetrics::enable(bool enabled)
+{
+    ServerMetrics *sm = &m_server_metrics[STKProcess::getType()];
+    if (enabled)
+        sm->reset();
+    sm->m_enabled.store(enabled);
+}   // enable
+
+// ----------------------------------------------------------------------------
+/** Adds a value to a histogram. */
+void ServerMetrics::observe(HistogramType type, uint64_t microseconds)
+{
+    unsigned int bucket = 0;
+    while (bucket < BUCKET_COUNT && microseconds > m_bucket_bounds[bucket])
+        bucket++;
+    m_buckets[type][bucket].fetch_add(1, std::memory_order_relaxed);
+    m_sum[type].fetch_add(microseconds, std::memory_order_relaxed);
+}   // observe
+
+// ----------------------------------------------------------------------------
+/** Returns all metrics in the Prometheus text exposition format.
+ *  \param peers The traffic of all connected peers.
+ */
+std::string ServerMetrics::getText(const std::vector<PeerTraffic> &peers)
+                                                                         const
+{
+    std::string text;
+    const char *last_name = "";
+    for (unsigned int i = 0; i < HT_COUNT; i++)
+    {
+        const MetricInfo &info = g_histograms[i];
+        if (strcmp(info.m_name, last_name) != 0)
+            addHeader(info.m_name, info.m_help, "histogram", &text);
+        last_name = info.m_name;
+
+        const std::string name = info.m_name;
+        uint64_t count = 0;
+        for (unsigned int j = 0; j <= BUCKET_COUNT; j++)
+        {
+            count += m_buckets[i][j].load(std::memory_order_relaxed);
+            const std::string le = j < BUCKET_COUNT
+                                 ? microsecondsToSeconds(m_bucket_bounds[j])
+                                 : "+Inf";
+            addSample(name + "_bucket", info.m_label, "le=\"" + le + "\"",
+                      std::to_string(count), &text);
+        }
+        addSample(name + "_sum", info.m_label, "",
+            microsecondsToSeconds(m_sum[i].load(std::memory_order_relaxed)),
+            &text);
+        addSample(name + "_count", info.m_label, "", std::to_string(count),
+                  &text);
+    }
+
+    last_name = "";
+    for (unsigned int i = 0; i < GT_COUNT; i++)
+    {
+        const MetricInfo &info = g_gauges[i];
+        if (strcmp(info.m_name, last_name) != 0)
+            addHeader(info.m_name, info.m_help, "gauge", &text);
+        last_name = info.m_name;
+        addSample(info.m_name, info.m_label, "",
+            std::to_string(m_gauges[i].load(std::memory_order_relaxed)),
+            &text);
+    }
+
+    addHeader("stk_peers", "Number of connected peers.", "gauge", &text);
+    addSample("stk_peers", "", "", std::to_string(peers.size()), &text);
+
+    struct PeerCounter
+    {
+        const char *m_name;
+        const char *m_help;
+        std::array<uint64_t, EVENT_CHANNEL_COUNT> PeerTraffic::*m_values;
+    };
+    const PeerCounter counters[] =
+    {
+        { "stk_peer_sent_bytes_total", "Bytes sent to a peer.",
+          &PeerTraffic::m_sent_bytes },
+        { "stk_peer_sent_packets_total", "Packets sent to a peer.",
+          &PeerTraffic::m_sent_packets },
+        { "stk_peer_received_bytes_total", "Bytes received from a peer.",
+          &PeerTraffic::m_received_bytes },
+        { "stk_peer_received_packets_total", "Packets received from a peer.",
+          &PeerTraffic::m_received_packets },
+    };
+    for (const PeerCounter &counter : counters)
+    {
+        if (peers.empty())
+            break;
+        addHeader(counter.m_name, counter.m_help, "counter", &text);
+        for (const PeerTraffic &peer : peers)
+        {
+            const std::string peer_label = "peer=\"" +
+                std::to_string(peer.m_host_id) + "\",address=\"" +
+                peer.m_address + "\"";
+            for (unsigned int c = 0; c < EVENT_CHANNEL_COUNT; c++)
+            {
+                addSample(counter.m_name, peer_label,
+                    std::string("channel=\"") + g_channel_names[c] + "\"",
+                    std::to_string((peer.*counter.m_values)[c]), &text);
+            }
+        }
+    }
+    return text;
+}   // getText
+
+// ----------------------------------------------------------------------------
+/** Writes the metrics to a file. A temporary file is written first and then
+ *  renamed, so a scraper never reads a partially written file.
+ *  \return True if the file was written.
+ */
+bool ServerMetrics::writeFile(const std::string &filename,
+                              const std::string &text)
+{
+    const std::string tmp_name = filename + ".tmp";
+    FILE *fp = FileUtils::fopenU8Path(tmp_name, "wb");
+    if (!fp)
+    {
+        Log::warn("ServerMetrics", "Can't open '%s'.", tmp_name.c_str());
+        return false;
+    }
+    bool ok = fwrite(text.data(), 1, text.size(), fp) == text.size();
+    ok &= fclose(fp) == 0;
+    if (ok)
+    {
+#if defined(WIN32)
+        // rename() can't replace an existing file on windows
+        remove(filename.c_str());
+#endif
+        ok = FileUtils::renameU8Path(tmp_name, filename) == 0;
+    }
+    if (!ok)
+    {
+        Log::warn("ServerMetrics", "Failed to write '%s'.", filename.c_str());
+        remove(tmp_name.c_str());
+    }
+    return ok;
+}   // writeFile
+
+// ----------------------------------------------------------------------------
+void ServerMetrics::unitTesting()
+{
+    ServerMetrics sm;
+    sm.observe(HT_TICK_DURATION, 0);
+    sm.observe(HT_TICK_DURATION, 10);
+    sm.observe(HT_TICK_DURATION, 11);
+    sm.observe(HT_TICK_DURATION, 2000000);
+    sm.observe(HT_SQL_QUERY, 700);
+    sm.setGauge(GT_STATE_SIZE, 1234);
+    sm.setGauge(GT_TOTAL_PLAYERS, 3);
+
+    PeerTraffic peer;
+    peer.m_host_id = 7;
+    peer.m_address = "127.0.0.1:2759";
+    peer.m_sent_bytes = {{ 100, 20, 0 }};
+    peer.m_sent_packets = {{ 2, 1, 0 }};
+    peer.m_received_bytes = {{ 50, 0, 0 }};
+    peer.m_received_packets = {{ 1, 0, 0 }};
+    const std::string text = sm.getText({ peer });
+
+    const char *expected[] =
+    {
+        "# TYPE stk_server_tick_duration_seconds histogram\n",
+        "stk_server_tick_duration_seconds_bucket{le=\"0.000010\"} 2\n",
+        "stk_server_tick_duration_seconds_bucket{le=\"0.000050\"} 3\n",
+        "stk_server_tick_duration_seconds_bucket{le=\"1.000000\"} 3\n",
+        "stk_server_tick_duration_seconds_bucket{le=\"+Inf\"} 4\n",
+        "stk_server_tick_duration_seconds_sum 2.000021\n",
+        "stk_server_tick_duration_seconds_count 4\n",
+        "stk_crypto_duration_seconds_count{op=\"encrypt\"} 0\n",
+        "stk_sql_query_duration_seconds_bucket{le=\"0.000500\"} 0\n",
+        "stk_sql_query_duration_seconds_bucket{le=\"0.001000\"} 1\n",
+        "stk_rewind_state_size_bytes 1234\n",
+        "stk_players{state=\"total\"} 3\n",
+        "stk_peers 1\n",
+        "stk_peer_sent_bytes_total{peer=\"7\",address=\"127.0.0.1:2759\","
+        "channel=\"normal\"} 100\n",
+        "stk_peer_sent_packets_total{peer=\"7\",address=\"127.0.0.1:2759\","
+        "channel=\"unencrypted\"} 1\n",
+        "stk_peer_received_bytes_total{peer=\"7\",address=\"127.0.0.1:2759\","
+        "channel=\"data_transfer\"} 0\n",
+    };
+    for (const char *line : expected)
+    {
+        assert(text.find(line) != std::string::npos);
+        if (text.find(line) == std::string::npos)
+            Log::error("ServerMetrics", "Missing line: %s", line);
+    }
+
+    // Each metric family must only have one HELP and TYPE line
+    const std::string type = "# TYPE stk_crypto_duration_seconds";
+    assert(text.find(type) != std::string::npos);
+    assert(text.find(type, text.find(type) + 1) == std::string::npos);
+}   // unitTesting
@@ -0,0 +1,164 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_SERVER_METRICS_HPP
+#define HEADER_SERVER_METRICS_HPP
+
+#include "network/event.hpp"
+#include "utils/no_copy.hpp"
+#include "utils/stk_process.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/** \ingroup network
+ *  Collects telemetry of a server (time step duration, encryption time,
+ *  protocol event latency, database query time, state size, queue depths
+ *  and player counts) and exports it in the Prometheus text format, so any
+ *  scraper can read it without STK specific code.
+ *  The values are recorded from different threads, so all of them are
+ *  atomics, and recording costs a few relaxed atomic additions. The
+ *  network traffic per peer and channel is counted in STKPeer, and passed
+ *  in when the text is created.
+ *  There is one object per process type (so a server running in a child
+ *  process of a client does not mix its values with the client), which is
+ *  never destroyed. get() only returns it while it is enabled, i.e. while
+ *  a server with a metrics file set in the server config is running.
+ */
+class ServerMetrics : public NoCopy
+{
+public:
+    /** The histograms, several of them can share a metric name and differ
+     *  in a label only. */
+    enum HistogramType
+    {
+        HT_TICK_DURATION,
+        HT_ENCRYPTION,
+        HT_DECRYPTION,
+        HT_SYNC_EVENT_LATENCY,
+        HT_ASYNC_EVENT_LATENCY,
+        HT_SQL_QUERY,
+        HT_COUNT
+    };
+
+    enum GaugeType
+    {
+        GT_STATE_SIZE,
+        GT_SYNC_EVENT_QUEUE,
+        GT_ASYNC_EVENT_QUEUE,
+        GT_PLAYERS_IN_GAME,
+        GT_PLAYERS_WAITING,
+        GT_TOTAL_PLAYERS,
+        GT_TRACK_CACHE_HITS,
+        GT_TRACK_CACHE_MISSES,
+        GT_TRACK_CACHE_SIZE,
+        GT_COUNT
+    };
+
+    /** A snapshot of the traffic of one peer. */
+    struct PeerTraffic
+    {
+        uint32_t m_host_id;
+        std::string m_address;
+        std::array<uint64_t, EVENT_CHANNEL_COUNT> m_sent_bytes;
+        std::array<uint64_t, EVENT_CHANNEL_COUNT> m_sent_packets;
+        std::array<uint64_t, EVENT_CHANNEL_COUNT> m_received_bytes;
+        std::array<uint64_t, EVENT_CHANNEL_COUNT> m_received_packets;
+    };
+
+    /** Measures the time from its creation till it goes out of scope and
+     *  adds it to a histogram. It does nothing if the metrics are not
+     *  enabled when it is created. */
+    class ScopedTimer : public NoCopy
+    {
+    private:
+        ServerMetrics *m_metrics;
+        HistogramType m_type;
+        std::chrono::steady_clock::time_point m_start;
+    public:
+        ScopedTimer(HistogramType type) : m_metrics(get()), m_type(type)
+        {
+            if (m_metrics)
+                m_start = std::chrono::steady_clock::now();
+        }   // ScopedTimer
+        // --------------------------------------------------------------------
+        ~ScopedTimer()
+        {
+            if (!m_metrics)
+                return;
+            auto d = std::chrono::steady_clock::now() - m_start;
+            m_metrics->observe(m_type, (uint64_t)std::chrono::duration_cast
+                <std::chrono::microseconds>(d).count());
+        }   // ~ScopedTimer
+    };   // ScopedTimer
+
+private:
+    /** Number of histogram buckets, not including the +Inf bucket. */
+    static const unsigned int BUCKET_COUNT = 14;
+
+    /** Upper bounds of the buckets in microseconds. */
+    static const uint64_t m_bucket_bounds[BUCKET_COUNT];
+
+    static ServerMetrics m_server_metrics[PT_COUNT];
+
+    std::atomic_bool m_enabled;
+
+    /** Number of values in each bucket (not cumulative), the last one
+     *  counts the values above all bounds. */
+    std::atomic<uint64_t> m_buckets[HT_COUNT][BUCKET_COUNT + 1];
+
+    /** Sum of all values of each histogram in microseconds. */
+    std::atomic<uint64_t> m_sum[HT_COUNT];
+
+    std::atomic<int64_t> m_gauges[GT_COUNT];
+
+    // ------------------------------------------------------------------------
+    ServerMetrics();
+    // ------------------------------------------------------------------------
+    void reset();
+
+public:
+    static void unitTesting();
+    // ------------------------------------------------------------------------
+    static void enable(bool enabled);
+    // ------------------------------------------------------------------------
+    /** Returns the metrics of the current process, or NULL if they are not
+     *  enabled. */
+    static ServerMetrics *get()
+    {
+        ServerMetrics *sm = &m_server_metrics[STKProcess::getType()];
+        return sm->m_enabled.load(std::memory_order_relaxed) ? sm : NULL;
+    }   // get
+    // ------------------------------------------------------------------------
+    void observe(HistogramType type, uint64_t microseconds);
+    // ------------------------------------------------------------------------
+    void setGauge(GaugeType type, int64_t value)
+    {
+        m_gauges[type].store(value, std::memory_order_relaxed);
+    }   // setGauge
+    // ------------------------------------------------------------------------
+    std::string getText(const std::vector<PeerTraffic> &peers) const;
+    // ------------------------------------------------------------------------
+    static bool writeFile(const std::string &filename,
+                          const std::string &text);
+};   // ServerMetrics
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "config/stk_config.hpp"
 #include "config/user_config.hpp"
+#include "io/file_manager.hpp"
 #include "io/xml_node.hpp"
 #include "network/network.hpp"
 #include "network/network_config.hpp"
@@ -30,6 +31,7 @@
 #include "network/stk_ipv6.hpp"
 #include "online/xml_request.hpp"
 #include "online/request_manager.hpp"
+#include "utils/string_utils.hpp"
 #include "utils/translation.hpp"
 #include "utils/time.hpp"
 
@@ -62,6 +64,7 @@ extern "C" {
 }
 #endif
 #  include <net/if.h>
+#  include <unistd.h>
 #endif
 
 static ServersManager* g_manager_singleton(NULL);
@@ -85,6 +88,7 @@ void ServersManager::deallocate()
 // ----------------------------------------------------------------------------
 ServersManager::ServersManager()
 {
+    m_wan_cache = std::make_shared<WANServerCache>();
 }   // ServersManager
 
 // ----------------------------------------------------------------------------
@@ -92,34 +96,59 @@ ServersManager::~ServersManager()
 {
 }   // ~ServersManager
 
-// ----------------------------------------------------------------------------
-/** Returns a WAN update-list-of-servers request. It queries the
- *  STK server for an up-to-date list of servers.
+// ============================================================================
+/** A request that downloads the list of WAN servers, and fills a ServerList
+ *  when it is finished. The ETag of the last list is sent, and if the list
+ *  did not change (response 304 or the same content), it is not parsed
+ *  again. The list is parsed in the request thread.
  */
-std::shared_ptr<ServerList> ServersManager::getWANRefreshRequest() const
+class WANRefreshRequest : public Online::XMLRequest
 {
-    // ========================================================================
-    /** A small local class that triggers an update of the ServersManager
-     *  when the request is finished. */
-    class WANRefreshRequest : public Online::XMLRequest
+private:
+    std::weak_ptr<ServerList> m_server_list;
+    std::shared_ptr<WANServerCache> m_cache;
+    // Run the ip detect in separate thread, so it can be done parallel
+    // with the wan server request (which takes few seconds too)
+    uint64_t m_creation_time;
+    /** False if no ip detection is done (used in the unit test). */
+    bool m_detect_ip;
+public:
+    WANRefreshRequest(std::shared_ptr<ServerList> server_list,
+                      std::shared_ptr<WANServerCache> cache,
+                      bool detect_ip = true)
+    : Online::XMLRequest(/*priority*/100)
     {
-    private:
-        std::weak_ptr<ServerList> m_server_list;
-        // Run the ip detect in separate thread, so it can be done parallel
-        // with the wan server request (which takes few seconds too)
-        uint64_t m_creation_time;
-    public:
-        WANRefreshRequest(std::shared_ptr<ServerList> server_list)
-        : Online::XMLRequest(/*priority*/100)
-        {
+        m_detect_ip = detect_ip;
+        if (m_detect_ip)
             NetworkConfig::queueIPDetection();
-            m_creation_time = StkTime::getMonoTimeMs();
-            m_server_list = server_list;
+        m_creation_time = StkTime::getMonoTimeMs();
+        m_server_list = server_list;
+        m_cache = cache;
+        std::lock_guard<std::mutex> lock(m_cache->m_mutex);
+        if (!m_cache->m_etag.empty())
+            addHeader("If-None-Match: " + m_cache->m_etag);
+    }
+    // ------------------------------------------------------------------------
+    virtual void afterOperation() OVERRIDE
+    {
+        const size_t hash = std::hash<std::string>()(getData());
+        bool unchanged = false;
+        if (!hadDownloadError())
+        {
+            std::lock_guard<std::mutex> lock(m_cache->m_mutex);
+            unchanged = m_cache->m_xml &&
+                ((getResponseCode() == 304 && !m_cache->m_etag.empty()) ||
+                hash == m_cache->m_hash);
         }
-        // --------------------------------------------------------------------
-        virtual void afterOperation() OVERRIDE
+        if (unchanged)
         {
+            m_success = true;
+            Online::HTTPRequest::afterOperation();
+        }
+        else
             Online::XMLRequest::afterOperation();
+        if (m_detect_ip)
+        {
             // Wait at most 2 seconds for ip detection
             uint64_t timeout = StkTime::getMonoTimeMs() - m_creation_time;
             if (timeout > 2000)
@@ -127,56 +156,147 @@ std::shared_ptr<ServerList> ServersManager::getWANRefreshRequest() const
             else
                 timeout = 2000 - timeout;
             NetworkConfig::get()->getIPDetectionResult(timeout);
-            auto server_list = m_server_list.lock();
-            if (!server_list)
-                return;
-
-            if (!isSuccess())
-            {
-                Log::error("ServersManager", "Could not refresh server list");
-                server_list->m_list_updated = true;
-                return;
-            }
+        }
+        auto server_list = m_server_list.lock();
+        if (!server_list)
+            return;
 
-            const XMLNode *servers_xml = getXMLData()->getNode("servers");
-            for (unsigned int i = 0; i < servers_xml->getNumNodes(); i++)
-            {
-                const XMLNode* s = servers_xml->getNode(i);
-                assert(s);
-                const XMLNode* si = s->getNode("server-info");
-                assert(si);
-                int version = 0;
-                si->get("version", &version);
-                assert(version != 0);
-                if (version < stk_config->m_max_server_version ||
-                    version > stk_config->m_max_server_version)
-                {
-                    Log::verbose("ServersManager", "Skipping a server");
-                    continue;
-                }
-                std::shared_ptr<Server> ser = std::make_shared<Server>(*s);
-                if (ser->getAddress().isUnset() &&
-                    NetworkConfig::get()->getIPType() == NetworkConfig::IP_V4)
-                {
-                    Log::verbose("ServersManager",
-                        "Skipping an IPv6 only server");
-                    continue;
-                }
-                server_list->m_servers.emplace_back(ser);
-            }
+        if (!isSuccess())
+        {
+            Log::error("ServersManager", "Could not refresh server list");
             server_list->m_list_updated = true;
-        }   // afterOperation
-        // --------------------------------------------------------------------
-    };   // RefreshRequest
-    // ========================================================================
+            return;
+        }
+
+        if (unchanged)
+        {
+            Log::verbose("ServersManager", "Server list is unchanged.");
+            ServersManager::updateWANServers(NULL, m_cache.get(),
+                                             &server_list->m_servers);
+        }
+        else
+        {
+            ServersManager::updateWANServers(releaseXMLData(), m_cache.get(),
+                                             &server_list->m_servers);
+            std::lock_guard<std::mutex> lock(m_cache->m_mutex);
+            m_cache->m_etag = getResponseHeader("ETag");
+            m_cache->m_hash = hash;
+        }
+        server_list->m_list_updated = true;
+    }   // afterOperation
+};   // WANRefreshRequest
+
+// ============================================================================
+WANServerCache::WANServerCache()
+{
+    m_hash = 0;
+}   // WANServerCache
+
+// ----------------------------------------------------------------------------
+WANServerCache::~WANServerCache()
+{
+}   // ~WANServerCache
 
+// ============================================================================
+/** Returns a WAN update-list-of-servers request. It queries the
+ *  STK server for an up-to-date list of servers, see WANRefreshRequest.
+ */
+std::shared_ptr<ServerList> ServersManager::getWANRefreshRequest() const
+{
     auto server_list = std::make_shared<ServerList>();
-    auto request = std::make_shared<WANRefreshRequest>(server_list);
+    auto request = std::make_shared<WANRefreshRequest>(server_list,
+                                                       m_wan_cache);
     request->setApiURL(Online::API::SERVER_PATH, "get-all");
     Online::RequestManager::get()->addRequest(request);
     return server_list;
 }   // getWANRefreshRequest
 
+// ----------------------------------------------------------------------------
+/** Updates the cached WAN server list, and adds the servers that can be used
+ *  to a list. The Server objects are created again on each call: they store
+ *  state of the current player (owner names, bookmarks) and of connection
+ *  attempts, so they can not be shared between refreshes.
+ *  \param xml The downloaded list, this function takes its ownership. NULL
+ *         if the list did not change since the last call.
+ *  \param cache The last list.
+ *  \param out The list to add the servers to.
+ */
+void ServersManager::updateWANServers(XMLNode* xml, WANServerCache* cache,
+                                      std::vector<std::shared_ptr<Server> >* out)
+{
+    std::lock_guard<std::mutex> lock(cache->m_mutex);
+    if (xml)
+    {
+        cache->m_xml.reset(xml);
+        std::set<size_t> old_hashes;
+        std::set<uint32_t> old_ids, new_ids;
+        for (auto& s : cache->m_servers)
+        {
+            old_hashes.insert(s.first);
+            old_ids.insert(s.second);
+        }
+        cache->m_servers.clear();
+        const XMLNode* servers_xml = xml->getNode("servers");
+        assert(servers_xml);
+        int added = 0, changed = 0, unchanged = 0;
+        for (unsigned int i = 0; i < servers_xml->getNumNodes(); i++)
+        {
+            const XMLNode* s = servers_xml->getNode(i);
+            assert(s);
+            const XMLNode* si = s->getNode("server-info");
+            assert(si);
+            uint32_t id = 0;
+            si->get("id", &id);
+            const size_t hash = s->getHash();
+            cache->m_servers.emplace_back(hash, id);
+            new_ids.insert(id);
+            if (old_hashes.find(hash) != old_hashes.end())
+                unchanged++;
+            else if (old_ids.find(id) != old_ids.end())
+                changed++;
+            else
+                added++;
+        }
+        int removed = 0;
+        for (uint32_t id : old_ids)
+        {
+            if (new_ids.find(id) == new_ids.end())
+                removed++;
+        }
+        Log::verbose("ServersManager", "Server list: %d added, %d changed, "
+            "%d removed, %d unchanged.", added, changed, removed, unchanged);
+    }
+    if (!cache->m_xml)
+        return;
+
+    const XMLNode* servers_xml = cache->m_xml->getNode("servers");
+    assert(servers_xml);
+    for (unsigned int i = 0; i < servers_xml->getNumNodes(); i++)
+    {
+        const XMLNode* s = servers_xml->getNode(i);
+        assert(s);
+        const XMLNode* si = s->getNode("server-info");
+        assert(si);
+        int version = 0;
+        si->get("version", &version);
+        assert(version != 0);
+        if (version < stk_config->m_max_server_version ||
+            version > stk_config->m_max_server_version)
+        {
+            Log::verbose("ServersManager", "Skipping a server");
+            continue;
+        }
+        std::shared_ptr<Server> ser = std::make_shared<Server>(*s);
+        if (ser->getAddress().isUnset() &&
+            NetworkConfig::get()->getIPType() == NetworkConfig::IP_V4)
+        {
+            Log::verbose("ServersManager", "Skipping an IPv6 only server");
+            continue;
+        }
+        out->push_back(ser);
+    }
+}   // updateWANServers
+
 // ----------------------------------------------------------------------------
 /** Returns a LAN update-list-of-servers request. It uses UDP broadcasts
  *  to find LAN servers, and waits for a certain amount of time fr 
@@ -251,10 +371,14 @@ std::shared_ptr<ServerList> ServersManager::getLANRefreshRequest() const
 
             const int LEN=2048;
             char buffer[LEN];
-            // Wait for up to 0.5 seconds to receive an answer from 
-            // any local servers.
+            // Wait for up to 1 second to receive an answer from any local
+            // servers. All broadcasts are sent already, so the servers
+            // answer at about the same time: stop early if no new answer
+            // arrived for a short time after the first one.
             uint64_t start_time = StkTime::getMonoTimeMs();
             const uint64_t DURATION = 1000;
+            const uint64_t QUIET_DURATION = 250;
+            uint64_t last_answer_time = 0;
             int cur_server_id = 0;
             // Use a map with the server name as key to automatically remove
             // duplicated answers from a server (since we potentially do
@@ -264,6 +388,10 @@ std::shared_ptr<ServerList> ServersManager::getLANRefreshRequest() const
             std::map<irr::core::stringw, std::shared_ptr<Server> > servers_now;
             while (StkTime::getMonoTimeMs() - start_time < DURATION)
             {
+                if (last_answer_time > 0 &&
+                    StkTime::getMonoTimeMs() - last_answer_time >
+                    QUIET_DURATION)
+                    break;
                 SocketAddress sender;
                 int len = broadcast->receiveRawPacket(buffer, LEN, &sender, 1);
                 if (len > 0)
@@ -305,7 +433,9 @@ std::shared_ptr<ServerList> ServersManager::getLANRefreshRequest() const
                         server->setIPV6Address(sender);
                         server->setIPV6Connection(true);
                     }
-                    servers_now.insert(std::make_pair(name, server));
+                    if (servers_now.insert(std::make_pair(name, server))
+                        .second)
+                        last_answer_time = StkTime::getMonoTimeMs();
                     //all_servers.[name] = servers_now.back();
                 }   // if received_data
             }    // while still waiting
@@ -562,3 +692,141 @@ std::vector<SocketAddress> ServersManager::getBroadcastAddresses(bool ipv6)
     }
     return result;
 }   // getBroadcastAddresses
+
+// ----------------------------------------------------------------------------
+/** Tests the WAN refresh requests with a local HTTP stand-in, which answers
+ *  with recorded server lists (and a 304 response if the client sent the
+ *  ETag of the current list).
+ */
+void ServersManager::unitTesting()
+{
+    const std::string version =
+        StringUtils::toString(stk_config->m_max_server_version);
+    auto server_xml = [version](int id, const std::string& name, int players,
+                                const std::string& ver)->std::string
+    {
+        std::string xml = "<server><server-info id=\"" +
+            StringUtils::toString(id) + "\" name=\"" + name +
+            "\" ip=\"2130706433\" port=\"2759\" ipv6=\"::1\" version=\"" +
+            (ver.empty() ? version : ver) +
+            "\" max_players=\"8\" current_players=\"" +
+            StringUtils::toString(players) + "\" game_mode=\"3\"/><players>";
+        for (int i = 0; i < players; i++)
+        {
+            xml += "<player-info username=\"player" +
+                StringUtils::toString(i) + "\"/>";
+        }
+        return xml + "</players></server>";
+    };
+    auto response = [](const std::string& etag,
+                       const std::string& servers)->std::string
+    {
+        std::string body = servers.empty() ? "" :
+            "<?xml version=\"1.0\"?><server-list success=\"yes\"><servers>" +
+            servers + "</servers></server-list>";
+        return std::string(body.empty() ? "HTTP/1.1 304 Not Modified\r\n" :
+            "HTTP/1.1 200 OK\r\n") + "ETag: " + etag + "\r\n" +
+            "Content-Length: " + StringUtils::toString(body.size()) +
+            "\r\nConnection: close\r\n\r\n" + body;
+    };
+    std::vector<std::string> responses =
+    {
+        response("\"list-1\"", server_xml(1, "A", 0, "") +
+            server_xml(2, "B", 1, "") + server_xml(5, "Old", 0, "1")),
+        response("\"list-1\"", ""),
+        response("\"list-2\"", server_xml(1, "A", 0, "") +
+            server_xml(2, "B", 2, "") + server_xml(4, "D", 0, "")),
+    };
+
+    // The HTTP stand-in, it answers each connection with the next response
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+#ifdef WIN32
+    SOCKET listener = socket(AF_INET, SOCK_STREAM, 0);
+    assert(listener != INVALID_SOCKET);
+#else
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    assert(listener != -1);
+#endif
+    bool success = bind(listener, (sockaddr*)&addr, addr_len) == 0 &&
+        getsockname(listener, (sockaddr*)&addr, &addr_len) == 0 &&
+        listen(listener, 1) == 0;
+    assert(success);
+    (void)success;
+    std::vector<std::string> requests(responses.size());
+    std::thread stand_in([&]()
+    {
+        for (unsigned i = 0; i < responses.size(); i++)
+        {
+            auto client = accept(listener, NULL, NULL);
+            char buffer[1024];
+            while (requests[i].find("\r\n\r\n") == std::string::npos)
+            {
+                int len = recv(client, buffer, sizeof(buffer), 0);
+                if (len <= 0)
+                    break;
+                requests[i].append(buffer, len);
+            }
+            send(client, responses[i].c_str(), (int)responses[i].size(), 0);
+#ifdef WIN32
+            closesocket(client);
+#else
+            close(client);
+#endif
+        }
+    });
+    const std::string url = "http://127.0.0.1:" +
+        StringUtils::toString(ntohs(addr.sin_port)) + "/";
+
+    auto cache = std::make_shared<WANServerCache>();
+    auto refresh = [cache, url]()->std::vector<std::shared_ptr<Server> >
+    {
+        auto server_list = std::make_shared<ServerList>();
+        auto request = std::make_shared<WANRefreshRequest>(server_list,
+            cache, /*detect_ip*/false);
+        request->setURL(url);
+        request->executeNow();
+        assert(server_list->m_list_updated);
+        return server_list->m_servers;
+    };
+
+    std::vector<std::shared_ptr<Server> > first = refresh();
+    assert(first.size() == 2);
+    assert(first[0]->getServerId() == 1);
+    assert(!first[0]->useIPV6Connection());
+    // Change the state like a connection attempt does
+    first[0]->setIPV6Connection(true);
+    first[0]->setReconnectWhenQuitLobby(true);
+    first[0]->setAddress(SocketAddress("127.0.0.2", 1234));
+    first[0]->setBookmarkID(7);
+
+    // Unchanged list: the cached list is used, but new servers are created
+    std::vector<std::shared_ptr<Server> > second = refresh();
+    assert(requests[1].find("If-None-Match: \"list-1\"") !=
+           std::string::npos);
+    assert(second.size() == 2);
+    assert(second[0] != first[0]);
+    assert(second[0]->getServerId() == 1);
+    assert(!second[0]->useIPV6Connection());
+    assert(!second[0]->reconnectWhenQuitLobby());
+    assert(second[0]->getAddress() == SocketAddress("127.0.0.1", 2759));
+    assert(second[0]->getBookmarkID() == 0);
+
+    // One unchanged, one changed, one removed and one added server
+    std::vector<std::shared_ptr<Server> > third = refresh();
+    assert(third.size() == 3);
+    assert(third[0] != second[0]);
+    assert(third[1]->getServerId() == 2);
+    assert(third[1]->getCurrentPlayers() == 2);
+    assert(third[2]->getServerId() == 4);
+    assert(cache->m_etag == "\"list-2\"");
+
+    stand_in.join();
+#ifdef WIN32
+    closesocket(listener);
+#else
+    close(listener);
+#endif
+}   // unitTesting
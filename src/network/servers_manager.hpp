@@ -24,6 +24,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -44,12 +45,35 @@ struct ServerList
     ServerList() { m_list_updated.store(false); }
 };
 
+/** The result of the last WAN refresh. It is used to send a conditional
+ *  request, and to skip parsing the list if it did not change. Only the
+ *  parsed list is kept, not the Server objects created from it.
+ */
+struct WANServerCache
+{
+    std::mutex m_mutex;
+    /** ETag of the last response, "" if none was sent. */
+    std::string m_etag;
+    /** Hash of the last response. */
+    size_t m_hash;
+    /** The last list, NULL if none was downloaded yet. */
+    std::unique_ptr<XMLNode> m_xml;
+    /** Hash of the XML node and id of each server in the last list, used to
+     *  log the changes of the next list. */
+    std::vector<std::pair<size_t, uint32_t> > m_servers;
+    WANServerCache();
+    ~WANServerCache();
+};   // WANServerCache
+
 class ServersManager
 {
 private:
     /** List of broadcast addresses to use. */
     std::vector<SocketAddress> m_broadcast_address;
 
+    /** Shared with the refresh requests, which can outlive this object. */
+    std::shared_ptr<WANServerCache> m_wan_cache;
+
     // ------------------------------------------------------------------------
      ServersManager();
     // ------------------------------------------------------------------------
@@ -75,6 +99,11 @@ public:
     std::shared_ptr<ServerList> getWANRefreshRequest() const;
     // ------------------------------------------------------------------------
     std::shared_ptr<ServerList> getLANRefreshRequest() const;
+    // ------------------------------------------------------------------------
+    static void updateWANServers(XMLNode* xml, WANServerCache* cache,
+                                 std::vector<std::shared_ptr<Server> >* out);
+    // ------------------------------------------------------------------------
+    static void unitTesting();
 
 };   // class ServersManager
 #endif // HEADER_SERVERS_MANAGER_HPP
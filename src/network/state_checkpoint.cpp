@@ -0,0 +1,288 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/state_checkpoint.hpp"
+
+#include "items/network_item_manager.hpp"
+#include "utils/log.hpp"
+#include "utils/vs.hpp"
+
+#include <cassert>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace
+{
+    /** Upper limit for the uncompressed size of a received checkpoint, so
+     *  a broken packet can't make a client allocate a lot of memory. */
+    const uint32_t MAX_UNCOMPRESSED_SIZE = 16 * 1024 * 1024;
+}
+
+// ----------------------------------------------------------------------------
+/** Starts the thread which compresses the checkpoints.
+ *  \param interval_ticks Number of ticks between two checkpoints.
+ */
+StateCheckpoint::StateCheckpoint(int interval_ticks)
+{
+    m_pending          = NULL;
+    m_pending_ticks    = -1;
+    m_compressed_ticks = -1;
+    m_race             = 0;
+    m_exit             = false;
+    m_current_ticks    = -1;
+    m_interval_ticks   = interval_ticks > 1 ? interval_ticks : 1;
+    m_next_ticks       = 0;
+    m_thread = std::thread([this]()
+        {
+            VS::setThreadName("StateCheckpoint");
+            compressLoop();
+        });
+}   // StateCheckpoint
+
+// ----------------------------------------------------------------------------
+StateCheckpoint::~StateCheckpoint()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+    delete m_pending;
+}   // ~StateCheckpoint
+
+// ----------------------------------------------------------------------------
+/** The thread which compresses the states saved by update(). Only the
+ *  latest state is compressed if the thread falls behind.
+ */
+void StateCheckpoint::compressLoop()
+{
+    std::unique_lock<std::mutex> ul(m_mutex);
+    while (true)
+    {
+        m_cv.wait(ul, [this]() { return m_exit || m_pending != NULL; });
+        if (m_exit)
+            return;
+        BareNetworkString* state = m_pending;
+        const int ticks = m_pending_ticks;
+        const unsigned race = m_race;
+        m_pending = NULL;
+        ul.unlock();
+
+        BareNetworkString compressed;
+        const bool success = compress(*state, &compressed);
+        if (success)
+        {
+            Log::debug("StateCheckpoint", "Checkpoint at %d: %u bytes "
+                "compressed to %u.", ticks, state->size(),
+                compressed.size());
+        }
+        delete state;
+
+        ul.lock();
+        if (success && race == m_race)
+        {
+            std::swap(m_compressed, compressed);
+            m_compressed_ticks = ticks;
+        }
+    }
+}   // compressLoop
+
+// ----------------------------------------------------------------------------
+/** Called by the game thread during a race. It passes a newly compressed
+ *  checkpoint to the item manager, and saves the state for the next one
+ *  once the interval has passed.
+ *  \param nim The item manager of the race.
+ *  \param ticks Current world ticks.
+ */
+void StateCheckpoint::update(NetworkItemManager* nim, int ticks)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_compressed_ticks != -1)
+        {
+            std::swap(m_current, m_compressed);
+            m_current_ticks = m_compressed_ticks;
+            m_compressed_ticks = -1;
+            nim->setCheckpointTicks(m_current_ticks);
+        }
+    }
+
+    if (ticks < m_next_ticks)
+        return;
+    m_next_ticks = ticks + m_interval_ticks;
+
+    // Only this copy is done on the game thread
+    BareNetworkString* state = new BareNetworkString(1024);
+    nim->saveCompleteState(state);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        delete m_pending;
+        m_pending = state;
+        m_pending_ticks = ticks;
+    }
+    m_cv.notify_one();
+}   // update
+
+// ----------------------------------------------------------------------------
+/** Discards all checkpoints, called when a new race is loaded. */
+void StateCheckpoint::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    delete m_pending;
+    m_pending = NULL;
+    m_compressed.getBuffer().clear();
+    m_compressed.reset();
+    m_compressed_ticks = -1;
+    m_race++;
+    m_current.getBuffer().clear();
+    m_current.reset();
+    m_current_ticks = -1;
+    m_next_ticks = 0;
+}   // clear
+
+// ----------------------------------------------------------------------------
+/** Adds the latest checkpoint (which the item manager keeps the events
+ *  for) to a network string.
+ *  \return The world ticks of the checkpoint, or -1 if there is none yet
+ *          (and nothing was added).
+ */
+int StateCheckpoint::addCheckpoint(BareNetworkString* ns) const
+{
+    if (m_current_ticks == -1)
+        return -1;
+    *ns += m_current;
+    return m_current_ticks;
+}   // addCheckpoint
+
+// ----------------------------------------------------------------------------
+/** Compresses the unread part of a network string.
+ *  \param in The data to compress.
+ *  \param out The uncompressed size, the compressed size and the compressed
+ *         data are added to it.
+ */
+bool StateCheckpoint::compress(const BareNetworkString& in,
+                               BareNetworkString* out)
+{
+    uLongf length = compressBound(in.size());
+    std::vector<uint8_t> data(length);
+    if (::compress(data.data(), &length, (const Bytef*)in.getCurrentData(),
+        in.size()) != Z_OK)
+    {
+        Log::error("StateCheckpoint", "Failed to compress %u bytes.",
+            in.size());
+        return false;
+    }
+    out->addUInt32(in.size()).addUInt32((uint32_t)length);
+    out->getBuffer().insert(out->getBuffer().end(), data.begin(),
+        data.begin() + length);
+    return true;
+}   // compress
+
+// ----------------------------------------------------------------------------
+/** Reads data written by compress() and skips it.
+ *  \param in The received network string.
+ *  \param out The uncompressed data is added to it.
+ *  \throws std::runtime_error if the data is invalid.
+ */
+void StateCheckpoint::decompress(BareNetworkString* in,
+                                 BareNetworkString* out)
+{
+    const uint32_t size = in->getUInt32();
+    const uint32_t compressed_size = in->getUInt32();
+    if (size > MAX_UNCOMPRESSED_SIZE || compressed_size > in->size())
+        throw std::runtime_error("Invalid checkpoint size.");
+
+    std::vector<uint8_t>& buffer = out->getBuffer();
+    const size_t offset = buffer.size();
+    buffer.resize(offset + size);
+    uLongf length = size;
+    if (uncompress(buffer.data() + offset, &length,
+        (const Bytef*)in->getCurrentData(), compressed_size) != Z_OK ||
+        length != size)
+    {
+        buffer.resize(offset);
+        throw std::runtime_error("Invalid compressed checkpoint.");
+    }
+    in->skip(compressed_size);
+}   // decompress
+
+// ----------------------------------------------------------------------------
+void StateCheckpoint::unitTesting()
+{
+    BareNetworkString state;
+    state.addUInt32(1234).addUInt32((uint32_t)-1).addUInt32(200);
+    for (unsigned i = 0; i < 200; i++)
+    {
+        state.addUInt8(i % 3 == 0 ? 0 : 1);
+        state.addUInt8(i % 5).addFloat(i * 0.5f).addUInt32(i);
+    }
+
+    // Round trip, and the data after the checkpoint must still be readable
+    BareNetworkString ns;
+    ns.addUInt8(42);
+    bool success = compress(state, &ns);
+    assert(success);
+    (void)success;
+    ns.addUInt8(43);
+    assert(ns.size() < state.size());
+    assert(ns.getUInt8() == 42);
+    BareNetworkString restored;
+    decompress(&ns, &restored);
+    assert(restored.getBuffer() == state.getBuffer());
+    assert(ns.getUInt8() == 43);
+    assert(restored.getUInt32() == 1234);
+
+    // An empty state
+    BareNetworkString empty, empty_compressed, empty_restored;
+    success = compress(empty, &empty_compressed);
+    assert(success);
+    decompress(&empty_compressed, &empty_restored);
+    assert(empty_restored.size() == 0);
+
+    // Broken data must be detected
+    ns.reset();
+    ns.getUInt8();
+    ns.getBuffer()[ns.getCurrentOffset() + 12] ^= 0xFF;
+    bool failed = false;
+    try
+    {
+        BareNetworkString broken;
+        decompress(&ns, &broken);
+    }
+    catch (std::exception&)
+    {
+        failed = true;
+    }
+    assert(failed);
+    (void)failed;
+
+    BareNetworkString too_big;
+    too_big.addUInt32(MAX_UNCOMPRESSED_SIZE + 1).addUInt32(0);
+    failed = false;
+    try
+    {
+        BareNetworkString broken;
+        decompress(&too_big, &broken);
+    }
+    catch (std::exception&)
+    {
+        failed = true;
+    }
+    assert(failed);
+}   // unitTesting
@@ -0,0 +1,107 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_STATE_CHECKPOINT_HPP
+#define HEADER_STATE_CHECKPOINT_HPP
+
+#include "network/network_string.hpp"
+#include "utils/no_copy.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class NetworkItemManager;
+
+/** \ingroup network
+ *  Periodic compressed checkpoints of the complete item state of a game in
+ *  progress on the server, which are sent to live-joining clients instead
+ *  of saving the current state for each of them.
+ *  The game thread only copies the state into a network string, which is
+ *  compressed by a separate thread. Once a checkpoint is compressed, the
+ *  item manager keeps all item events since it (see
+ *  NetworkItemManager::setCheckpointTicks), so a client starting from the
+ *  checkpoint gets these events with the next states.
+ *  The state of the world (laps, scores, ...) has no such events, so it is
+ *  still saved for each live join.
+ */
+class StateCheckpoint : public NoCopy
+{
+private:
+    std::thread m_thread;
+
+    /** Protects all variables up to m_exit. */
+    std::mutex m_mutex;
+
+    /** Signals the thread that a new state is available (or to exit). */
+    std::condition_variable m_cv;
+
+    /** Uncompressed state waiting to be compressed, or NULL. */
+    BareNetworkString* m_pending;
+
+    /** World ticks at which m_pending was saved. */
+    int m_pending_ticks;
+
+    /** The latest compressed checkpoint. */
+    BareNetworkString m_compressed;
+
+    /** World ticks of m_compressed, or -1 if there is none. */
+    int m_compressed_ticks;
+
+    /** Incremented by clear(), so a state of the previous race which is
+     *  compressed at that time is discarded. */
+    unsigned m_race;
+
+    bool m_exit;
+
+    /** The checkpoint which is sent to clients, it is only changed in
+     *  update() together with the ticks in the item manager. */
+    BareNetworkString m_current;
+
+    /** World ticks of m_current, or -1 if there is none. */
+    int m_current_ticks;
+
+    /** Number of ticks between two checkpoints. */
+    int m_interval_ticks;
+
+    /** World ticks at which the next checkpoint is saved. */
+    int m_next_ticks;
+
+    // ------------------------------------------------------------------------
+    void compressLoop();
+
+public:
+    // ------------------------------------------------------------------------
+    StateCheckpoint(int interval_ticks);
+    // ------------------------------------------------------------------------
+    ~StateCheckpoint();
+    // ------------------------------------------------------------------------
+    void update(NetworkItemManager* nim, int ticks);
+    // ------------------------------------------------------------------------
+    void clear();
+    // ------------------------------------------------------------------------
+    int addCheckpoint(BareNetworkString* ns) const;
+    // ------------------------------------------------------------------------
+    static bool compress(const BareNetworkString& in, BareNetworkString* out);
+    // ------------------------------------------------------------------------
+    static void decompress(BareNetworkString* in, BareNetworkString* out);
+    // ------------------------------------------------------------------------
+    static void unitTesting();
+};   // StateCheckpoint
+
+#endif
@@ -21,6 +21,7 @@
 #include "config/stk_config.hpp"
 #include "config/user_config.hpp"
 #include "io/file_manager.hpp"
+#include "network/connection_limiter.hpp"
 #include "network/event.hpp"
 #include "network/game_setup.hpp"
 #include "network/network.hpp"
@@ -33,6 +34,7 @@
 #include "network/protocols/server_lobby.hpp"
 #include "network/protocol_manager.hpp"
 #include "network/server_config.hpp"
+#include "network/server_metrics.hpp"
 #include "network/child_loop.hpp"
 #include "network/stk_ipv6.hpp"
 #include "network/stk_peer.hpp"
@@ -303,7 +305,15 @@ STKHost::STKHost(bool server)
                               "ENet server host.");
     }
     if (server)
+    {
         Log::info("STKHost", "Server port is %d", getPrivatePort());
+        m_connection_limiter.reset(new ConnectionLimiter(
+            ServerConfig::m_connection_rate,
+            (float)ServerConfig::m_connection_burst));
+        m_network->getENetHost()->intercept = STKHost::interceptCallback;
+        if (!std::string(ServerConfig::m_metrics_file).empty())
+            ServerMetrics::enable(true);
+    }
 }   // STKHost
 
 // ----------------------------------------------------------------------------
@@ -378,6 +388,7 @@ STKHost::~STKHost()
         m_client_loop_thread.join();
         delete m_client_loop;
     }
+    ServerMetrics::enable(false);
 }   // ~STKHost
 
 //-----------------------------------------------------------------------------
@@ -822,6 +833,7 @@ void STKHost::mainLoop(ProcessType pt)
 
     uint64_t last_ping_time = StkTime::getMonoTimeMs();
     uint64_t last_update_speed_time = StkTime::getMonoTimeMs();
+    uint64_t last_metrics_time = StkTime::getMonoTimeMs();
     uint64_t last_ping_time_update_for_client = StkTime::getMonoTimeMs();
     std::map<std::string, uint64_t> ctp;
     while (m_exit_timeout.load() > StkTime::getMonoTimeMs())
@@ -846,6 +858,15 @@ void STKHost::mainLoop(ProcessType pt)
             getNetwork()->getENetHost()->totalReceivedData = 0;
         }
 
+        if (is_server && ServerMetrics::get() &&
+            last_metrics_time < StkTime::getMonoTimeMs())
+        {
+            last_metrics_time = StkTime::getMonoTimeMs() +
+                (uint64_t)(ServerConfig::m_metrics_interval * 1000.0f);
+            ServerMetrics::writeFile(ServerConfig::m_metrics_file,
+                getMetricsText());
+        }
+
         auto sl = LobbyProtocol::get<ServerLobby>();
         if (direct_socket && sl && sl->waitingForPlayers())
         {
@@ -964,6 +985,8 @@ void STKHost::mainLoop(ProcessType pt)
                         // If enet_peer_send failed, destroy the packet to
                         // prevent leaking, this can only be done if the packet
                         // is copied instead of shared sending to all peers
+                        it->second->addSentData(EVENT_CHANNEL_UNENCRYPTED,
+                            packet->dataLength);
                         if (enet_peer_send(
                             it->first, EVENT_CHANNEL_UNENCRYPTED, packet) < 0)
                         {
@@ -1123,6 +1146,8 @@ void STKHost::mainLoop(ProcessType pt)
             {
                 std::shared_ptr<STKPeer> peer = m_peers.at(event.peer);
                 lock.unlock();
+                peer->addReceivedData(event.channelID,
+                    event.packet->dataLength);
                 if (isPingPacket(event.packet->data, event.packet->dataLength))
                 {
                     if (!is_server)
@@ -1283,6 +1308,10 @@ void STKHost::handleDirectSocketRequest(Network* direct_socket,
             Log::error("STKHost", "which is outside of LAN - rejected.");
             return;
         }
+        // Each request starts a protocol, and the address may be spoofed
+        if (!m_connection_limiter->allowRequest(sender,
+            StkTime::getMonoTimeMs()))
+            return;
         if (ctp.find(peer_addr) == ctp.end())
         {
             ctp[peer_addr] = StkTime::getMonoTimeMs();
@@ -1301,6 +1330,78 @@ void STKHost::handleDirectSocketRequest(Network* direct_socket,
 
 }   // handleDirectSocketRequest
 
+// ----------------------------------------------------------------------------
+/** Intercept callback of the server host, which ENet calls for each received
+ *  datagram before handling it. Connection requests are checked by the
+ *  connection limiter before ENet allocates a peer for them, and they are
+ *  answered with a cookie if the limiter requires it, see ConnectionLimiter
+ *  and ConnectToServer::interceptCallback for the client side.
+ *  \return 1 if ENet should ignore the datagram.
+ */
+int STKHost::interceptCallback(ENetHost* host, ENetEvent* event)
+{
+    // A connection request has no peer id, and the connect command first
+    // (the compression is not used in STK)
+    const enet_uint8* data = host->receivedData;
+    const size_t length = host->receivedDataLength;
+    if (length < 2)
+        return 0;
+    const uint16_t peer_id = (uint16_t)((data[0] << 8) | data[1]);
+    if ((peer_id & ENET_PROTOCOL_MAXIMUM_PEER_ID) !=
+        ENET_PROTOCOL_MAXIMUM_PEER_ID ||
+        (peer_id & ENET_PROTOCOL_HEADER_FLAG_COMPRESSED) != 0)
+        return 0;
+    const size_t offset =
+        (peer_id & ENET_PROTOCOL_HEADER_FLAG_SENT_TIME) != 0 ? 4 : 2;
+    if (length < offset + sizeof(ENetProtocolConnect) ||
+        (data[offset] & ENET_PROTOCOL_COMMAND_MASK) !=
+        ENET_PROTOCOL_COMMAND_CONNECT)
+        return 0;
+    ENetProtocolConnect connect;
+    memcpy(&connect, data + offset, sizeof(connect));
+
+    unsigned half_open = 0;
+    for (ENetPeer* peer = host->peers;
+         peer < &host->peers[host->peerCount]; peer++)
+    {
+        if (peer->state == ENET_PEER_STATE_DISCONNECTED)
+            continue;
+        // Let enet handle a resent request of a known address
+#if defined(ENABLE_IPV6) || defined(__SWITCH__)
+        if (enet_ip_equal(peer->address.host, host->receivedAddress.host) &&
+#else
+        if (peer->address.host == host->receivedAddress.host &&
+#endif
+            peer->address.port == host->receivedAddress.port)
+            return 0;
+        if (peer->state == ENET_PEER_STATE_ACKNOWLEDGING_CONNECT)
+            half_open++;
+    }
+
+    STKHost* sh = STKHost::get();
+    SocketAddress sender(host->receivedAddress);
+    const uint64_t now = StkTime::getMonoTimeMs();
+    switch (sh->m_connection_limiter->handleConnect(sender,
+        ENET_NET_TO_HOST_32(connect.data), half_open, now))
+    {
+    case ConnectionLimiter::CD_ACCEPT:
+        return 0;
+    case ConnectionLimiter::CD_CHALLENGE:
+    {
+        // Starts with 0xFFFF like "aloha-stk", and it is smaller than the
+        // request, so it cannot be used to amplify a flood
+        BareNetworkString s(17);
+        s.addUInt8(0xff).addUInt8(0xff).encodeString(std::string("stk-cookie"))
+            .addUInt32(sh->m_connection_limiter->getCookie(sender, now));
+        sh->m_network->sendRawPacket(s, sender);
+        return 1;
+    }
+    case ConnectionLimiter::CD_DROP:
+        return 1;
+    }
+    return 0;
+}   // interceptCallback
+
 // ----------------------------------------------------------------------------
 /** \brief Tells if a peer is known.
  *  \return True if the peer is known, false elseway.
@@ -1589,6 +1690,39 @@ void STKHost::updatePlayers(unsigned* ingame, unsigned* waiting,
         *total = total_players;
 }   // updatePlayers
 
+// ----------------------------------------------------------------------------
+/** Returns the server metrics in the Prometheus text format, or an empty
+ *  string if they are not enabled. */
+std::string STKHost::getMetricsText()
+{
+    ServerMetrics* sm = ServerMetrics::get();
+    if (!sm)
+        return "";
+    sm->setGauge(ServerMetrics::GT_PLAYERS_IN_GAME, getPlayersInGame());
+    sm->setGauge(ServerMetrics::GT_PLAYERS_WAITING, getWaitingPlayers());
+    sm->setGauge(ServerMetrics::GT_TOTAL_PLAYERS, getTotalPlayers());
+
+    std::vector<ServerMetrics::PeerTraffic> traffic;
+    std::unique_lock<std::mutex> lock(m_peers_mutex);
+    for (auto& p : m_peers)
+    {
+        const STKPeer* peer = p.second.get();
+        ServerMetrics::PeerTraffic t;
+        t.m_host_id = peer->getHostId();
+        t.m_address = peer->getAddress().toString();
+        for (unsigned i = 0; i < EVENT_CHANNEL_COUNT; i++)
+        {
+            t.m_sent_bytes[i] = peer->getSentBytes(i);
+            t.m_sent_packets[i] = peer->getSentPackets(i);
+            t.m_received_bytes[i] = peer->getReceivedBytes(i);
+            t.m_received_packets[i] = peer->getReceivedPackets(i);
+        }
+        traffic.push_back(t);
+    }
+    lock.unlock();
+    return sm->getText(traffic);
+}   // getMetricsText
+
 // ----------------------------------------------------------------------------
 /** True if this is a client and server in graphics mode made by server
   *  creation screen. */
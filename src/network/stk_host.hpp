@@ -48,6 +48,7 @@
 #include <vector>
 
 class BareNetworkString;
+class ConnectionLimiter;
 class GameSetup;
 class LobbyProtocol;
 class Network;
@@ -157,6 +158,10 @@ private:
 
     std::unique_ptr<NetworkTimerSynchronizer> m_nts;
 
+    /** Rate limits connection requests of a server, only used in the
+     *  listening thread. */
+    std::unique_ptr<ConnectionLimiter> m_connection_limiter;
+
     // ------------------------------------------------------------------------
     STKHost(bool server);
     // ------------------------------------------------------------------------
@@ -170,6 +175,8 @@ private:
     // ------------------------------------------------------------------------
     void mainLoop(ProcessType pt);
     // ------------------------------------------------------------------------
+    static int interceptCallback(ENetHost* host, ENetEvent* event);
+    // ------------------------------------------------------------------------
     void getIPFromStun(int socket, const std::string& stun_address,
                        short family, SocketAddress* result);
 public:
@@ -375,6 +382,8 @@ public:
     /* Return download speed in bytes per second. */
     unsigned getDownloadSpeed() const       { return m_download_speed.load(); }
     // ------------------------------------------------------------------------
+    std::string getMetricsText();
+    // ------------------------------------------------------------------------
     void updatePlayers(unsigned* ingame = NULL,
                        unsigned* waiting = NULL,
                        unsigned* total = NULL);
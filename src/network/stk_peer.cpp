@@ -24,6 +24,7 @@
 #include "network/network.hpp"
 #include "network/network_config.hpp"
 #include "network/network_string.hpp"
+#include "network/server_metrics.hpp"
 #include "network/socket_address.hpp"
 #include "network/stk_ipv6.hpp"
 #include "network/stk_host.hpp"
@@ -33,6 +34,9 @@
 
 #include <string.h>
 
+static_assert(STKPeer::TRAFFIC_CHANNELS == EVENT_CHANNEL_COUNT,
+              "Traffic must be counted for all channels.");
+
 /** Constructor for an empty peer.
  */
 STKPeer::STKPeer(ENetPeer *enet_peer, STKHost* host, uint32_t host_id)
@@ -54,6 +58,13 @@ STKPeer::STKPeer(ENetPeer *enet_peer, STKHost* host, uint32_t host_id)
     m_last_activity.store((int64_t)StkTime::getMonoTimeMs());
     m_last_message.store(0);
     m_consecutive_messages = 0;
+    for (unsigned int i = 0; i < TRAFFIC_CHANNELS; i++)
+    {
+        m_sent_bytes[i].store(0);
+        m_sent_packets[i].store(0);
+        m_received_bytes[i].store(0);
+        m_received_packets[i].store(0);
+    }
 }   // STKPeer
 
 //-----------------------------------------------------------------------------
@@ -108,6 +119,7 @@ void STKPeer::sendPacket(NetworkString *data, bool reliable, bool encrypted)
     ENetPacket* packet = NULL;
     if (m_crypto && encrypted)
     {
+        ServerMetrics::ScopedTimer timer(ServerMetrics::HT_ENCRYPTION);
         packet = m_crypto->encryptSend(*data, reliable);
     }
     else
@@ -127,9 +139,11 @@ void STKPeer::sendPacket(NetworkString *data, bool reliable, bool encrypted)
                 packet->dataLength, getAddress().toString().c_str(),
                 StkTime::getRealTime());
         }
-        m_host->addEnetCommand(m_enet_peer, packet,
-                encrypted ? EVENT_CHANNEL_NORMAL : EVENT_CHANNEL_UNENCRYPTED,
-                ECT_SEND_PACKET, m_address);
+        const EVENT_CHANNEL channel =
+            encrypted ? EVENT_CHANNEL_NORMAL : EVENT_CHANNEL_UNENCRYPTED;
+        addSentData(channel, packet->dataLength);
+        m_host->addEnetCommand(m_enet_peer, packet, channel, ECT_SEND_PACKET,
+                               m_address);
     }
 }   // sendPacket
 
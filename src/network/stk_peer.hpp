@@ -74,6 +74,11 @@ enum AlwaysSpectateMode : uint8_t
  */
 class STKPeer : public NoCopy
 {
+public:
+    /** Number of channels for which the traffic is counted, must be the
+     *  same as EVENT_CHANNEL_COUNT. */
+    static const unsigned int TRAFFIC_CHANNELS = 3;
+
 protected:
     /** Pointer to the corresponding ENet peer data structure. */
     ENetPeer* m_enet_peer;
@@ -131,6 +136,13 @@ protected:
     std::set<std::string> m_client_capabilities;
 
     std::array<int, AS_TOTAL> m_addons_scores;
+
+    /** Bytes and packets sent to and received from this peer on each
+     *  channel, for the server metrics. */
+    std::array<std::atomic<uint64_t>, TRAFFIC_CHANNELS> m_sent_bytes;
+    std::array<std::atomic<uint64_t>, TRAFFIC_CHANNELS> m_sent_packets;
+    std::array<std::atomic<uint64_t>, TRAFFIC_CHANNELS> m_received_bytes;
+    std::array<std::atomic<uint64_t>, TRAFFIC_CHANNELS> m_received_packets;
 public:
     STKPeer(ENetPeer *enet_peer, STKHost* host, uint32_t host_id);
     // ------------------------------------------------------------------------
@@ -310,6 +322,36 @@ public:
         if (m_always_spectate.load() == ASM_FULL)
             m_always_spectate.store(ASM_NONE);
     }
+    // ------------------------------------------------------------------------
+    /** Counts a packet sent to this peer on the given channel. */
+    void addSentData(unsigned int channel, size_t bytes)
+    {
+        if (channel >= TRAFFIC_CHANNELS)
+            return;
+        m_sent_bytes[channel].fetch_add(bytes, std::memory_order_relaxed);
+        m_sent_packets[channel].fetch_add(1, std::memory_order_relaxed);
+    }   // addSentData
+    // ------------------------------------------------------------------------
+    /** Counts a packet received from this peer on the given channel. */
+    void addReceivedData(unsigned int channel, size_t bytes)
+    {
+        if (channel >= TRAFFIC_CHANNELS)
+            return;
+        m_received_bytes[channel].fetch_add(bytes, std::memory_order_relaxed);
+        m_received_packets[channel].fetch_add(1, std::memory_order_relaxed);
+    }   // addReceivedData
+    // ------------------------------------------------------------------------
+    uint64_t getSentBytes(unsigned int channel) const
+                                       { return m_sent_bytes[channel].load(); }
+    // ------------------------------------------------------------------------
+    uint64_t getSentPackets(unsigned int channel) const
+                                     { return m_sent_packets[channel].load(); }
+    // ------------------------------------------------------------------------
+    uint64_t getReceivedBytes(unsigned int channel) const
+                                   { return m_received_bytes[channel].load(); }
+    // ------------------------------------------------------------------------
+    uint64_t getReceivedPackets(unsigned int channel) const
+                                 { return m_received_packets[channel].load(); }
 };   // STKPeer
 
 #endif // STK_PEER_HPP
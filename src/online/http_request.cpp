@@ -90,6 +90,7 @@ namespace Online
         m_filename      = "";
         m_parameters    = "";
         m_curl_code     = CURLE_OK;
+        m_response_code = 0;
         m_progress.store(0.0f);
         m_total_size.store(-1.0);
         m_disable_sending_log = false;
@@ -185,6 +186,12 @@ namespace Online
         std::string host = "Host: " + StringUtils::getHostNameFromURL(m_url);
         m_http_header = curl_slist_append(m_http_header, host.c_str());
         assert(m_http_header != nullptr);
+        for (const std::string& header : m_headers)
+            m_http_header = curl_slist_append(m_http_header, header.c_str());
+        curl_easy_setopt(m_curl_session, CURLOPT_HEADERDATA,
+                         &m_response_headers);
+        curl_easy_setopt(m_curl_session, CURLOPT_HEADERFUNCTION,
+                         &HTTPRequest::headerCallback);
         curl_easy_setopt(m_curl_session, CURLOPT_HTTPHEADER, m_http_header);
         curl_easy_setopt(m_curl_session, CURLOPT_SSL_VERIFYPEER, 1L);
         curl_easy_setopt(m_curl_session, CURLOPT_SSL_VERIFYHOST, 2L);
@@ -270,6 +277,8 @@ namespace Online
         curl_easy_setopt(m_curl_session, CURLOPT_USERAGENT, uagent.c_str());
 
         m_curl_code = curl_easy_perform(m_curl_session);
+        curl_easy_getinfo(m_curl_session, CURLINFO_RESPONSE_CODE,
+                          &m_response_code);
         Request::operation();
 
         if (fout)
@@ -341,6 +350,45 @@ namespace Online
         return size * nmemb;
     }   // writeCallback
 
+    // ------------------------------------------------------------------------
+    /** Callback from curl for each received header line.
+     *  \param buffer The header line (not 0 terminated).
+     *  \param size Always 1.
+     *  \param nitems Length of the line.
+     *  \param userp Pointer to the string to store the header lines in.
+     */
+    size_t HTTPRequest::headerCallback(char *buffer, size_t size,
+                                       size_t nitems, void *userp)
+    {
+        ((std::string*)userp)->append(buffer, size * nitems);
+        return size * nitems;
+    }   // headerCallback
+
+    // ------------------------------------------------------------------------
+    /** Returns the value of a response header, or "" if it was not received.
+     *  If there were several responses (e.g. because of a redirect), the
+     *  value of the last one is returned.
+     *  \param name Name of the header, case insensitive.
+     */
+    std::string HTTPRequest::getResponseHeader(const std::string &name) const
+    {
+        std::string value;
+        const std::string lower_name = StringUtils::toLowerCase(name) + ":";
+        for (const std::string& line :
+             StringUtils::split(m_response_headers, '\n'))
+        {
+            if (line.size() < lower_name.size() ||
+                StringUtils::toLowerCase(line.substr(0, lower_name.size())) !=
+                lower_name)
+                continue;
+            size_t start = line.find_first_not_of(" \t", lower_name.size());
+            size_t end = line.find_last_not_of(" \t\r");
+            value = start == std::string::npos || end < start ?
+                "" : line.substr(start, end - start + 1);
+        }
+        return value;
+    }   // getResponseHeader
+
     // ----------------------------------------------------------------------------
     /** Callback function from curl: inform about progress. It makes sure that
      *  the value reported by getProgress () is <1 while the download is still
@@ -80,6 +80,15 @@ namespace Online
         std::string m_string_buffer;
 
         struct curl_slist* m_http_header = NULL;
+
+        /** Additional header lines to send, e.g. "If-None-Match: ...". */
+        std::vector<std::string> m_headers;
+
+        /** All header lines received. */
+        std::string m_response_headers;
+
+        /** The HTTP response code, 0 if no response was received. */
+        long m_response_code;
     protected:
         /** Contains a filename if the data should be saved into a file
          *  instead of being kept in in memory. Otherwise this is "". */
@@ -100,6 +109,8 @@ namespace Online
 
         static size_t writeCallback(void *contents, size_t size,
                                     size_t nmemb,   void *userp);
+        static size_t headerCallback(char *buffer, size_t size,
+                                     size_t nitems, void *userp);
         void init();
 
     public :
@@ -119,6 +130,20 @@ namespace Online
         virtual bool       isAllowedToAdd() const OVERRIDE;
         void               setApiURL(const std::string& url, const std::string &action);
         void               setAddonsURL(const std::string& path);
+        std::string        getResponseHeader(const std::string &name) const;
+
+        // ------------------------------------------------------------------------
+        /** Adds a header line to send with the request.
+         *  \pre Request must not have been started. */
+        void addHeader(const std::string &header)
+        {
+            assert(!isBusy());
+            m_headers.push_back(header);
+        }   // addHeader
+        // ------------------------------------------------------------------------
+        /** Returns the HTTP response code (e.g. 200 or 304), or 0 if no
+         *  response was received. */
+        long getResponseCode() const               { return m_response_code; }
 
         // ------------------------------------------------------------------------
         /** Returns true if there was an error downloading the file. */
@@ -68,6 +68,18 @@ namespace Online
             return m_xml_data;
         }   // getXMLData
 
+        // ------------------------------------------------------------------------
+        /** Returns the downloaded XML tree, the caller takes its ownership.
+         *  \pre request has to be executed.
+         */
+        XMLNode* releaseXMLData()
+        {
+            assert(hasBeenExecuted());
+            XMLNode* xml = m_xml_data;
+            m_xml_data = NULL;
+            return xml;
+        }   // releaseXMLData
+
         // ------------------------------------------------------------------------
         /** Returns the additional information (or error message) contained in
          *  a finished request.
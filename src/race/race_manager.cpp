@@ -35,6 +35,7 @@
 #include "karts/controller/controller.hpp"
 #include "karts/kart_properties_manager.hpp"
 #include "main_loop.hpp"
+#include "modes/ai_race_runner.hpp"
 #include "modes/capture_the_flag.hpp"
 #include "modes/cutscene_world.hpp"
 #include "modes/demo_world.hpp"
@@ -42,6 +43,7 @@
 #include "modes/follow_the_leader.hpp"
 #include "modes/free_for_all.hpp"
 #include "modes/overworld.hpp"
+#include "modes/simulation_benchmark.hpp"
 #include "modes/standard_race.hpp"
 #include "modes/tutorial_world.hpp"
 #include "modes/world.hpp"
@@ -654,6 +656,10 @@ void RaceManager::startNextRace()
         World::setWorld(new DemoWorld());
     else if(ProfileWorld::isProfileMode())
         World::setWorld(new ProfileWorld());
+    else if(SimulationBenchmark::isEnabled())
+        World::setWorld(new SimulationBenchmark());
+    else if(AIRaceRunner::isEnabled())
+        World::setWorld(new AIRaceRunner());
     else if(m_minor_mode==MINOR_MODE_FOLLOW_LEADER)
         World::setWorld(new FollowTheLeaderRace());
     else if(m_minor_mode==MINOR_MODE_NORMAL_RACE ||
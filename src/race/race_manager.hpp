@@ -443,6 +443,9 @@ public:
     void setBenchmarking(bool benchmark);
     void scheduleBenchmark();
 
+    // ----------------------------------------------------------------------------------------
+    /** Removes all karts added with setDefaultAIKartList(). */
+    void clearDefaultAIKartList()                 { m_default_ai_list.clear(); }
     // ----------------------------------------------------------------------------------------
     bool hasTimeTarget() const { return m_time_target > 0.0f; }
     // ----------------------------------------------------------------------------------------
@@ -17,28 +17,7 @@
 
 #include "replay/replay_base.hpp"
 
-#include "io/file_manager.hpp"
-#include "utils/file_utils.hpp"
-
 // -----------------------------------------------------------------------------
 ReplayBase::ReplayBase()
 {
 }   // ReplayBaese
-// -----------------------------------------------------------------------------
-/** Opens a replay file which is determined by sub classes.
- *  \param writeable True if the file should be opened for writing.
- *  \param full_path True if the file is full path.
- *  \return A FILE *, or NULL if the file could not be opened.
- */
-FILE* ReplayBase::openReplayFile(bool writeable, bool full_path, int replay_file_number)
-{
-    FILE* fd = FileUtils::fopenU8Path(full_path ? getReplayFilename(replay_file_number) :
-        file_manager->getReplayDir() + getReplayFilename(replay_file_number),
-        writeable ? "w" : "r");
-    if (!fd)
-    {
-        return NULL;
-    }
-    return fd;
-
-}   // openReplayFile
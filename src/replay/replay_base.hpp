@@ -97,8 +97,6 @@ protected:
         bool        m_jumping;
     };   // KartReplayEvent
 
-    // ------------------------------------------------------------------------
-    FILE *openReplayFile(bool writeable, bool full_path = false, int replay_file_number=1);
     // ------------------------------------------------------------------------
     /** Returns the filename that was opened. */
     virtual const std::string& getReplayFilename(int replay_file_number = 1) const = 0;
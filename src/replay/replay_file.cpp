@@ -0,0 +1,1043 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "replay/replay_file.hpp"
+
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/string_utils.hpp"
+
+#include <cassert>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include <stdio.h>
+
+namespace
+{
+    /** Increase this if the layout of the binary format changes. The
+     *  recorded data itself is versioned by the replay version. */
+    const uint32_t REPLAY_BINARY_VERSION = 2;
+
+    const char     REPLAY_BINARY_MAGIC[8] =
+                              { 'S', 'T', 'K', 'R', 'E', 'P', 'L', 'Y' };
+    const uint32_t REPLAY_BYTE_ORDER_MARK = 0x01020304;
+
+    /** Header of a binary replay file. It is followed by m_num_karts
+     *  BinaryReplayKart, the strings (each as a varint length and its utf8
+     *  bytes: stk version, minor mode, track, and ident and name of each
+     *  kart) and the events of each kart.
+     */
+    struct BinaryReplayHeader
+    {
+        char     m_magic[8];
+        uint32_t m_binary_version;
+        uint32_t m_byte_order;
+        uint32_t m_replay_version;
+        uint32_t m_num_karts;
+        uint64_t m_replay_uid;
+        float    m_min_time;
+        uint32_t m_difficulty;
+        uint32_t m_laps;
+        uint32_t m_reverse;
+        uint32_t m_strings_offset;
+        uint32_t m_strings_size;
+    };   // BinaryReplayHeader
+
+    struct BinaryReplayKart
+    {
+        float    m_color;
+        uint32_t m_num_events;
+        /** Offset of the events from the start of the file. */
+        uint32_t m_offset;
+        uint32_t m_size;
+    };   // BinaryReplayKart
+
+    /** Number of values of each event, see ReplayFile::getColumns. */
+    const unsigned int NUM_COLUMNS = 26;
+
+    /** Floats are stored with 6 decimals, like "%f" in the text format, so
+     *  a binary replay keeps the same precision as a text replay. */
+    const double FLOAT_SCALE = 1000000.0;
+
+    // ------------------------------------------------------------------------
+    int64_t quantize(float value, double scale)
+    {
+        // Large enough for any track, and far away from overflows
+        const double limit = 1e15;
+        double v = std::round((double)value * scale);
+        if (!(v > -limit))
+            v = std::isnan(v) ? 0.0 : -limit;
+        else if (v > limit)
+            v = limit;
+        return (int64_t)v;
+    }   // quantize
+
+    // ------------------------------------------------------------------------
+    float dequantize(int64_t value, double scale)
+    {
+        return (float)((double)value / scale);
+    }   // dequantize
+
+    // ------------------------------------------------------------------------
+    void appendVarint(std::vector<uint8_t>* buffer, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer->push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        buffer->push_back((uint8_t)value);
+    }   // appendVarint
+
+    // ------------------------------------------------------------------------
+    bool readVarint(const uint8_t** p, const uint8_t* end, uint64_t* value)
+    {
+        *value = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7)
+        {
+            if (*p >= end)
+                return false;
+            const uint8_t byte = *(*p)++;
+            *value |= (uint64_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }   // readVarint
+
+    // ------------------------------------------------------------------------
+    /** Maps signed values to unsigned ones, so small negative differences
+     *  need few bytes as well. */
+    uint64_t zigzag(int64_t value)
+    {
+        return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    }   // zigzag
+
+    // ------------------------------------------------------------------------
+    int64_t unzigzag(uint64_t value)
+    {
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }   // unzigzag
+
+    // ------------------------------------------------------------------------
+    void appendString(std::vector<uint8_t>* buffer, const std::string& s)
+    {
+        appendVarint(buffer, s.size());
+        buffer->insert(buffer->end(), s.begin(), s.end());
+    }   // appendString
+
+    // ------------------------------------------------------------------------
+    bool readString(const uint8_t** p, const uint8_t* end, std::string* s)
+    {
+        uint64_t length;
+        if (!readVarint(p, end, &length) || length > (uint64_t)(end - *p))
+            return false;
+        s->assign((const char*)*p, (size_t)length);
+        *p += length;
+        return true;
+    }   // readString
+
+    // ------------------------------------------------------------------------
+    template<typename T>
+    void appendToBuffer(std::vector<uint8_t>* buffer, const T* data,
+                        size_t count = 1)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        buffer->insert(buffer->end(), p, p + count * sizeof(T));
+    }   // appendToBuffer
+}   // namespace
+
+// ----------------------------------------------------------------------------
+ReplayFile::ReplayFile()
+{
+    m_version    = getCurrentReplayVersion();
+    m_reverse    = false;
+    m_difficulty = 0;
+    m_laps       = 0;
+    m_min_time   = 0.0f;
+    m_replay_uid = 0;
+    m_binary     = false;
+}   // ReplayFile
+
+// ----------------------------------------------------------------------------
+/** Loads a replay file in the text or binary format.
+ *  \param u8_path Full path of the file.
+ *  \param header_only Only load the information about the replay (karts,
+ *         track, ...), but not the recorded events.
+ *  \return True if the file was loaded successfully.
+ */
+bool ReplayFile::load(const std::string& u8_path, bool header_only)
+{
+    m_filename = u8_path;
+    m_karts.clear();
+    {
+        MappedFile file;
+        if (file.open(u8_path))
+        {
+            const char* magic =
+                file.getAt<char>(0, sizeof(REPLAY_BINARY_MAGIC));
+            if (magic && memcmp(magic, REPLAY_BINARY_MAGIC,
+                                sizeof(REPLAY_BINARY_MAGIC)) == 0)
+            {
+                m_binary = true;
+                return decodeBinary(file.getData(), file.getSize(),
+                                    header_only);
+            }
+        }
+    }
+
+    m_binary = false;
+    FILE* fd = FileUtils::fopenU8Path(u8_path, "r");
+    if (!fd)
+        return false;
+    const bool success = loadText(fd, header_only);
+    fclose(fd);
+    return success;
+}   // load
+
+// ----------------------------------------------------------------------------
+/** Reads a replay in the text format, which is used up to replay version 4.
+ */
+bool ReplayFile::loadText(FILE* fd, bool header_only)
+{
+    char s[1024], s1[1024];
+    const char* fn = m_filename.c_str();
+
+    if (fgets(s, 1023, fd) == NULL ||
+        sscanf(s, "version: %u", &m_version) != 1)
+    {
+        Log::warn("Replay", "No Version information "
+                  "found in replay file (bogus replay file).");
+        return false;
+    }
+    if (m_version < getMinSupportedReplayVersion())
+    {
+        Log::warn("Replay", "Replay is version '%d', Minimum supported "
+                  "replay version is '%d', skipped '%s'", m_version,
+                  getMinSupportedReplayVersion(), fn);
+        return false;
+    }
+    else if (m_version > getCurrentReplayVersion())
+    {
+        Log::warn("Replay", "Replay is version '%d', STK replay version is "
+                  "'%d', skipped '%s'", m_version, getCurrentReplayVersion(),
+                  fn);
+        return false;
+    }
+
+    if (m_version >= 4)
+    {
+        if (fgets(s, 1023, fd) == NULL ||
+            sscanf(s, "stk_version: %1023s", s1) != 1)
+        {
+            Log::warn("Replay", "No STK release version found in replay "
+                      "file, '%s'.", fn);
+            return false;
+        }
+        m_stk_version = s1;
+    }
+    else
+        m_stk_version = "";
+
+    while (true)
+    {
+        if (fgets(s, 1023, fd) == NULL)
+        {
+            Log::warn("Replay", "Could not read ghost karts info!");
+            return false;
+        }
+        core::stringc is_end(s);
+        is_end.trim();
+        if (is_end == "kart_list_end")
+            break;
+        char display_name_encoded[1024];
+
+        int scanned = sscanf(s, "kart: %1023s %1023[^\n]", s1,
+                             display_name_encoded);
+        if (scanned < 1)
+        {
+            Log::warn("Replay", "Could not read ghost karts info!");
+            break;
+        }
+
+        KartData kart;
+        kart.m_ident = s1;
+        // If username of kart is not present, kart display name will
+        // default to kart name (see GhostController::getName)
+        if (scanned == 2)
+        {
+            kart.m_name =
+                StringUtils::xmlDecode(std::string(display_name_encoded));
+        }
+
+        // Read kart color data
+        kart.m_color = 0.0f;
+        if (m_version >= 4)
+        {
+            if (fgets(s, 1023, fd) == NULL ||
+                sscanf(s, "kart_color: %f", &kart.m_color) != 1)
+            {
+                Log::warn("Replay", "Kart color missing in replay file, "
+                          "'%s'.", fn);
+                return false;
+            }
+        }
+        m_karts.push_back(kart);
+    }
+
+    int reverse = 0;
+    if (fgets(s, 1023, fd) == NULL || sscanf(s, "reverse: %d", &reverse) != 1)
+    {
+        Log::warn("Replay", "No reverse info found in replay file, '%s'.",
+                  fn);
+        return false;
+    }
+    m_reverse = reverse != 0;
+
+    if (fgets(s, 1023, fd) == NULL ||
+        sscanf(s, "difficulty: %u", &m_difficulty) != 1)
+    {
+        Log::warn("Replay", " No difficulty found in replay file, '%s'.",
+                  fn);
+        return false;
+    }
+
+    if (m_version >= 4)
+    {
+        if (fgets(s, 1023, fd) == NULL || sscanf(s, "mode: %1023s", s1) != 1)
+        {
+            Log::warn("Replay", "Replay mode not found in replay file, "
+                      "'%s'.", fn);
+            return false;
+        }
+        m_minor_mode = s1;
+    }
+    // Assume time-trial mode for old replays
+    else
+        m_minor_mode = "time-trial";
+
+    // sscanf always stops at whitespaces, but a track name may contain a
+    // whitespace. Official tracks should avoid whitespaces in their name,
+    // but it unavoidably occurs with some addons or WIP tracks.
+    if (fgets(s, 1023, fd) != NULL && std::strncmp(s, "track: ", 7) == 0)
+    {
+        int i = 0;
+        for (i = 7; s[i] != '\0'; i++)
+        {
+            // Break when newline is reached
+            if (s[i] == '\n' || s[i] == '\r')
+                break;
+            s1[i-7] = s[i];
+        }
+        s1[i-7] = '\0';
+
+        if (i >= 8)
+        {
+            m_track_name = std::string(s1);
+        }
+        else
+        {
+            Log::warn("Replay", "Track name is empty in replay file, '%s'.",
+                      fn);
+            return false;
+        }
+    }
+    else
+    {
+        Log::warn("Replay", "Track info not found in replay file, '%s'.",
+                  fn);
+        return false;
+    }
+
+    if (fgets(s, 1023, fd) == NULL || sscanf(s, "laps: %u", &m_laps) != 1)
+    {
+        Log::warn("Replay", "No number of laps found in replay file, "
+                  "'%s'.", fn);
+        return false;
+    }
+
+    if (fgets(s, 1023, fd) == NULL ||
+        sscanf(s, "min_time: %f", &m_min_time) != 1)
+    {
+        Log::warn("Replay", "Finish time not found in replay file, '%s'.",
+                  fn);
+        return false;
+    }
+
+    if (m_version >= 4)
+    {
+        if (fgets(s, 1023, fd) == NULL ||
+            sscanf(s, "replay_uid: %" PRIu64, &m_replay_uid) != 1)
+        {
+            Log::warn("Replay", "Replay UID not found in replay file, "
+                      "'%s'.", fn);
+            return false;
+        }
+    }
+    // No UID in old replay format
+    else
+        m_replay_uid = 0;
+
+    if (header_only)
+        return true;
+
+    for (unsigned int k = 0; k < m_karts.size(); k++)
+    {
+        KartData& kart = m_karts[k];
+        unsigned int size;
+        if (fgets(s, 1023, fd) == NULL || sscanf(s, "size: %u", &size) != 1)
+        {
+            Log::warn("Replay", "Number of records not found in replay file "
+                      "for kart %d.", k);
+            return false;
+        }
+
+        for (unsigned int i = 0; i < size; i++)
+        {
+            if (fgets(s, 1023, fd) == NULL)
+            {
+                Log::warn("Replay", "Replay data of kart %d is incomplete.",
+                          k);
+                return false;
+            }
+            float x, y, z, rx, ry, rz, rw, time, speed, steer, w1, w2, w3, w4,
+                  nitro_amount = 0.0f, distance = 0.0f;
+            int skidding_state = 0, attachment = 0, item_amount = 0,
+                item_type = 0, special_value = 0, nitro, zipper, skidding,
+                red_skidding, jumping;
+            bool valid;
+            // Up to STK 0.9.3 replays
+            if (m_version == 3)
+            {
+                valid = sscanf(s, "%f  %f %f %f  %f %f %f %f  %f  %f  %f %f "
+                    "%f %f  %d %d %d %d %d\n",
+                    &time,
+                    &x, &y, &z,
+                    &rx, &ry, &rz, &rw,
+                    &speed, &steer, &w1, &w2, &w3, &w4,
+                    &nitro, &zipper, &skidding, &red_skidding, &jumping
+                    ) == 19;
+            }
+            // version 4 replays (STK 0.9.4 and higher)
+            else
+            {
+                valid = sscanf(s, "%f  %f %f %f  %f %f %f %f  %f  %f  %f %f "
+                    "%f %f %d  %d %f %d %d %d  %f %d %d %d %d %d\n",
+                    &time,
+                    &x, &y, &z,
+                    &rx, &ry, &rz, &rw,
+                    &speed, &steer, &w1, &w2, &w3, &w4, &skidding_state,
+                    &attachment, &nitro_amount, &item_amount, &item_type,
+                    &special_value,
+                    &distance, &nitro, &zipper, &skidding, &red_skidding,
+                    &jumping
+                    ) == 26;
+            }
+            if (!valid)
+            {
+                // Invalid record found
+                // ---------------------
+                Log::warn("Replay", "Can't read replay data line %d:", i);
+                Log::warn("Replay", "%s", s);
+                Log::warn("Replay", "Ignored.");
+                continue;
+            }
+
+            TransformEvent te;
+            PhysicInfo pi             = {0};
+            BonusInfo bi              = {0};
+            KartReplayEvent kre       = {0};
+
+            te.m_time                 = time;
+            te.m_transform = btTransform(btQuaternion(rx, ry, rz, rw),
+                                         btVector3(x, y, z));
+            pi.m_speed                = speed;
+            pi.m_steer                = steer;
+            pi.m_suspension_length[0] = w1;
+            pi.m_suspension_length[1] = w2;
+            pi.m_suspension_length[2] = w3;
+            pi.m_suspension_length[3] = w4;
+            pi.m_skidding_state       = skidding_state;
+            bi.m_attachment           = attachment;
+            bi.m_nitro_amount         = nitro_amount;
+            bi.m_item_amount          = item_amount;
+            bi.m_item_type            = item_type;
+            bi.m_special_value        = special_value;
+            kre.m_distance            = distance;
+            kre.m_nitro_usage         = nitro;
+            kre.m_zipper_usage        = zipper != 0;
+            kre.m_skidding_effect     = skidding;
+            kre.m_red_skidding        = red_skidding != 0;
+            kre.m_jumping             = jumping != 0;
+            kart.m_transforms.push_back(te);
+            kart.m_physic_info.push_back(pi);
+            kart.m_bonus_info.push_back(bi);
+            kart.m_kart_replay_events.push_back(kre);
+        }   // for i
+    }   // for k
+    return true;
+}   // loadText
+
+// ----------------------------------------------------------------------------
+/** Writes the replay in the text format of replay version 4, which can be
+ *  read by older versions of STK.
+ */
+bool ReplayFile::saveText(const std::string& u8_path) const
+{
+    FILE* fd = FileUtils::fopenU8Path(u8_path, "w");
+    if (!fd)
+    {
+        Log::error("Replay", "Can't open '%s' for writing.",
+                   u8_path.c_str());
+        return false;
+    }
+
+    fprintf(fd, "version: %d\n", 4);
+    // Only version 3 replays have no STK version, they were recorded up to
+    // STK 0.9.3
+    fprintf(fd, "stk_version: %s\n",
+            m_stk_version.empty() ? "0.9.3" : m_stk_version.c_str());
+    for (const KartData& kart : m_karts)
+    {
+        // XML encode the username to handle Unicode
+        if (kart.m_name.empty())
+            fprintf(fd, "kart: %s\n", kart.m_ident.c_str());
+        else
+        {
+            fprintf(fd, "kart: %s %s\n", kart.m_ident.c_str(),
+                    StringUtils::xmlEncode(kart.m_name).c_str());
+        }
+        fprintf(fd, "kart_color: %f\n", kart.m_color);
+    }
+    fprintf(fd, "kart_list_end\n");
+    fprintf(fd, "reverse: %d\n",    (int)m_reverse);
+    fprintf(fd, "difficulty: %d\n", m_difficulty);
+    fprintf(fd, "mode: %s\n",       m_minor_mode.c_str());
+    fprintf(fd, "track: %s\n",      m_track_name.c_str());
+    fprintf(fd, "laps: %d\n",       m_laps);
+    fprintf(fd, "min_time: %f\n",   m_min_time);
+    fprintf(fd, "replay_uid: %" PRIu64 "\n", m_replay_uid);
+
+    for (const KartData& kart : m_karts)
+    {
+        const unsigned int num_transforms =
+            (unsigned int)kart.m_transforms.size();
+        fprintf(fd, "size:     %d\n", num_transforms);
+
+        for (unsigned int i = 0; i < num_transforms; i++)
+        {
+            const TransformEvent *p  = &(kart.m_transforms[i]);
+            const PhysicInfo *q      = &(kart.m_physic_info[i]);
+            const BonusInfo *b       = &(kart.m_bonus_info[i]);
+            const KartReplayEvent *r = &(kart.m_kart_replay_events[i]);
+            fprintf(fd, "%f  %f %f %f  %f %f %f %f  %f  %f  %f %f %f %f %d  "
+                    "%d %f %d %d %d  %f %d %d %d %d %d\n",
+                    p->m_time,
+                    p->m_transform.getOrigin().getX(),
+                    p->m_transform.getOrigin().getY(),
+                    p->m_transform.getOrigin().getZ(),
+                    p->m_transform.getRotation().getX(),
+                    p->m_transform.getRotation().getY(),
+                    p->m_transform.getRotation().getZ(),
+                    p->m_transform.getRotation().getW(),
+                    q->m_speed,
+                    q->m_steer,
+                    q->m_suspension_length[0],
+                    q->m_suspension_length[1],
+                    q->m_suspension_length[2],
+                    q->m_suspension_length[3],
+                    q->m_skidding_state,
+                    b->m_attachment,
+                    b->m_nitro_amount,
+                    b->m_item_amount,
+                    b->m_item_type,
+                    b->m_special_value,
+                    r->m_distance,
+                    r->m_nitro_usage,
+                    (int)r->m_zipper_usage,
+                    r->m_skidding_effect,
+                    (int)r->m_red_skidding,
+                    (int)r->m_jumping
+                );
+        }   // for i
+    }
+    return fclose(fd) == 0;
+}   // saveText
+
+// ----------------------------------------------------------------------------
+/** Stores all values of one event as integers, in the order of the columns.
+ *  \param kart The kart data.
+ *  \param i Index of the event.
+ *  \param values NUM_COLUMNS values.
+ */
+void ReplayFile::getColumns(const KartData& kart, unsigned int i,
+                            int64_t* values)
+{
+    const TransformEvent& p  = kart.m_transforms[i];
+    const PhysicInfo& q      = kart.m_physic_info[i];
+    const BonusInfo& b       = kart.m_bonus_info[i];
+    const KartReplayEvent& r = kart.m_kart_replay_events[i];
+    const btVector3& xyz = p.m_transform.getOrigin();
+    const btQuaternion rotation = p.m_transform.getRotation();
+
+    *values++ = quantize(p.m_time, FLOAT_SCALE);
+    *values++ = quantize(xyz.getX(), FLOAT_SCALE);
+    *values++ = quantize(xyz.getY(), FLOAT_SCALE);
+    *values++ = quantize(xyz.getZ(), FLOAT_SCALE);
+    *values++ = quantize(rotation.getX(), FLOAT_SCALE);
+    *values++ = quantize(rotation.getY(), FLOAT_SCALE);
+    *values++ = quantize(rotation.getZ(), FLOAT_SCALE);
+    *values++ = quantize(rotation.getW(), FLOAT_SCALE);
+    *values++ = quantize(q.m_speed, FLOAT_SCALE);
+    *values++ = quantize(q.m_steer, FLOAT_SCALE);
+    for (unsigned int j = 0; j < 4; j++)
+        *values++ = quantize(q.m_suspension_length[j], FLOAT_SCALE);
+    *values++ = q.m_skidding_state;
+    *values++ = b.m_attachment;
+    *values++ = quantize(b.m_nitro_amount, FLOAT_SCALE);
+    *values++ = b.m_item_amount;
+    *values++ = b.m_item_type;
+    *values++ = b.m_special_value;
+    *values++ = quantize(r.m_distance, FLOAT_SCALE);
+    *values++ = r.m_nitro_usage;
+    *values++ = r.m_zipper_usage;
+    *values++ = r.m_skidding_effect;
+    *values++ = r.m_red_skidding;
+    *values++ = r.m_jumping;
+}   // getColumns
+
+// ----------------------------------------------------------------------------
+/** Sets event i of a kart from the values stored by getColumns. */
+void ReplayFile::setColumns(const int64_t* values, unsigned int i,
+                            KartData* kart)
+{
+    TransformEvent& p  = kart->m_transforms[i];
+    PhysicInfo& q      = kart->m_physic_info[i];
+    BonusInfo& b       = kart->m_bonus_info[i];
+    KartReplayEvent& r = kart->m_kart_replay_events[i];
+
+    p.m_time = dequantize(*values++, FLOAT_SCALE);
+    btVector3 xyz;
+    xyz.setX(dequantize(*values++, FLOAT_SCALE));
+    xyz.setY(dequantize(*values++, FLOAT_SCALE));
+    xyz.setZ(dequantize(*values++, FLOAT_SCALE));
+    btQuaternion rotation;
+    rotation.setX(dequantize(*values++, FLOAT_SCALE));
+    rotation.setY(dequantize(*values++, FLOAT_SCALE));
+    rotation.setZ(dequantize(*values++, FLOAT_SCALE));
+    rotation.setW(dequantize(*values++, FLOAT_SCALE));
+    if (rotation.length2() == 0.0f)
+        rotation = btQuaternion(0.0f, 0.0f, 0.0f, 1.0f);
+    p.m_transform = btTransform(rotation, xyz);
+    q.m_speed = dequantize(*values++, FLOAT_SCALE);
+    q.m_steer = dequantize(*values++, FLOAT_SCALE);
+    for (unsigned int j = 0; j < 4; j++)
+    {
+        q.m_suspension_length[j] =
+            dequantize(*values++, FLOAT_SCALE);
+    }
+    q.m_skidding_state = (int)*values++;
+    b.m_attachment     = (int)*values++;
+    b.m_nitro_amount   = dequantize(*values++, FLOAT_SCALE);
+    b.m_item_amount    = (int)*values++;
+    b.m_item_type      = (int)*values++;
+    b.m_special_value  = (int)*values++;
+    r.m_distance        = dequantize(*values++, FLOAT_SCALE);
+    r.m_nitro_usage     = (int)*values++;
+    r.m_zipper_usage    = *values++ != 0;
+    r.m_skidding_effect = (int)*values++;
+    r.m_red_skidding    = *values++ != 0;
+    r.m_jumping         = *values++ != 0;
+}   // setColumns
+
+// ----------------------------------------------------------------------------
+/** Encodes the replay in the binary format.
+ *  \param buffer The file content is appended to it.
+ */
+void ReplayFile::encodeBinary(std::vector<uint8_t>* buffer) const
+{
+    const uint32_t num_karts = (uint32_t)m_karts.size();
+    BinaryReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, REPLAY_BINARY_MAGIC, sizeof(header.m_magic));
+    header.m_binary_version = REPLAY_BINARY_VERSION;
+    header.m_byte_order     = REPLAY_BYTE_ORDER_MARK;
+    header.m_replay_version = m_version;
+    header.m_num_karts      = num_karts;
+    header.m_replay_uid     = m_replay_uid;
+    header.m_min_time       = m_min_time;
+    header.m_difficulty     = m_difficulty;
+    header.m_laps           = m_laps;
+    header.m_reverse        = m_reverse;
+
+    std::vector<uint8_t> strings;
+    appendString(&strings, m_stk_version);
+    appendString(&strings, m_minor_mode);
+    appendString(&strings, m_track_name);
+    for (const KartData& kart : m_karts)
+    {
+        appendString(&strings, kart.m_ident);
+        appendString(&strings, StringUtils::wideToUtf8(kart.m_name));
+    }
+    header.m_strings_offset = (uint32_t)(sizeof(BinaryReplayHeader) +
+                                         num_karts * sizeof(BinaryReplayKart));
+    header.m_strings_size   = (uint32_t)strings.size();
+
+    std::vector<BinaryReplayKart> table(num_karts);
+    std::vector<uint8_t> events;
+    std::vector<int64_t> values;
+    const uint32_t events_offset =
+        header.m_strings_offset + header.m_strings_size;
+    for (unsigned int k = 0; k < num_karts; k++)
+    {
+        const KartData& kart = m_karts[k];
+        const unsigned int num_events = (unsigned int)kart.m_transforms.size();
+        assert(kart.m_physic_info.size() == num_events &&
+               kart.m_bonus_info.size() == num_events &&
+               kart.m_kart_replay_events.size() == num_events);
+        values.resize(num_events * NUM_COLUMNS);
+        for (unsigned int i = 0; i < num_events; i++)
+            getColumns(kart, i, &values[i * NUM_COLUMNS]);
+
+        table[k].m_color      = kart.m_color;
+        table[k].m_num_events = num_events;
+        table[k].m_offset     = events_offset + (uint32_t)events.size();
+        for (unsigned int c = 0; c < NUM_COLUMNS; c++)
+        {
+            int64_t previous = 0;
+            for (unsigned int i = 0; i < num_events; i++)
+            {
+                const int64_t value = values[i * NUM_COLUMNS + c];
+                appendVarint(&events, zigzag(value - previous));
+                previous = value;
+            }
+        }
+        table[k].m_size = events_offset + (uint32_t)events.size() -
+                          table[k].m_offset;
+    }
+
+    buffer->reserve(buffer->size() + events_offset + events.size());
+    appendToBuffer(buffer, &header);
+    appendToBuffer(buffer, table.data(), table.size());
+    appendToBuffer(buffer, strings.data(), strings.size());
+    appendToBuffer(buffer, events.data(), events.size());
+}   // encodeBinary
+
+// ----------------------------------------------------------------------------
+/** Decodes a replay in the binary format.
+ *  \param data Content of the file, usually memory mapped.
+ *  \param size Size of the file.
+ *  \param header_only Only decode the information about the replay, but
+ *         not the recorded events.
+ *  \return False if the data is not a valid replay.
+ */
+bool ReplayFile::decodeBinary(const uint8_t* data, size_t size,
+                              bool header_only)
+{
+    const char* fn = m_filename.c_str();
+    BinaryReplayHeader header;
+    if (size < sizeof(header))
+        return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.m_magic, REPLAY_BINARY_MAGIC,
+               sizeof(header.m_magic)) != 0 ||
+        header.m_binary_version != REPLAY_BINARY_VERSION ||
+        header.m_byte_order != REPLAY_BYTE_ORDER_MARK)
+    {
+        Log::warn("Replay", "Unsupported binary replay format, skipped "
+                  "'%s'.", fn);
+        return false;
+    }
+    m_version = header.m_replay_version;
+    if (m_version < getMinSupportedReplayVersion() ||
+        m_version > getCurrentReplayVersion())
+    {
+        Log::warn("Replay", "Replay is version '%d', STK replay version is "
+                  "'%d', skipped '%s'", m_version, getCurrentReplayVersion(),
+                  fn);
+        return false;
+    }
+
+    const uint64_t table_end = sizeof(header) +
+        (uint64_t)header.m_num_karts * sizeof(BinaryReplayKart);
+    if (table_end > size || header.m_strings_offset < table_end ||
+        (uint64_t)header.m_strings_offset + header.m_strings_size > size)
+    {
+        Log::warn("Replay", "Corrupted replay file, '%s'.", fn);
+        return false;
+    }
+
+    m_replay_uid = header.m_replay_uid;
+    m_min_time   = header.m_min_time;
+    m_difficulty = header.m_difficulty;
+    m_laps       = header.m_laps;
+    m_reverse    = header.m_reverse != 0;
+
+    const uint8_t* p = data + header.m_strings_offset;
+    const uint8_t* end = p + header.m_strings_size;
+    bool valid = readString(&p, end, &m_stk_version) &&
+                 readString(&p, end, &m_minor_mode) &&
+                 readString(&p, end, &m_track_name);
+    m_karts.resize(header.m_num_karts);
+    std::vector<BinaryReplayKart> table(header.m_num_karts);
+    memcpy(table.data(), data + sizeof(header),
+           table.size() * sizeof(BinaryReplayKart));
+    for (unsigned int k = 0; k < m_karts.size() && valid; k++)
+    {
+        std::string name;
+        valid = readString(&p, end, &m_karts[k].m_ident) &&
+                readString(&p, end, &name);
+        m_karts[k].m_name  = StringUtils::utf8ToWide(name);
+        m_karts[k].m_color = table[k].m_color;
+    }
+    if (!valid || m_track_name.empty())
+    {
+        Log::warn("Replay", "Corrupted replay file, '%s'.", fn);
+        return false;
+    }
+    if (header_only)
+        return true;
+
+    std::vector<int64_t> values;
+    for (unsigned int k = 0; k < m_karts.size(); k++)
+    {
+        const BinaryReplayKart& bk = table[k];
+        // Each value needs at least one byte, which also limits the memory
+        // used for a broken file
+        if ((uint64_t)bk.m_offset + bk.m_size > size ||
+            (uint64_t)bk.m_num_events * NUM_COLUMNS > bk.m_size)
+        {
+            Log::warn("Replay", "Corrupted replay data of kart %d, '%s'.",
+                      k, fn);
+            return false;
+        }
+        const unsigned int num_events = bk.m_num_events;
+        values.resize(num_events * NUM_COLUMNS);
+        p = data + bk.m_offset;
+        end = p + bk.m_size;
+        for (unsigned int c = 0; c < NUM_COLUMNS && valid; c++)
+        {
+            uint64_t previous = 0;
+            for (unsigned int i = 0; i < num_events; i++)
+            {
+                uint64_t delta;
+                if (!readVarint(&p, end, &delta))
+                {
+                    valid = false;
+                    break;
+                }
+                previous += (uint64_t)unzigzag(delta);
+                values[i * NUM_COLUMNS + c] = (int64_t)previous;
+            }
+        }
+        if (!valid || p != end)
+        {
+            Log::warn("Replay", "Corrupted replay data of kart %d, '%s'.",
+                      k, fn);
+            return false;
+        }
+
+        KartData& kart = m_karts[k];
+        kart.m_transforms.resize(num_events);
+        kart.m_physic_info.resize(num_events);
+        kart.m_bonus_info.resize(num_events);
+        kart.m_kart_replay_events.resize(num_events);
+        for (unsigned int i = 0; i < num_events; i++)
+            setColumns(&values[i * NUM_COLUMNS], i, &kart);
+    }
+    return true;
+}   // decodeBinary
+
+// ----------------------------------------------------------------------------
+bool ReplayFile::saveBinary(const std::string& u8_path) const
+{
+    std::vector<uint8_t> buffer;
+    encodeBinary(&buffer);
+    FILE* fd = FileUtils::fopenU8Path(u8_path, "wb");
+    if (!fd)
+    {
+        Log::error("Replay", "Can't open '%s' for writing.",
+                   u8_path.c_str());
+        return false;
+    }
+    bool ok = fwrite(buffer.data(), buffer.size(), 1, fd) == 1;
+    ok &= fclose(fd) == 0;
+    if (!ok)
+        Log::error("Replay", "Failed to write '%s'.", u8_path.c_str());
+    return ok;
+}   // saveBinary
+
+// ----------------------------------------------------------------------------
+/** Converts a replay in the text format into the binary format, or a binary
+ *  replay back into the text format (e.g. for older versions of STK). The
+ *  result is saved next to the original file, with "-binary" or "-text"
+ *  added to its name.
+ *  \param u8_path Full path of the replay to convert.
+ */
+bool ReplayFile::convert(const std::string& u8_path)
+{
+    ReplayFile file;
+    if (!file.load(u8_path, /*header_only*/false))
+    {
+        Log::error("Replay", "Can't read replay '%s'.", u8_path.c_str());
+        return false;
+    }
+    // Version 3 replays have no UID, which version 4 requires
+    if (file.m_version < 4)
+    {
+        file.m_version = 4;
+        file.m_replay_uid = MappedFile::hashFile(u8_path);
+    }
+
+    const std::string out = StringUtils::removeExtension(u8_path) +
+        (file.isBinary() ? "-text.replay" : "-binary.replay");
+    const bool ok = file.isBinary() ? file.saveText(out)
+                                    : file.saveBinary(out);
+    if (!ok)
+        return false;
+    struct stat in_stat, out_stat;
+    if (FileUtils::statU8Path(u8_path, &in_stat) == 0 &&
+        FileUtils::statU8Path(out, &out_stat) == 0)
+    {
+        Log::info("Replay", "Converted '%s' (%u bytes) into '%s' (%u "
+                  "bytes).", u8_path.c_str(), (unsigned)in_stat.st_size,
+                  out.c_str(), (unsigned)out_stat.st_size);
+    }
+    return true;
+}   // convert
+
+// ----------------------------------------------------------------------------
+void ReplayFile::unitTesting()
+{
+    ReplayFile replay;
+    replay.m_stk_version = "1.5";
+    replay.m_reverse     = true;
+    replay.m_difficulty  = 3;
+    replay.m_minor_mode  = "time-trial";
+    replay.m_track_name  = "black forest";
+    replay.m_laps        = 2;
+    replay.m_min_time    = 73.286743f;
+    replay.m_replay_uid  = 564944495606616311ULL;
+    replay.m_karts.resize(2);
+    for (unsigned int k = 0; k < 2; k++)
+    {
+        KartData& kart = replay.m_karts[k];
+        kart.m_ident = k == 0 ? "pidgin" : "tux";
+        kart.m_name  = k == 0 ? L"☆ player" : L"";
+        kart.m_color = 0.65f * k;
+        for (unsigned int i = 0; i < 500; i++)
+        {
+            TransformEvent te;
+            PhysicInfo pi       = {0};
+            BonusInfo bi        = {0};
+            KartReplayEvent kre = {0};
+            te.m_time = i * 0.05f + k * 0.0125f;
+            btQuaternion q(btVector3(0, 1, 0), i * 0.01f);
+            te.m_transform = btTransform(q,
+                btVector3(-106.975f + i * 0.3f, 6.2f + sinf(i * 0.1f),
+                          65.9f - i * 0.25f));
+            pi.m_speed = 5.5f + i * 0.01f;
+            pi.m_steer = sinf(i * 0.2f);
+            for (unsigned int j = 0; j < 4; j++)
+                pi.m_suspension_length[j] = 0.29f - j * 0.001f;
+            pi.m_skidding_state = i % 50 < 10 ? 1 : 0;
+            bi.m_attachment     = i > 200 ? 3 : 0;
+            bi.m_nitro_amount   = i * 0.1f;
+            bi.m_item_amount    = 1;
+            bi.m_item_type      = 4;
+            bi.m_special_value  = -1;
+            // The distance can start with a big negative value
+            kre.m_distance      = i == 0 ? -2613.376221f : i * 0.3f;
+            kre.m_zipper_usage  = i % 7 == 0;
+            kre.m_jumping       = i % 11 == 0;
+            kart.m_transforms.push_back(te);
+            kart.m_physic_info.push_back(pi);
+            kart.m_bonus_info.push_back(bi);
+            kart.m_kart_replay_events.push_back(kre);
+        }
+    }
+
+    std::vector<uint8_t> buffer;
+    replay.encodeBinary(&buffer);
+    // Smaller than the values as floats
+    assert(buffer.size() < 2 * 500 * NUM_COLUMNS * sizeof(float));
+
+    ReplayFile header_only;
+    bool success = header_only.decodeBinary(buffer.data(), buffer.size(),
+                                            /*header_only*/true);
+    assert(success);
+    assert(header_only.m_karts.size() == 2);
+    assert(header_only.m_karts[0].m_transforms.empty());
+    assert(header_only.m_track_name == "black forest");
+
+    ReplayFile decoded;
+    success = decoded.decodeBinary(buffer.data(), buffer.size(),
+                                   /*header_only*/false);
+    assert(success);
+    (void)success;
+    assert(decoded.m_version == replay.m_version);
+    assert(decoded.m_stk_version == "1.5");
+    assert(decoded.m_reverse && decoded.m_difficulty == 3);
+    assert(decoded.m_minor_mode == "time-trial");
+    assert(decoded.m_laps == 2);
+    assert(decoded.m_min_time == replay.m_min_time);
+    assert(decoded.m_replay_uid == replay.m_replay_uid);
+    for (unsigned int k = 0; k < 2; k++)
+    {
+        const KartData& a = replay.m_karts[k];
+        const KartData& b = decoded.m_karts[k];
+        assert(a.m_ident == b.m_ident && a.m_name == b.m_name);
+        assert(a.m_color == b.m_color);
+        assert(b.m_transforms.size() == 500);
+        for (unsigned int i = 0; i < 500; i++)
+        {
+            const TransformEvent& ta = a.m_transforms[i];
+            const TransformEvent& tb = b.m_transforms[i];
+            (void)ta;
+            (void)tb;
+            assert(fabsf(ta.m_time - tb.m_time) < 1e-5f);
+            assert((ta.m_transform.getOrigin() -
+                    tb.m_transform.getOrigin()).length() < 1e-4f);
+            assert(fabsf(ta.m_transform.getRotation()
+                         .dot(tb.m_transform.getRotation())) > 0.99999f);
+            assert(fabsf(a.m_physic_info[i].m_steer -
+                         b.m_physic_info[i].m_steer) < 1e-5f);
+            assert(b.m_physic_info[i].m_skidding_state ==
+                   a.m_physic_info[i].m_skidding_state);
+            assert(b.m_bonus_info[i].m_attachment ==
+                   a.m_bonus_info[i].m_attachment);
+            assert(b.m_bonus_info[i].m_special_value == -1);
+            assert(fabsf(a.m_kart_replay_events[i].m_distance -
+                         b.m_kart_replay_events[i].m_distance) < 1e-4f);
+            assert(b.m_kart_replay_events[i].m_zipper_usage ==
+                   a.m_kart_replay_events[i].m_zipper_usage);
+            assert(b.m_kart_replay_events[i].m_jumping ==
+                   a.m_kart_replay_events[i].m_jumping);
+        }
+    }
+
+    // Truncated or corrupted files must be detected
+    ReplayFile broken;
+    success = broken.decodeBinary(buffer.data(), buffer.size() - 1, false);
+    assert(!success);
+    buffer[0] = 'X';
+    success = broken.decodeBinary(buffer.data(), buffer.size(), true);
+    assert(!success);
+}   // unitTesting
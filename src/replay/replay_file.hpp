@@ -0,0 +1,112 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_REPLAY_FILE_HPP
+#define HEADER_REPLAY_FILE_HPP
+
+#include "replay/replay_base.hpp"
+
+#include "irrString.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace irr;
+
+/**
+  * \brief The contents of a replay file, which is either in the old text
+  *  format or in the binary format.
+  *  The binary format starts with a fixed header and a table of all karts,
+  *  followed by the strings and the recorded events of each kart. The
+  *  events of a kart are stored column by column (all times, then all x
+  *  coordinates, ...), each value as a varint of the difference to the
+  *  previous event. Floats are stored with the 6 decimals of the text
+  *  format, so both formats have the same precision. Binary files are read
+  *  through a memory mapping.
+  * \ingroup replay
+  */
+class ReplayFile : public ReplayBase
+{
+public:
+    /** All recorded data of one kart. */
+    struct KartData
+    {
+        std::string                  m_ident;
+        /** Name of the player, empty to use the name of the kart. */
+        core::stringw                m_name;
+        float                        m_color;
+        std::vector<TransformEvent>  m_transforms;
+        std::vector<PhysicInfo>      m_physic_info;
+        std::vector<BonusInfo>       m_bonus_info;
+        std::vector<KartReplayEvent> m_kart_replay_events;
+    };   // KartData
+
+    unsigned int          m_version;
+    std::string           m_stk_version;
+    std::vector<KartData> m_karts;
+    bool                  m_reverse;
+    unsigned int          m_difficulty;
+    std::string           m_minor_mode;
+    std::string           m_track_name;
+    unsigned int          m_laps;
+    float                 m_min_time;
+    /** Unique id of the replay, 0 for version 3 replays without one. */
+    uint64_t              m_replay_uid;
+
+private:
+    std::string m_filename;
+
+    bool m_binary;
+
+    // ------------------------------------------------------------------------
+    bool loadText(FILE* fd, bool header_only);
+    // ------------------------------------------------------------------------
+    static void getColumns(const KartData& kart, unsigned int i,
+                           int64_t* values);
+    // ------------------------------------------------------------------------
+    static void setColumns(const int64_t* values, unsigned int i,
+                           KartData* kart);
+
+public:
+    // ------------------------------------------------------------------------
+    ReplayFile();
+    // ------------------------------------------------------------------------
+    bool load(const std::string& u8_path, bool header_only);
+    // ------------------------------------------------------------------------
+    void encodeBinary(std::vector<uint8_t>* buffer) const;
+    // ------------------------------------------------------------------------
+    bool decodeBinary(const uint8_t* data, size_t size, bool header_only);
+    // ------------------------------------------------------------------------
+    bool saveBinary(const std::string& u8_path) const;
+    // ------------------------------------------------------------------------
+    bool saveText(const std::string& u8_path) const;
+    // ------------------------------------------------------------------------
+    /** Returns true if the loaded file was in the binary format. */
+    bool isBinary() const                                 { return m_binary; }
+    // ------------------------------------------------------------------------
+    /** Returns the filename that was loaded. */
+    virtual const std::string& getReplayFilename(int replay_file_number = 1)
+        const                                           { return m_filename; }
+    // ------------------------------------------------------------------------
+    static bool convert(const std::string& u8_path);
+    // ------------------------------------------------------------------------
+    static void unitTesting();
+};   // ReplayFile
+
+#endif
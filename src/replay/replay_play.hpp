@@ -20,6 +20,7 @@
 #define HEADER_REPLAY__PLAY_HPP
 
 #include "replay/replay_base.hpp"
+#include "replay/replay_file.hpp"
 #include "tracks/track.hpp"
 
 #include "irrString.h"
@@ -124,7 +125,7 @@ private:
 
           ReplayPlay();
          ~ReplayPlay();
-    void  readKartData(FILE *fd, char *next_line, bool second_replay);
+    void  readKartData(const ReplayFile::KartData& kart, bool second_replay);
 public:
     void  reset();
     void  load();
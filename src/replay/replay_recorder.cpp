@@ -33,6 +33,7 @@
 #include "modes/world.hpp"
 #include "physics/btKart.hpp"
 #include "race/race_manager.hpp"
+#include "replay/replay_file.hpp"
 #include "tracks/track.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/translation.hpp"
@@ -40,7 +41,6 @@
 #include <algorithm>
 #include <stdio.h>
 #include <string>
-#include <cinttypes>
 
 ReplayRecorder *ReplayRecorder::m_replay_recorder = NULL;
 
@@ -383,38 +383,37 @@ void ReplayRecorder::save()
         << "_" << num_karts << "_" << time << ".replay";
     m_filename = oss.str();
 
-    FILE *fd = openReplayFile(/*writeable*/true);
-    if (!fd)
-    {
-        Log::error("ReplayRecorder", "Can't open '%s' for writing - "
-            "can't save replay data.", getReplayFilename().c_str());
-        return;
-    }
-
-    core::stringw msg = _("Replay saved in \"%s\".",
-        StringUtils::utf8ToWide(file_manager->getReplayDir() + getReplayFilename()));
-    MessageQueue::add(MessageQueue::MT_GENERIC, msg);
-
-    fprintf(fd, "version: %d\n", getCurrentReplayVersion());
-    fprintf(fd, "stk_version: %s\n", STK_VERSION);
+    ReplayFile file;
+    file.m_stk_version = STK_VERSION;
 
     unsigned int player_count = 0;
-    for (unsigned int real_karts = 0; real_karts < num_karts; real_karts++)
+    for (unsigned int k = 0; k < num_karts; k++)
     {
-        const AbstractKart *kart = world->getKart(real_karts);
+        const AbstractKart *kart = world->getKart(k);
         if (kart->isGhostKart()) continue;
 
-        // XML encode the username to handle Unicode
-        fprintf(fd, "kart: %s %s\n", kart->getIdent().c_str(),
-                StringUtils::xmlEncode(kart->getController()->getName()).c_str());
-
+        ReplayFile::KartData data;
+        data.m_ident = kart->getIdent();
+        data.m_name  = kart->getController()->getName();
+        data.m_color = 0.0f;
         if (kart->getController()->isPlayerController())
         {
-            fprintf(fd, "kart_color: %f\n", StateManager::get()->getActivePlayer(player_count)->getConstProfile()->getDefaultKartColor());
+            data.m_color = StateManager::get()->getActivePlayer(player_count)
+                                 ->getConstProfile()->getDefaultKartColor();
             player_count++;
         }
-        else
-            fprintf(fd, "kart_color: 0\n");
+
+        const unsigned int num_transforms = std::min(m_max_frames,
+                                                     m_count_transforms[k]);
+        data.m_transforms.assign(m_transform_events[k].begin(),
+            m_transform_events[k].begin() + num_transforms);
+        data.m_physic_info.assign(m_physic_info[k].begin(),
+            m_physic_info[k].begin() + num_transforms);
+        data.m_bonus_info.assign(m_bonus_info[k].begin(),
+            m_bonus_info[k].begin() + num_transforms);
+        data.m_kart_replay_events.assign(m_kart_replay_event[k].begin(),
+            m_kart_replay_event[k].begin() + num_transforms);
+        file.m_karts.push_back(data);
     }
 
     m_last_uid = computeUID(min_time);
@@ -422,61 +421,24 @@ void ReplayRecorder::save()
     int num_laps = RaceManager::get()->getNumLaps();
     if (num_laps == 9999) num_laps = 0; // no lap in that race mode
 
-    fprintf(fd, "kart_list_end\n");
-    fprintf(fd, "reverse: %d\n",    (int)RaceManager::get()->getReverseTrack());
-    fprintf(fd, "difficulty: %d\n", RaceManager::get()->getDifficulty());
-    fprintf(fd, "mode: %s\n",       RaceManager::get()->getMinorModeName().c_str());
-    fprintf(fd, "track: %s\n",      Track::getCurrentTrack()->getIdent().c_str());
-    fprintf(fd, "laps: %d\n",       num_laps);
-    fprintf(fd, "min_time: %f\n",   min_time);
-    fprintf(fd, "replay_uid: %" PRIu64 "\n", m_last_uid);
+    file.m_reverse    = RaceManager::get()->getReverseTrack();
+    file.m_difficulty = RaceManager::get()->getDifficulty();
+    file.m_minor_mode = RaceManager::get()->getMinorModeName();
+    file.m_track_name = Track::getCurrentTrack()->getIdent();
+    file.m_laps       = num_laps;
+    file.m_min_time   = min_time;
+    file.m_replay_uid = m_last_uid;
 
-    for (unsigned int k = 0; k < num_karts; k++)
+    if (!file.saveBinary(file_manager->getReplayDir() + getReplayFilename()))
     {
-        if (world->getKart(k)->isGhostKart()) continue;
-
-        const unsigned int num_transforms = std::min(m_max_frames,
-                                                     m_count_transforms[k]);
-
-        fprintf(fd, "size:     %d\n", num_transforms);
-
-        for (unsigned int i = 0; i < num_transforms; i++)
-        {
-            const TransformEvent *p  = &(m_transform_events[k][i]);
-            const PhysicInfo *q      = &(m_physic_info[k][i]);
-            const BonusInfo *b      = &(m_bonus_info[k][i]);
-            const KartReplayEvent *r = &(m_kart_replay_event[k][i]);
-            fprintf(fd, "%f  %f %f %f  %f %f %f %f  %f  %f  %f %f %f %f %d  %d %f %d %d %d  %f %d %d %d %d %d\n",
-                    p->m_time,
-                    p->m_transform.getOrigin().getX(),
-                    p->m_transform.getOrigin().getY(),
-                    p->m_transform.getOrigin().getZ(),
-                    p->m_transform.getRotation().getX(),
-                    p->m_transform.getRotation().getY(),
-                    p->m_transform.getRotation().getZ(),
-                    p->m_transform.getRotation().getW(),
-                    q->m_speed,
-                    q->m_steer,
-                    q->m_suspension_length[0],
-                    q->m_suspension_length[1],
-                    q->m_suspension_length[2],
-                    q->m_suspension_length[3],
-                    q->m_skidding_state,
-                    b->m_attachment,
-                    b->m_nitro_amount,
-                    b->m_item_amount,
-                    b->m_item_type,
-                    b->m_special_value,
-                    r->m_distance,
-                    r->m_nitro_usage,
-                    (int)r->m_zipper_usage,
-                    r->m_skidding_effect,
-                    (int)r->m_red_skidding,
-                    (int)r->m_jumping
-                );
-        }   // for i
+        Log::error("ReplayRecorder", "Can't open '%s' for writing - "
+            "can't save replay data.", getReplayFilename().c_str());
+        return;
     }
-    fclose(fd);
+
+    core::stringw msg = _("Replay saved in \"%s\".",
+        StringUtils::utf8ToWide(file_manager->getReplayDir() + getReplayFilename()));
+    MessageQueue::add(MessageQueue::MT_GENERIC, msg);
 }   // save
 
 /* Returns an encoding value for a given attachment type.
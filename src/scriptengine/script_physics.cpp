@@ -19,7 +19,6 @@
 #include <assert.h>
 #include <angelscript.h>
 #include "script_physics.hpp"
-#include "graphics/explosion.hpp"
 #include "graphics/hit_effect.hpp"
 #include "guiengine/engine.hpp"
 #include "items/projectile_manager.hpp"
@@ -37,7 +36,8 @@ namespace Scripting
             if (GUIEngine::isNoGraphics())
                 return;
             Vec3 *explosion_loc = (Vec3*)gen->GetArgAddress(0);
-            HitEffect *he = new Explosion(*explosion_loc, "explosion", "explosion_bomb.xml");
+            HitEffect *he = ProjectileManager::get()->newExplosion(
+                *explosion_loc, "explosion", "explosion_bomb.xml");
             ProjectileManager::get()->addHitEffect(he);
         }
         void registerScriptFunctions(asIScriptEngine *engine)
@@ -26,20 +26,21 @@
 #include "tracks/track.hpp"
 #include "tracks/track_manager.hpp"
 #include "utils/log.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/time.hpp"
 
 #include <algorithm>
-#include <queue>
+#include <cmath>
 
 // -----------------------------------------------------------------------------
 ArenaGraph::ArenaGraph(const std::string &navmesh, const XMLNode *node)
           : Graph()
 {
     loadNavmesh(navmesh);
-    buildGraph();
-    // Compute shortest distance from all nodes
-    for (unsigned int i = 0; i < getNumNodes(); i++)
-        computeDijkstra(i);
-
+    // Shortest paths are only computed when needed (or loaded from the disk
+    // cache), see ArenaPathCache
+    m_path_cache = new ArenaPathCache(this, MappedFile::hashFile(navmesh),
+                                      UserConfigParams::m_cache_graphs);
     setNearbyNodesOfAllNodes();
     if (node && RaceManager::get()->getMinorMode() == RaceManager::MINOR_MODE_SOCCER)
         loadGoalNodes(node);
@@ -48,6 +49,12 @@ ArenaGraph::ArenaGraph(const std::string &navmesh, const XMLNode *node)
 
 }   // ArenaGraph
 
+// -----------------------------------------------------------------------------
+ArenaGraph::~ArenaGraph()
+{
+    delete m_path_cache;
+}   // ~ArenaGraph
+
 // -----------------------------------------------------------------------------
 ArenaNode* ArenaGraph::getNode(unsigned int i) const
 {
@@ -175,11 +182,16 @@ void ArenaGraph::loadNavmesh(const std::string &navmesh)
 }   // loadNavmesh
 
 // ----------------------------------------------------------------------------
-void ArenaGraph::buildGraph()
+/** Creates the full distance and parent matrices from the adjacency of the
+ *  navmesh. THIS FUNCTION IS ONLY USED FOR UNIT-TESTING, together with
+ *  computeFloydWarshall() to verify the shortest paths of ArenaPathCache.
+ */
+void ArenaGraph::buildGraph(std::vector<std::vector<float> >* distance_matrix,
+                       std::vector<std::vector<int16_t> >* parent_node) const
 {
     const unsigned int n_nodes = getNumNodes();
 
-    m_distance_matrix = std::vector<std::vector<float>>
+    *distance_matrix = std::vector<std::vector<float>>
         (n_nodes, std::vector<float>(n_nodes, 9999.9f));
     for (unsigned int i = 0; i < n_nodes; i++)
     {
@@ -188,95 +200,43 @@ void ArenaGraph::buildGraph()
         {
             Vec3 diff = getNode(adjacent)->getCenter() - cur_node->getCenter();
             float distance = diff.length();
-            m_distance_matrix[i][adjacent] = distance;
+            (*distance_matrix)[i][adjacent] = distance;
         }
-        m_distance_matrix[i][i] = 0.0f;
+        (*distance_matrix)[i][i] = 0.0f;
     }
 
     // Allocate and initialise the previous node data structure:
-    m_parent_node = std::vector<std::vector<int16_t>>
+    *parent_node = std::vector<std::vector<int16_t>>
         (n_nodes, std::vector<int16_t>(n_nodes, Graph::UNKNOWN_SECTOR));
     for (unsigned int i = 0; i < n_nodes; i++)
     {
         for (unsigned int j = 0; j < n_nodes; j++)
         {
-            if (i == j || m_distance_matrix[i][j] >= 9899.9f)
-                m_parent_node[i][j] = -1;
+            if (i == j || (*distance_matrix)[i][j] >= 9899.9f)
+                (*parent_node)[i][j] = -1;
             else
-                m_parent_node[i][j] = i;
+                (*parent_node)[i][j] = i;
         }   // for j
     }   // for i
 
 }   // buildGraph
 
 // ----------------------------------------------------------------------------
-/** Dijkstra shortest path computation. It computes the shortest distance from
- *  the specified node 'source' to all other nodes. At the end of the
- *  computation, m_distance_matrix[i][j] stores the shortest path distance from
- *  source to j and m_parent_node[source][j] stores the last vertex visited on
- *  the shortest path from i to j before visiting j. Suppose the shortest path
- *  from i to j is i->......->k->j  then m_parent_node[i][j] = k
- */
-void ArenaGraph::computeDijkstra(int source)
-{
-    // Stores the distance (float) to 'source' from a specified node (int)
-    typedef std::pair<int, float> IndDistPair;
-
-    class Shortest
-    {
-    public:
-        bool operator()(const IndDistPair &p1, const IndDistPair &p2)
-        {
-            return p1.second > p2.second;
-        }
-    };
-
-    std::priority_queue<IndDistPair, std::vector<IndDistPair>, Shortest> queue;
-    IndDistPair begin(source, 0.0f);
-    queue.push(begin);
-    const unsigned int n = getNumNodes();
-    std::vector<bool> visited;
-    visited.resize(n, false);
-    while (!queue.empty())
-    {
-        // Get element with shortest path
-        IndDistPair current = queue.top();
-        queue.pop();
-        int cur_index = current.first;
-        if (visited[cur_index]) continue;
-        visited[cur_index] = true;
-
-        for (const int& adjacent : getNode(cur_index)->getAdjacentNodes())
-        {
-            // Distance already computed, can be ignored
-            if (visited[adjacent]) continue;
-
-            float new_dist =
-                current.second + m_distance_matrix[cur_index][adjacent];
-            if (new_dist < m_distance_matrix[source][adjacent])
-            {
-                m_distance_matrix[source][adjacent] = new_dist;
-                m_parent_node[source][adjacent] = cur_index;
-            }
-            IndDistPair pair(adjacent, new_dist);
-            queue.push(pair);
-        }
-    }
-}   // computeDijkstra
-
-// ----------------------------------------------------------------------------
-/** THIS FUNCTION IS ONLY USED FOR UNIT-TESTING, to verify that the new
- *  Dijkstra algorithm gives the same results.
+/** THIS FUNCTION IS ONLY USED FOR UNIT-TESTING, to verify that the
+ *  Dijkstra algorithm in ArenaPathCache gives the same results.
  *  computeFloydWarshall() computes the shortest distance between any two
- *  nodes. At the end of the computation, m_distance_matrix[i][j] stores the
- *  shortest path distance from i to j and m_parent_node[i][j] stores the last
+ *  nodes. At the end of the computation, distance_matrix[i][j] stores the
+ *  shortest path distance from i to j and parent_node[i][j] stores the last
  *  vertex visited on the shortest path from i to j before visiting j. Suppose
  *  the shortest path from i to j is i->......->k->j  then
- *  m_parent_node[i][j] = k
+ *  parent_node[i][j] = k
  */
-void ArenaGraph::computeFloydWarshall()
+void ArenaGraph::computeFloydWarshall(
+                       std::vector<std::vector<float> >* distance_matrix,
+                       std::vector<std::vector<int16_t> >* parent_node) const
 {
     unsigned int n = getNumNodes();
+    std::vector<std::vector<float> >& dist = *distance_matrix;
 
     for (unsigned int k = 0; k < n; k++)
     {
@@ -284,12 +244,10 @@ void ArenaGraph::computeFloydWarshall()
         {
             for (unsigned int j = 0; j < n; j++)
             {
-                if ((m_distance_matrix[i][k] + m_distance_matrix[k][j]) <
-                    m_distance_matrix[i][j])
+                if ((dist[i][k] + dist[k][j]) < dist[i][j])
                 {
-                    m_distance_matrix[i][j] =
-                        m_distance_matrix[i][k] + m_distance_matrix[k][j];
-                    m_parent_node[i][j] = m_parent_node[k][j];
+                    dist[i][j] = dist[i][k] + dist[k][j];
+                    (*parent_node)[i][j] = (*parent_node)[k][j];
                 }
             }
         }
@@ -344,24 +302,11 @@ void ArenaGraph::setNearbyNodesOfAllNodes()
 {
     // Only save the nearby 8 nodes
     const unsigned int try_count = 8;
+    std::vector<int> nearby_nodes;
     for (unsigned int i = 0; i < getNumNodes(); i++)
     {
-        // Get the distance to all nodes at i
-        ArenaNode* cur_node = getNode(i);
-        std::vector<int> nearby_nodes;
-        std::vector<float> dist = m_distance_matrix[i];
-
-        // Skip the same node
-        dist[i] = 999999.0f;
-        for (unsigned int j = 0; j < try_count; j++)
-        {
-            std::vector<float>::iterator it =
-                std::min_element(dist.begin(), dist.end());
-            const int pos = int(it - dist.begin());
-            nearby_nodes.push_back(pos);
-            dist[pos] = 999999.0f;
-        }
-        cur_node->setNearbyNodes(nearby_nodes);
+        m_path_cache->findNearestNodes(i, try_count, &nearby_nodes);
+        getNode(i)->setNearbyNodes(nearby_nodes);
     }
 
 }   // setNearbyNodesOfAllNodes
@@ -384,46 +329,75 @@ std::vector<int16_t> ArenaGraph::getPathFromTo(int from, int to,
 }   // getPathFromTo
 
 // ============================================================================
-/** Unit testing for arena graph distance and parent node computation.
- *  Instead of using hand-tuned test cases we use the tested, verified and
- *  easier to understand Floyd-Warshall algorithm to compute the distances,
- *  and check if the (significanty faster) Dijkstra algorithm gives the same
- *  results. For now we use the cave mesh as test case.
+/** Unit testing and benchmark for arena graph distance and parent node
+ *  computation. Instead of using hand-tuned test cases we use the tested,
+ *  verified and easier to understand Floyd-Warshall algorithm to compute the
+ *  full distance matrix (as was done when loading an arena before the paths
+ *  were computed on demand), and check if the (significanty faster) Dijkstra
+ *  algorithm of ArenaPathCache gives the same results. For now we use the
+ *  cave mesh as test case.
  */
 void ArenaGraph::unitTesting()
 {
     Track *track = track_manager->getTrack("cave");
     std::string navmesh_file_name=track->getTrackFile("navmesh.xml");
 
+    // Disable the disk cache, so all paths are really computed
+    bool cache_graphs = UserConfigParams::m_cache_graphs;
+    UserConfigParams::m_cache_graphs = false;
     double s = StkTime::getRealTime();
     ArenaGraph* ag = new ArenaGraph(navmesh_file_name);
     double e = StkTime::getRealTime();
-    Log::error("Time", "Dijkstra       %lf", e-s);
+    UserConfigParams::m_cache_graphs = cache_graphs;
+    Log::info("Time", "Loading (on demand) %lf", e-s);
 
-    // Save the Dijkstra results
-    std::vector< std::vector< float > > distance_matrix = ag->m_distance_matrix;
-    std::vector< std::vector< int16_t > > parent_node = ag->m_parent_node;
-    ag->buildGraph();
+    s = StkTime::getRealTime();
+    ag->m_path_cache->computeAllRows();
+    e = StkTime::getRealTime();
+    Log::info("Time", "Dijkstra all nodes  %lf", e-s);
 
     // Now compute results with Floyd-Warshall
+    std::vector< std::vector< float > > distance_matrix;
+    std::vector< std::vector< int16_t > > parent_node;
     s = StkTime::getRealTime();
-    ag->computeFloydWarshall();
+    ag->buildGraph(&distance_matrix, &parent_node);
+    ag->computeFloydWarshall(&distance_matrix, &parent_node);
     e = StkTime::getRealTime();
-    Log::error("Time", "Floyd-Warshall %lf", e-s);
+    Log::info("Time", "Floyd-Warshall      %lf", e-s);
+
+    const unsigned int n = ag->getNumNodes();
+    Log::info("ArenaGraph", "%d nodes, full matrices: %d KB, path cache "
+              "with all nodes computed: %d KB.", n,
+              int(n * n * (sizeof(float) + sizeof(int16_t)) / 1024),
+              int(ag->m_path_cache->getMemoryUsage() / 1024));
 
     int error_count = 0;
-    for(unsigned int i=0; i<ag->m_distance_matrix.size(); i++)
+    for(unsigned int i=0; i<n; i++)
     {
-        for(unsigned int j=0; j<ag->m_distance_matrix[i].size(); j++)
+        for(unsigned int j=0; j<n; j++)
         {
-            if(ag->m_distance_matrix[i][j] - distance_matrix[i][j] > 0.001f)
+            const float dijkstra = ag->m_path_cache->getDistance(i, j);
+            if(fabsf(distance_matrix[i][j] - dijkstra) > 0.001f)
             {
                 Log::error("ArenaGraph",
                            "Incorrect distance %d, %d: Dijkstra: %f F.W.: %f",
-                           i, j, distance_matrix[i][j], ag->m_distance_matrix[i][j]);
+                           i, j, dijkstra, distance_matrix[i][j]);
                 error_count++;
             }    // if distance is too different
 
+            // Following the next nodes must lead to the target
+            int node = i;
+            unsigned int steps = 0;
+            while (node != (int)j && node != Graph::UNKNOWN_SECTOR &&
+                   steps++ < n)
+                node = ag->getNextNode(node, j);
+            if (node != (int)j && dijkstra < 9899.9f)
+            {
+                Log::error("ArenaGraph", "Next node from %d doesn't lead "
+                           "to %d.", i, j);
+                error_count++;
+            }
+
             // Unortunately it happens frequently that there are different
             // shortest path with the same length. And Dijkstra might find
             // a different path then Floyd-Warshall. So the test for parent
@@ -432,16 +406,20 @@ void ArenaGraph::unitTesting()
             // debugging in the feature
 #undef TEST_PARENT_POLY_EVEN_THOUGH_MANY_FALSE_POSITIVES
 #ifdef TEST_PARENT_POLY_EVEN_THOUGH_MANY_FALSE_POSITIVES
-            if(ag->m_parent_node[i][j] != parent_node[i][j])
+            if(ag->m_path_cache->getParent(i, j) != parent_node[i][j])
             {
                 error_count++;
-                std::vector<int16_t> dijkstra_path = getPathFromTo(i, j, parent_node);
-                std::vector<int16_t> floyd_path = getPathFromTo(i, j, ag->m_parent_node);
+                std::vector< std::vector< int16_t > > dijkstra_parent
+                    (n, std::vector<int16_t>(n));
+                for (unsigned k = 0; k < n; k++)
+                    dijkstra_parent[i][k] = ag->m_path_cache->getParent(i, k);
+                std::vector<int16_t> dijkstra_path = getPathFromTo(i, j, dijkstra_parent);
+                std::vector<int16_t> floyd_path = getPathFromTo(i, j, parent_node);
                 if(dijkstra_path.size()!=floyd_path.size())
                 {
                     Log::error("ArenaGraph",
                                "Incorrect path length %d, %d: Dijkstra: %d F.W.: %d",
-                               i, j, parent_node[i][j], ag->m_parent_node[i][j]);
+                               i, j, dijkstra_parent[i][j], parent_node[i][j]);
                     continue;
                 }
                 Log::error("ArenaGraph", "Path problems from %d to %d:",
@@ -459,6 +437,33 @@ void ArenaGraph::unitTesting()
         }   // for j
     }   // for i
 
+    // The nearby nodes found with the bounded search must be the same as
+    // the ones found with the full distance matrix
+    for (unsigned int i = 0; i < n; i++)
+    {
+        std::vector<float> dist = distance_matrix[i];
+        dist[i] = 999999.0f;
+        std::vector<int>* nearby = ag->getNode(i)->getNearbyNodes();
+        for (unsigned int j = 0; j < nearby->size(); j++)
+        {
+            std::vector<float>::iterator it =
+                std::min_element(dist.begin(), dist.end());
+            const int pos = int(it - dist.begin());
+            // Ties with the same distance can be found in any order
+            if ((*nearby)[j] != pos &&
+                fabsf(dist[pos] - dist[(*nearby)[j]]) > 0.001f)
+            {
+                Log::error("ArenaGraph", "Incorrect nearby node %d of %d: "
+                           "%d instead of %d.", j, i, (*nearby)[j], pos);
+                error_count++;
+            }
+            dist[pos] = 999999.0f;
+        }
+    }
+
+    if (error_count > 0)
+        Log::error("ArenaGraph", "%d errors found.", error_count);
+    assert(error_count == 0);
     delete ag;
 
 }   // unitTesting
@@ -19,6 +19,7 @@
 #ifndef HEADER_ARENA_GRAPH_HPP
 #define HEADER_ARENA_GRAPH_HPP
 
+#include "tracks/arena_path_cache.hpp"
 #include "tracks/graph.hpp"
 #include "utils/cpp2011.hpp"
 
@@ -34,11 +35,8 @@ class XMLNode;
 class ArenaGraph : public Graph
 {
 private:
-    /** The actual graph data structure, it is an adjacency matrix. */
-    std::vector<std::vector<float>> m_distance_matrix;
-
-    /** The matrix that is used to store computed shortest paths. */
-    std::vector<std::vector<int16_t>> m_parent_node;
+    /** Computes and caches the shortest paths between nodes on demand. */
+    ArenaPathCache* m_path_cache;
 
     /** Used in soccer mode to colorize the goal lines in minimap. */
     std::set<int> m_red_node;
@@ -50,13 +48,13 @@ private:
     // ------------------------------------------------------------------------
     void loadNavmesh(const std::string &navmesh);
     // ------------------------------------------------------------------------
-    void buildGraph();
-    // ------------------------------------------------------------------------
     void setNearbyNodesOfAllNodes();
     // ------------------------------------------------------------------------
-    void computeDijkstra(int n);
+    void buildGraph(std::vector<std::vector<float> >* distance_matrix,
+                    std::vector<std::vector<int16_t> >* parent_node) const;
     // ------------------------------------------------------------------------
-    void computeFloydWarshall();
+    void computeFloydWarshall(std::vector<std::vector<float> >* distance_matrix,
+                         std::vector<std::vector<int16_t> >* parent_node) const;
     // ------------------------------------------------------------------------
     static std::vector<int16_t> getPathFromTo(int from, int to,
                      const std::vector< std::vector< int16_t > >& parent_node);
@@ -72,19 +70,19 @@ public:
     // ------------------------------------------------------------------------
     ArenaGraph(const std::string &navmesh, const XMLNode *node = NULL);
     // ------------------------------------------------------------------------
-    virtual ~ArenaGraph() {}
+    virtual ~ArenaGraph();
     // ------------------------------------------------------------------------
     ArenaNode* getNode(unsigned int i) const;
     // ------------------------------------------------------------------------
     /** Returns the next node on the shortest path from i to j.
-     *  Note: m_parent_node[j][i] contains the parent of i on path from j to i,
-     *  which is the next node on the path from i to j (undirected graph)
+     *  Note: the parent of i on the path from j to i is the next node on
+     *  the path from i to j (undirected graph).
      */
     int getNextNode(int i, int j) const
     {
         if (i == Graph::UNKNOWN_SECTOR || j == Graph::UNKNOWN_SECTOR)
             return Graph::UNKNOWN_SECTOR;
-        return (int)(m_parent_node[j][i]);
+        return m_path_cache->getParent(j, i);
     }
     // ------------------------------------------------------------------------
     /** Returns the distance between any two nodes */
@@ -92,7 +90,7 @@ public:
     {
         if (from == Graph::UNKNOWN_SECTOR || to == Graph::UNKNOWN_SECTOR)
             return 99999.0f;
-        return m_distance_matrix[from][to];
+        return m_path_cache->getDistance(from, to);
     }
 
 };   // ArenaGraph
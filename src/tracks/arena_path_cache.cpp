@@ -0,0 +1,433 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "tracks/arena_path_cache.hpp"
+
+#include "config/user_config.hpp"
+#include "io/file_manager.hpp"
+#include "tracks/arena_graph.hpp"
+#include "tracks/arena_node.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
+#include "utils/string_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+
+namespace
+{
+    /** Distance used for nodes that can't be reached. */
+    const float UNREACHABLE_DISTANCE = 9999.9f;
+
+    /** Increase this if the layout or the computation of the rows changes,
+     *  so that old cache files are discarded. */
+    const uint32_t CACHE_VERSION = 1;
+
+    /** Header of the cache file. It is followed by one uint32_t offset for
+     *  each node (0 if the row for that source is not cached), and the rows
+     *  themselves: num_nodes floats of distances followed by num_nodes
+     *  int16_t of parents, padded to a multiple of 4 bytes. */
+    struct CacheHeader
+    {
+        char     m_magic[4];
+        uint32_t m_version;
+        uint32_t m_byte_order;
+        uint32_t m_num_nodes;
+        uint64_t m_navmesh_hash;
+        uint32_t m_num_rows;
+        uint32_t m_padding;
+    };   // CacheHeader
+
+    const char     CACHE_MAGIC[4] = { 'S', 'T', 'K', 'A' };
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    // ------------------------------------------------------------------------
+    size_t getRowSize(unsigned int num_nodes)
+    {
+        size_t size = num_nodes * (sizeof(float) + sizeof(int16_t));
+        return (size + 3) & ~size_t(3);
+    }   // getRowSize
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Creates the path cache for an arena graph. Only the adjacency is copied
+ *  from the graph, no path is computed here.
+ *  \param graph The arena graph, its nodes and adjacency must be loaded.
+ *  \param navmesh_hash Hash of the navmesh file, to find the cache file.
+ *  \param use_disk_cache If the disk cache should be loaded and saved.
+ */
+ArenaPathCache::ArenaPathCache(const ArenaGraph* graph, uint64_t navmesh_hash,
+                               bool use_disk_cache)
+{
+    m_num_nodes         = graph->getNumNodes();
+    m_navmesh_hash      = navmesh_hash;
+    m_num_computed_rows = 0;
+    m_num_cached_rows   = 0;
+
+    m_adjacent_start.reserve(m_num_nodes + 1);
+    for (unsigned int i = 0; i < m_num_nodes; i++)
+    {
+        m_adjacent_start.push_back((unsigned int)m_adjacent.size());
+        ArenaNode* cur_node = graph->getNode(i);
+        for (const int& adjacent : cur_node->getAdjacentNodes())
+        {
+            if (adjacent < 0 || adjacent >= (int)m_num_nodes)
+                continue;
+            Vec3 diff = graph->getNode(adjacent)->getCenter() -
+                cur_node->getCenter();
+            m_adjacent.push_back(adjacent);
+            m_edge_length.push_back(diff.length());
+        }
+    }
+    m_adjacent_start.push_back((unsigned int)m_adjacent.size());
+
+    m_distance_row.resize(m_num_nodes, NULL);
+    m_parent_row.resize(m_num_nodes, NULL);
+    m_computed_distance.resize(m_num_nodes);
+    m_computed_parent.resize(m_num_nodes);
+
+    if (use_disk_cache && navmesh_hash != 0 && m_num_nodes > 0)
+    {
+        char name[64];
+        snprintf(name, 64, "navmesh-%016llx.bin",
+            (unsigned long long)navmesh_hash);
+        m_cache_filename = file_manager->getCachedGraphsDir() + name;
+        loadCache();
+    }
+}   // ArenaPathCache
+
+// ----------------------------------------------------------------------------
+ArenaPathCache::~ArenaPathCache()
+{
+    if (!m_cache_filename.empty() && m_num_computed_rows > 0)
+        saveCache();
+}   // ~ArenaPathCache
+
+// ----------------------------------------------------------------------------
+/** Maps the cache file and sets the row pointers of all rows in it. An
+ *  invalid or outdated file is ignored (and replaced when saving).
+ */
+void ArenaPathCache::loadCache()
+{
+    if (!m_cache_file.open(m_cache_filename))
+        return;
+
+    const CacheHeader* header = m_cache_file.getAt<CacheHeader>(0);
+    if (!header || memcmp(header->m_magic, CACHE_MAGIC, 4) != 0 ||
+        header->m_version != CACHE_VERSION ||
+        header->m_byte_order != BYTE_ORDER_MARK ||
+        header->m_num_nodes != m_num_nodes ||
+        header->m_navmesh_hash != m_navmesh_hash)
+    {
+        Log::info("ArenaPathCache", "Ignoring outdated cache '%s'.",
+            m_cache_filename.c_str());
+        m_cache_file.close();
+        return;
+    }
+
+    const uint32_t* offsets =
+        m_cache_file.getAt<uint32_t>(sizeof(CacheHeader), m_num_nodes);
+    if (!offsets)
+    {
+        m_cache_file.close();
+        return;
+    }
+    for (unsigned int i = 0; i < m_num_nodes; i++)
+    {
+        if (offsets[i] == 0)
+            continue;
+        const float* distance =
+            m_cache_file.getAt<float>(offsets[i], m_num_nodes);
+        const int16_t* parent = m_cache_file.getAt<int16_t>
+            (offsets[i] + m_num_nodes * sizeof(float), m_num_nodes);
+        if (!distance || !parent || offsets[i] % 4 != 0)
+        {
+            Log::warn("ArenaPathCache", "Corrupted cache '%s'.",
+                m_cache_filename.c_str());
+            for (unsigned int j = 0; j < m_num_nodes; j++)
+            {
+                m_distance_row[j] = NULL;
+                m_parent_row[j] = NULL;
+            }
+            m_num_cached_rows = 0;
+            m_cache_file.close();
+            return;
+        }
+        m_distance_row[i] = distance;
+        m_parent_row[i] = parent;
+        m_num_cached_rows++;
+    }
+    Log::info("ArenaPathCache", "Loaded %d of %d rows from '%s'.",
+        m_num_cached_rows, m_num_nodes, m_cache_filename.c_str());
+}   // loadCache
+
+// ----------------------------------------------------------------------------
+/** Writes all rows computed in this session, followed by the rows of the
+ *  previous cache file, to a new cache file. The total size is limited by
+ *  UserConfigParams::m_arena_path_cache_max_mb. The file is written under
+ *  a temporary name and then renamed, so that another process which has
+ *  the old file mapped or is writing at the same time is not affected.
+ */
+void ArenaPathCache::saveCache()
+{
+    const size_t row_size = getRowSize(m_num_nodes);
+    const size_t header_size = sizeof(CacheHeader) +
+        ((m_num_nodes * sizeof(uint32_t) + 3) & ~size_t(3));
+    const size_t max_size =
+        size_t(std::max(0, (int)UserConfigParams::m_arena_path_cache_max_mb))
+        * 1024 * 1024;
+    if (max_size < header_size + row_size)
+        return;
+    const size_t max_rows = (max_size - header_size) / row_size;
+
+    // Rows computed now are saved first, since they were needed in this race
+    std::vector<int> rows;
+    for (unsigned int i = 0; i < m_num_nodes && rows.size() < max_rows; i++)
+    {
+        if (!m_computed_distance[i].empty())
+            rows.push_back(i);
+    }
+    for (unsigned int i = 0; i < m_num_nodes && rows.size() < max_rows; i++)
+    {
+        if (m_computed_distance[i].empty() && m_distance_row[i] != NULL)
+            rows.push_back(i);
+    }
+
+    std::random_device rd;
+    std::string tmp_name = m_cache_filename + "." +
+        StringUtils::toString(rd()) + ".tmp";
+    FILE* fp = FileUtils::fopenU8Path(tmp_name, "wb");
+    if (!fp)
+    {
+        Log::warn("ArenaPathCache", "Can't write cache '%s'.",
+            tmp_name.c_str());
+        return;
+    }
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, CACHE_MAGIC, 4);
+    header.m_version      = CACHE_VERSION;
+    header.m_byte_order   = BYTE_ORDER_MARK;
+    header.m_num_nodes    = m_num_nodes;
+    header.m_navmesh_hash = m_navmesh_hash;
+    header.m_num_rows     = (uint32_t)rows.size();
+
+    std::vector<uint32_t> offsets(m_num_nodes, 0);
+    size_t offset = header_size;
+    for (int row : rows)
+    {
+        offsets[row] = (uint32_t)offset;
+        offset += row_size;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    std::vector<uint8_t> buffer(header_size - sizeof(header), 0);
+    memcpy(buffer.data(), offsets.data(), offsets.size() * sizeof(uint32_t));
+    ok &= fwrite(buffer.data(), buffer.size(), 1, fp) == 1;
+    buffer.assign(row_size, 0);
+    for (int row : rows)
+    {
+        memcpy(buffer.data(), m_distance_row[row],
+            m_num_nodes * sizeof(float));
+        memcpy(buffer.data() + m_num_nodes * sizeof(float), m_parent_row[row],
+            m_num_nodes * sizeof(int16_t));
+        ok &= fwrite(buffer.data(), buffer.size(), 1, fp) == 1;
+    }
+    ok &= fclose(fp) == 0;
+
+    // Windows can't replace a file which is still mapped.
+    m_cache_file.close();
+    for (unsigned int i = 0; i < m_num_nodes; i++)
+    {
+        if (m_computed_distance[i].empty())
+        {
+            m_distance_row[i] = NULL;
+            m_parent_row[i] = NULL;
+        }
+    }
+    if (ok)
+    {
+#if defined(WIN32)
+        // rename() can't replace an existing file on windows
+        file_manager->removeFile(m_cache_filename);
+#endif
+        ok = FileUtils::renameU8Path(tmp_name, m_cache_filename) == 0;
+    }
+    if (!ok)
+    {
+        Log::warn("ArenaPathCache", "Failed to save cache '%s'.",
+            m_cache_filename.c_str());
+        file_manager->removeFile(tmp_name);
+        return;
+    }
+    Log::info("ArenaPathCache", "Saved %d rows to '%s'.", (int)rows.size(),
+        m_cache_filename.c_str());
+}   // saveCache
+
+// ----------------------------------------------------------------------------
+/** Dijkstra shortest path computation. It computes the shortest distance from
+ *  the specified node 'source' to all other nodes. Afterwards
+ *  m_distance_row[source][j] stores the shortest path distance from source to
+ *  j and m_parent_row[source][j] stores the last node visited on the shortest
+ *  path from source to j before visiting j.
+ */
+void ArenaPathCache::computeRow(int source) const
+{
+    std::vector<float>& distance = m_computed_distance[source];
+    std::vector<int16_t>& parent = m_computed_parent[source];
+    distance.assign(m_num_nodes, UNREACHABLE_DISTANCE);
+    parent.assign(m_num_nodes, -1);
+    distance[source] = 0.0f;
+
+    typedef std::pair<float, int> DistIndPair;
+    std::priority_queue<DistIndPair, std::vector<DistIndPair>,
+                        std::greater<DistIndPair> > queue;
+    queue.push(DistIndPair(0.0f, source));
+    while (!queue.empty())
+    {
+        DistIndPair current = queue.top();
+        queue.pop();
+        const int cur_index = current.second;
+        // Outdated entry, node was already reached on a shorter path
+        if (current.first > distance[cur_index]) continue;
+
+        for (unsigned int k = m_adjacent_start[cur_index];
+             k < m_adjacent_start[cur_index + 1]; k++)
+        {
+            const int adjacent = m_adjacent[k];
+            const float new_dist = current.first + m_edge_length[k];
+            if (new_dist < distance[adjacent])
+            {
+                distance[adjacent] = new_dist;
+                parent[adjacent] = (int16_t)cur_index;
+                queue.push(DistIndPair(new_dist, adjacent));
+            }
+        }
+    }
+    m_distance_row[source] = distance.data();
+    m_parent_row[source] = parent.data();
+    m_num_computed_rows++;
+}   // computeRow
+
+// ----------------------------------------------------------------------------
+/** Returns the 'count' nodes with the shortest path distance from 'source'
+ *  (not including source itself), ordered by distance and then by node
+ *  index. If the row of source is not available, this uses a Dijkstra
+ *  search which stops as soon as enough nodes are found, so it is cheap
+ *  to call for all nodes when loading the arena.
+ */
+void ArenaPathCache::findNearestNodes(int source, unsigned int count,
+                                      std::vector<int>* nodes) const
+{
+    nodes->clear();
+    if (m_num_nodes < 2)
+        return;
+    count = std::min(count, m_num_nodes - 1);
+
+    typedef std::pair<float, int> DistIndPair;
+    std::vector<DistIndPair> found;
+    if (m_distance_row[source] != NULL)
+    {
+        const float* distance = m_distance_row[source];
+        for (unsigned int i = 0; i < m_num_nodes; i++)
+        {
+            if ((int)i != source)
+                found.push_back(DistIndPair(distance[i], i));
+        }
+    }
+    else
+    {
+        std::vector<float> distance(m_num_nodes, UNREACHABLE_DISTANCE);
+        std::vector<bool> settled(m_num_nodes, false);
+        distance[source] = 0.0f;
+        std::priority_queue<DistIndPair, std::vector<DistIndPair>,
+                            std::greater<DistIndPair> > queue;
+        queue.push(DistIndPair(0.0f, source));
+        while (!queue.empty())
+        {
+            DistIndPair current = queue.top();
+            // Continue while there are nodes with the same distance as the
+            // last one found, so that ties are broken by index below
+            if (found.size() >= count &&
+                current.first > found.back().first)
+                break;
+            queue.pop();
+            const int cur_index = current.second;
+            if (settled[cur_index]) continue;
+            settled[cur_index] = true;
+            if (cur_index != source)
+                found.push_back(current);
+
+            for (unsigned int k = m_adjacent_start[cur_index];
+                 k < m_adjacent_start[cur_index + 1]; k++)
+            {
+                const int adjacent = m_adjacent[k];
+                const float new_dist = current.first + m_edge_length[k];
+                if (new_dist < distance[adjacent])
+                {
+                    distance[adjacent] = new_dist;
+                    queue.push(DistIndPair(new_dist, adjacent));
+                }
+            }
+        }
+        // Not enough reachable nodes, fill with the unreachable ones
+        for (unsigned int i = 0; i < m_num_nodes && found.size() < count; i++)
+        {
+            if (!settled[i])
+                found.push_back(DistIndPair(UNREACHABLE_DISTANCE, i));
+        }
+    }
+    std::partial_sort(found.begin(), found.begin() + count, found.end());
+    for (unsigned int i = 0; i < count; i++)
+        nodes->push_back(found[i].second);
+}   // findNearestNodes
+
+// ----------------------------------------------------------------------------
+/** Computes all rows which are not available yet. Used for unit testing and
+ *  benchmarking, and to pre-fill the disk cache.
+ */
+void ArenaPathCache::computeAllRows()
+{
+    for (unsigned int i = 0; i < m_num_nodes; i++)
+        getRow(i);
+}   // computeAllRows
+
+// ----------------------------------------------------------------------------
+/** Returns the number of bytes of heap memory used by this object (not
+ *  including the mapped cache file).
+ */
+size_t ArenaPathCache::getMemoryUsage() const
+{
+    size_t size = m_adjacent_start.capacity() * sizeof(unsigned int) +
+                  m_adjacent.capacity() * sizeof(int) +
+                  m_edge_length.capacity() * sizeof(float) +
+                  m_distance_row.capacity() * sizeof(float*) +
+                  m_parent_row.capacity() * sizeof(int16_t*) +
+                  m_computed_distance.capacity() * sizeof(std::vector<float>) +
+                  m_computed_parent.capacity() * sizeof(std::vector<int16_t>);
+    for (unsigned int i = 0; i < m_num_nodes; i++)
+    {
+        size += m_computed_distance[i].capacity() * sizeof(float) +
+                m_computed_parent[i].capacity() * sizeof(int16_t);
+    }
+    return size;
+}   // getMemoryUsage
@@ -0,0 +1,140 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_ARENA_PATH_CACHE_HPP
+#define HEADER_ARENA_PATH_CACHE_HPP
+
+#include "utils/mapped_file.hpp"
+#include "utils/no_copy.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ArenaGraph;
+
+/**
+ *  \brief Answers shortest path queries on an arena navmesh.
+ *  Instead of computing the full distance and parent matrices when the
+ *  arena is loaded (which is quadratic in memory and takes seconds for large
+ *  addon arenas), the shortest paths from a node are computed with Dijkstra
+ *  the first time that node is used as the source of a query. Computed rows
+ *  are saved in a per navmesh cache file (keyed by the hash of the navmesh),
+ *  which is memory mapped the next time the arena is loaded, so the rows are
+ *  only paged in when used and shared with a child server process.
+ *  \ingroup tracks
+ */
+class ArenaPathCache : public NoCopy
+{
+private:
+    /** Number of nodes in the navmesh. */
+    unsigned int m_num_nodes;
+
+    /** Adjacency of the navmesh in compressed form: the neighbours of node
+     *  i are m_adjacent[m_adjacent_start[i]] to
+     *  m_adjacent[m_adjacent_start[i+1]-1]. */
+    std::vector<unsigned int> m_adjacent_start;
+
+    std::vector<int> m_adjacent;
+
+    /** Length of each edge in m_adjacent. */
+    std::vector<float> m_edge_length;
+
+    /** For each source node a pointer to the shortest distances to all
+     *  nodes, or NULL if this row was not computed yet. It points either
+     *  into the mapped cache file or into m_computed_distance. */
+    mutable std::vector<const float*> m_distance_row;
+
+    /** For each source node a pointer to the row of parent nodes, i.e.
+     *  m_parent_row[i][j] is the node visited before j on the shortest
+     *  path from i to j, -1 if j is i or not reachable. */
+    mutable std::vector<const int16_t*> m_parent_row;
+
+    /** Rows computed in this session (empty if not computed). */
+    mutable std::vector<std::vector<float> > m_computed_distance;
+
+    mutable std::vector<std::vector<int16_t> > m_computed_parent;
+
+    /** Number of rows computed in this session. */
+    mutable unsigned int m_num_computed_rows;
+
+    /** Number of rows found in the disk cache. */
+    unsigned int m_num_cached_rows;
+
+    /** Hash of the navmesh file, used to invalidate the cache. */
+    uint64_t m_navmesh_hash;
+
+    /** Full path of the cache file, empty if caching is disabled. */
+    std::string m_cache_filename;
+
+    /** The memory mapped cache file. */
+    MappedFile m_cache_file;
+
+    // ------------------------------------------------------------------------
+    void loadCache();
+    // ------------------------------------------------------------------------
+    void saveCache();
+    // ------------------------------------------------------------------------
+    void computeRow(int source) const;
+    // ------------------------------------------------------------------------
+    /** Makes sure the row for the given source is available. */
+    void getRow(int source) const
+    {
+        if (m_distance_row[source] == NULL)
+            computeRow(source);
+    }   // getRow
+
+public:
+    ArenaPathCache(const ArenaGraph* graph, uint64_t navmesh_hash,
+                   bool use_disk_cache);
+    // ------------------------------------------------------------------------
+    ~ArenaPathCache();
+    // ------------------------------------------------------------------------
+    void findNearestNodes(int source, unsigned int count,
+                          std::vector<int>* nodes) const;
+    // ------------------------------------------------------------------------
+    void computeAllRows();
+    // ------------------------------------------------------------------------
+    size_t getMemoryUsage() const;
+    // ------------------------------------------------------------------------
+    /** Returns the shortest distance from node 'from' to node 'to',
+     *  9999.9 if 'to' can't be reached. */
+    float getDistance(int from, int to) const
+    {
+        getRow(from);
+        return m_distance_row[from][to];
+    }   // getDistance
+    // ------------------------------------------------------------------------
+    /** Returns the node visited before 'to' on the shortest path from 'from'
+     *  to 'to', -1 if there is none. */
+    int getParent(int from, int to) const
+    {
+        getRow(from);
+        return m_parent_row[from][to];
+    }   // getParent
+    // ------------------------------------------------------------------------
+    /** Returns how many rows were computed (i.e. not found in the disk
+     *  cache) so far. */
+    unsigned int getNumComputedRows() const      { return m_num_computed_rows; }
+    // ------------------------------------------------------------------------
+    /** Returns how many rows were loaded from the disk cache. */
+    unsigned int getNumCachedRows() const          { return m_num_cached_rows; }
+
+};   // ArenaPathCache
+
+#endif
@@ -23,13 +23,145 @@
 #include "io/xml_node.hpp"
 #include "main_loop.hpp"
 #include "modes/world.hpp"
+#include "physics/triangle_mesh.hpp"
 #include "race/race_manager.hpp"
 #include "tracks/check_lap.hpp"
 #include "tracks/check_line.hpp"
 #include "tracks/check_manager.hpp"
 #include "tracks/drive_node.hpp"
 #include "tracks/track.hpp"
+#include "tracks/track_manager.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/mapped_file.hpp"
 #include "utils/string_utils.hpp"
+#include "utils/time.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+namespace
+{
+    /** Increase this if the layout of the cache or any of the computations
+     *  stored in it change, so that old cache files are discarded. */
+    const uint32_t DRIVE_GRAPH_CACHE_VERSION = 2;
+
+    const char     DRIVE_GRAPH_CACHE_MAGIC[4] = { 'S', 'T', 'K', 'D' };
+    const uint32_t DRIVE_GRAPH_BYTE_ORDER_MARK = 0x01020304;
+
+    /** Header of the drive graph cache file. It is followed by the arrays
+     *  (in this order): m_num_nodes CachedNode, m_num_edges CachedEdge (in
+     *  the order the edges were added), m_num_edges CachedDirection (for
+     *  each node and each of its successors), m_num_paths int32_t path-to-
+     *  node entries, m_num_checklines int32_t checkline requirements, and
+     *  m_num_slices CachedSlice entries of the road profiles.
+     */
+    struct DriveGraphCacheHeader
+    {
+        char     m_magic[4];
+        uint32_t m_version;
+        uint32_t m_byte_order;
+        uint32_t m_num_nodes;
+        uint64_t m_source_hash;
+        float    m_lap_length;
+        float    m_min_height_testing;
+        float    m_max_height_testing;
+        int32_t  m_bb_nodes[4];
+        uint32_t m_num_edges;
+        uint32_t m_num_paths;
+        uint32_t m_num_checklines;
+        uint32_t m_has_checklines;
+        uint32_t m_num_slices;
+    };   // DriveGraphCacheHeader
+
+    struct CachedNode
+    {
+        float    m_p[4][3];
+        float    m_distance_from_start;
+        uint32_t m_flags;
+        uint32_t m_num_paths;
+        uint32_t m_num_checklines;
+        uint32_t m_num_slices;
+        float    m_curve_radius;
+    };   // CachedNode
+
+    enum CachedNodeFlags { CN_INVISIBLE = 1, CN_AI_IGNORE = 2, CN_IGNORED = 4 };
+
+    struct CachedEdge
+    {
+        uint32_t m_from;
+        uint32_t m_to;
+    };   // CachedEdge
+
+    struct CachedDirection
+    {
+        uint32_t m_direction;
+        uint32_t m_last_index;
+    };   // CachedDirection
+
+    struct CachedSlice
+    {
+        int32_t  m_node;
+        float    m_forward;
+        float    m_lateral;
+        float    m_half_width;
+        float    m_clearance;
+        float    m_min_height;
+        float    m_max_height;
+    };   // CachedSlice
+
+    /** Maximum distance and number of nodes covered by the road profile
+     *  of a node. */
+    const float        MAX_PROFILE_DISTANCE = 100.0f;
+    const unsigned int MAX_PROFILE_SLICES   = 64;
+
+    /** The 2d (x/z) frame in which the road profile of a drive node is
+     *  given, see DriveNode::ProfileSlice. */
+    class ProfileFrame
+    {
+    private:
+        Vec3  m_origin;
+        float m_forward_x, m_forward_z;
+    public:
+        /** Sets up the frame of a node, returns false if the node has no
+         *  horizontal driving direction (e.g. in a loop). */
+        bool init(const DriveNode &node)
+        {
+            Vec3 d = node.getUpperCenter() - node.getLowerCenter();
+            float len = sqrtf(d.getX()*d.getX() + d.getZ()*d.getZ());
+            if (len < 0.001f)
+                return false;
+            m_origin    = node.getLowerCenter();
+            m_forward_x = d.getX() / len;
+            m_forward_z = d.getZ() / len;
+            return true;
+        }   // init
+        // --------------------------------------------------------------------
+        /** Converts a direction into this frame. */
+        void rotate(const Vec3 &d, float *forward, float *lateral) const
+        {
+            *forward = d.getX()*m_forward_x + d.getZ()*m_forward_z;
+            *lateral = d.getZ()*m_forward_x - d.getX()*m_forward_z;
+        }   // rotate
+        // --------------------------------------------------------------------
+        /** Converts a point into this frame. */
+        void transform(const Vec3 &p, float *forward, float *lateral) const
+        {
+            rotate(p - m_origin, forward, lateral);
+        }   // transform
+    };   // ProfileFrame
+
+    // ------------------------------------------------------------------------
+    template<typename T>
+    void appendToBuffer(std::vector<uint8_t>* buffer, const T* data,
+                        size_t count = 1)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        buffer->insert(buffer->end(), p, p + count * sizeof(T));
+    }   // appendToBuffer
+}   // namespace
 
 // ----------------------------------------------------------------------------
 /** Constructor, loads the graph information for a given set of quads
@@ -39,21 +171,40 @@
  */
 DriveGraph::DriveGraph(const std::string &quad_file_name,
                        const std::string &graph_file_name,
-                       const bool reverse) : m_reverse(reverse)
+                       const bool reverse,
+                       const std::string &scene_file_name)
+          : m_reverse(reverse)
 {
-    m_lap_length    = 0;
-    m_quad_filename = quad_file_name;
+    m_lap_length            = 0;
+    m_quad_filename         = quad_file_name;
+    m_min_height_testing    = Graph::MIN_HEIGHT_TESTING;
+    m_max_height_testing    = Graph::MAX_HEIGHT_TESTING;
+    m_source_hash           = 0;
+    m_loaded_from_cache     = false;
+    m_has_cached_checklines = false;
     Graph::setGraph(this);
-    load(quad_file_name, graph_file_name);
+
+    const uint64_t start = StkTime::getMonoTimeMs();
+    if (UserConfigParams::m_cache_graphs)
+    {
+        setupCache(quad_file_name, graph_file_name, scene_file_name);
+        if (!m_cache_filename.empty())
+            m_loaded_from_cache = loadCache();
+    }
+    if (!m_loaded_from_cache)
+        load(quad_file_name, graph_file_name);
+    Log::debug("DriveGraph", "Loading '%s' took %dms%s.",
+        quad_file_name.c_str(), (int)(StkTime::getMonoTimeMs() - start),
+        m_loaded_from_cache ? " (from cache)" : "");
 }   // DriveGraph
 
 // ----------------------------------------------------------------------------
 void DriveGraph::addSuccessor(unsigned int from, unsigned int to)
 {
     if(m_reverse)
-        getNode(to)->addSuccessor(from);
-    else
-        getNode(from)->addSuccessor(to);
+        std::swap(from, to);
+    getNode(from)->addSuccessor(to);
+    m_edges.push_back(std::make_pair(from, to));
 
 }   // addSuccessor
 
@@ -159,6 +310,8 @@ void DriveGraph::load(const std::string &quad_file_name,
         m_all_nodes[i]->setHeightTesting(min_height_testing,
             max_height_testing);
     }
+    m_min_height_testing = min_height_testing;
+    m_max_height_testing = max_height_testing;
     delete quad;
 
     const XMLNode *xml = file_manager->createXMLTree(filename);
@@ -264,6 +417,316 @@ void DriveGraph::load(const std::string &quad_file_name,
 
 }   // load
 
+// ----------------------------------------------------------------------------
+/** Computes the hash of everything the processed graph depends on (the quad,
+ *  graph and scene files and the direction), and sets the name of the cache
+ *  file from it.
+ */
+void DriveGraph::setupCache(const std::string &quad_file_name,
+                            const std::string &graph_file_name,
+                            const std::string &scene_file_name)
+{
+    MappedFile file;
+    // Without quads there is nothing worth caching
+    if (!file.open(quad_file_name))
+        return;
+    uint8_t flags[2] = { m_reverse, RaceManager::get()->getReverseTrack() };
+    uint64_t hash = MappedFile::hash(flags, sizeof(flags));
+    hash = MappedFile::hash(file.getData(), file.getSize(), hash);
+    // A missing graph or scene file is a valid input as well
+    if (file.open(graph_file_name))
+        hash = MappedFile::hash(file.getData(), file.getSize(), hash);
+    else
+        hash = MappedFile::hash("-", 1, hash);
+    if (!scene_file_name.empty() && file.open(scene_file_name))
+        hash = MappedFile::hash(file.getData(), file.getSize(), hash);
+    else
+        hash = MappedFile::hash("-", 1, hash);
+
+    m_source_hash = hash;
+    char name[64];
+    snprintf(name, 64, "drivegraph-%016llx.bin", (unsigned long long)hash);
+    m_cache_filename = file_manager->getCachedGraphsDir() + name;
+}   // setupCache
+
+// ----------------------------------------------------------------------------
+/** Loads the fully processed graph from the cache file, which is memory
+ *  mapped and used in place. The quads and edges are re-created with the
+ *  same functions used when loading from xml (which only do some cheap
+ *  vector maths), all other data is copied from the cache.
+ *  \return True if the cache was valid and loaded.
+ */
+bool DriveGraph::loadCache()
+{
+    MappedFile cache;
+    if (!cache.open(m_cache_filename))
+        return false;
+
+    const DriveGraphCacheHeader* header =
+        cache.getAt<DriveGraphCacheHeader>(0);
+    if (!header ||
+        memcmp(header->m_magic, DRIVE_GRAPH_CACHE_MAGIC, 4) != 0 ||
+        header->m_version != DRIVE_GRAPH_CACHE_VERSION ||
+        header->m_byte_order != DRIVE_GRAPH_BYTE_ORDER_MARK ||
+        header->m_source_hash != m_source_hash ||
+        header->m_num_nodes == 0)
+    {
+        Log::info("DriveGraph", "Ignoring outdated cache '%s'.",
+            m_cache_filename.c_str());
+        return false;
+    }
+
+    const unsigned int num_nodes = header->m_num_nodes;
+    size_t offset = sizeof(DriveGraphCacheHeader);
+    const CachedNode* nodes = cache.getAt<CachedNode>(offset, num_nodes);
+    offset += num_nodes * sizeof(CachedNode);
+    const CachedEdge* edges =
+        cache.getAt<CachedEdge>(offset, header->m_num_edges);
+    offset += header->m_num_edges * sizeof(CachedEdge);
+    const CachedDirection* directions =
+        cache.getAt<CachedDirection>(offset, header->m_num_edges);
+    offset += header->m_num_edges * sizeof(CachedDirection);
+    const int32_t* paths = cache.getAt<int32_t>(offset, header->m_num_paths);
+    offset += header->m_num_paths * sizeof(int32_t);
+    const int32_t* checklines =
+        cache.getAt<int32_t>(offset, header->m_num_checklines);
+    offset += header->m_num_checklines * sizeof(int32_t);
+    const CachedSlice* slices =
+        cache.getAt<CachedSlice>(offset, header->m_num_slices);
+    if (!nodes || !edges || !directions || !paths || !checklines || !slices)
+    {
+        Log::warn("DriveGraph", "Corrupted cache '%s'.",
+            m_cache_filename.c_str());
+        return false;
+    }
+
+    // Validate all indices before creating anything
+    unsigned int total_paths = 0, total_checklines = 0, total_slices = 0;
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        if (nodes[i].m_num_paths != 0 && nodes[i].m_num_paths != num_nodes)
+            return false;
+        total_paths += nodes[i].m_num_paths;
+        total_checklines += nodes[i].m_num_checklines;
+        total_slices += nodes[i].m_num_slices;
+    }
+    if (total_paths != header->m_num_paths ||
+        total_checklines != header->m_num_checklines ||
+        total_slices != header->m_num_slices)
+        return false;
+    for (unsigned int i = 0; i < header->m_num_slices; i++)
+    {
+        if (slices[i].m_node < 0 || slices[i].m_node >= (int)num_nodes)
+            return false;
+    }
+    for (unsigned int i = 0; i < header->m_num_edges; i++)
+    {
+        if (edges[i].m_from >= num_nodes || edges[i].m_to >= num_nodes)
+            return false;
+    }
+
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        const CachedNode& cn = nodes[i];
+        createQuad(Vec3(cn.m_p[0][0], cn.m_p[0][1], cn.m_p[0][2]),
+                   Vec3(cn.m_p[1][0], cn.m_p[1][1], cn.m_p[1][2]),
+                   Vec3(cn.m_p[2][0], cn.m_p[2][1], cn.m_p[2][2]),
+                   Vec3(cn.m_p[3][0], cn.m_p[3][1], cn.m_p[3][2]), i,
+                   (cn.m_flags & CN_INVISIBLE) != 0,
+                   (cn.m_flags & CN_AI_IGNORE) != 0, false/*is_arena*/,
+                   (cn.m_flags & CN_IGNORED) != 0);
+        m_all_nodes[i]->setHeightTesting(header->m_min_height_testing,
+                                         header->m_max_height_testing);
+    }
+    m_min_height_testing = header->m_min_height_testing;
+    m_max_height_testing = header->m_max_height_testing;
+
+    // Adding the edges in the original order restores the order of
+    // successors and predecessors
+    for (unsigned int i = 0; i < header->m_num_edges; i++)
+    {
+        getNode(edges[i].m_from)->addSuccessor(edges[i].m_to);
+        m_edges.push_back(std::make_pair(edges[i].m_from, edges[i].m_to));
+    }
+
+    unsigned int direction_index = 0;
+    std::vector<DriveNode::ProfileSlice> profile;
+    m_cached_checklines.resize(header->m_has_checklines ? num_nodes : 0);
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        DriveNode* dn = getNode(i);
+        dn->setDistanceFromStart(nodes[i].m_distance_from_start);
+        for (unsigned int j = 0; j < dn->getNumberOfSuccessors(); j++)
+        {
+            if (direction_index >= header->m_num_edges)
+                break;
+            const CachedDirection& cd = directions[direction_index++];
+            dn->setDirectionData(j, (DriveNode::DirectionType)cd.m_direction,
+                                 cd.m_last_index);
+        }
+        if (nodes[i].m_num_paths > 0)
+        {
+            dn->setPathsToNode(paths, nodes[i].m_num_paths);
+            paths += nodes[i].m_num_paths;
+        }
+        if (header->m_has_checklines)
+        {
+            m_cached_checklines[i].assign(checklines,
+                checklines + nodes[i].m_num_checklines);
+        }
+        checklines += nodes[i].m_num_checklines;
+        profile.resize(nodes[i].m_num_slices);
+        for (unsigned int j = 0; j < nodes[i].m_num_slices; j++)
+        {
+            const CachedSlice& cs = *slices++;
+            DriveNode::ProfileSlice& ps = profile[j];
+            ps.m_node       = cs.m_node;
+            ps.m_forward    = cs.m_forward;
+            ps.m_lateral    = cs.m_lateral;
+            ps.m_half_width = cs.m_half_width;
+            ps.m_clearance  = cs.m_clearance;
+            ps.m_min_height = cs.m_min_height;
+            ps.m_max_height = cs.m_max_height;
+        }
+        dn->setProfile(profile.data(), (unsigned int)profile.size());
+        dn->setCurveRadius(nodes[i].m_curve_radius);
+    }
+    m_has_cached_checklines = header->m_has_checklines != 0;
+    m_lap_length = header->m_lap_length;
+    memcpy(m_bb_nodes, header->m_bb_nodes, sizeof(m_bb_nodes));
+    return true;
+}   // loadCache
+
+// ----------------------------------------------------------------------------
+/** Saves the fully processed graph to the cache file. It is first written
+ *  to a temporary file which is then renamed, so a concurrently running
+ *  process (e.g. the child server) never sees an incomplete file.
+ *  \param with_checklines If the checkline requirements were computed and
+ *         should be saved as well.
+ */
+void DriveGraph::saveCache(bool with_checklines) const
+{
+    const unsigned int num_nodes = getNumNodes();
+    if (num_nodes == 0)
+        return;
+
+    DriveGraphCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, DRIVE_GRAPH_CACHE_MAGIC, 4);
+    header.m_version            = DRIVE_GRAPH_CACHE_VERSION;
+    header.m_byte_order         = DRIVE_GRAPH_BYTE_ORDER_MARK;
+    header.m_num_nodes          = num_nodes;
+    header.m_source_hash        = m_source_hash;
+    header.m_lap_length         = m_lap_length;
+    header.m_min_height_testing = m_min_height_testing;
+    header.m_max_height_testing = m_max_height_testing;
+    memcpy(header.m_bb_nodes, m_bb_nodes, sizeof(m_bb_nodes));
+    header.m_num_edges          = (uint32_t)m_edges.size();
+    header.m_has_checklines     = with_checklines;
+
+    std::vector<CachedNode> nodes(num_nodes);
+    std::vector<CachedDirection> directions;
+    std::vector<int32_t> paths;
+    std::vector<int32_t> checklines;
+    std::vector<CachedSlice> slices;
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        const DriveNode* dn = getNode(i);
+        CachedNode& cn = nodes[i];
+        memset(&cn, 0, sizeof(cn));
+        for (unsigned int j = 0; j < 4; j++)
+        {
+            cn.m_p[j][0] = (*dn)[j].getX();
+            cn.m_p[j][1] = (*dn)[j].getY();
+            cn.m_p[j][2] = (*dn)[j].getZ();
+        }
+        cn.m_distance_from_start = dn->getDistanceFromStart();
+        cn.m_flags = (dn->isInvisible() ? CN_INVISIBLE : 0) |
+                     (dn->letAIIgnore() ? CN_AI_IGNORE : 0) |
+                     (dn->isIgnored()   ? CN_IGNORED   : 0);
+        for (unsigned int j = 0; j < dn->getNumberOfSuccessors(); j++)
+        {
+            CachedDirection cd;
+            DriveNode::DirectionType dir;
+            unsigned int last;
+            dn->getDirectionData(j, &dir, &last);
+            cd.m_direction  = dir;
+            cd.m_last_index = last;
+            directions.push_back(cd);
+        }
+        const std::vector<int>& path = dn->getPathsToNode();
+        cn.m_num_paths = (uint32_t)path.size();
+        paths.insert(paths.end(), path.begin(), path.end());
+        if (with_checklines)
+        {
+            const std::vector<int>& req = dn->getChecklineRequirements();
+            cn.m_num_checklines = (uint32_t)req.size();
+            checklines.insert(checklines.end(), req.begin(), req.end());
+        }
+        cn.m_curve_radius = dn->getCurveRadius();
+        for (const DriveNode::ProfileSlice& ps : dn->getProfile())
+        {
+            CachedSlice cs;
+            cs.m_node       = ps.m_node;
+            cs.m_forward    = ps.m_forward;
+            cs.m_lateral    = ps.m_lateral;
+            cs.m_half_width = ps.m_half_width;
+            cs.m_clearance  = ps.m_clearance;
+            cs.m_min_height = ps.m_min_height;
+            cs.m_max_height = ps.m_max_height;
+            slices.push_back(cs);
+        }
+        cn.m_num_slices = (uint32_t)dn->getProfile().size();
+    }
+    // The direction data must match the edges exactly
+    if (directions.size() != m_edges.size())
+        return;
+    header.m_num_paths      = (uint32_t)paths.size();
+    header.m_num_checklines = (uint32_t)checklines.size();
+    header.m_num_slices     = (uint32_t)slices.size();
+
+    std::vector<uint8_t> buffer;
+    appendToBuffer(&buffer, &header);
+    appendToBuffer(&buffer, nodes.data(), nodes.size());
+    for (unsigned int i = 0; i < m_edges.size(); i++)
+    {
+        CachedEdge ce;
+        ce.m_from = m_edges[i].first;
+        ce.m_to   = m_edges[i].second;
+        appendToBuffer(&buffer, &ce);
+    }
+    appendToBuffer(&buffer, directions.data(), directions.size());
+    appendToBuffer(&buffer, paths.data(), paths.size());
+    appendToBuffer(&buffer, checklines.data(), checklines.size());
+    appendToBuffer(&buffer, slices.data(), slices.size());
+
+    std::random_device rd;
+    std::string tmp_name = m_cache_filename + "." +
+        StringUtils::toString(rd()) + ".tmp";
+    FILE* fp = FileUtils::fopenU8Path(tmp_name, "wb");
+    if (!fp)
+    {
+        Log::warn("DriveGraph", "Can't write cache '%s'.", tmp_name.c_str());
+        return;
+    }
+    bool ok = fwrite(buffer.data(), buffer.size(), 1, fp) == 1;
+    ok &= fclose(fp) == 0;
+    if (ok)
+    {
+#if defined(WIN32)
+        // rename() can't replace an existing file on windows
+        file_manager->removeFile(m_cache_filename);
+#endif
+        ok = FileUtils::renameU8Path(tmp_name, m_cache_filename) == 0;
+    }
+    if (!ok)
+    {
+        Log::warn("DriveGraph", "Failed to save cache '%s'.",
+            m_cache_filename.c_str());
+        file_manager->removeFile(tmp_name);
+    }
+}   // saveCache
+
 // ----------------------------------------------------------------------------
 /** Returns the index of the first graph node (i.e. the graph node which
  *  will trigger a new lap when a kart first enters it). This is always
@@ -282,8 +745,21 @@ unsigned int DriveGraph::getStartNode() const
  */
 void DriveGraph::computeChecklineRequirements()
 {
+    if (m_has_cached_checklines)
+    {
+        for (unsigned int i = 0; i < m_cached_checklines.size(); i++)
+        {
+            for (int checkline : m_cached_checklines[i])
+                getNode(i)->setChecklineRequirements(checkline);
+        }
+        m_cached_checklines.clear();
+        m_has_cached_checklines = false;
+        return;
+    }
     computeChecklineRequirements(getNode(0),
                                  Track::getCurrentTrack()->getCheckManager()->getLapLineIndex());
+    if (!m_cache_filename.empty())
+        saveCache(/*with_checklines*/true);
 }   // computeChecklineRequirements
 
 // ----------------------------------------------------------------------------
@@ -354,15 +830,453 @@ void DriveGraph::computeChecklineRequirements(DriveNode* node,
  *  Only graph nodes with more than one successor have this data structure
  *  (since on other graph nodes only one path can be used anyway, this
  *  saves some memory).
+ *  The road profiles for the AI are computed here as well, since they are
+ *  cached together with the paths.
  */
 void DriveGraph::setupPaths()
 {
+    // The paths and profiles are part of the cache
+    if (m_loaded_from_cache)
+        return;
+
     for(unsigned int i=0; i<getNumNodes(); i++)
     {
         getNode(i)->setupPathsToNode();
     }
+    computeProfiles();
+    if (!m_cache_filename.empty())
+        saveCache(/*with_checklines*/false);
 }   // setupPaths
 
+// ----------------------------------------------------------------------------
+/** Computes the road profile of each node for the AI. It describes the road
+ *  ahead of a node when following successor 0: the center, the safe width
+ *  and the height of each following node, and for each of them the
+ *  lateral clearance of the straight line from the center of the first
+ *  node. The profile ends at a 3d node, if the road turns by more than 60
+ *  degrees, or after MAX_PROFILE_DISTANCE or MAX_PROFILE_SLICES. It also
+ *  computes the curve radius of each node. The AI uses this data (see
+ *  findProfileCrashStep() and findProfileReachableNode()) instead of
+ *  testing points ahead of the kart against the quads each frame.
+ */
+void DriveGraph::computeProfiles()
+{
+    std::vector<DriveNode::ProfileSlice> profile;
+    for (unsigned int n = 0; n < getNumNodes(); n++)
+    {
+        DriveNode* dn = getNode(n);
+        profile.clear();
+        if (dn->getNumberOfSuccessors() == 0)
+        {
+            dn->setProfile(NULL, 0);
+            continue;
+        }
+
+        unsigned int succ = dn->getSuccessor(0);
+        if (getNode(succ)->getNumberOfSuccessors() > 0)
+        {
+            float diff = normalizeAngle(getAngleToNext(succ, 0) -
+                                        getAngleToNext(n, 0));
+            if (fabsf(diff) > 0.001f)
+            {
+                dn->setCurveRadius(dn->getDistanceToSuccessor(0) /
+                                   fabsf(diff));
+            }
+        }
+
+        ProfileFrame frame;
+        bool has_frame = !dn->is3DQuad() && frame.init(*dn);
+        unsigned int k = n;
+        while (has_frame && profile.size() < MAX_PROFILE_SLICES)
+        {
+            const DriveNode* dk = getNode(k);
+            if (dk->is3DQuad())
+                break;
+            float forward, lateral;
+            frame.rotate(dk->getUpperCenter() - dk->getLowerCenter(),
+                         &forward, &lateral);
+            float length = sqrtf(forward*forward + lateral*lateral);
+            // Stop if the road turns too much, the width along the lateral
+            // axis would become meaningless
+            if (length < 0.001f || forward < 0.5f*length)
+                break;
+            DriveNode::ProfileSlice slice;
+            slice.m_node       = k;
+            frame.transform(dk->getCenter(), &slice.m_forward,
+                            &slice.m_lateral);
+            if (slice.m_forward > MAX_PROFILE_DISTANCE ||
+                (!profile.empty() &&
+                 slice.m_forward <= profile.back().m_forward))
+                break;
+            slice.m_half_width = 0.5f * dk->getPathWidth() * length / forward;
+            slice.m_clearance  = slice.m_half_width;
+            slice.m_min_height = dk->getMinHeight();
+            slice.m_max_height = dk->getMaxHeight();
+            profile.push_back(slice);
+            if (dk->getNumberOfSuccessors() == 0)
+                break;
+            k = dk->getSuccessor(0);
+            if (k == n)
+                break;
+        }
+
+        // The clearance of the line from the first center to the center
+        // of node i is the smallest distance to the side of the road of
+        // all nodes on the way.
+        for (unsigned int i = 1; i < profile.size(); i++)
+        {
+            const DriveNode::ProfileSlice& first  = profile[0];
+            const DriveNode::ProfileSlice& target = profile[i];
+            float slope = (target.m_lateral - first.m_lateral)
+                        / (target.m_forward - first.m_forward);
+            float clearance = std::numeric_limits<float>::max();
+            for (unsigned int j = 1; j <= i; j++)
+            {
+                const DriveNode::ProfileSlice& s = profile[j];
+                float line = first.m_lateral
+                           + slope * (s.m_forward - first.m_forward);
+                clearance = std::min(clearance, s.m_half_width
+                                     - fabsf(line - s.m_lateral));
+            }
+            profile[i].m_clearance = clearance;
+        }
+        dn->setProfile(profile.data(), (unsigned int)profile.size());
+    }
+}   // computeProfiles
+
+// ----------------------------------------------------------------------------
+/** Casts a ray from the center of each node along the negative node normal
+ *  into the track mesh and stores the normal of the hit triangle in the
+ *  node. If nothing is hit, the normal of the node is used. These normals
+ *  are not cached with the rest of the graph, since the files hashed for
+ *  the cache do not include the track meshes.
+ *  \param mesh The track mesh.
+ */
+void DriveGraph::computeGroundNormals(const TriangleMesh &mesh)
+{
+    for (unsigned int i = 0; i < getNumNodes(); i++)
+    {
+        DriveNode* dn = getNode(i);
+        const Vec3& normal = dn->getNormal();
+        Vec3 hit;
+        Vec3 hit_normal(0, 1, 0);
+        const Material* m;
+        if (!mesh.castRay(dn->getCenter() + normal,
+                          dn->getCenter() + normal * -10000, &hit, &m,
+                          &hit_normal))
+            hit_normal = normal;
+        dn->setGroundNormal(hit_normal);
+    }
+}   // computeGroundNormals
+
+// ----------------------------------------------------------------------------
+/** Finds the first step along a straight line at which a kart would be off
+ *  the road, using the road profile of a node.
+ *  \param node The node the kart is on.
+ *  \param xyz Position of the kart.
+ *  \param direction Normalised driving direction.
+ *  \param step_length Distance between two steps.
+ *  \param steps Number of steps to test (step 0 is not tested).
+ *  \param next_node The next node for each node on the path of the kart.
+ *  \param crash_step On return the first step off the road, or -1.
+ *  \return False if the profile can't answer this, i.e. the steps go
+ *          beyond the profile or the path of the kart leaves it.
+ */
+bool DriveGraph::findProfileCrashStep(int node, const Vec3 &xyz,
+                                      const Vec3 &direction,
+                                      float step_length, int steps,
+                                      const std::vector<int> &next_node,
+                                      int *crash_step) const
+{
+    if (node == UNKNOWN_SECTOR)
+        return false;
+    const DriveNode* dn = getNode(node);
+    const std::vector<DriveNode::ProfileSlice>& profile = dn->getProfile();
+    ProfileFrame frame;
+    if (profile.size() < 2 || !frame.init(*dn))
+        return false;
+
+    float forward, lateral, dir_forward, dir_lateral;
+    frame.transform(xyz, &forward, &lateral);
+    frame.rotate(direction, &dir_forward, &dir_lateral);
+    if (dir_forward <= 0)
+        return false;
+
+    unsigned int j = 0;
+    for (int i = 1; steps > i; ++i)
+    {
+        float s = step_length * float(i);
+        float f = forward + s * dir_forward;
+        // Find the two slices around f, both must be on the kart's path
+        while (true)
+        {
+            if (j + 1 >= profile.size() ||
+                next_node[profile[j].m_node] != profile[j + 1].m_node)
+                return false;
+            if (profile[j + 1].m_forward > f)
+                break;
+            j++;
+        }
+        const DriveNode::ProfileSlice& a = profile[j];
+        const DriveNode::ProfileSlice& b = profile[j + 1];
+        float t = std::max(0.0f, (f - a.m_forward)
+                               / (b.m_forward - a.m_forward));
+        float center     = a.m_lateral + t * (b.m_lateral - a.m_lateral);
+        float half_width = a.m_half_width
+                         + t * (b.m_half_width - a.m_half_width);
+        const DriveNode::ProfileSlice& nearest = t < 0.5f ? a : b;
+        float y = xyz.getY() + s * direction.getY();
+        if (fabsf(lateral + s * dir_lateral - center) > half_width ||
+            y - nearest.m_max_height > m_max_height_testing ||
+            y - nearest.m_min_height < m_min_height_testing)
+        {
+            *crash_step = i;
+            return true;
+        }
+    }
+    *crash_step = -1;
+    return true;
+}   // findProfileCrashStep
+
+// ----------------------------------------------------------------------------
+/** Finds the node furthest ahead whose center can be reached in a straight
+ *  line from a position, using the lateral clearance of the road profile.
+ *  The line from the position differs from the line from the first center
+ *  of the profile by at most their distance at the position, so the node
+ *  can be reached if its clearance is at least that distance. The search
+ *  ends at the end of the profile.
+ *  \param node The node the kart is on.
+ *  \param xyz Position of the kart.
+ *  \param next_node The next node for each node on the path of the kart.
+ *  \param reachable_node On return the reachable node, at least the next
+ *         node of the kart.
+ *  \return False if the profile can't answer this, i.e. the path of the
+ *          kart leaves the profile before the furthest reachable node.
+ */
+bool DriveGraph::findProfileReachableNode(int node, const Vec3 &xyz,
+                                          const std::vector<int> &next_node,
+                                          int *reachable_node) const
+{
+    if (node == UNKNOWN_SECTOR)
+        return false;
+    const DriveNode* dn = getNode(node);
+    const std::vector<DriveNode::ProfileSlice>& profile = dn->getProfile();
+    ProfileFrame frame;
+    if (profile.size() < 2 || !frame.init(*dn))
+        return false;
+
+    float forward, lateral;
+    frame.transform(xyz, &forward, &lateral);
+    const DriveNode::ProfileSlice& first = profile[0];
+    if (next_node[first.m_node] != profile[1].m_node)
+        return false;
+    *reachable_node = profile[1].m_node;
+    for (unsigned int i = 2; i < profile.size(); i++)
+    {
+        const DriveNode::ProfileSlice& target = profile[i];
+        if (next_node[profile[i - 1].m_node] != target.m_node)
+            return false;
+        float line = first.m_lateral + (target.m_lateral - first.m_lateral)
+                   * (forward - first.m_forward)
+                   / (target.m_forward - first.m_forward);
+        if (target.m_clearance < fabsf(lateral - line))
+            break;
+        *reachable_node = target.m_node;
+    }
+    return true;
+}   // findProfileReachableNode
+
+// ----------------------------------------------------------------------------
+/** Returns the ground normal of the node on the road profile whose center
+ *  is closest (along the road) to a position.
+ *  \param node The node the kart is on.
+ *  \param xyz The position.
+ *  \param next_node The next node for each node on the path of the kart.
+ *  \param normal On return the ground normal.
+ *  \return False if the position is not covered by the profile.
+ */
+bool DriveGraph::getProfileGroundNormal(int node, const Vec3 &xyz,
+                                        const std::vector<int> &next_node,
+                                        Vec3 *normal) const
+{
+    if (node == UNKNOWN_SECTOR)
+        return false;
+    const DriveNode* dn = getNode(node);
+    const std::vector<DriveNode::ProfileSlice>& profile = dn->getProfile();
+    ProfileFrame frame;
+    if (profile.empty() || !frame.init(*dn))
+        return false;
+
+    float forward, lateral;
+    frame.transform(xyz, &forward, &lateral);
+    if (forward > profile.back().m_forward)
+        return false;
+    unsigned int j = 0;
+    while (j + 1 < profile.size() &&
+           forward > 0.5f * (profile[j].m_forward + profile[j + 1].m_forward))
+    {
+        if (next_node[profile[j].m_node] != profile[j + 1].m_node)
+            return false;
+        j++;
+    }
+    *normal = getNode(profile[j].m_node)->getGroundNormal();
+    return true;
+}   // getProfileGroundNormal
+
+// ----------------------------------------------------------------------------
+/** Compares the answers of the road profiles with tests against the quads
+ *  on a real track, and checks that the profiles are restored from the
+ *  cache.
+ */
+void DriveGraph::unitTesting()
+{
+    Track* track = track_manager->getTrack("lighthouse");
+    if (!track)
+    {
+        Log::error("DriveGraph", "Track 'lighthouse' not found, not tested.");
+        return;
+    }
+    const std::string quad_file  = track->getTrackFile("quads.xml");
+    const std::string graph_file = track->getTrackFile("graph.xml");
+    const std::string scene_file = track->getTrackFile("scene.xml");
+
+    bool cache_graphs = UserConfigParams::m_cache_graphs;
+    UserConfigParams::m_cache_graphs = false;
+    DriveGraph* dg = new DriveGraph(quad_file, graph_file, false, scene_file);
+    dg->setupPaths();
+    const unsigned int n = dg->getNumNodes();
+
+    // Follow successor 0 like an AI that never takes a shortcut
+    std::vector<int> next_node(n);
+    std::vector<std::vector<int> > look_ahead(n);
+    for (unsigned int i = 0; i < n; i++)
+        next_node[i] = dg->getNode(i)->getSuccessor(0);
+    for (unsigned int i = 0; i < n; i++)
+    {
+        int current = i;
+        for (unsigned int j = 0; j < 10; j++)
+        {
+            current = next_node[current];
+            look_ahead[i].push_back(current);
+        }
+    }
+
+    // Drive from points in each quad in three directions, and compare the
+    // crash step with the one found by testing the steps against the quads
+    // (like SkiddingAI::findRoadCrashStep). Also test that the reachable
+    // node can be reached on the quads.
+    const float step_length = 1.5f;
+    const int   steps       = 20;
+    int tests = 0, crash_agree = 0, reach_tests = 0, reach_agree = 0;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        const DriveNode* dn = dg->getNode(i);
+        Vec3 forward = dn->getUpperCenter() - dn->getLowerCenter();
+        forward.setY(0);
+        if (forward.length() < 0.001f)
+            continue;
+        forward.normalize();
+        for (unsigned int p = 0; p < 9; p++)
+        {
+            const float side = 0.2f + 0.3f * (p % 3);
+            const float along = 0.2f + 0.3f * (p / 3);
+            Vec3 lower = (*dn)[0] + ((*dn)[1] - (*dn)[0]) * side;
+            Vec3 upper = (*dn)[3] + ((*dn)[2] - (*dn)[3]) * side;
+            Vec3 xyz = lower + (upper - lower) * along;
+            for (float angle = -0.3f; angle < 0.4f; angle += 0.3f)
+            {
+                Vec3 dir(forward.getX() * cosf(angle)
+                         - forward.getZ() * sinf(angle), 0,
+                         forward.getX() * sinf(angle)
+                         + forward.getZ() * cosf(angle));
+                int crash_step;
+                if (!dg->findProfileCrashStep(i, xyz, dir, step_length,
+                                              steps, next_node, &crash_step))
+                    continue;
+                int current = i, quad_step = -1;
+                for (int s = 1; steps > s && quad_step == -1; s++)
+                {
+                    dg->findRoadSector(xyz + dir * (step_length * s),
+                                       &current, &look_ahead[current]);
+                    if (current == UNKNOWN_SECTOR)
+                        quad_step = s;
+                }
+                tests++;
+                if ((crash_step == -1) == (quad_step == -1) &&
+                    abs(crash_step - quad_step) <= 1)
+                    crash_agree++;
+            }
+
+            int reachable;
+            if (!dg->findProfileReachableNode(i, xyz, next_node, &reachable))
+                continue;
+            const Vec3 line = dg->getNode(reachable)->getCenter() - xyz;
+            const int samples = int(line.length() / 0.5f) + 1;
+            int current = i;
+            for (int s = 0; s <= samples && current != UNKNOWN_SECTOR; s++)
+            {
+                dg->findRoadSector(xyz + line * (float(s) / samples),
+                                   &current, &look_ahead[current]);
+            }
+            reach_tests++;
+            if (current != UNKNOWN_SECTOR)
+                reach_agree++;
+        }
+    }
+    Log::info("DriveGraph", "%d nodes: crash step within one step of the "
+              "quad test in %d of %d tests, reachable node on the road in "
+              "%d of %d tests.", n, crash_agree, tests, reach_agree,
+              reach_tests);
+    // The profile is an approximation of the quads, so allow some errors
+    if (tests == 0 || crash_agree < 0.9f * tests ||
+        reach_agree < 0.9f * reach_tests)
+    {
+        Log::error("DriveGraph", "Road profiles differ too much from the "
+                   "quads.");
+    }
+
+    // Save the profiles, and load them again from the cache
+    std::vector<std::vector<DriveNode::ProfileSlice> > profiles(n);
+    std::vector<float> curve_radius(n);
+    for (unsigned int i = 0; i < n; i++)
+    {
+        profiles[i]     = dg->getNode(i)->getProfile();
+        curve_radius[i] = dg->getNode(i)->getCurveRadius();
+    }
+    dg->setupCache(quad_file, graph_file, scene_file);
+    const std::string cache_file = dg->m_cache_filename;
+    if (cache_file.empty())
+    {
+        Log::warn("DriveGraph", "No graph cache, cache not tested.");
+        Graph::destroy();
+        UserConfigParams::m_cache_graphs = cache_graphs;
+        return;
+    }
+    dg->saveCache(/*with_checklines*/false);
+    Graph::destroy();
+
+    UserConfigParams::m_cache_graphs = true;
+    dg = new DriveGraph(quad_file, graph_file, false, scene_file);
+    UserConfigParams::m_cache_graphs = cache_graphs;
+    if (!dg->isLoadedFromCache() || dg->getNumNodes() != n)
+        Log::fatal("DriveGraph", "Graph not loaded from the cache.");
+    for (unsigned int i = 0; i < n; i++)
+    {
+        const std::vector<DriveNode::ProfileSlice>& profile =
+            dg->getNode(i)->getProfile();
+        if (profile.size() != profiles[i].size() ||
+            dg->getNode(i)->getCurveRadius() != curve_radius[i] ||
+            (!profile.empty() &&
+             memcmp(profile.data(), profiles[i].data(),
+                    profile.size() * sizeof(DriveNode::ProfileSlice)) != 0))
+        {
+            Log::fatal("DriveGraph", "Cached profile of node %d differs.", i);
+        }
+    }
+    Graph::destroy();
+    file_manager->removeFile(cache_file);
+}   // unitTesting
+
 // -----------------------------------------------------------------------------
 /** This function sets a default successor for all graph nodes that currently
  *  don't have a successor defined. The default successor of node X is X+1.
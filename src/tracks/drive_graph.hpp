@@ -19,6 +19,7 @@
 #ifndef HEADER_DRIVE_GRAPH_HPP
 #define HEADER_DRIVE_GRAPH_HPP
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -29,6 +30,7 @@
 #include "LinearMath/btTransform.h"
 
 class DriveNode;
+class TriangleMesh;
 class XMLNode;
 
 /**
@@ -47,6 +49,31 @@ private:
     /** Wether the graph should be reverted or not */
     bool m_reverse;
 
+    /** Height testing values of all quads, from the quad file. */
+    float m_min_height_testing, m_max_height_testing;
+
+    /** All edges of the graph as (from, to) pairs, in the order in which
+     *  they were added (which defines the order of the predecessors). */
+    std::vector<std::pair<uint32_t, uint32_t> > m_edges;
+
+    /** Name of the cache file of the processed graph, empty if caching is
+     *  disabled. */
+    std::string m_cache_filename;
+
+    /** Hash of the source files and settings the graph depends on. */
+    uint64_t m_source_hash;
+
+    /** True if the graph (incl. paths) was loaded from the cache. */
+    bool m_loaded_from_cache;
+
+    /** True if the cache contained the checkline requirements. */
+    bool m_has_cached_checklines;
+
+    /** The checkline requirements of each node loaded from the cache. They
+     *  are only applied in computeChecklineRequirements(), since they are
+     *  not used in all modes. */
+    std::vector<std::vector<int> > m_cached_checklines;
+
     // ------------------------------------------------------------------------
     void setDefaultSuccessors();
     // ------------------------------------------------------------------------
@@ -54,6 +81,8 @@ private:
     // ------------------------------------------------------------------------
     void computeDirectionData();
     // ------------------------------------------------------------------------
+    void computeProfiles();
+    // ------------------------------------------------------------------------
     void determineDirection(unsigned int current, unsigned int succ_index);
     // ------------------------------------------------------------------------
     float normalizeAngle(float f);
@@ -62,6 +91,14 @@ private:
     // ------------------------------------------------------------------------
     void load(const std::string &quad_file_name, const std::string &filename);
     // ------------------------------------------------------------------------
+    void setupCache(const std::string &quad_file_name,
+                    const std::string &graph_file_name,
+                    const std::string &scene_file_name);
+    // ------------------------------------------------------------------------
+    bool loadCache();
+    // ------------------------------------------------------------------------
+    void saveCache(bool with_checklines) const;
+    // ------------------------------------------------------------------------
     void getPoint(const XMLNode *xml, const std::string &attribute_name,
                   Vec3 *result) const;
     // ------------------------------------------------------------------------
@@ -77,10 +114,13 @@ public:
     static DriveGraph* get()     { return dynamic_cast<DriveGraph*>(m_graph); }
     // ------------------------------------------------------------------------
     DriveGraph(const std::string &quad_file_name,
-               const std::string &graph_file_name, const bool reverse);
+               const std::string &graph_file_name, const bool reverse,
+               const std::string &scene_file_name = "");
     // ------------------------------------------------------------------------
     virtual ~DriveGraph() {}
     // ------------------------------------------------------------------------
+    static void unitTesting();
+    // ------------------------------------------------------------------------
     void getSuccessors(int node_number, std::vector<unsigned int>& succ,
                        bool for_ai=false) const;
     // ------------------------------------------------------------------------
@@ -99,6 +139,21 @@ public:
     // ------------------------------------------------------------------------
     void computeChecklineRequirements();
     // ------------------------------------------------------------------------
+    void computeGroundNormals(const TriangleMesh &mesh);
+    // ------------------------------------------------------------------------
+    bool findProfileCrashStep(int node, const Vec3 &xyz,
+                              const Vec3 &direction, float step_length,
+                              int steps, const std::vector<int> &next_node,
+                              int *crash_step) const;
+    // ------------------------------------------------------------------------
+    bool findProfileReachableNode(int node, const Vec3 &xyz,
+                                  const std::vector<int> &next_node,
+                                  int *reachable_node) const;
+    // ------------------------------------------------------------------------
+    bool getProfileGroundNormal(int node, const Vec3 &xyz,
+                                const std::vector<int> &next_node,
+                                Vec3 *normal) const;
+    // ------------------------------------------------------------------------
     /** Return the distance to the j-th successor of node n. */
     float getDistanceToNext(int n, int j) const;
     // ------------------------------------------------------------------------
@@ -119,6 +174,9 @@ public:
     float getLapLength() const                         { return m_lap_length; }
     // ------------------------------------------------------------------------
     bool isReverse() const                                { return m_reverse; }
+    // ------------------------------------------------------------------------
+    /** Returns true if the processed graph was loaded from the cache. */
+    bool isLoadedFromCache() const              { return m_loaded_from_cache; }
 
 };   // DriveGraph
 
@@ -23,6 +23,8 @@
 #include "tracks/drive_graph.hpp"
 #include "utils/log.hpp"
 
+#include <limits>
+
 // ----------------------------------------------------------------------------
 DriveNode::DriveNode(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2,
                      const Vec3 &p3, const Vec3 &normal,
@@ -32,6 +34,8 @@ DriveNode::DriveNode(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2,
 {
     m_ai_ignore           = ai_ignore;
     m_distance_from_start = -1.0f;
+    m_curve_radius        = std::numeric_limits<float>::max();
+    m_ground_normal       = normal;
 
     // The following values should depend on the actual orientation
     // of the quad. ATM we always assume that indices 0,1 are the lower end,
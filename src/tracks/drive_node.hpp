@@ -19,6 +19,7 @@
 #ifndef HEADER_DRIVE_NODE_HPP
 #define HEADER_DRIVE_NODE_HPP
 
+#include <cstdint>
 #include <vector>
 
 #include "tracks/quad.hpp"
@@ -36,6 +37,29 @@ public:
      *  AI only. */
     enum         DirectionType {DIR_STRAIGHT, DIR_LEFT, DIR_RIGHT,
                                 DIR_UNDEFINED};
+
+    /** One entry of the road profile of a drive node (see
+     *  DriveGraph::computeProfiles()). Positions are given in the 2d frame
+     *  of the node that owns the profile: the origin is its lower center,
+     *  'forward' is the distance along its driving direction and 'lateral'
+     *  the signed distance orthogonal to it. */
+    struct ProfileSlice
+    {
+        /** The drive node this slice describes. */
+        int   m_node;
+        /** Position of the center of the node. */
+        float m_forward, m_lateral;
+        /** Half of the safe road width at the center of the node, measured
+         *  along the lateral axis. */
+        float m_half_width;
+        /** Lateral clearance of the straight line from the center of the
+         *  first node of the profile to the center of this node, i.e. how
+         *  far the line can be moved sidewards and still stay on the road
+         *  till this node. Negative if this node can not be reached. */
+        float m_clearance;
+        /** Minimum and maximum height of the quad of the node. */
+        float m_min_height, m_max_height;
+    };   // ProfileSlice
 protected:
     /** Lower center point of the drive node. */
     Vec3 m_lower_center;
@@ -96,6 +120,16 @@ private:
      */
    std::vector< int > m_checkline_requirements;
 
+    /** The road ahead of this node when following successor 0, starting
+     *  with this node. Empty if the AI can't use a profile here. */
+    std::vector<ProfileSlice> m_profile;
+
+    /** Radius of the curve from this node to its first successor. */
+    float m_curve_radius;
+
+    /** Normal of the track mesh below the center of this node. */
+    Vec3 m_ground_normal;
+
 
     // ------------------------------------------------------------------------
    void markAllSuccessorsToUse(unsigned int n,
@@ -118,6 +152,35 @@ public:
     void         setDirectionData(unsigned int successor, DirectionType dir,
                                   unsigned int last_node_index);
     // ------------------------------------------------------------------------
+    /** Returns the path-to-node data, empty if there is only one successor.
+     *  Used to save the processed graph to the cache. */
+    const std::vector<int>& getPathsToNode() const   { return m_path_to_node; }
+    // ------------------------------------------------------------------------
+    /** Sets the path-to-node data loaded from the drive graph cache. */
+    void         setPathsToNode(const int32_t* path, unsigned int num)
+    {
+        m_path_to_node.assign(path, path + num);
+    }
+    // ------------------------------------------------------------------------
+    /** Returns the road profile ahead of this node. */
+    const std::vector<ProfileSlice>& getProfile() const   { return m_profile; }
+    // ------------------------------------------------------------------------
+    /** Sets the road profile, computed or loaded from the cache. */
+    void         setProfile(const ProfileSlice* slices, unsigned int num)
+    {
+        m_profile.assign(slices, slices + num);
+    }
+    // ------------------------------------------------------------------------
+    /** Returns the radius of the curve to the first successor. */
+    float        getCurveRadius() const              { return m_curve_radius; }
+    // ------------------------------------------------------------------------
+    void         setCurveRadius(float r)                { m_curve_radius = r; }
+    // ------------------------------------------------------------------------
+    /** Returns the normal of the track mesh below the center. */
+    const Vec3&  getGroundNormal() const            { return m_ground_normal; }
+    // ------------------------------------------------------------------------
+    void         setGroundNormal(const Vec3& n)        { m_ground_normal = n; }
+    // ------------------------------------------------------------------------
     /** Returns the number of successors. */
     unsigned int getNumberOfSuccessors() const
                              { return (unsigned int)m_successor_nodes.size(); }
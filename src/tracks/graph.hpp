@@ -56,6 +56,9 @@ protected:
 
     std::vector<Quad*> m_all_nodes;
 
+    /** The 4 closest graph nodes to the bounding box. */
+    int m_bb_nodes[4];
+
     // ------------------------------------------------------------------------
     /** Factory method to dynamic create 2d / 3d quad for drive and arena
      *  graph. */
@@ -72,9 +75,6 @@ private:
     Vec3 m_bb_min;
     Vec3 m_bb_max;
 
-    /** The 4 closest graph nodes to the bounding box. */
-    int m_bb_nodes[4];
-
     /** The node of the graph mesh. */
     scene::ISceneNode *m_node;
 
@@ -96,6 +96,9 @@ public:
     /** Returns the minimum height of a quad. */
     float getMinHeight() const                         { return m_min_height; }
     // ------------------------------------------------------------------------
+    /** Returns the maximum height of a quad. */
+    float getMaxHeight() const                         { return m_max_height; }
+    // ------------------------------------------------------------------------
     /** Returns the index of this quad. */
     int getIndex() const
     {
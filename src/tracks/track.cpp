@@ -75,11 +75,13 @@
 #include "tracks/drive_graph.hpp"
 #include "tracks/drive_node.hpp"
 #include "tracks/model_definition_loader.hpp"
+#include "tracks/track_cache.hpp"
 #include "tracks/track_manager.hpp"
 #include "tracks/track_object_manager.hpp"
 #include "utils/constants.hpp"
 #include "utils/log.hpp"
 #include "mini_glm.hpp"
+#include "utils/profiler.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/translation.hpp"
 
@@ -800,7 +802,8 @@ btQuaternion Track::getArenaStartRotation(const Vec3& xyz, float heading)
 void Track::loadDriveGraph(unsigned int mode_id, const bool reverse)
 {
     new DriveGraph(m_root+m_all_modes[mode_id].m_quad_name,
-        m_root+m_all_modes[mode_id].m_graph_name, reverse);
+        m_root+m_all_modes[mode_id].m_graph_name, reverse,
+        m_root+m_all_modes[mode_id].m_scene);
 
     // setGraph is done in DriveGraph constructor
     assert(DriveGraph::get());
@@ -1531,8 +1534,9 @@ bool Track::loadMainTrack(const XMLNode &root)
         main_loop->renderGUI(4400, i, m_all_nodes.size());
     }
 
-    // Free the tangent (track mesh) after converting to physics
-    if (GUIEngine::isNoGraphics())
+    // Free the tangent (track mesh) after converting to physics, unless
+    // the track cache may keep it (see freeCachedMeshVertexBuffer)
+    if (GUIEngine::isNoGraphics() && !TrackCache::get())
         tangent_mesh->freeMeshVertexBuffer();
 
     if (m_track_mesh == NULL)
@@ -1683,7 +1687,9 @@ void Track::update(int ticks)
     }
     float dt = stk_config->ticks2Time(ticks);
     m_check_manager->update(dt);
+    PROFILER_PUSH_CPU_MARKER("Track::update (items)", 0x20, 0x7F, 0x60);
     m_item_manager->update(ticks);
+    PROFILER_POP_CPU_MARKER();
 
     // TODO: enable onUpdate scripts if we ever find a compelling use for them
     //Scripting::ScriptEngine* script_engine = World::getWorld()->getScriptEngine();
@@ -1844,6 +1850,8 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
         reverse_track = false;
     }
     main_loop->renderGUI(3000);
+    if (TrackCache::get())
+        TrackCache::get()->startLoading();
     m_check_manager = new CheckManager();
     assert(m_all_cached_meshes.size()==0);
     if(UserConfigParams::logMemory())
@@ -2261,7 +2269,10 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
 
     main_loop->renderGUI(5600);
 
-    freeCachedMeshVertexBuffer();
+    // The track cache must take the meshes with their vertices, they are
+    // only freed below if it does not keep them
+    if (!TrackCache::get())
+        freeCachedMeshVertexBuffer();
 
     const bool arena_random_item_created =
         m_item_manager->randomItemsForArena(m_start_transforms);
@@ -2319,6 +2330,11 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
                   "positions might be incorrect.");
     }
 
+    // Keep the meshes loaded for the next races on this track
+    if (TrackCache::get() &&
+        !TrackCache::get()->finishLoading(m_ident, mode_id))
+        freeCachedMeshVertexBuffer();
+
     if (UserConfigParams::logMemory())
     {
         Log::debug("track", "[memory] After loading  '%s': mesh cache %d "
@@ -2332,6 +2348,8 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
     {
         DriveGraph::get()->computeChecklineRequirements();
     }
+    if (DriveGraph::get() && m_track_mesh)
+        DriveGraph::get()->computeGroundNormals(*m_track_mesh);
     main_loop->renderGUI(6000);
 
     EasterEggHunt *easter_world = dynamic_cast<EasterEggHunt*>(world);
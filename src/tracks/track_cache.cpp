@@ -0,0 +1,283 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "tracks/track_cache.hpp"
+
+#include "config/user_config.hpp"
+#include "graphics/irr_driver.hpp"
+#include "guiengine/engine.hpp"
+#include "network/server_metrics.hpp"
+#include "physics/triangle_mesh.hpp"
+#include "race/race_manager.hpp"
+#include "tracks/track.hpp"
+#include "utils/log.hpp"
+#include "utils/string_utils.hpp"
+
+#include <cassert>
+
+#include <IAnimatedMesh.h>
+#include <IMeshBuffer.h>
+#include <IMeshCache.h>
+#include <ISceneManager.h>
+
+TrackCache* TrackCache::m_track_cache = NULL;
+
+// ----------------------------------------------------------------------------
+/** Creates the cache.
+ *  \param max_bytes Maximum size of all cached meshes, 0 disables the cache.
+ */
+void TrackCache::create(uint64_t max_bytes)
+{
+    assert(!m_track_cache);
+    if (max_bytes == 0)
+        return;
+    m_track_cache = new TrackCache(max_bytes);
+    Log::info("TrackCache", "Keeping up to %uMB of track meshes loaded.",
+        (unsigned)(max_bytes / 1024 / 1024));
+}   // create
+
+// ----------------------------------------------------------------------------
+void TrackCache::destroy()
+{
+    delete m_track_cache;
+    m_track_cache = NULL;
+}   // destroy
+
+// ----------------------------------------------------------------------------
+TrackCache::TrackCache(uint64_t max_bytes)
+{
+    m_max_bytes = max_bytes;
+    m_bytes = 0;
+    m_hits = 0;
+    m_misses = 0;
+}   // TrackCache
+
+// ----------------------------------------------------------------------------
+TrackCache::~TrackCache()
+{
+    clear();
+}   // ~TrackCache
+
+// ----------------------------------------------------------------------------
+/** Returns the size of the vertices and indices of a mesh in bytes. */
+uint64_t TrackCache::getMeshSize(const scene::IMesh* mesh)
+{
+    uint64_t size = 0;
+    for (unsigned int i = 0; i < mesh->getMeshBufferCount(); i++)
+    {
+        const scene::IMeshBuffer* mb = mesh->getMeshBuffer(i);
+        size += (uint64_t)mb->getVertexCount() *
+            video::getVertexPitchFromType(mb->getVertexType());
+        size += (uint64_t)mb->getIndexCount() *
+            (mb->getIndexType() == video::EIT_32BIT ? 4 : 2);
+    }
+    return size;
+}   // getMeshSize
+
+// ----------------------------------------------------------------------------
+void TrackCache::getCachedMeshes(std::set<scene::IMesh*>* meshes) const
+{
+    scene::IMeshCache* cache = irr_driver->getSceneManager()->getMeshCache();
+    for (unsigned int i = 0; i < cache->getMeshCount(); i++)
+        meshes->insert(cache->getMeshByIndex(i));
+}   // getCachedMeshes
+
+// ----------------------------------------------------------------------------
+/** Called before a track is loaded, to find the meshes loaded for it
+ *  afterwards.
+ */
+void TrackCache::startLoading()
+{
+    m_meshes_before_loading.clear();
+    getCachedMeshes(&m_meshes_before_loading);
+}   // startLoading
+
+// ----------------------------------------------------------------------------
+/** Called after a track is loaded. It keeps all meshes which were added to
+ *  irrlicht's mesh cache since startLoading, and removes the least recently
+ *  used tracks if the cache is too big.
+ *  \param ident Ident of the track.
+ *  \param mode_id The mode of the track (which can have its own scene).
+ *  \return True if the track is kept in the cache, false if it was removed
+ *          again because it is too big.
+ */
+bool TrackCache::finishLoading(const std::string& ident, unsigned int mode_id)
+{
+    const std::string key = ident + ":" + StringUtils::toString(mode_id);
+    auto it = m_entries.begin();
+    while (it != m_entries.end() && it->m_key != key)
+        it++;
+    const bool hit = it != m_entries.end();
+    if (hit)
+    {
+        m_hits++;
+        m_entries.splice(m_entries.begin(), m_entries, it);
+    }
+    else
+    {
+        m_misses++;
+        Entry entry;
+        entry.m_key = key;
+        entry.m_bytes = 0;
+        m_entries.push_front(entry);
+    }
+
+    Entry& entry = m_entries.front();
+    std::set<scene::IMesh*> loaded;
+    getCachedMeshes(&loaded);
+    for (scene::IMesh* mesh : loaded)
+    {
+        if (m_meshes_before_loading.find(mesh) !=
+            m_meshes_before_loading.end())
+            continue;
+        scene::IAnimatedMesh* am = (scene::IAnimatedMesh*)mesh;
+        // The track keeps the first frame of static meshes (see
+        // IrrDriver::getMesh), which is what decides if the mesh is removed
+        // from the cache, so keep both
+        scene::IMesh* frame = am->getMesh(0);
+        std::vector<scene::IMesh*> keep;
+        if (frame)
+            keep.push_back(frame);
+        if (frame != mesh)
+            keep.push_back(mesh);
+        for (scene::IMesh* m : keep)
+        {
+            m->grab();
+            irr_driver->grabAllTextures(m);
+            entry.m_meshes.push_back(m);
+        }
+        const uint64_t size = getMeshSize(frame ? frame : mesh);
+        entry.m_bytes += size;
+        m_bytes += size;
+    }
+    m_meshes_before_loading.clear();
+
+    // Remove the least recently used tracks, the current one is removed
+    // as well if it is too big on its own
+    bool kept = true;
+    while (m_bytes > m_max_bytes && !m_entries.empty())
+    {
+        if (m_entries.size() == 1)
+            kept = false;
+        Log::info("TrackCache", "Removing '%s' from the cache.",
+            m_entries.back().m_key.c_str());
+        releaseEntry(&m_entries.back());
+        m_entries.pop_back();
+    }
+
+    Log::info("TrackCache", "%s for '%s', %u tracks with %uMB cached, "
+        "%u hits and %u misses so far.", hit ? "Hit" : "Miss", key.c_str(),
+        (unsigned)m_entries.size(), (unsigned)(m_bytes / 1024 / 1024),
+        m_hits, m_misses);
+    updateMetrics();
+    return kept;
+}   // finishLoading
+
+// ----------------------------------------------------------------------------
+/** Drops the references of an entry, in the same way as Track::cleanup
+ *  does, so a mesh which is not used anymore is removed from irrlicht's
+ *  mesh cache.
+ */
+void TrackCache::releaseEntry(Entry* entry)
+{
+    for (scene::IMesh* mesh : entry->m_meshes)
+    {
+        irr_driver->dropAllTextures(mesh);
+        // Already removed from the mesh cache (together with its animated
+        // mesh), this is the last reference
+        if (mesh->getReferenceCount() == 1)
+        {
+            mesh->drop();
+            continue;
+        }
+        mesh->drop();
+        if (mesh->getReferenceCount() == 1)
+            irr_driver->removeMeshFromCache(mesh);
+    }
+    entry->m_meshes.clear();
+    m_bytes -= entry->m_bytes;
+    entry->m_bytes = 0;
+}   // releaseEntry
+
+// ----------------------------------------------------------------------------
+/** Removes all tracks from the cache. */
+void TrackCache::clear()
+{
+    for (Entry& entry : m_entries)
+        releaseEntry(&entry);
+    m_entries.clear();
+    updateMetrics();
+}   // clear
+
+// ----------------------------------------------------------------------------
+void TrackCache::updateMetrics() const
+{
+    ServerMetrics* sm = ServerMetrics::get();
+    if (!sm)
+        return;
+    sm->setGauge(ServerMetrics::GT_TRACK_CACHE_HITS, m_hits);
+    sm->setGauge(ServerMetrics::GT_TRACK_CACHE_MISSES, m_misses);
+    sm->setGauge(ServerMetrics::GT_TRACK_CACHE_SIZE, (int64_t)m_bytes);
+}   // updateMetrics
+
+// ----------------------------------------------------------------------------
+/** Loads a track twice on a server without graphics, the second time with
+ *  the meshes from the cache, and checks that the physics are built from
+ *  the same triangles both times.
+ */
+void TrackCache::unitTesting()
+{
+    if (!GUIEngine::isNoGraphics())
+    {
+        Log::info("TrackCache", "Only used without graphics, not tested.");
+        return;
+    }
+    const bool created = m_track_cache == NULL;
+    if (created)
+        create(1024 * 1024 * 1024);
+    const unsigned int hits = m_track_cache->getHits();
+
+    RaceManager* rm = RaceManager::get();
+    unsigned int triangles[2];
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        rm->setMajorMode(RaceManager::MAJOR_MODE_SINGLE);
+        rm->setMinorMode(RaceManager::MINOR_MODE_NORMAL_RACE);
+        rm->setNumPlayers(0);
+        rm->setNumKarts(1);
+        rm->setDefaultAIKartList(std::vector<std::string>(1,
+                                          UserConfigParams::m_default_kart));
+        rm->setTrack("lighthouse");
+        rm->setReverseTrack(false);
+        rm->setNumLaps(1);
+        rm->setupPlayerKartInfo();
+        rm->startNew(false);
+        triangles[i] =
+            Track::getCurrentTrack()->getTriangleMesh().getNumTriangles();
+        rm->exitRace();
+    }
+    Log::info("TrackCache", "%u triangles when loaded, %u when cached.",
+        triangles[0], triangles[1]);
+    assert(triangles[0] > 0);
+    assert(triangles[1] == triangles[0]);
+    assert(m_track_cache->getHits() > hits);
+    (void)hits;
+
+    if (created)
+        destroy();
+}   // unitTesting
@@ -0,0 +1,118 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_TRACK_CACHE_HPP
+#define HEADER_TRACK_CACHE_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <cstdint>
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace irr
+{
+    namespace scene { class IMesh; }
+}
+using namespace irr;
+
+/**
+ *  \brief Keeps the meshes of recently used tracks loaded on a dedicated
+ *  server.
+ *  When a race ends, Track::cleanup removes all meshes of the track from
+ *  irrlicht's mesh cache, so the next race on the same track would read and
+ *  parse all model files again. This cache takes an additional reference
+ *  of each mesh which was added to irrlicht's mesh cache while a track was
+ *  loaded, so they stay in irrlicht's cache and are found there the next
+ *  time the track is loaded. The entries are kept in least recently used
+ *  order and removed when their total size exceeds the limit.
+ *  It is only created on a server without graphics, where a mesh is just
+ *  its vertices and indices in memory. Track::loadTrackModel does not free
+ *  the vertices of the meshes (which it does otherwise on such a server
+ *  once the physics are built) while the cache is used, since the next
+ *  load of the track builds its physics from the cached meshes.
+ *  \ingroup tracks
+ */
+class TrackCache : public NoCopy
+{
+private:
+    struct Entry
+    {
+        /** Track ident and mode. */
+        std::string m_key;
+        /** Each mesh is grabbed once. */
+        std::vector<scene::IMesh*> m_meshes;
+        uint64_t m_bytes;
+    };
+
+    static TrackCache* m_track_cache;
+
+    /** Most recently used entry first. */
+    std::list<Entry> m_entries;
+
+    /** Meshes in irrlicht's mesh cache before a track was loaded. */
+    std::set<scene::IMesh*> m_meshes_before_loading;
+
+    uint64_t m_max_bytes;
+
+    uint64_t m_bytes;
+
+    unsigned int m_hits;
+
+    unsigned int m_misses;
+
+    // ------------------------------------------------------------------------
+    TrackCache(uint64_t max_bytes);
+    // ------------------------------------------------------------------------
+    ~TrackCache();
+    // ------------------------------------------------------------------------
+    void getCachedMeshes(std::set<scene::IMesh*>* meshes) const;
+    // ------------------------------------------------------------------------
+    void releaseEntry(Entry* entry);
+    // ------------------------------------------------------------------------
+    void updateMetrics() const;
+
+public:
+    // ------------------------------------------------------------------------
+    static void create(uint64_t max_bytes);
+    // ------------------------------------------------------------------------
+    static void destroy();
+    // ------------------------------------------------------------------------
+    /** Returns the cache, or NULL if it is not used. */
+    static TrackCache* get()                           { return m_track_cache; }
+    // ------------------------------------------------------------------------
+    static uint64_t getMeshSize(const scene::IMesh* mesh);
+    // ------------------------------------------------------------------------
+    void startLoading();
+    // ------------------------------------------------------------------------
+    bool finishLoading(const std::string& ident, unsigned int mode_id);
+    // ------------------------------------------------------------------------
+    void clear();
+    // ------------------------------------------------------------------------
+    unsigned int getHits() const                             { return m_hits; }
+    // ------------------------------------------------------------------------
+    unsigned int getMisses() const                         { return m_misses; }
+    // ------------------------------------------------------------------------
+    uint64_t getSize() const                                { return m_bytes; }
+    // ------------------------------------------------------------------------
+    static void unitTesting();
+};   // TrackCache
+
+#endif
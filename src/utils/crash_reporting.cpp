@@ -108,6 +108,7 @@
                                 "Call stack:\n";
             msg += callstack;
             Log::error("StackTrace", "%s", msg.c_str());
+            Log::flushBuffers(/*crashed*/true);
             MessageBoxA(NULL, msg.c_str(), "SuperTuxKart crashed!", MB_ICONERROR | MB_OK);
         }   // winCrashHandler
 
@@ -412,6 +413,7 @@
             {
                 Log::warn("CrashReporting", "Failed loading or missing BFD of "
                           "STK binary, no backtrace available when reporting");
+                Log::flushBuffers(/*crashed*/true);
                 exit(0);
             }
 
@@ -425,6 +427,7 @@
                 // Skip 3 stacks which are crash_reporting doing
                 Log::error("CrashReporting", "%s", each[i].c_str());
             }
+            Log::flushBuffers(/*crashed*/true);
             exit(0);
         }
 
@@ -545,9 +548,36 @@
 
 #else
 
+#ifndef WIN32
+    #include <signal.h>
+#endif
+
     namespace CrashReporting
     {
+#ifndef WIN32
+        /** No backtrace is available without libbfd, but the lines of the
+         *  asynchronous log are still written before the default action.
+         *  Only async-signal-safe functions are used: flushBuffers(true)
+         *  writes with write() and takes no lock. */
+        void signalHandler(int signal_no)
+        {
+            Log::flushBuffers(/*crashed*/true);
+            raise(signal_no);
+        }   // signalHandler
+
+        // --------------------------------------------------------------------
+        void installHandlers()
+        {
+            struct sigaction sa;
+            memset(&sa, 0, sizeof(sa));
+            sa.sa_handler = &signalHandler;
+            sigemptyset(&sa.sa_mask);
+            sa.sa_flags = SA_RESETHAND;
+            sigaction(SIGSEGV, &sa, NULL);
+        }   // installHandlers
+#else
         void installHandlers() {}
+#endif
         void getCallStack(std::string& callstack) {}
     }   // end namespace CrashReporting
 
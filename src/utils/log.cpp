@@ -22,10 +22,16 @@
 #include "network/network_config.hpp"
 #include "utils/file_utils.hpp"
 #include "utils/tls.hpp"
+#include "utils/vs.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <ctime>
+#include <mutex>
 #include <stdio.h>
+#include <thread>
 
 #ifdef ANDROID
 #  include <android/log.h>
@@ -38,6 +44,10 @@
 #ifdef WIN32
 #  define WIN32_LEAN_AND_MEAN
 #  include <windows.h>
+#  include <io.h>
+#else
+#  include <errno.h>
+#  include <unistd.h>
 #endif
 
 Log::LogLevel Log::m_min_log_level = Log::LL_VERBOSE;
@@ -45,9 +55,103 @@ bool          Log::m_no_colors     = false;
 FILE*         Log::m_file_stdout   = NULL;
 size_t        Log::m_buffer_size = 1;
 bool          Log::m_console_log = true;
+std::atomic_bool Log::m_async(false);
 Synchronised<std::vector<struct Log::LineInfo> > Log::m_line_buffer;
 thread_local  char g_prefix[11] = {};
 
+// ============================================================================
+// Asynchronous logging
+//
+// Each thread stores its formatted lines in its own ring buffer, which is
+// only written by this thread and only read while g_async_mutex is held, so
+// a thread that logs does neither need a lock nor wait for any output. A
+// writer thread periodically writes all lines. Each line gets a global
+// sequence number, and the lines read in one batch are written sorted by it.
+// Lines of different threads are only ordered within a batch: a thread can
+// get its sequence number, then be suspended before it publishes the line,
+// and the writer thread meanwhile writes later lines of other threads. The
+// lines of one thread are always written in order.
+namespace
+{
+    /** Size of the ring buffer of each thread in bytes. */
+    const uint32_t ASYNC_BUFFER_SIZE = 1 << 16;
+
+    /** The end of a thread can not be detected, so buffers are never freed.
+     *  Threads started after that many buffers exist log synchronously. */
+    const unsigned int MAX_ASYNC_BUFFERS = 64;
+
+    struct AsyncLineHeader
+    {
+        uint64_t m_sequence;
+        uint16_t m_length;
+        uint8_t  m_level;
+    };   // AsyncLineHeader
+
+    struct AsyncBuffer
+    {
+        char m_data[ASYNC_BUFFER_SIZE];
+        std::atomic<uint32_t> m_write;
+        std::atomic<uint32_t> m_read;
+        /** Number of lines dropped since the buffer was full. */
+        std::atomic<uint32_t> m_dropped;
+        // --------------------------------------------------------------------
+        AsyncBuffer() : m_write(0), m_read(0), m_dropped(0) {}
+        // --------------------------------------------------------------------
+        void copyIn(uint32_t pos, const void *src, uint32_t size)
+        {
+            pos &= ASYNC_BUFFER_SIZE - 1;
+            uint32_t first = std::min(size, ASYNC_BUFFER_SIZE - pos);
+            memcpy(m_data + pos, src, first);
+            memcpy(m_data, (const char*)src + first, size - first);
+        }   // copyIn
+        // --------------------------------------------------------------------
+        void copyOut(uint32_t pos, void *dst, uint32_t size) const
+        {
+            pos &= ASYNC_BUFFER_SIZE - 1;
+            uint32_t first = std::min(size, ASYNC_BUFFER_SIZE - pos);
+            memcpy(dst, m_data + pos, first);
+            memcpy((char*)dst + first, m_data, size - first);
+        }   // copyOut
+    };   // AsyncBuffer
+
+    /** Plain arrays and pointers, so that nothing is destroyed at exit while
+     *  the writer thread might still run. */
+    AsyncBuffer              *g_async_buffers[MAX_ASYNC_BUFFERS];
+    std::atomic<unsigned int> g_async_buffer_count(0);
+    thread_local AsyncBuffer *g_async_buffer = NULL;
+    thread_local bool         g_async_no_buffer = false;
+    std::atomic<uint64_t>     g_async_sequence(0);
+    /** Protects reading the buffers and writing to the output. */
+    std::mutex                g_async_mutex;
+    std::condition_variable   g_async_cv;
+    std::thread              *g_async_thread = NULL;
+    bool                      g_async_stop = false;
+    std::atomic_bool          g_async_crashed(false);
+    /** File descriptor of the log file, so that it can be written from a
+     *  signal handler, or -1. */
+    int                       g_log_fd = -1;
+
+    // ------------------------------------------------------------------------
+    /** Writes to a file descriptor, it is async-signal-safe. */
+    void writeToFd(int fd, const char *data, uint32_t size)
+    {
+        while (size > 0)
+        {
+#ifdef WIN32
+            int n = _write(fd, data, size);
+#else
+            ssize_t n = write(fd, data, size);
+            if (n < 0 && errno == EINTR)
+                continue;
+#endif
+            if (n <= 0)
+                return;
+            data += n;
+            size -= (uint32_t)n;
+        }
+    }   // writeToFd
+}   // namespace
+
 // ----------------------------------------------------------------------------
 void Log::setPrefix(const char* prefix)
 {
@@ -199,6 +303,15 @@ void Log::printMessage(int level, const char *component, const char *format,
     index = index > MAX_LENGTH - 1 ? MAX_LENGTH - 1 : index;
     sprintf(line + index, "\n");
 
+    if (m_async.load(std::memory_order_relaxed))
+    {
+        addAsyncLine(line, index + 1, level);
+        // The program will exit after a fatal message
+        if (level == LL_FATAL)
+            flushBuffers();
+        return;
+    }
+
     // If the data is not buffered, immediately print it:
     if (m_buffer_size <= 1)
     {
@@ -296,9 +409,25 @@ void Log::toggleConsoleLog(bool val)
 
 // ----------------------------------------------------------------------------
 /** Flushes all stored log messages to the various output devices (thread safe).
+ *  \param crashed True if called from a crash handler (e.g. a signal
+ *         handler). In this case only the lines of the asynchronous mode
+ *         are written by writeAsyncLinesAfterCrash(), which is
+ *         async-signal-safe, and the lines buffered with --logbuffer are
+ *         not written.
  */
-void Log::flushBuffers()
+void Log::flushBuffers(bool crashed)
 {
+    if (crashed)
+    {
+        g_async_crashed.store(true);
+        writeAsyncLinesAfterCrash();
+        return;
+    }
+
+    g_async_mutex.lock();
+    writeAsyncLines();
+    g_async_mutex.unlock();
+
     m_line_buffer.lock();
     for (unsigned int i = 0; i < m_line_buffer.getData().size(); i++)
     {
@@ -326,6 +455,11 @@ void Log::openOutputFiles(const std::string &logout)
     {
         // Disable buffering so that messages are seen asap
         setvbuf(m_file_stdout, NULL, _IONBF, 0);
+#ifdef WIN32
+        g_log_fd = _fileno(m_file_stdout);
+#else
+        g_log_fd = fileno(m_file_stdout);
+#endif
     }
 } // closeOutputFiles
 
@@ -333,6 +467,248 @@ void Log::openOutputFiles(const std::string &logout)
 /** Function to close output files */
 void Log::closeOutputFiles()
 {
+    g_log_fd = -1;
     fclose(m_file_stdout);
 } // closeOutputFiles
 
+// ----------------------------------------------------------------------------
+/** Adds a line to the ring buffer of the current thread. If the buffer is
+ *  full, debug, verbose and info lines are dropped (and the number of
+ *  dropped lines is reported later), while warnings and errors wait for the
+ *  writer thread to make room. If no buffer is available for this thread
+ *  the line is written immediately.
+ *  \param line The line to add.
+ *  \param length Length of the line (not including the 0 byte).
+ *  \param level Message level.
+ */
+void Log::addAsyncLine(const char *line, int length, int level)
+{
+    if (!g_async_buffer && !g_async_no_buffer)
+    {
+        std::lock_guard<std::mutex> lock(g_async_mutex);
+        unsigned int count = g_async_buffer_count.load();
+        if (count < MAX_ASYNC_BUFFERS)
+        {
+            g_async_buffer = new AsyncBuffer();
+            g_async_buffers[count] = g_async_buffer;
+            g_async_buffer_count.store(count + 1);
+        }
+        else
+            g_async_no_buffer = true;
+    }
+    if (g_async_no_buffer)
+    {
+        std::lock_guard<std::mutex> lock(g_async_mutex);
+        writeLine(line, level);
+        return;
+    }
+
+    AsyncBuffer *ab = g_async_buffer;
+    AsyncLineHeader header;
+    header.m_length = (uint16_t)length;
+    header.m_level  = (uint8_t)level;
+    const uint32_t size = sizeof(header) + length;
+    const uint32_t w = ab->m_write.load(std::memory_order_relaxed);
+    // Wait at most one second for the writer thread, e.g. in case that it
+    // is stopped or has crashed
+    int wait = 0;
+    while (w + size - ab->m_read.load(std::memory_order_acquire) >
+           ASYNC_BUFFER_SIZE)
+    {
+        if (level < LL_WARN || wait++ >= 1000)
+        {
+            ab->m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        g_async_cv.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    header.m_sequence = g_async_sequence.fetch_add(1,
+                                                   std::memory_order_relaxed);
+    ab->copyIn(w, &header, sizeof(header));
+    ab->copyIn(w + sizeof(header), line, length);
+    ab->m_write.store(w + size, std::memory_order_release);
+    // Wake up the writer early if the buffer gets full
+    if (w + size - ab->m_read.load(std::memory_order_relaxed) >
+        ASYNC_BUFFER_SIZE / 2)
+        g_async_cv.notify_one();
+}   // addAsyncLine
+
+// ----------------------------------------------------------------------------
+/** Writes all lines of all thread buffers sorted by their sequence number.
+ *  Must be called with g_async_mutex locked (except after a crash).
+ */
+void Log::writeAsyncLines()
+{
+    struct Line
+    {
+        uint64_t m_sequence;
+        int m_level;
+        std::string m_text;
+        bool operator<(const Line &other) const
+        {
+            return m_sequence < other.m_sequence;
+        }
+    };
+    std::vector<Line> lines;
+    uint32_t dropped = 0;
+    const unsigned int count = g_async_buffer_count.load();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        AsyncBuffer *ab = g_async_buffers[i];
+        uint32_t r = ab->m_read.load(std::memory_order_relaxed);
+        const uint32_t w = ab->m_write.load(std::memory_order_acquire);
+        while (r != w)
+        {
+            AsyncLineHeader header;
+            ab->copyOut(r, &header, sizeof(header));
+            Line line;
+            line.m_sequence = header.m_sequence;
+            line.m_level = header.m_level;
+            line.m_text.resize(header.m_length);
+            ab->copyOut(r + sizeof(header), &line.m_text[0], header.m_length);
+            lines.push_back(line);
+            r += sizeof(header) + header.m_length;
+        }
+        ab->m_read.store(r, std::memory_order_release);
+        dropped += ab->m_dropped.exchange(0, std::memory_order_relaxed);
+    }
+    std::sort(lines.begin(), lines.end());
+    for (const Line &line : lines)
+        writeLine(line.m_text.c_str(), line.m_level);
+    if (dropped > 0)
+    {
+        char line[100];
+        snprintf(line, 100, "[warn   ] Log: %u lines were dropped since the "
+                 "log buffer was full.\n", dropped);
+        writeLine(line, LL_WARN);
+    }
+}   // writeAsyncLines
+
+// ----------------------------------------------------------------------------
+/** Writes the lines of all thread buffers after a crash. It is called from
+ *  signal handlers, so it only uses async-signal-safe functions: it takes
+ *  no lock (the crashed thread might hold g_async_mutex), allocates no
+ *  memory and writes with write() to the file descriptors of the console
+ *  and the log file. The lines of all buffers are merged by their sequence
+ *  number. The buffers are only read, since the writer thread might still
+ *  be using them, so a line it is writing at this time can appear twice.
+ */
+void Log::writeAsyncLinesAfterCrash()
+{
+    const unsigned int count = std::min(g_async_buffer_count.load(),
+                                        MAX_ASYNC_BUFFERS);
+    uint32_t read_pos[MAX_ASYNC_BUFFERS];
+    uint32_t write_pos[MAX_ASYNC_BUFFERS];
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const AsyncBuffer *ab = g_async_buffers[i];
+        read_pos[i]  = ab->m_read.load(std::memory_order_acquire);
+        write_pos[i] = ab->m_write.load(std::memory_order_acquire);
+    }
+    // Same condition as in writeLine
+    const int console_fd = m_console_log &&
+                           (m_buffer_size <= 1 || !m_file_stdout) ? 1 : -1;
+    while (true)
+    {
+        int next = -1;
+        AsyncLineHeader next_header;
+        for (unsigned int i = 0; i < count; i++)
+        {
+            if (read_pos[i] == write_pos[i])
+                continue;
+            AsyncLineHeader header;
+            g_async_buffers[i]->copyOut(read_pos[i], &header, sizeof(header));
+            if (next == -1 || header.m_sequence < next_header.m_sequence)
+            {
+                next = i;
+                next_header = header;
+            }
+        }
+        if (next == -1)
+            return;
+
+        const AsyncBuffer *ab = g_async_buffers[next];
+        const uint32_t pos = (read_pos[next] + sizeof(next_header)) &
+                             (ASYNC_BUFFER_SIZE - 1);
+        const uint32_t first = std::min((uint32_t)next_header.m_length,
+                                        ASYNC_BUFFER_SIZE - pos);
+        const int fds[] = { console_fd, g_log_fd };
+        for (int fd : fds)
+        {
+            if (fd == -1)
+                continue;
+            writeToFd(fd, ab->m_data + pos, first);
+            writeToFd(fd, ab->m_data, next_header.m_length - first);
+        }
+        read_pos[next] += sizeof(next_header) + next_header.m_length;
+    }
+}   // writeAsyncLinesAfterCrash
+
+// ----------------------------------------------------------------------------
+void Log::asyncWriterLoop()
+{
+    VS::setThreadName("LogWriter");
+    std::unique_lock<std::mutex> ul(g_async_mutex);
+    while (!g_async_stop)
+    {
+        // After a crash the lines are written by the crash handler
+        if (!g_async_crashed.load())
+            writeAsyncLines();
+        g_async_cv.wait_for(ul, std::chrono::milliseconds(50));
+    }
+    if (!g_async_crashed.load())
+        writeAsyncLines();
+}   // asyncWriterLoop
+
+// ----------------------------------------------------------------------------
+void Log::flushAtExit()
+{
+    // After a crash the lines are already written, and the lock might be
+    // held by the crashed thread
+    if (g_async_crashed.load())
+        return;
+    setAsync(false);
+}   // flushAtExit
+
+// ----------------------------------------------------------------------------
+/** Enables or disables asynchronous logging. If enabled, threads that log
+ *  only store the formatted line in a ring buffer, and a separate thread
+ *  writes the lines to the console and log file. When disabled, all
+ *  remaining lines are written before this function returns.
+ */
+void Log::setAsync(bool async)
+{
+    std::unique_lock<std::mutex> ul(g_async_mutex);
+    if (async == (g_async_thread != NULL))
+        return;
+    if (async)
+    {
+        static bool at_exit_registered = false;
+        if (!at_exit_registered)
+        {
+            atexit(flushAtExit);
+            at_exit_registered = true;
+        }
+        g_async_stop = false;
+        m_async.store(true);
+        g_async_thread = new std::thread(asyncWriterLoop);
+        return;
+    }
+
+    m_async.store(false);
+    g_async_stop = true;
+    std::thread *thread = g_async_thread;
+    g_async_thread = NULL;
+    ul.unlock();
+    g_async_cv.notify_one();
+    if (thread->get_id() == std::this_thread::get_id())
+        thread->detach();
+    else
+        thread->join();
+    delete thread;
+
+    // A thread might have added a line after the writer stopped
+    ul.lock();
+    writeAsyncLines();
+}   // setAsync
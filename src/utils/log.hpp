@@ -22,6 +22,7 @@
 
 #include "utils/synchronised.hpp"
 
+#include <atomic>
 #include <assert.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -78,9 +79,18 @@ private:
      ** the maximum number of lines the buffer should hold. */
     static size_t m_buffer_size;
 
+    /** If set, lines are stored in per-thread ring buffers and written by
+     *  a separate writer thread. */
+    static std::atomic_bool m_async;
+
     static void setTerminalColor(LogLevel level);
     static void resetTerminalColor();
     static void writeLine(const char *line, int level);
+    static void addAsyncLine(const char *line, int length, int level);
+    static void writeAsyncLines();
+    static void writeAsyncLinesAfterCrash();
+    static void asyncWriterLoop();
+    static void flushAtExit();
 
     static void printMessage(int level, const char *component,
                              const char *format, VALIST va_list);
@@ -116,8 +126,9 @@ public:
     static void openOutputFiles(const std::string &logout);
 
     static void closeOutputFiles();
-    static void flushBuffers();
+    static void flushBuffers(bool crashed = false);
     static void toggleConsoleLog(bool val);
+    static void setAsync(bool async);
 
     // ------------------------------------------------------------------------
     /** Sets the number of lines to buffer. Setting the buffer size to a 
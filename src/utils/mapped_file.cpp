@@ -0,0 +1,199 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "utils/mapped_file.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
+#include "utils/string_utils.hpp"
+
+#if defined(WIN32)
+#  include <windows.h>
+#elif !defined(__SWITCH__)
+#  define STK_HAS_MMAP
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+// ----------------------------------------------------------------------------
+MappedFile::MappedFile()
+{
+    m_data = NULL;
+    m_size = 0;
+#if defined(WIN32)
+    m_file_handle    = NULL;
+    m_mapping_handle = NULL;
+#endif
+}   // MappedFile
+
+// ----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    close();
+}   // ~MappedFile
+
+// ----------------------------------------------------------------------------
+/** 64-bit FNV-1a hash, used to detect if the source of a cached file has
+ *  changed. It is not meant to be cryptographically secure.
+ *  \param seed Result of a previous call to combine several blocks.
+ */
+uint64_t MappedFile::hash(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t h = seed;
+    for (size_t i = 0; i < size; i++)
+    {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}   // hash
+
+// ----------------------------------------------------------------------------
+/** Returns the hash of the content of a file, or 0 if it can't be read. */
+uint64_t MappedFile::hashFile(const std::string& u8_path)
+{
+    MappedFile file;
+    if (!file.open(u8_path))
+        return 0;
+    return hash(file.getData(), file.getSize());
+}   // hashFile
+
+// ----------------------------------------------------------------------------
+/** Opens the given file. Any previously opened file is closed first.
+ *  \param u8_path Utf8 encoded path of the file.
+ *  \return True if the file could be opened, false otherwise (this includes
+ *          empty files).
+ */
+bool MappedFile::open(const std::string& u8_path)
+{
+    close();
+#if defined(WIN32)
+    irr::core::stringw w_path = StringUtils::utf8ToWide(u8_path);
+    HANDLE file = CreateFileW(w_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0,
+        NULL);
+    if (mapping == NULL)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file_handle    = file;
+    m_mapping_handle = mapping;
+    m_data = (const uint8_t*)data;
+    m_size = (size_t)size.QuadPart;
+    return true;
+#elif defined(STK_HAS_MMAP)
+    int fd = ::open(u8_path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        Log::warn("MappedFile", "Can't map '%s', reading it instead.",
+            u8_path.c_str());
+    }
+    else
+    {
+        m_data = (const uint8_t*)data;
+        m_size = (size_t)st.st_size;
+        return true;
+    }
+#endif
+
+#if !defined(WIN32)
+    // Fallback if memory mapping is not available
+    FILE* fp = FileUtils::fopenU8Path(u8_path, "rb");
+    if (!fp)
+        return false;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size <= 0)
+    {
+        fclose(fp);
+        return false;
+    }
+    m_buffer.resize((size_t)size);
+    if (fread(m_buffer.data(), 1, m_buffer.size(), fp) != m_buffer.size())
+    {
+        fclose(fp);
+        m_buffer.clear();
+        return false;
+    }
+    fclose(fp);
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return true;
+#endif
+}   // open
+
+// ----------------------------------------------------------------------------
+/** Unmaps the file (or frees the buffer). Pointers returned by getData()
+ *  are invalid afterwards. */
+void MappedFile::close()
+{
+    if (m_data == NULL)
+        return;
+#if defined(WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle((HANDLE)m_mapping_handle);
+    CloseHandle((HANDLE)m_file_handle);
+    m_mapping_handle = NULL;
+    m_file_handle    = NULL;
+#else
+    if (m_buffer.empty())
+    {
+#   ifdef STK_HAS_MMAP
+        munmap((void*)m_data, m_size);
+#   endif
+    }
+    else
+    {
+        m_buffer.clear();
+        m_buffer.shrink_to_fit();
+    }
+#endif
+    m_data = NULL;
+    m_size = 0;
+}   // close
@@ -0,0 +1,90 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_MAPPED_FILE_HPP
+#define HEADER_MAPPED_FILE_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** A read-only view of a whole file. On platforms with memory mapping the
+ *  file is mapped into the address space, so that only the pages actually
+ *  accessed are read from disk, and the pages are shared between processes
+ *  (e.g. the game and its child server process). On other platforms the
+ *  file is read into memory. Used for the binary caches and file formats
+ *  which are designed to be accessed in place.
+ *  \ingroup utils
+ */
+class MappedFile : public NoCopy
+{
+private:
+    /** Start of the file contents, NULL if no file is open. */
+    const uint8_t* m_data;
+
+    /** Size of the file in bytes. */
+    size_t m_size;
+
+    /** Used if the file can not be mapped. */
+    std::vector<uint8_t> m_buffer;
+
+#if defined(WIN32)
+    void* m_file_handle;
+    void* m_mapping_handle;
+#endif
+
+public:
+    MappedFile();
+    // ------------------------------------------------------------------------
+    ~MappedFile();
+    // ------------------------------------------------------------------------
+    static uint64_t hash(const void* data, size_t size,
+                         uint64_t seed = 14695981039346656037ULL);
+    // ------------------------------------------------------------------------
+    static uint64_t hashFile(const std::string& u8_path);
+    // ------------------------------------------------------------------------
+    bool open(const std::string& u8_path);
+    // ------------------------------------------------------------------------
+    void close();
+    // ------------------------------------------------------------------------
+    /** Returns true if a file is currently open. */
+    bool isOpen() const                           { return m_data != NULL; }
+    // ------------------------------------------------------------------------
+    /** Returns the start of the file contents. */
+    const uint8_t* getData() const                          { return m_data; }
+    // ------------------------------------------------------------------------
+    /** Returns the size of the file in bytes. */
+    size_t getSize() const                                  { return m_size; }
+    // ------------------------------------------------------------------------
+    /** Returns a pointer to a T at the given byte offset, or NULL if the
+     *  requested range is outside of the file. */
+    template<typename T>
+    const T* getAt(size_t offset, size_t count = 1) const
+    {
+        if (m_data == NULL || offset > m_size ||
+            count > (m_size - offset) / sizeof(T))
+            return NULL;
+        return reinterpret_cast<const T*>(m_data + offset);
+    }   // getAt
+
+};   // MappedFile
+
+#endif
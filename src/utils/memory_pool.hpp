@@ -0,0 +1,145 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_MEMORY_POOL_HPP
+#define HEADER_MEMORY_POOL_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ *  \brief Keeps freed memory blocks of one size for reuse, so that objects
+ *  which are frequently created and destroyed (e.g. projectiles) do not
+ *  need a heap allocation each time. The size of the blocks is set by the
+ *  first allocation, blocks of a different size are passed on to the heap.
+ *  The pool is not thread safe, each pool must only be used by one thread.
+ *  \ingroup utils
+ */
+class MemoryPool : public NoCopy
+{
+private:
+    /** Size of the pooled blocks, 0 if not known yet. */
+    size_t m_block_size;
+
+    /** Maximum number of free blocks to keep. */
+    size_t m_max_free;
+
+    /** The free blocks. */
+    std::vector<void*> m_free;
+
+public:
+    /** \param max_free Maximum number of free blocks to keep. */
+    MemoryPool(size_t max_free = 32)
+    {
+        m_block_size = 0;
+        m_max_free   = max_free;
+    }   // MemoryPool
+    // ------------------------------------------------------------------------
+    ~MemoryPool()
+    {
+        for (void *p : m_free)
+            ::operator delete(p);
+    }   // ~MemoryPool
+    // ------------------------------------------------------------------------
+    /** Returns a block of the given size. */
+    void* allocate(size_t size)
+    {
+        if (m_block_size == 0)
+            m_block_size = size;
+        if (size == m_block_size && !m_free.empty())
+        {
+            void *p = m_free.back();
+            m_free.pop_back();
+            return p;
+        }
+        return ::operator new(size);
+    }   // allocate
+    // ------------------------------------------------------------------------
+    /** Returns a block to the pool (or frees it if the pool is full). */
+    void deallocate(void *p, size_t size)
+    {
+        if (size == m_block_size && m_free.size() < m_max_free)
+            m_free.push_back(p);
+        else
+            ::operator delete(p);
+    }   // deallocate
+    // ------------------------------------------------------------------------
+    /** Returns the number of free blocks in the pool. */
+    size_t getNumFree() const                         { return m_free.size(); }
+};   // MemoryPool
+
+// ============================================================================
+/**
+ *  \brief A standard allocator which gets single objects from a MemoryPool.
+ *  It is meant to be used with std::allocate_shared, which allocates the
+ *  object and the reference count in one block. The allocator (and so the
+ *  pool) is kept alive by the shared pointer as long as the object exists.
+ *  \ingroup utils
+ */
+template<typename T>
+class PoolAllocator
+{
+private:
+    template<typename U> friend class PoolAllocator;
+
+    std::shared_ptr<MemoryPool> m_pool;
+
+public:
+    typedef T value_type;
+    template<typename U> struct rebind { typedef PoolAllocator<U> other; };
+
+    // ------------------------------------------------------------------------
+    explicit PoolAllocator(const std::shared_ptr<MemoryPool> &pool)
+        : m_pool(pool) {}
+    // ------------------------------------------------------------------------
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U> &other) : m_pool(other.m_pool) {}
+    // ------------------------------------------------------------------------
+    T* allocate(size_t n)
+    {
+        if (n != 1)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(m_pool->allocate(sizeof(T)));
+    }   // allocate
+    // ------------------------------------------------------------------------
+    void deallocate(T *p, size_t n)
+    {
+        if (n != 1)
+            ::operator delete(p);
+        else
+            m_pool->deallocate(p, sizeof(T));
+    }   // deallocate
+    // ------------------------------------------------------------------------
+    template<typename U>
+    bool operator==(const PoolAllocator<U> &other) const
+    {
+        return m_pool == other.m_pool;
+    }   // operator==
+    // ------------------------------------------------------------------------
+    template<typename U>
+    bool operator!=(const PoolAllocator<U> &other) const
+    {
+        return m_pool != other.m_pool;
+    }   // operator!=
+};   // PoolAllocator
+
+#endif
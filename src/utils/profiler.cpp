@@ -30,15 +30,18 @@
 #include "replay/replay_play.hpp"
 #include "tracks/track.hpp"
 #include "utils/file_utils.hpp"
+#include "utils/log.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/tls.hpp"
 #include "utils/vs.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <ostream>
 #include <stack>
 #include <sstream>
+#include <string.h>
 
 #include <IVideoDriver.h>
 
@@ -82,6 +85,169 @@ Profiler profiler;
 #endif
 // --- End portable precise timer ---
 
+// ============================================================================
+// Continuous trace export
+//
+// Each thread writes its events into its own ring buffer, which is only
+// written by this thread and only read by the trace writer thread, so no
+// lock is needed to record an event. The writer thread periodically moves
+// all events into a file in the Chrome trace event format, which can be
+// loaded in chrome://tracing or Perfetto.
+namespace
+{
+    /** Name of the current thread (set by VS::setThreadName), used for the
+     *  trace buffer of this thread. */
+    thread_local char g_thread_name[32] = { 0 };
+
+    /** The trace buffer of the current thread. */
+    thread_local Profiler::TraceBuffer* g_trace_buffer = NULL;
+
+    /** Number of events in each trace buffer, must be a power of 2. */
+    const uint32_t TRACE_BUFFER_SIZE = 1 << 15;
+
+    /** Appends a string to a JSON text, escaping as needed. */
+    void addJSONString(const char* s, std::string* json)
+    {
+        *json += "\"";
+        for (; *s; s++)
+        {
+            const unsigned char c = (unsigned char)*s;
+            if (c == '"' || c == '\\')
+            {
+                *json += '\\';
+                *json += (char)c;
+            }
+            else if (c < 0x20)
+                *json += ' ';
+            else
+                *json += (char)c;
+        }
+        *json += "\"";
+    }   // addJSONString
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** One recorded trace event. */
+struct TraceEvent
+{
+    /** Time of the event in ms, see getTimeMilliseconds(). */
+    double   m_time;
+    /** Value of counter events. */
+    unsigned m_value;
+    /** The phase of the event in the trace format: 'B' (begin), 'E' (end),
+     *  'i' (instant) or 'C' (counter). */
+    char     m_phase;
+    /** Name of the event, not used for 'E' events. */
+    char     m_name[51];
+};   // TraceEvent
+
+// ----------------------------------------------------------------------------
+/** A single producer, single consumer ring buffer of trace events. */
+struct Profiler::TraceBuffer
+{
+    std::vector<TraceEvent> m_events;
+
+    /** Number of events written, only changed by the owning thread. */
+    std::atomic<uint32_t> m_write;
+
+    /** Number of events read, only changed by the writer thread. */
+    std::atomic<uint32_t> m_read;
+
+    /** Number of events dropped because the buffer was full. */
+    std::atomic<uint32_t> m_dropped;
+
+    /** Thread id in the trace. */
+    int m_tid;
+
+    /** Name of the thread, protected by the trace mutex. */
+    std::string m_name;
+
+    /** True if the name was changed and must be written again, protected
+     *  by the trace mutex. */
+    bool m_name_changed;
+
+    // The following are only used by the owning thread:
+    /** The trace this buffer was last used in. */
+    unsigned int m_generation;
+
+    /** Number of 'B' events recorded in this trace without an 'E' event. */
+    uint32_t m_depth;
+
+    /** Number of 'B' events dropped without an 'E' event. As long as this
+     *  is not 0, all events are dropped, so that begin and end events
+     *  still match. */
+    uint32_t m_skip;
+
+    // ------------------------------------------------------------------------
+    TraceBuffer(int tid, const std::string& name)
+        : m_events(TRACE_BUFFER_SIZE), m_tid(tid), m_name(name),
+          m_name_changed(true), m_generation(0), m_depth(0), m_skip(0)
+    {
+        m_write.store(0);
+        m_read.store(0);
+        m_dropped.store(0);
+    }   // TraceBuffer
+
+    // ------------------------------------------------------------------------
+    /** Adds an event, called from the owning thread only. */
+    void add(char phase, const char* name, unsigned value, double time,
+             unsigned int generation)
+    {
+        if (m_generation != generation)
+        {
+            m_generation = generation;
+            m_depth = 0;
+            m_skip = 0;
+        }
+        if (phase == 'E')
+        {
+            if (m_skip > 0)
+            {
+                m_skip--;
+                return;
+            }
+            // The begin event was before the trace was started
+            if (m_depth == 0)
+                return;
+        }
+        else if (m_skip > 0)
+        {
+            if (phase == 'B')
+                m_skip++;
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const uint32_t w = m_write.load(std::memory_order_relaxed);
+        const uint32_t r = m_read.load(std::memory_order_acquire);
+        // Always keep room for the end events of all open begin events,
+        // so that an end event is never dropped.
+        if (phase != 'E' && w - r + m_depth + 1 >= TRACE_BUFFER_SIZE)
+        {
+            if (phase == 'B')
+                m_skip++;
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        TraceEvent& e = m_events[w & (TRACE_BUFFER_SIZE - 1)];
+        e.m_time  = time;
+        e.m_value = value;
+        e.m_phase = phase;
+        if (name)
+        {
+            strncpy(e.m_name, name, sizeof(e.m_name) - 1);
+            e.m_name[sizeof(e.m_name) - 1] = 0;
+        }
+        else
+            e.m_name[0] = 0;
+        if (phase == 'B')
+            m_depth++;
+        else if (phase == 'E')
+            m_depth--;
+        m_write.store(w + 1, std::memory_order_release);
+    }   // add
+};   // TraceBuffer
+
 //-----------------------------------------------------------------------------
 Profiler::Profiler()
 {
@@ -97,11 +263,19 @@ Profiler::Profiler()
     m_has_wrapped_around  = false;
     m_drawing             = true;
     m_threads_used = 1;
+    m_tracing.store(false);
+    m_trace_generation.store(0);
+    m_trace_file          = NULL;
+    m_trace_start         = 0.0;
+    m_trace_first_event   = true;
 }   // Profiler
 
 //-----------------------------------------------------------------------------
 Profiler::~Profiler()
 {
+    stopTrace();
+    for (TraceBuffer* tb : m_trace_buffers)
+        delete tb;
 }   // ~Profiler
 
 thread_local int g_thread_id = -1;
@@ -129,6 +303,7 @@ void Profiler::reset()
         ThreadData &td = m_all_threads_data[i];
         td.m_all_event_data.clear();
         td.m_event_stack.clear();
+        td.m_start_stack.clear();
         td.m_ordered_headings.clear();
     }   // for i in threads
 
@@ -161,6 +336,9 @@ int Profiler::getThreadID()
 /// Push a new marker that starts now
 void Profiler::pushCPUMarker(const char* name, const video::SColor& colour)
 {
+    if (isTracing())
+        addTraceEvent('B', name);
+
     // Don't do anything when disabled or frozen
     if (!UserConfigParams::m_profiler_enabled ||
          m_freeze_state == FROZEN || m_freeze_state == WAITING_FOR_UNFREEZE )
@@ -173,7 +351,8 @@ void Profiler::pushCPUMarker(const char* name, const video::SColor& colour)
 
     ThreadData &td = m_all_threads_data[thread_id];
     AllEventData::iterator i = td.m_all_event_data.find(name);
-    double  start = getTimeMilliseconds() - m_time_last_sync;
+    double  now   = getTimeMilliseconds();
+    double  start = now - m_time_last_sync;
     if (i != td.m_all_event_data.end())
     {
         i->second.setStart(m_current_frame, start, (int)td.m_event_stack.size());
@@ -190,6 +369,7 @@ void Profiler::pushCPUMarker(const char* name, const video::SColor& colour)
         td.m_ordered_headings.push_back(name);
     }
     td.m_event_stack.push_back(name);
+    td.m_start_stack.push_back(now);
     m_lock.unlock();
 }   // pushCPUMarker
 
@@ -197,6 +377,9 @@ void Profiler::pushCPUMarker(const char* name, const video::SColor& colour)
 /// Stop the last pushed marker
 void Profiler::popCPUMarker()
 {
+    if (isTracing())
+        addTraceEvent('E', NULL);
+
     // Don't do anything when disabled or frozen
     if( !UserConfigParams::m_profiler_enabled ||
         m_freeze_state == FROZEN || m_freeze_state == WAITING_FOR_UNFREEZE )
@@ -219,12 +402,57 @@ void Profiler::popCPUMarker()
     assert(td.m_event_stack.size() > 0);
 
     const std::string &name = td.m_event_stack.back();
-    td.m_all_event_data[name].setEnd(m_current_frame, now - m_time_last_sync);
+    EventData &ed = td.m_all_event_data[name];
+    ed.setEnd(m_current_frame, now - m_time_last_sync);
+    ed.addToTotal(now - td.m_start_stack.back());
 
     td.m_event_stack.pop_back();
+    td.m_start_stack.pop_back();
     m_lock.unlock();
 }   // popCPUMarker
 
+//-----------------------------------------------------------------------------
+/** Returns the total duration (in ms) and number of occurrences of each
+ *  event since the last call to clearEventTotals(), summed over all
+ *  threads. Unlike the per frame data this is not limited by the size of
+ *  the circular buffer, so it can be used for long headless runs.
+ */
+std::map<std::string, Profiler::EventTotal> Profiler::getEventTotals()
+{
+    std::map<std::string, EventTotal> totals;
+    m_lock.lock();
+    for (int i = 0; i < m_threads_used && i < (int)m_all_threads_data.size();
+         i++)
+    {
+        const ThreadData &td = m_all_threads_data[i];
+        for (AllEventData::const_iterator it = td.m_all_event_data.begin();
+             it != td.m_all_event_data.end(); it++)
+        {
+            EventTotal &total = totals[it->first];
+            total.m_duration += it->second.getTotalDuration();
+            total.m_count    += it->second.getTotalCount();
+        }
+    }
+    m_lock.unlock();
+    return totals;
+}   // getEventTotals
+
+//-----------------------------------------------------------------------------
+/** Resets the totals returned by getEventTotals().
+ */
+void Profiler::clearEventTotals()
+{
+    m_lock.lock();
+    for (int i = 0; i < m_threads_used && i < (int)m_all_threads_data.size();
+         i++)
+    {
+        AllEventData &aed = m_all_threads_data[i].m_all_event_data;
+        for (AllEventData::iterator it = aed.begin(); it != aed.end(); it++)
+            it->second.clearTotal();
+    }
+    m_lock.unlock();
+}   // clearEventTotals
+
 //-----------------------------------------------------------------------------
 /** Switches the profiler on
  */
@@ -263,6 +491,23 @@ void Profiler::desactivate()
  */
 void Profiler::synchronizeFrame()
 {
+    if (isTracing())
+    {
+        addTraceEvent('i', "Frame");
+#ifndef SERVER_ONLY
+        // The GPU timers are only read here, in the thread owning the
+        // OpenGL context.
+        if (!GUIEngine::isNoGraphics())
+        {
+            for (unsigned i = 0; i < Q_LAST; i++)
+            {
+                addTraceEvent('C', irr_driver->getGPUQueryPhaseName(i),
+                              irr_driver->getGPUTimer(i).elapsedTimeus());
+            }
+        }
+#endif
+    }
+
     // Don't do anything when frozen
     if(!UserConfigParams::m_profiler_enabled || m_freeze_state == FROZEN)
         return;
@@ -810,3 +1055,276 @@ void Profiler::writeToFile()
     m_lock.unlock();
 
 }   // writeFile
+
+// ============================================================================
+// Continuous trace export (see TraceBuffer at the top of this file)
+// ----------------------------------------------------------------------------
+/** Called by VS::setThreadName, so that traces show the thread names. */
+void setProfilerThreadName(const char* name)
+{
+    Profiler::setThreadName(name);
+}   // setProfilerThreadName
+
+// ----------------------------------------------------------------------------
+/** Sets the name of the current thread in traces. */
+void Profiler::setThreadName(const char* name)
+{
+    strncpy(g_thread_name, name, sizeof(g_thread_name) - 1);
+    g_thread_name[sizeof(g_thread_name) - 1] = 0;
+    if (g_trace_buffer)
+    {
+        std::lock_guard<std::mutex> lock(profiler.m_trace_mutex);
+        g_trace_buffer->m_name = g_thread_name;
+        g_trace_buffer->m_name_changed = true;
+    }
+}   // setThreadName
+
+// ----------------------------------------------------------------------------
+/** Returns the trace buffer of the current thread, creating it if this
+ *  thread had not recorded a trace event before. */
+Profiler::TraceBuffer* Profiler::getTraceBuffer()
+{
+    if (g_trace_buffer)
+        return g_trace_buffer;
+    std::lock_guard<std::mutex> lock(m_trace_mutex);
+    const int tid = (int)m_trace_buffers.size();
+    std::string name = g_thread_name;
+    if (name.empty())
+        name = "Thread " + StringUtils::toString(tid);
+    g_trace_buffer = new TraceBuffer(tid, name);
+    m_trace_buffers.push_back(g_trace_buffer);
+    return g_trace_buffer;
+}   // getTraceBuffer
+
+// ----------------------------------------------------------------------------
+/** Records a trace event in the buffer of the current thread. */
+void Profiler::addTraceEvent(char phase, const char* name, unsigned value)
+{
+    getTraceBuffer()->add(phase, name, value, getTimeMilliseconds(),
+                          m_trace_generation.load(std::memory_order_relaxed));
+}   // addTraceEvent
+
+// ----------------------------------------------------------------------------
+/** Starts writing all markers to a file in the Chrome trace event format,
+ *  till stopTrace() is called. This works without graphics (e.g. on
+ *  servers) and is independent of the on-screen profiler and its limits.
+ *  \param filename Name of the JSON file to write.
+ *  \return True if the file could be opened.
+ */
+bool Profiler::startTrace(const std::string& filename)
+{
+    stopTrace();
+    m_trace_file = FileUtils::fopenU8Path(filename, "wb");
+    if (!m_trace_file)
+    {
+        Log::error("Profiler", "Can't open trace file '%s'.",
+                   filename.c_str());
+        return false;
+    }
+    // startTrace is called from the main thread
+    if (!g_thread_name[0])
+        setThreadName("Main");
+
+    std::unique_lock<std::mutex> lock(m_trace_mutex);
+    for (TraceBuffer* tb : m_trace_buffers)
+    {
+        // Discard events of a previous trace
+        tb->m_read.store(tb->m_write.load());
+        tb->m_dropped.store(0);
+        tb->m_name_changed = true;
+    }
+    lock.unlock();
+
+    m_trace_start = getTimeMilliseconds();
+    m_trace_first_event = true;
+    fputs("[\n", m_trace_file);
+    writeTraceLine("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                   "\"args\":{\"name\":\"SuperTuxKart\"}}");
+    m_trace_generation.fetch_add(1);
+    m_tracing.store(true);
+    m_trace_thread = std::thread(&Profiler::traceWriterLoop, this);
+    Log::info("Profiler", "Writing trace to '%s'.", filename.c_str());
+    return true;
+}   // startTrace
+
+// ----------------------------------------------------------------------------
+/** Stops writing the trace started with startTrace(). */
+void Profiler::stopTrace()
+{
+    if (!m_trace_file)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_trace_mutex);
+        m_tracing.store(false);
+    }
+    m_trace_cv.notify_one();
+    m_trace_thread.join();
+
+    uint32_t dropped = 0;
+    for (TraceBuffer* tb : m_trace_buffers)
+        dropped += tb->m_dropped.load();
+    if (dropped > 0)
+    {
+        Log::warn("Profiler", "%u trace events were dropped since the trace "
+                  "buffer was full.", dropped);
+    }
+    fputs("\n]\n", m_trace_file);
+    fclose(m_trace_file);
+    m_trace_file = NULL;
+}   // stopTrace
+
+// ----------------------------------------------------------------------------
+/** The trace writer thread: regularly writes the recorded events to the
+ *  file, till tracing is stopped. */
+void Profiler::traceWriterLoop()
+{
+    VS::setThreadName("ProfilerTrace");
+    std::unique_lock<std::mutex> lock(m_trace_mutex);
+    while (m_tracing.load())
+    {
+        m_trace_cv.wait_for(lock, std::chrono::milliseconds(100));
+        writeTraceEvents();
+    }
+    writeTraceEvents();
+}   // traceWriterLoop
+
+// ----------------------------------------------------------------------------
+void Profiler::writeTraceLine(const std::string& line)
+{
+    if (!m_trace_first_event)
+        fputs(",\n", m_trace_file);
+    m_trace_first_event = false;
+    fputs(line.c_str(), m_trace_file);
+}   // writeTraceLine
+
+// ----------------------------------------------------------------------------
+/** Writes all events recorded since the last call to the trace file. Must
+ *  be called with the trace mutex locked. */
+void Profiler::writeTraceEvents()
+{
+    std::string line;
+    char buffer[128];
+    for (TraceBuffer* tb : m_trace_buffers)
+    {
+        const std::string ids = "\"pid\":1,\"tid\":" +
+                                StringUtils::toString(tb->m_tid);
+        if (tb->m_name_changed)
+        {
+            line = "{\"name\":\"thread_name\",\"ph\":\"M\"," + ids +
+                   ",\"args\":{\"name\":";
+            addJSONString(tb->m_name.c_str(), &line);
+            line += "}}";
+            writeTraceLine(line);
+            tb->m_name_changed = false;
+        }
+
+        const uint32_t w = tb->m_write.load(std::memory_order_acquire);
+        uint32_t r = tb->m_read.load(std::memory_order_relaxed);
+        for (; r != w; r++)
+        {
+            const TraceEvent& e = tb->m_events[r & (TRACE_BUFFER_SIZE - 1)];
+            line = "{";
+            if (e.m_phase != 'E')
+            {
+                line += "\"name\":";
+                addJSONString(e.m_name, &line);
+                line += ",";
+            }
+            snprintf(buffer, sizeof(buffer), "\"ph\":\"%c\",\"ts\":%.3f,",
+                     e.m_phase, (e.m_time - m_trace_start) * 1000.0);
+            line += buffer;
+            line += ids;
+            if (e.m_phase == 'i')
+                line += ",\"s\":\"g\"";
+            else if (e.m_phase == 'C')
+                line += ",\"args\":{\"us\":" + StringUtils::toString(e.m_value)
+                      + "}";
+            line += "}";
+            writeTraceLine(line);
+        }
+        tb->m_read.store(w, std::memory_order_release);
+    }
+    fflush(m_trace_file);
+}   // writeTraceEvents
+
+// ----------------------------------------------------------------------------
+void Profiler::unitTesting()
+{
+    const std::string name = file_manager->getUserConfigFile("trace-test.json");
+    if (!profiler.startTrace(name))
+    {
+        Log::fatal("Profiler", "Unit test can't start trace '%s'.",
+                   name.c_str());
+        return;
+    }
+
+    // Record more events than fit into a buffer, so that some are dropped
+    // while the writer thread is running.
+    const video::SColor colour(255, 255, 0, 0);
+    std::thread t([colour]()
+        {
+            VS::setThreadName("TraceTest");
+            for (int i = 0; i < 3000; i++)
+            {
+                profiler.pushCPUMarker("Outer", colour);
+                for (int j = 0; j < 20; j++)
+                {
+                    profiler.pushCPUMarker("Inner \"quoted\"", colour);
+                    profiler.popCPUMarker();
+                }
+                profiler.popCPUMarker();
+            }
+        });
+    profiler.pushCPUMarker("Main", colour);
+    profiler.synchronizeFrame();
+    t.join();
+    profiler.popCPUMarker();
+    // Not recorded, the begin event was before the trace
+    profiler.stopTrace();
+    profiler.popCPUMarker();
+
+    std::ifstream f(FileUtils::getPortableReadingPath(name));
+    std::string line;
+    std::map<std::string, int> depth;
+    bool found_name = false, found_frame = false;
+    int lines = 0;
+    while (std::getline(f, line))
+    {
+        lines++;
+        if (line == "[" || line == "]")
+            continue;
+        if (line.find("\"name\":\"TraceTest\"") != std::string::npos)
+            found_name = true;
+        if (line.find("\"name\":\"Frame\"") != std::string::npos)
+            found_frame = true;
+        size_t tid = line.find("\"tid\":");
+        if (tid == std::string::npos)
+            continue;
+        const std::string id = line.substr(tid, line.find_first_of(",}", tid)
+                                                - tid);
+        if (line.find("\"ph\":\"B\"") != std::string::npos)
+            depth[id]++;
+        else if (line.find("\"ph\":\"E\"") != std::string::npos &&
+                 depth[id]-- == 0)
+        {
+            Log::fatal("Profiler", "Unit test: end event without begin in "
+                       "'%s'.", line.c_str());
+        }
+    }
+    f.close();
+    if (lines <= 3 || !found_name || !found_frame)
+    {
+        Log::fatal("Profiler", "Unit test: incomplete trace, %d lines, "
+                   "thread name %d, frame %d.", lines, found_name,
+                   found_frame);
+    }
+    for (auto& d : depth)
+    {
+        if (d.second != 0)
+        {
+            Log::fatal("Profiler", "Unit test: %d unmatched begin events "
+                       "for %s.", d.second, d.first.c_str());
+        }
+    }
+    file_manager->removeFile(name);
+}   // unitTesting
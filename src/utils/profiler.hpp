@@ -22,13 +22,17 @@
 
 #include <assert.h>
 #include <atomic>
+#include <condition_variable>
+#include <cstdio>
 #include <iostream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <stack>
 #include <streambuf>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <vector2d.h>
@@ -99,6 +103,10 @@ using namespace irr;
  */
 class Profiler
 {
+public:
+    /** Per thread buffer of trace events, see startTrace(). */
+    struct TraceBuffer;
+
 private:
     // ------------------------------------------------------------------------
     class Marker
@@ -173,12 +181,21 @@ private:
         /** Vector of all buffered markers. */
         std::vector<Marker> m_all_markers;
 
+        /** Total duration of this event (in ms), independent of the
+         *  circular buffer. */
+        double m_total_duration;
+
+        /** How often this event was recorded. */
+        int m_total_count;
+
     public:
-        EventData() {}
+        EventData() { m_total_duration = 0; m_total_count = 0; }
         EventData(video::SColor colour, int max_size)
         {
             m_all_markers.resize(max_size);
             m_colour = colour;
+            m_total_duration = 0;
+            m_total_count = 0;
         }   // EventData
         // --------------------------------------------------------------------
         /** Records the start of an event for a given frame. */
@@ -201,6 +218,19 @@ private:
         /** Returns the colour for this event. */
         video::SColor getColour() const { return m_colour;  }
         // --------------------------------------------------------------------
+        /** Adds the duration of one occurrence of this event to the totals. */
+        void addToTotal(double duration)
+        {
+            m_total_duration += duration;
+            m_total_count++;
+        }   // addToTotal
+        // --------------------------------------------------------------------
+        void clearTotal() { m_total_duration = 0; m_total_count = 0; }
+        // --------------------------------------------------------------------
+        double getTotalDuration() const { return m_total_duration; }
+        // --------------------------------------------------------------------
+        int getTotalCount() const { return m_total_count; }
+        // --------------------------------------------------------------------
     };   // EventData
 
     // ========================================================================
@@ -212,6 +242,9 @@ private:
         /** Stack of events to detect nesting. */
         std::vector< std::string > m_event_stack;
 
+        /** Absolute start time of each event in m_event_stack. */
+        std::vector<double> m_start_stack;
+
         /** This stores the event names in the order in which they occur.
         *  This means that 'outer' events occur here before any child
         *  events. This list is then used to determine the order in which the
@@ -222,7 +255,16 @@ private:
     };   // class ThreadData
 
     // ========================================================================
+public:
+    /** Accumulated duration and count of an event, see getEventTotals(). */
+    struct EventTotal
+    {
+        double m_duration;
+        int    m_count;
+        EventTotal() : m_duration(0), m_count(0) {}
+    };   // EventTotal
 
+private:
     /** Data structure containing all currently buffered markers. The index
      *  is the thread id. */
     std::vector< ThreadData> m_all_threads_data;
@@ -304,9 +346,44 @@ private:
 
     FreezeState     m_freeze_state;
 
+    // ------------------------------------------------------------------------
+    // Continuous trace export, independent of the on-screen profiler.
+    /** True while a trace is written. */
+    std::atomic_bool m_tracing;
+
+    /** Incremented for each trace, so that threads can reset the state of
+     *  their buffer. */
+    std::atomic<unsigned int> m_trace_generation;
+
+    /** The buffers of all threads that ever recorded a trace event, the
+     *  index is the thread id used in the trace. Protected by
+     *  m_trace_mutex. */
+    std::vector<TraceBuffer*> m_trace_buffers;
+
+    std::mutex m_trace_mutex;
+
+    /** Used to wake up the trace writer thread when tracing is stopped. */
+    std::condition_variable m_trace_cv;
+
+    std::thread m_trace_thread;
+
+    FILE* m_trace_file;
+
+    /** Time (in ms) when the trace was started, all trace times are
+     *  relative to this. */
+    double m_trace_start;
+
+    /** True if no event was written to the trace file yet. */
+    bool m_trace_first_event;
+
 private:
     int  getThreadID();
     void drawBackground();
+    TraceBuffer* getTraceBuffer();
+    void addTraceEvent(char phase, const char* name, unsigned value = 0);
+    void writeTraceEvents();
+    void writeTraceLine(const std::string& line);
+    void traceWriterLoop();
 
 public:
              Profiler();
@@ -324,6 +401,17 @@ public:
     void     computeStableFPS();
     void     startBenchmark();
     void     writeToFile();
+    std::map<std::string, EventTotal> getEventTotals();
+    void     clearEventTotals();
+    bool     startTrace(const std::string& filename);
+    void     stopTrace();
+    static void setThreadName(const char* name);
+    static void unitTesting();
+
+    // ------------------------------------------------------------------------
+    /** Returns true if a trace is currently written. */
+    bool isTracing() const
+                        { return m_tracing.load(std::memory_order_relaxed); }
 
     // ------------------------------------------------------------------------
     bool isFrozen() const { return m_freeze_state == FROZEN; }
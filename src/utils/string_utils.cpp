@@ -844,6 +844,23 @@ namespace StringUtils
         return output.str();
     }   // xmlEncode
 
+    // ------------------------------------------------------------------------
+    /** Returns the (utf8) string as a quoted JSON string, i.e. quotes and
+     *  backslashes are escaped and control characters are removed. */
+    std::string jsonEncode(const std::string &s)
+    {
+        std::string result = "\"";
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                result += '\\';
+            if ((unsigned char)c < 0x20)
+                continue;
+            result += c;
+        }
+        return result + "\"";
+    }   // jsonEncode
+
     // ------------------------------------------------------------------------
 
     std::string wideToUtf8(const wchar_t* input)
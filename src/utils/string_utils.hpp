@@ -69,6 +69,8 @@ namespace StringUtils
 
     std::string xmlEncode(const irr::core::stringw &output);
 
+    std::string jsonEncode(const std::string &s);
+
     // ------------------------------------------------------------------------
     template <class T>
     std::string toString(const T& any)
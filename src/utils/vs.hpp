@@ -53,6 +53,9 @@
 #  include <kernel/scheduler.h>
 #endif
 
+/** Defined in profiler.cpp, so that exported traces show the thread names. */
+void setProfilerThreadName(const char *name);
+
 namespace VS
 {
 #if defined(_MSC_VER) && defined(DEBUG)
@@ -64,6 +67,7 @@ namespace VS
      */
     static void setThreadName(const char *name)
     {
+        setProfilerThreadName(name);
         const DWORD MS_VC_EXCEPTION=0x406D1388;
 #pragma pack(push,8)
         typedef struct tagTHREADNAME_INFO
@@ -94,6 +98,7 @@ namespace VS
 #else
     static void setThreadName(const char* name)
     {
+        setProfilerThreadName(name);
 #if defined(__linux__) && defined(__GLIBC__) && defined(__GLIBC_MINOR__)
 #if __GLIBC__ > 2 || __GLIBC_MINOR__ > 11 || defined(__sun)
         pthread_setname_np(pthread_self(), name);
@@ -0,0 +1,129 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "utils/worker_pool.hpp"
+#include "utils/string_utils.hpp"
+#include "utils/vs.hpp"
+
+// ----------------------------------------------------------------------------
+/** Starts the worker threads.
+ *  \param num_threads Number of threads to start. The thread calling run()
+ *         works on the jobs as well, so this is usually one less than the
+ *         number of cores to use.
+ *  \param name Name of the threads (for debugging).
+ */
+WorkerPool::WorkerPool(unsigned int num_threads, const std::string &name)
+{
+    m_job      = NULL;
+    m_num_jobs = 0;
+    m_next_job.store(0);
+    m_num_busy = 0;
+    m_batch    = 0;
+    m_exit     = false;
+    for (unsigned int i = 0; i < num_threads; i++)
+    {
+        std::string thread_name = name + StringUtils::toString(i);
+        m_threads.emplace_back([this, thread_name]()
+            {
+                VS::setThreadName(thread_name.c_str());
+                workerLoop();
+            });
+    }
+}   // WorkerPool
+
+// ----------------------------------------------------------------------------
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    m_start_cv.notify_all();
+    for (std::thread &t : m_threads)
+        t.join();
+}   // ~WorkerPool
+
+// ----------------------------------------------------------------------------
+/** Executes jobs of the current batch till no job is left. */
+void WorkerPool::executeJobs()
+{
+    while (true)
+    {
+        int i = m_next_job.fetch_add(1);
+        if (i >= m_num_jobs)
+            return;
+        (*m_job)(i);
+    }
+}   // executeJobs
+
+// ----------------------------------------------------------------------------
+/** The main loop of each worker thread: waits for a new batch, works on it
+ *  and reports back when no more jobs are left. */
+void WorkerPool::workerLoop()
+{
+    unsigned int last_batch = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_start_cv.wait(lock, [this, last_batch]()
+            {
+                return m_exit || m_batch != last_batch;
+            });
+        if (m_exit)
+            return;
+        last_batch = m_batch;
+        lock.unlock();
+        executeJobs();
+        lock.lock();
+        if (--m_num_busy == 0)
+            m_done_cv.notify_one();
+    }
+}   // workerLoop
+
+// ----------------------------------------------------------------------------
+/** Calls job(i) for all i in [0, num_jobs) and waits till all calls are
+ *  finished. The order in which the jobs are executed is undefined, so the
+ *  jobs must be independent of each other.
+ *  \param num_jobs Number of jobs.
+ *  \param job The function to call for each job index.
+ */
+void WorkerPool::run(int num_jobs, const std::function<void(int)> &job)
+{
+    if (m_threads.empty() || num_jobs < 2)
+    {
+        for (int i = 0; i < num_jobs; i++)
+            job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job      = &job;
+        m_num_jobs = num_jobs;
+        m_next_job.store(0);
+        m_num_busy = (unsigned int)m_threads.size();
+        m_batch++;
+    }
+    m_start_cv.notify_all();
+
+    executeJobs();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cv.wait(lock, [this]() { return m_num_busy == 0; });
+    m_job = NULL;
+}   // run
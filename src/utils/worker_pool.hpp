@@ -0,0 +1,89 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_WORKER_POOL_HPP
+#define HEADER_WORKER_POOL_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ *  \brief A small pool of threads that executes a number of independent
+ *  jobs in parallel. run() hands out the job indices to the worker threads
+ *  and the calling thread, and only returns once all jobs are done. It is
+ *  meant for short, frequently repeated batches (e.g. once per time step),
+ *  so the threads are kept alive between batches.
+ *  \ingroup utils
+ */
+class WorkerPool : public NoCopy
+{
+private:
+    std::vector<std::thread> m_threads;
+
+    /** Protects all variables below except m_next_job. */
+    std::mutex m_mutex;
+
+    /** Signals the workers that a new batch is available (or to exit). */
+    std::condition_variable m_start_cv;
+
+    /** Signals the caller of run() that all workers are done. */
+    std::condition_variable m_done_cv;
+
+    /** The job of the current batch. */
+    const std::function<void(int)> *m_job;
+
+    /** Number of jobs in the current batch. */
+    int m_num_jobs;
+
+    /** Index of the next job to be executed. */
+    std::atomic<int> m_next_job;
+
+    /** Number of workers still busy with the current batch. */
+    unsigned int m_num_busy;
+
+    /** Incremented for each batch, so a worker can detect a new batch. */
+    unsigned int m_batch;
+
+    /** Set to make all workers exit. */
+    bool m_exit;
+
+    // ------------------------------------------------------------------------
+    void workerLoop();
+    // ------------------------------------------------------------------------
+    void executeJobs();
+
+public:
+    WorkerPool(unsigned int num_threads, const std::string &name);
+    // ------------------------------------------------------------------------
+    ~WorkerPool();
+    // ------------------------------------------------------------------------
+    void run(int num_jobs, const std::function<void(int)> &job);
+    // ------------------------------------------------------------------------
+    /** Returns the number of worker threads (not including the thread
+     *  calling run()). */
+    unsigned int getNumThreads() const { return (unsigned int)m_threads.size(); }
+};   // WorkerPool
+
+#endif
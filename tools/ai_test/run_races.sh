@@ -0,0 +1,28 @@
+#!/bin/bash
+# Runs a batch of AI races (see --ai-races in supertuxkart --help) in
+# several parallel processes and merges the CSV results.
+# Usage: run_races.sh <supertuxkart binary> <number of processes> <result.csv>
+#                     [other --ai-races-* options]
+
+if [ $# -lt 3 ]; then
+    echo "Usage: $0 <supertuxkart binary> <processes> <result.csv> [options]"
+    exit 1
+fi
+
+stk=$1
+workers=$2
+result=$3
+shift 3
+
+for ((i = 0; i < workers; i++)); do
+    $stk --log=0 --ai-races=$result.$i.csv --ai-races-worker=$i,$workers \
+        "$@" > stdout.ai_races.$i &
+done
+wait
+
+head -n 1 $result.0.csv > $result
+for ((i = 0; i < workers; i++)); do
+    tail -n +2 $result.$i.csv >> $result
+    rm $result.$i.csv
+done
+echo "Results written to $result"
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+#
+# SuperTuxKart - a fun racing game with go-kart
+# Copyright (C) 2026 SuperTuxKart-Team
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# Local load generator for the connection flood protection of a server (see
+# connection-rate and connection-burst in the server config).
+#
+# It sends ENet connection requests from many loopback addresses
+# (127.1.0.0/16 on Linux, which routes all of 127.0.0.0/8 to the loopback
+# interface), which never finish the handshake, like a flood with spoofed
+# addresses. At the same time a probe client from 127.0.0.1 tries to
+# connect once per second, answering cookies like a real client, and
+# reports how long it takes till the server accepts it.
+#
+# Usage: connection_flood.py [--server 127.0.0.1:2759] [--rate 2000]
+#                            [--duration 10] [--sources 256] [--no-probe]
+#
+# Only use it against your own server.
+
+import argparse
+import os
+import random
+import select
+import socket
+import struct
+import sys
+import time
+
+COMMAND_CONNECT = 2
+COMMAND_VERIFY_CONNECT = 3
+COMMAND_DISCONNECT = 4
+COMMAND_FLAG_ACKNOWLEDGE = 1 << 7
+HEADER_FLAG_SENT_TIME = 1 << 15
+HEADER_FLAG_COMPRESSED = 1 << 14
+MAXIMUM_PEER_ID = 0xFFF
+# EVENT_CHANNEL_COUNT in src/network/event.hpp
+CHANNEL_COUNT = 3
+
+COOKIE_PREFIX = b"\xff\xff\x0astk-cookie"
+
+# -----------------------------------------------------------------------------
+def connectRequest(data=0):
+    """Returns an ENet connect command, with the cookie in its data."""
+    header = struct.pack(">HH", MAXIMUM_PEER_ID | HEADER_FLAG_SENT_TIME,
+                         int(time.time() * 1000) & 0xFFFF)
+    command = struct.pack(">BBH", COMMAND_CONNECT | COMMAND_FLAG_ACKNOWLEDGE,
+                          0xFF, 1)
+    connect = struct.pack(">HBBIIIIIIIIII", 0, 0xFF, 0xFF, 1400, 32768,
+                          CHANNEL_COUNT, 0, 0, 5000, 2, 2,
+                          random.getrandbits(32), data)
+    return header + command + connect
+
+# -----------------------------------------------------------------------------
+def parseReply(data):
+    """Returns ("cookie", value), ("verify", (peer id, session id)) or
+    None."""
+    if len(data) == len(COOKIE_PREFIX) + 4 and \
+       data.startswith(COOKIE_PREFIX):
+        return ("cookie", struct.unpack(">I", data[-4:])[0])
+    if len(data) < 2:
+        return None
+    flags = struct.unpack(">H", data[:2])[0]
+    if flags & HEADER_FLAG_COMPRESSED:
+        return None
+    offset = 4 if flags & HEADER_FLAG_SENT_TIME else 2
+    # An acknowledge of the connect command can come first
+    while offset + 4 <= len(data):
+        command = data[offset] & 0x0F
+        if command == COMMAND_VERIFY_CONNECT and offset + 8 <= len(data):
+            peer_id, incoming, outgoing = \
+                struct.unpack(">HBB", data[offset + 4:offset + 8])
+            return ("verify", (peer_id, outgoing))
+        if command == 1:
+            # Acknowledge: command header and 4 bytes
+            offset += 8
+        else:
+            break
+    return None
+
+# -----------------------------------------------------------------------------
+def disconnect(sock, server, verify):
+    """Frees the peer of an accepted probe, so the server keeps free
+    slots."""
+    peer_id, session = verify
+    header = struct.pack(">H", peer_id | ((session & 3) << 12))
+    command = struct.pack(">BBHI", COMMAND_DISCONNECT, 0xFF, 0, 0)
+    sock.sendto(header + command, server)
+
+# -----------------------------------------------------------------------------
+class Probe:
+    """A client from 127.0.0.1 which answers the cookies."""
+    def __init__(self, server):
+        self.server = server
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(("127.0.0.1", 0))
+        self.sock.setblocking(False)
+        self.start = None
+        self.last_send = 0
+        self.cookie = 0
+        self.times = []
+        self.attempts = 0
+
+    def update(self, now):
+        if self.start is None:
+            if now - self.last_send >= 1.0:
+                self.start = now
+                self.cookie = 0
+                self.attempts += 1
+                self.send(now)
+        elif now - self.last_send >= 0.5:
+            # Resend like ENet, in case of packet loss
+            self.send(now)
+        if self.start is not None and now - self.start > 10.0:
+            print("Probe: not accepted after 10s")
+            self.start = None
+
+    def send(self, now):
+        self.sock.sendto(connectRequest(self.cookie), self.server)
+        self.last_send = now
+
+    def receive(self, now):
+        try:
+            data, sender = self.sock.recvfrom(2048)
+        except BlockingIOError:
+            return
+        reply = parseReply(data)
+        if reply is None or self.start is None:
+            return
+        if reply[0] == "cookie":
+            self.cookie = reply[1]
+            self.send(now)
+        else:
+            self.times.append(now - self.start)
+            disconnect(self.sock, self.server, reply[1])
+            self.start = None
+
+# -----------------------------------------------------------------------------
+def main():
+    parser = argparse.ArgumentParser(description="Floods a local STK server "
+                                     "with connection requests.")
+    parser.add_argument("--server", default="127.0.0.1:2759",
+                        help="Address of the server (default %(default)s)")
+    parser.add_argument("--rate", type=int, default=2000,
+                        help="Requests per second (default %(default)s)")
+    parser.add_argument("--duration", type=float, default=10.0,
+                        help="Duration in seconds (default %(default)s)")
+    parser.add_argument("--sources", type=int, default=256,
+                        help="Number of source addresses (default "
+                        "%(default)s)")
+    parser.add_argument("--no-probe", action="store_true",
+                        help="Do not test a normal client")
+    args = parser.parse_args()
+
+    host, port = args.server.rsplit(":", 1)
+    server = (socket.gethostbyname(host), int(port))
+    if not server[0].startswith("127."):
+        sys.exit("Only a local server can be flooded.")
+
+    sources = []
+    for i in range(args.sources):
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        try:
+            sock.bind(("127.1.%d.%d" % (i // 254, i % 254 + 1), 0))
+        except OSError as e:
+            sys.exit("Cannot bind to 127.1.x.y (%s), this needs Linux." % e)
+        sock.setblocking(False)
+        sources.append(sock)
+    probe = None if args.no_probe else Probe(server)
+
+    sent = verified = cookies = 0
+    start = time.time()
+    next_send = start
+    while True:
+        now = time.time()
+        if now - start >= args.duration:
+            break
+        while next_send <= now:
+            random.choice(sources).sendto(connectRequest(), server)
+            sent += 1
+            next_send += 1.0 / args.rate
+        if probe:
+            probe.update(now)
+        readable, _, _ = select.select(sources +
+            ([probe.sock] if probe else []), [], [],
+            max(0.0, min(next_send - time.time(), 0.01)))
+        for sock in readable:
+            if probe and sock is probe.sock:
+                probe.receive(time.time())
+                continue
+            try:
+                data, sender = sock.recvfrom(2048)
+            except BlockingIOError:
+                continue
+            reply = parseReply(data)
+            if reply is None:
+                continue
+            if reply[0] == "cookie":
+                cookies += 1
+            else:
+                verified += 1
+
+    elapsed = time.time() - start
+    print("Sent %d connection requests in %.1fs from %d addresses." %
+          (sent, elapsed, len(sources)))
+    print("Accepted by ENet (verify connect): %d, answered with a cookie: "
+          "%d, ignored: %d" % (verified, cookies,
+                               max(0, sent - verified - cookies)))
+    if probe:
+        if probe.times:
+            probe.times.sort()
+            print("Probe client accepted %d of %d times, median %.0fms, "
+                  "max %.0fms." % (len(probe.times), probe.attempts,
+                  probe.times[len(probe.times) // 2] * 1000,
+                  probe.times[-1] * 1000))
+        else:
+            print("Probe client never accepted in %d attempts." %
+                  probe.attempts)
+
+if __name__ == "__main__":
+    main()
@@ -181,6 +181,19 @@ def createAcGetter(groups):
 }}  // get{1}
 """.format(m.typeC, nameTitle, nameUnderscore.upper(), typeC, result))
 
+""" Returns true if the values of this member are stored directly in the
+    characteristic table of the kart properties (not in a container) """
+def isScalar(member):
+    return member.typeC in ("float", "bool")
+
+""" Returns all (group, member) tuples in the order of the characteristic
+    table: all scalar values first, so that they are close together in
+    memory, followed by the containers """
+def tableMembers(groups):
+    members = [(g, m) for g in groups for m in g.members]
+    return [gm for gm in members if isScalar(gm[1])] + \
+           [gm for gm in members if not isScalar(gm[1])]
+
 def createKpDefs(groups):
     for g in groups:
         print()
@@ -188,24 +201,23 @@ def createKpDefs(groups):
             nameTitle = joinSubName(g, m, True)
             nameUnderscore = joinSubName(g, m, False)
             typeC = m.typeC
+            if not isScalar(m):
+                typeC = "const {0}&".format(typeC)
 
-            print("    {0} get{1}() const;".
+            print("    {0} get{1}() const\n        {{ return m_table.m_{2}; }}".
                 format(typeC, nameTitle, nameUnderscore))
 
-def createKpGetter(groups):
-    for g in groups:
-        for m in g.members:
-            nameTitle = joinSubName(g, m, True)
-            nameUnderscore = joinSubName(g, m, False)
-            typeC = m.typeC
-            result = "result"
+def createKpTable(groups):
+    for g, m in tableMembers(groups):
+        nameUnderscore = joinSubName(g, m, False)
+        print("        {0} m_{1};".format(m.typeC, nameUnderscore))
 
-            print("""// ----------------------------------------------------------------------------
-{1} KartProperties::get{0}() const
-{{
-    return m_cached_characteristic->get{0}();
-}}  // get{0}
-""".format(nameTitle, typeC))
+def createKpTableFill(groups):
+    for g, m in tableMembers(groups):
+        nameTitle = joinSubName(g, m, True)
+        nameUnderscore = joinSubName(g, m, False)
+        print("""    m_table.m_{0} =
+        m_cached_characteristic->get{1}();""".format(nameUnderscore, nameTitle))
 
 def createGetType(groups):
     for g in groups:
@@ -243,8 +255,9 @@ functions = {
     "acgetter": (createAcGetter, "Implement the getters",                                  "karts/abstract_characteristic.cpp"),
     "getType":  (createGetType,  "Implement the getType function",                         "karts/abstract_characteristic.cpp"),
     "getName":  (createGetName,  "Implement the getName function",                         "karts/abstract_characteristic.cpp"),
-    "kpdefs":   (createKpDefs,   "Create the header function definitions for the getters", "karts/kart_properties.hpp"),
-    "kpgetter": (createKpGetter, "Implement the getters",                                  "karts/kart_properties.cpp"),
+    "kpdefs":   (createKpDefs,   "Create the inline getters",                              "karts/kart_properties.hpp"),
+    "kptable":  (createKpTable,  "Create the members of the characteristic table",        "karts/kart_properties.hpp"),
+    "kptablefill": (createKpTableFill, "Fill the characteristic table",                    "karts/kart_properties.cpp"),
     "loadXml":  (createLoadXml,  "Code to load the characteristics from an xml file",      "karts/xml_characteristic.cpp"),
 }
 